@@ -687,6 +687,26 @@ function(generate_inc_file_for_target
   generate_inc_file_for_gen_target(${target} ${source_file} ${generated_file} ${generated_target_name} ${ARGN})
 endfunction()
 
+# Usage:
+#   generate_http_static_inc_files_for_target(<target> <source_file> <generated_base>)
+#
+# Generate the files needed to serve <source_file> as an HTTP server static
+# resource with content negotiation (struct http_resource_detail_static):
+# - <generated_base>.inc with the content as is,
+# - <generated_base>.gz.inc with the gzip compressed content,
+# - <generated_base>.etag.inc with a string literal holding the entity tag of
+#   the content, which changes whenever the content does.
+# Any additional arguments are passed on to file2hex.py.
+function(generate_http_static_inc_files_for_target
+    target          # The cmake target that depends on the generated files
+    source_file     # The source file to be converted to hex
+    generated_base  # Path of the generated files without the extension
+    )
+  generate_inc_file_for_target(${target} ${source_file} ${generated_base}.inc ${ARGN})
+  generate_inc_file_for_target(${target} ${source_file} ${generated_base}.gz.inc --gzip ${ARGN})
+  generate_inc_file_for_target(${target} ${source_file} ${generated_base}.etag.inc --etag ${ARGN})
+endfunction()
+
 # 1.4. board_*
 #
 # This section is for extensions related to Zephyr board handling.
@@ -219,30 +219,38 @@ static struct net_pkt *prepare_pkt(struct eth_context *ctx,
 	return pkt;
 }
 
-static int read_data(struct eth_context *ctx, int fd)
+static struct net_pkt *read_data(struct eth_context *ctx, int fd)
 {
-	struct net_if *iface = ctx->iface;
-	struct net_pkt *pkt = NULL;
+	struct net_pkt *pkt;
 	int status;
 	int count;
 
 	count = nsi_host_read(fd, ctx->recv, sizeof(ctx->recv));
 	if (count <= 0) {
-		return 0;
+		return NULL;
 	}
 
 	pkt = prepare_pkt(ctx, count, &status);
 	if (!pkt) {
-		return status;
+		return NULL;
 	}
 
-	update_gptp(iface, pkt, false);
+	update_gptp(ctx->iface, pkt, false);
 
-	if (net_recv_data(iface, pkt) < 0) {
-		net_pkt_unref(pkt);
-	}
+	return pkt;
+}
 
-	return 0;
+static void recv_data(struct eth_context *ctx, struct net_pkt **pkts,
+		      size_t count)
+{
+	int ret;
+
+	ret = net_recv_data_burst(ctx->iface, pkts, count);
+
+	/* The packets not taken by the stack are still ours */
+	for (size_t i = MAX(ret, 0); i < count; i++) {
+		net_pkt_unref(pkts[i]);
+	}
 }
 
 static void eth_rx(void *p1, void *p2, void *p3)
@@ -251,13 +259,31 @@ static void eth_rx(void *p1, void *p2, void *p3)
 	ARG_UNUSED(p3);
 
 	struct eth_context *ctx = p1;
+	struct net_pkt *pkts[CONFIG_ETH_NATIVE_POSIX_RX_BURST];
+	struct net_pkt *pkt;
+	size_t count;
+
 	LOG_DBG("Starting ZETH RX thread");
 
 	while (1) {
 		if (net_if_is_up(ctx->iface)) {
+			count = 0;
+
 			while (!eth_wait_data(ctx->dev_fd)) {
-				read_data(ctx, ctx->dev_fd);
-				k_yield();
+				pkt = read_data(ctx, ctx->dev_fd);
+				if (pkt) {
+					pkts[count++] = pkt;
+				}
+
+				if (count == ARRAY_SIZE(pkts)) {
+					recv_data(ctx, pkts, count);
+					count = 0;
+					k_yield();
+				}
+			}
+
+			if (count > 0) {
+				recv_data(ctx, pkts, count);
 			}
 		}
 
@@ -34,6 +34,8 @@
 extern "C" {
 #endif
 
+struct net_buf;
+
 /**
  * @brief Set of CoAP packet options we are aware of.
  *
@@ -483,6 +485,36 @@ int coap_packet_init(struct coap_packet *cpkt, uint8_t *data, uint16_t max_len,
 		     uint8_t ver, uint8_t type, uint8_t token_len,
 		     const uint8_t *token, uint8_t code, uint16_t id);
 
+/**
+ * @brief Creates a new CoAP Packet in a network buffer.
+ *
+ * This function works like @ref coap_packet_init, using the tailroom of
+ * @a buf as storage. A confirmable message sent with
+ * @ref coap_service_send_buf is then retransmitted from @a buf, rather than
+ * from a copy made by the pending message allocator.
+ *
+ * The message is still copied when it is sent, as @a buf has no room for
+ * the IP and UDP headers and is handed to the socket like any other data.
+ *
+ * The length of @a buf is not updated while the packet is built. Set it to
+ * the offset of @a cpkt once the packet is complete, unless it is sent with
+ * @ref coap_service_send_buf.
+ *
+ * @param cpkt New packet to be initialized using the storage from @a buf.
+ * @param buf Empty network buffer that will contain the CoAP packet
+ * @param ver CoAP header version
+ * @param type CoAP header type
+ * @param token_len CoAP header token length
+ * @param token CoAP header token
+ * @param code CoAP header code
+ * @param id CoAP header message id
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_packet_init_net_buf(struct coap_packet *cpkt, struct net_buf *buf,
+			     uint8_t ver, uint8_t type, uint8_t token_len,
+			     const uint8_t *token, uint8_t code, uint16_t id);
+
 /**
  * @brief Create a new CoAP Acknowledgment message for given request.
  *
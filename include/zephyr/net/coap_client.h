@@ -78,6 +78,21 @@ struct coap_client_option {
 };
 
 /** @cond INTERNAL_HIDDEN */
+#if CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1
+struct coap_client_block2_request {
+	struct coap_pending pending;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint16_t id;
+	uint32_t num;
+	bool ongoing;
+	bool received;
+	bool last;
+	uint8_t code;
+	uint16_t len;
+	uint8_t payload[CONFIG_COAP_CLIENT_BLOCK_SIZE];
+};
+#endif
+
 struct coap_client_internal_request {
 	uint8_t request_token[COAP_TOKEN_MAX_LEN];
 	uint32_t offset;
@@ -90,6 +105,10 @@ struct coap_client_internal_request {
 	struct coap_client_request coap_request;
 	struct coap_packet request;
 	uint8_t request_tag[COAP_TOKEN_MAX_LEN];
+#if CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1
+	struct coap_client_block2_request block2[CONFIG_COAP_CLIENT_BLOCK2_WINDOW];
+	uint32_t block2_next;
+#endif
 };
 
 struct coap_client {
@@ -40,10 +40,36 @@ extern "C" {
 
 /** @cond INTERNAL_HIDDEN */
 
+#if CONFIG_COAP_SERVICE_HASH_SIZE > 0
+/* Entries are linked by their array index + 1, 0 ends a chain */
+struct coap_service_index {
+	/* Observers by token, and the unused ones */
+	uint16_t observer_bucket[CONFIG_COAP_SERVICE_HASH_SIZE];
+	uint16_t observer_next[CONFIG_COAP_SERVICE_OBSERVERS];
+	uint16_t observer_free;
+	uint16_t observers_used;
+	/* Pending messages by message id, and the unused ones */
+	uint16_t pending_bucket[CONFIG_COAP_SERVICE_HASH_SIZE];
+	uint16_t pending_next[CONFIG_COAP_SERVICE_PENDING_MESSAGES];
+	uint16_t pending_free;
+	uint16_t pendings_used;
+	/* Timer wheel of the pending messages, by retransmission time */
+	uint16_t wheel[CONFIG_COAP_SERVICE_TIMER_WHEEL_SLOTS];
+	uint16_t wheel_next[CONFIG_COAP_SERVICE_PENDING_MESSAGES];
+	uint16_t wheel_slot[CONFIG_COAP_SERVICE_PENDING_MESSAGES];
+	uint16_t wheel_count;
+	int64_t wheel_tick;
+};
+#endif
+
 struct coap_service_data {
 	int sock_fd;
 	struct coap_observer observers[CONFIG_COAP_SERVICE_OBSERVERS];
 	struct coap_pending pending[CONFIG_COAP_SERVICE_PENDING_MESSAGES];
+	struct net_buf *pending_buf[CONFIG_COAP_SERVICE_PENDING_MESSAGES];
+#if CONFIG_COAP_SERVICE_HASH_SIZE > 0
+	struct coap_service_index index;
+#endif
 };
 
 struct coap_service {
@@ -258,6 +284,49 @@ int coap_resource_send(const struct coap_resource *resource, const struct coap_p
 		       const struct sockaddr *addr, socklen_t addr_len,
 		       const struct coap_transmission_parameters *params);
 
+/**
+ * @brief Send a CoAP message built in a network buffer from the provided @p service .
+ *
+ * @note This function is suitable for a @p service defined with @ref COAP_SERVICE_DEFINE.
+ *
+ * This function works like @ref coap_service_send, for a packet created with
+ * @ref coap_packet_init_net_buf. The length of @p buf is set to the length of the packet.
+ * A confirmable message keeps a reference to @p buf for retransmissions, instead of a copy
+ * of the packet, so the packet must not be changed afterwards. The caller keeps its own
+ * reference. Each transmission is sent through the socket of the service, which copies the
+ * packet like for @ref coap_service_send.
+ *
+ * @param service Pointer to CoAP service
+ * @param cpkt CoAP Packet to send
+ * @param buf Network buffer @p cpkt is built in
+ * @param addr Peer address
+ * @param addr_len Peer address length
+ * @param params Pointer to transmission parameters structure or NULL to use default values.
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_service_send_buf(const struct coap_service *service, const struct coap_packet *cpkt,
+			  struct net_buf *buf, const struct sockaddr *addr, socklen_t addr_len,
+			  const struct coap_transmission_parameters *params);
+
+/**
+ * @brief Send a CoAP message built in a network buffer from the provided @p resource .
+ *
+ * @note This function is suitable for a @p resource defined with @ref COAP_RESOURCE_DEFINE.
+ *
+ * This function works like @ref coap_service_send_buf.
+ *
+ * @param resource Pointer to CoAP resource
+ * @param cpkt CoAP Packet to send
+ * @param buf Network buffer @p cpkt is built in
+ * @param addr Peer address
+ * @param addr_len Peer address length
+ * @param params Pointer to transmission parameters structure or NULL to use default values.
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_resource_send_buf(const struct coap_resource *resource, const struct coap_packet *cpkt,
+			   struct net_buf *buf, const struct sockaddr *addr, socklen_t addr_len,
+			   const struct coap_transmission_parameters *params);
+
 /**
  * @brief Parse a CoAP observe request for the provided @p resource .
  *
@@ -196,6 +196,9 @@ enum ethernet_hw_caps {
 
 	/** TX-Injection supported */
 	ETHERNET_TXINJECTION_MODE	= BIT(20),
+
+	/** TCP segmentation offload (TSO) supported for IPv4 and IPv6 */
+	ETHERNET_HW_TX_TCP_SEGMENTATION	= BIT(21),
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -535,6 +538,14 @@ struct ethernet_api {
 
 	/** Send a network packet */
 	int (*send)(const struct device *dev, struct net_pkt *pkt);
+
+	/** Send several network packets, optional. Returns the number of
+	 * packets taken from the start of the array, which are then handled
+	 * as if send() had returned 0 for each, or <0 if none was taken.
+	 * The packets not taken are passed to send() one at a time.
+	 */
+	int (*send_burst)(const struct device *dev, struct net_pkt **pkts,
+			  size_t count);
 };
 
 /* Make sure that the network interface API is properly setup inside
@@ -1128,6 +1139,24 @@ void net_eth_carrier_off(struct net_if *iface);
  */
 int net_eth_promisc_mode(struct net_if *iface, bool enable);
 
+/** @cond INTERNAL_HIDDEN */
+
+/**
+ * @brief Send packets queued together for one interface.
+ *
+ * Used by the Tx traffic class threads. The result of each packet, as
+ * returned by the L2 send of a single packet, is stored in @a status.
+ *
+ * @param iface Network interface
+ * @param pkts Packets to send
+ * @param status Result of each packet
+ * @param count Number of packets, at most CONFIG_NET_TC_TX_BURST
+ */
+void net_eth_send_burst(struct net_if *iface, struct net_pkt **pkts,
+			int *status, size_t count);
+
+/** @endcond */
+
 /**
  * @brief Set TX-Injection mode either ON or OFF.
  *
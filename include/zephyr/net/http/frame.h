@@ -26,12 +26,22 @@ enum http_frame_type {
 	HTTP_SERVER_CONTINUATION_FRAME = 0x09
 };
 
+enum http_frame_error_code {
+	HTTP_SERVER_NO_ERROR = 0x00,
+	HTTP_SERVER_PROTOCOL_ERROR = 0x01,
+	HTTP_SERVER_INTERNAL_ERROR = 0x02,
+	HTTP_SERVER_FLOW_CONTROL_ERROR = 0x03,
+	HTTP_SERVER_FRAME_SIZE_ERROR = 0x06,
+};
+
 #define HTTP_SERVER_HPACK_METHOD 0
 #define HTTP_SERVER_HPACK_PATH   1
 
 #define HTTP_SERVER_FLAG_SETTINGS_ACK 0x1
 #define HTTP_SERVER_FLAG_END_HEADERS  0x4
 #define HTTP_SERVER_FLAG_END_STREAM   0x1
+#define HTTP_SERVER_FLAG_PADDED       0x8
+#define HTTP_SERVER_FLAG_PRIORITY     0x20
 
 #define HTTP_SERVER_FRAME_HEADER_SIZE      9
 #define HTTP_SERVER_FRAME_LENGTH_OFFSET    0
@@ -39,6 +49,14 @@ enum http_frame_type {
 #define HTTP_SERVER_FRAME_FLAGS_OFFSET     4
 #define HTTP_SERVER_FRAME_STREAM_ID_OFFSET 5
 
+#define HTTP_SERVER_PRIORITY_FIELDS_LEN    5
+#define HTTP_SERVER_DEFAULT_WEIGHT         16
+#define HTTP_SERVER_MAX_WEIGHT             256
+#define HTTP_SERVER_DEFAULT_WINDOW_SIZE    65535
+#define HTTP_SERVER_MAX_WINDOW_SIZE        0x7FFFFFFF
+#define HTTP_SERVER_MIN_MAX_FRAME_SIZE     16384
+#define HTTP_SERVER_MAX_MAX_FRAME_SIZE     0xFFFFFF
+
 struct http_settings_field {
 	uint16_t id;
 	uint32_t value;
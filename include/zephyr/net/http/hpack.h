@@ -12,6 +12,7 @@
 #ifndef ZEPHYR_INCLUDE_NET_HTTP_SERVER_HPACK_H_
 #define ZEPHYR_INCLUDE_NET_HTTP_SERVER_HPACK_H_
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -96,8 +97,10 @@ enum http_hpack_static_key {
 
 #if defined(CONFIG_HTTP_SERVER)
 #define HTTP_SERVER_HUFFMAN_DECODE_BUFFER_SIZE CONFIG_HTTP_SERVER_HUFFMAN_DECODE_BUFFER_SIZE
+#define HTTP_SERVER_HPACK_ENCODER_TABLE_SIZE CONFIG_HTTP_SERVER_HPACK_ENCODER_TABLE_SIZE
 #else
 #define HTTP_SERVER_HUFFMAN_DECODE_BUFFER_SIZE 0
+#define HTTP_SERVER_HPACK_ENCODER_TABLE_SIZE 0
 #endif
 
 /** HTTP2 header field with decoding buffer. */
@@ -121,6 +124,29 @@ struct http_hpack_header_buf {
 	size_t datalen;
 };
 
+/** HPACK encoder context, holding the dynamic table of one connection. */
+struct http_hpack_encoder {
+	/** Dynamic table entries, newest first. Each entry is stored as the
+	 *  name length, the value length, the name and the value.
+	 */
+	uint8_t table[HTTP_SERVER_HPACK_ENCODER_TABLE_SIZE];
+
+	/** Length of the data in the table buffer. */
+	uint16_t table_len;
+
+	/** Size of the dynamic table, as defined in RFC 7541, ch 4.1. */
+	uint16_t size;
+
+	/** Maximum size of the dynamic table. */
+	uint16_t max_size;
+
+	/** Number of entries in the dynamic table. */
+	uint8_t count;
+
+	/** Maximum size changed, not signaled to the peer yet. */
+	bool size_update;
+};
+
 int http_hpack_huffman_decode(const uint8_t *encoded_buf, size_t encoded_len,
 			      uint8_t *buf, size_t buflen);
 int http_hpack_huffman_encode(const uint8_t *str, size_t str_len,
@@ -129,6 +155,12 @@ int http_hpack_decode_header(const uint8_t *buf, size_t datalen,
 			     struct http_hpack_header_buf *header);
 int http_hpack_encode_header(uint8_t *buf, size_t buflen,
 			     struct http_hpack_header_buf *header);
+void http_hpack_encoder_init(struct http_hpack_encoder *encoder);
+void http_hpack_encoder_set_max_size(struct http_hpack_encoder *encoder,
+				     uint32_t max_size);
+int http_hpack_encoder_encode(struct http_hpack_encoder *encoder,
+			      uint8_t *buf, size_t buflen,
+			      struct http_hpack_header_buf *header);
 
 #ifdef __cplusplus
 }
@@ -22,6 +22,10 @@
 #include <zephyr/net/http/hpack.h>
 #include <zephyr/net/socket.h>
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+#include <zephyr/fs/fs.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -40,10 +44,19 @@ extern "C" {
 #define HTTP_SERVER_MAX_URL_LENGTH       0
 #endif
 
-/* Maximum header field name / value length. This is only used to detect Upgrade and
- * websocket header fields and values in the http1 server so the value is quite short.
+/* Maximum header field name / value length. This is only used to detect Upgrade,
+ * websocket, Accept-Encoding and If-None-Match header fields and values in the http1
+ * server so the value is quite short. It is twice the size needed for Upgrade and
+ * websocket, so that an Accept-Encoding value as sent by browsers, or an If-None-Match
+ * list holding a couple of generated entity tags, fits. Longer values are ignored,
+ * which only costs a full response instead of an encoded or 304 one.
  */
-#define HTTP_SERVER_MAX_HEADER_LEN 32
+#define HTTP_SERVER_MAX_HEADER_LEN 64
+
+/* Maximum length of the entity tag of a static resource, including the quotes
+ * and the suffix marking the gzip compressed variant.
+ */
+#define HTTP_SERVER_MAX_ETAG_LEN 32
 
 #define HTTP2_PREFACE "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
 
@@ -65,6 +78,9 @@ enum http_resource_type {
 	 *  after and upgrade.
 	 */
 	HTTP_RESOURCE_TYPE_WEBSOCKET,
+
+	/** Static resource served from a file on the file system. */
+	HTTP_RESOURCE_TYPE_STATIC_FS,
 };
 
 /**
@@ -77,7 +93,13 @@ struct http_resource_detail {
 	/** Resource type. */
 	enum http_resource_type type;
 
-	/** Length of the URL path. */
+	/** Length of the URL path matched by the last request.
+	 *
+	 * Only updated when the server runs a single thread
+	 * (CONFIG_HTTP_SERVER_NUM_WORKERS is 1). With more threads a resource
+	 * can be requested by several clients at the same time, so use
+	 * http_client_ctx::path_len, which is always updated, instead.
+	 */
 	int path_len;
 
 	/** Content encoding of the resource. */
@@ -105,6 +127,24 @@ struct http_resource_detail_static {
 
 	/** Size of the static resource. */
 	size_t static_data_len;
+
+	/** Optional gzip compressed variant of the content, sent instead of
+	 *  @ref static_data to clients accepting gzip encoding.
+	 */
+	const void *static_gzip_data;
+
+	/** Size of the gzip compressed variant. */
+	size_t static_gzip_data_len;
+
+	/** Optional entity tag of the resource, including the double quotes.
+	 *  Sent in the ETag header, a request with a matching If-None-Match
+	 *  header is answered with 304 Not Modified. The gzip compressed
+	 *  variant is tagged with "-gz" appended inside the quotes.
+	 */
+	const char *etag;
+
+	/** Optional value of the Cache-Control response header. */
+	const char *cache_control;
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -112,6 +152,25 @@ struct http_resource_detail_static {
 BUILD_ASSERT(offsetof(struct http_resource_detail_static, common) == 0);
 /** @endcond */
 
+/**
+ * @brief Representation of a static server resource backed by a file.
+ *
+ * The file is sent with zsock_sendfile() so the content does not need to be
+ * kept in memory. Requires @kconfig{CONFIG_HTTP_SERVER_STATIC_FS}.
+ */
+struct http_resource_detail_static_fs {
+	/** Common resource details. */
+	struct http_resource_detail common;
+
+	/** Path of the file on the file system. */
+	const char *fs_path;
+};
+
+/** @cond INTERNAL_HIDDEN */
+/* Make sure that the common is the first in the struct. */
+BUILD_ASSERT(offsetof(struct http_resource_detail_static_fs, common) == 0);
+/** @endcond */
+
 struct http_client_ctx;
 
 /** Indicates the status of the currently processed piece of data.  */
@@ -256,6 +315,16 @@ struct http_stream_ctx {
 	int stream_id; /**< Stream identifier. */
 	enum http_stream_state stream_state; /**< Stream state. */
 	int window_size; /**< Stream-level window size. */
+	int send_window_size; /**< Stream-level window size of the peer. */
+	uint32_t depends_on; /**< Stream this stream depends on, 0 if none. */
+	uint32_t vtime; /**< Virtual time used to share the connection. */
+	uint16_t weight; /**< Priority weight, 1 to 256. */
+	const char *pending_data; /**< Response data not sent yet. */
+	size_t pending_len; /**< Length of the response data not sent yet. */
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+	struct fs_file_t file; /**< File the pending data is read from. */
+	bool pending_file; /**< Pending data is read from the file. */
+#endif
 };
 
 /** @brief HTTP/2 frame representation. */
@@ -264,6 +333,7 @@ struct http_frame {
 	uint32_t stream_identifier; /**< Stream ID the frame belongs to. */
 	uint8_t type; /**< Frame type. */
 	uint8_t flags; /**< Frame flags. */
+	uint8_t padding; /**< Padding left to skip after the payload. */
 	uint8_t *payload; /**< A pointer to the frame payload. */
 };
 
@@ -286,6 +356,15 @@ struct http_client_ctx {
 	/** Connection-level window size. */
 	int window_size;
 
+	/** Connection-level window size of the peer. */
+	int send_window_size;
+
+	/** Initial stream-level window size of the peer. */
+	int peer_initial_window_size;
+
+	/** Virtual time of the last stream picked by the HTTP/2 scheduler. */
+	uint32_t sched_vtime;
+
 	/** Server state for the associated client. */
 	enum http_server_state server_state;
 
@@ -298,6 +377,9 @@ struct http_client_ctx {
 	/** HTTP/2 header parser context. */
 	struct http_hpack_header_buf header_field;
 
+	/** HTTP/2 header encoder context. */
+	struct http_hpack_encoder hpack_encoder;
+
 	/** HTTP/2 streams context. */
 	struct http_stream_ctx streams[HTTP_SERVER_MAX_STREAMS];
 
@@ -310,6 +392,11 @@ struct http_client_ctx {
 	/** Request URL. */
 	unsigned char url_buffer[HTTP_SERVER_MAX_URL_LENGTH];
 
+	/** Length of the resource path matched at the start of the request
+	 *  URL, the rest of the URL (for instance the query) follows it.
+	 */
+	int path_len;
+
 	/** Request content type. */
 	unsigned char content_type[HTTP_SERVER_MAX_CONTENT_TYPE_LEN];
 
@@ -338,6 +425,9 @@ struct http_client_ctx {
 	/* Websocket security key. */
 	IF_ENABLED(CONFIG_WEBSOCKET, (uint8_t ws_sec_key[HTTP_SERVER_WS_MAX_SEC_KEY_LEN]));
 
+	/** Value of the If-None-Match request header. */
+	unsigned char if_none_match[HTTP_SERVER_MAX_HEADER_LEN];
+
 	/** Flag indicating that headers were sent in the reply. */
 	bool headers_sent : 1;
 
@@ -355,6 +445,15 @@ struct http_client_ctx {
 
 	/** Flag indicating Websocket key is being processed. */
 	bool websocket_sec_key_next : 1;
+
+	/** Flag indicating Accept-Encoding header is being processed. */
+	bool accept_encoding_next : 1;
+
+	/** Flag indicating If-None-Match header is being processed. */
+	bool if_none_match_next : 1;
+
+	/** Flag indicating that the client accepts gzip encoded content. */
+	bool accept_gzip : 1;
 };
 
 /** @brief Start the HTTP2 server.
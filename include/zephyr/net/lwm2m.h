@@ -170,6 +170,8 @@ struct lwm2m_ctx {
 	sys_slist_t queued_messages;
 #endif
 	sys_slist_t observer;
+	/* Notifications due before this time are sent with the current batch */
+	int64_t notify_batch_end;
 	/** @endcond */
 
 	/** A pointer to currently processed request, for internal LwM2M engine
@@ -83,7 +83,10 @@ enum mqtt_evt_type {
 /** @brief MQTT version protocol level. */
 enum mqtt_version {
 	MQTT_VERSION_3_1_0 = 3, /**< Protocol level for 3.1.0. */
-	MQTT_VERSION_3_1_1 = 4  /**< Protocol level for 3.1.1. */
+	MQTT_VERSION_3_1_1 = 4, /**< Protocol level for 3.1.1. */
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	MQTT_VERSION_5_0 = 5,   /**< Protocol level for 5.0. */
+#endif
 };
 
 /** @brief MQTT Quality of Service types. */
@@ -165,6 +168,14 @@ struct mqtt_utf8 {
 #define MQTT_UTF8_LITERAL(literal)				\
 	((struct mqtt_utf8) {literal, sizeof(literal) - 1})
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/** @brief Abstracts UTF-8 encoded string pairs, used for user properties. */
+struct mqtt_utf8_pair {
+	struct mqtt_utf8 name;     /**< Name of the pair. */
+	struct mqtt_utf8 value;    /**< Value of the pair. */
+};
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 /** @brief Abstracts binary strings. */
 struct mqtt_binstr {
 	uint8_t *data;             /**< Pointer to binary stream. */
@@ -202,30 +213,90 @@ struct mqtt_connack_param {
 	 *  is unable to process a connection request for some reason.
 	 */
 	enum mqtt_conn_return_code return_code;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 properties of the connection. Properties not sent by the
+	 *  server are set to their default values. Strings point to the
+	 *  receive buffer and are only valid in the event callback.
+	 */
+	struct {
+		/** Session Expiry Interval in seconds. */
+		uint32_t session_expiry_interval;
+
+		/** Maximum Packet Size accepted by the server, 0 if unlimited.
+		 */
+		uint32_t maximum_packet_size;
+
+		/** Client identifier assigned by the server, if the client
+		 *  connected with an empty one.
+		 */
+		struct mqtt_utf8 assigned_client_id;
+
+		/** Human readable diagnostic string. */
+		struct mqtt_utf8 reason_string;
+
+		/** Number of QoS 1 and QoS 2 messages the server processes
+		 *  concurrently.
+		 */
+		uint16_t receive_maximum;
+
+		/** Highest topic alias the server accepts. */
+		uint16_t topic_alias_maximum;
+
+		/** Keep alive time imposed by the server, 0 if not sent. */
+		uint16_t server_keep_alive;
+
+		/** Highest QoS the server supports. */
+		uint8_t maximum_qos;
+
+		/** 1 if the server supports retained messages. */
+		uint8_t retain_available;
+	} prop;
+#endif /* CONFIG_MQTT_VERSION_5_0 */
 };
 
 /** @brief Parameters for MQTT publish acknowledgment (PUBACK). */
 struct mqtt_puback_param {
 	/** Message id of the PUBLISH message being acknowledged */
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 reason code, 0 for success. */
+	uint8_t reason_code;
+#endif
 };
 
 /** @brief Parameters for MQTT publish receive (PUBREC). */
 struct mqtt_pubrec_param {
 	/** Message id of the PUBLISH message being acknowledged */
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 reason code, 0 for success. */
+	uint8_t reason_code;
+#endif
 };
 
 /** @brief Parameters for MQTT publish release (PUBREL). */
 struct mqtt_pubrel_param {
 	/** Message id of the PUBREC message being acknowledged */
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 reason code, 0 for success. */
+	uint8_t reason_code;
+#endif
 };
 
 /** @brief Parameters for MQTT publish complete (PUBCOMP). */
 struct mqtt_pubcomp_param {
 	/** Message id of the PUBREL message being acknowledged */
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 reason code, 0 for success. */
+	uint8_t reason_code;
+#endif
 };
 
 /** @brief Parameters for MQTT subscription acknowledgment (SUBACK). */
@@ -242,6 +313,13 @@ struct mqtt_suback_param {
 struct mqtt_unsuback_param {
 	/** Message id of the UNSUBSCRIBE message being acknowledged */
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 reason codes, one for each topic in the unsubscription
+	 *  list.
+	 */
+	struct mqtt_binstr reason_codes;
+#endif
 };
 
 /** @brief Parameters for a publish message (PUBLISH). */
@@ -263,6 +341,31 @@ struct mqtt_publish_param {
 	 *  by the broker.
 	 */
 	uint8_t retain_flag : 1;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 properties of the message. Zeroed fields are not sent. */
+	struct {
+		/** User properties, the list ends at the first pair with an
+		 *  empty name.
+		 */
+		struct mqtt_utf8_pair user_prop[CONFIG_MQTT_USER_PROPERTIES_MAX];
+
+		/** MIME type of the payload. */
+		struct mqtt_utf8 content_type;
+
+		/** Lifetime of the message in seconds. */
+		uint32_t message_expiry_interval;
+
+		/** Topic alias of a received message. Aliases of published
+		 *  messages are managed by the library, this field is ignored
+		 *  there.
+		 */
+		uint16_t topic_alias;
+
+		/** 1 if the payload is UTF-8 encoded character data. */
+		uint8_t payload_format_indicator;
+	} prop;
+#endif /* CONFIG_MQTT_VERSION_5_0 */
 };
 
 /** @brief List of topics in a subscription request. */
@@ -465,6 +568,38 @@ struct mqtt_transport {
 #endif
 };
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/** @brief Topic alias table entry. */
+struct mqtt_topic_alias {
+	/** Internal. Topic mapped to the alias. */
+	uint8_t topic[CONFIG_MQTT_TOPIC_ALIAS_TOPIC_LEN];
+
+	/** Internal. Topic length, 0 if the alias is not in use. */
+	uint16_t topic_len;
+};
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+/** @brief Outbound queue entry, a PUBLISH message stored in the queue buffer.
+ */
+struct mqtt_queue_entry {
+	/** Internal. Offset of the encoded message in the queue buffer. */
+	uint32_t offset;
+
+	/** Internal. Length of the encoded message, payload included. */
+	uint32_t len;
+
+	/** Internal. Message id of the message, 0 for QoS 0. */
+	uint16_t message_id;
+
+	/** Internal. Delivery state of the message. */
+	uint8_t state;
+
+	/** Internal. QoS of the message. */
+	uint8_t qos;
+};
+#endif /* CONFIG_MQTT_OUTBOUND_QUEUE */
+
 /** @brief MQTT internal state. */
 struct mqtt_internal {
 	/** Internal. Mutex to protect access to the client instance. */
@@ -483,6 +618,71 @@ struct mqtt_internal {
 
 	/** Internal. Remaining payload length to read. */
 	uint32_t remaining_payload;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** Internal. Maximum Packet Size announced by the server, 0 if
+	 *  unlimited.
+	 */
+	uint32_t server_max_packet_size;
+
+	/** Internal. Receive Maximum announced by the server. */
+	uint16_t server_receive_max;
+
+	/** Internal. Topic Alias Maximum announced by the server. */
+	uint16_t server_topic_alias_max;
+
+	/** Internal. Message ids of the published QoS 1 and QoS 2 messages
+	 *  not acknowledged yet.
+	 */
+	uint16_t tx_inflight_id[CONFIG_MQTT_TX_INFLIGHT_MAX];
+
+	/** Internal. Number of message ids in tx_inflight_id. */
+	uint16_t tx_inflight;
+
+	/** Internal. Maximum QoS announced by the server. */
+	uint8_t server_max_qos;
+
+	/** Internal. Index of the outgoing alias to assign next. */
+	uint8_t tx_alias_next;
+
+	/** Internal. Topics of the outgoing aliases, indexed by alias - 1. */
+	struct mqtt_topic_alias tx_alias[CONFIG_MQTT_TOPIC_ALIAS_MAX];
+
+	/** Internal. Topics of the incoming aliases, indexed by alias - 1. */
+	struct mqtt_topic_alias rx_alias[CONFIG_MQTT_TOPIC_ALIAS_MAX];
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+	/** Internal. Queued messages, in the order they were queued. */
+	struct mqtt_queue_entry queue[CONFIG_MQTT_OUTBOUND_QUEUE_LEN];
+
+	/** Internal. Queue buffer offset following the newest message. */
+	uint32_t queue_tail;
+
+	/** Internal. Index of the oldest queued message. */
+	uint16_t queue_head;
+
+	/** Internal. Number of queued messages. */
+	uint16_t queue_count;
+
+	/** Internal. Number of queued messages, from the oldest, not waiting
+	 *  to be sent.
+	 */
+	uint16_t queue_unsent;
+
+	/** Internal. Queued QoS 2 messages waiting for their PUBREL to be
+	 *  sent.
+	 */
+	uint16_t queue_received;
+
+	/** Internal. Queued QoS 1 and QoS 2 messages sent and not
+	 *  acknowledged yet.
+	 */
+	uint16_t queue_inflight;
+
+	/** Internal. Last message id assigned to a queued message. */
+	uint16_t queue_message_id;
+#endif /* CONFIG_MQTT_OUTBOUND_QUEUE */
 };
 
 /**
@@ -539,6 +739,16 @@ struct mqtt_client {
 	/** Size of transmit buffer. */
 	uint32_t tx_buf_size;
 
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+	/** Buffer holding the messages of the outbound queue, encoded along
+	 *  with their payload. Only needed by mqtt_publish_queued().
+	 */
+	uint8_t *queue_buf;
+
+	/** Size of the outbound queue buffer. */
+	uint32_t queue_buf_size;
+#endif /* CONFIG_MQTT_OUTBOUND_QUEUE */
+
 	/** Keepalive interval for this client in seconds.
 	 *  Default is CONFIG_MQTT_KEEPALIVE.
 	 */
@@ -559,6 +769,16 @@ struct mqtt_client {
 	 */
 	uint8_t clean_session : 1;
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 connection properties. */
+	struct {
+		/** Session Expiry Interval in seconds. 0 ends the session when
+		 *  the connection closes, 0xFFFFFFFF keeps it forever.
+		 */
+		uint32_t session_expiry_interval;
+	} prop;
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 	/* Userdata */
 	void *user_data;
 };
@@ -605,7 +825,8 @@ int mqtt_client_set_proxy(struct mqtt_client *client,
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  *
  * @note Default protocol revision used for connection request is 3.1.1. Please
- *       set client.protocol_version = MQTT_VERSION_3_1_0 to use protocol 3.1.0.
+ *       set client.protocol_version = MQTT_VERSION_3_1_0 to use protocol 3.1.0,
+ *       or MQTT_VERSION_5_0 to use protocol 5.0.
  * @note
  *       Please modify @kconfig{CONFIG_MQTT_KEEPALIVE} time to override default
  *       of 1 minute.
@@ -620,11 +841,56 @@ int mqtt_connect(struct mqtt_client *client);
  * @param[in] param Parameters to be used for the publish message.
  *                  Shall not be NULL.
  *
+ * @note With MQTT 5.0, the topic is replaced with a topic alias when the
+ *       broker allows it, and -EAGAIN is returned while as many QoS 1 and
+ *       QoS 2 messages as the broker's Receive Maximum are unacknowledged.
+ *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  */
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param);
 
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+/**
+ * @brief API to publish messages through the outbound queue.
+ *
+ * The message is copied to the queue buffer of the client, so the topic and
+ * payload need not outlive the call. It is sent right away while less than
+ * half of the in-flight window is used, otherwise along with the other held
+ * back messages, in a single transport write, once enough messages are
+ * acknowledged. Messages may be queued while the client is not connected, and
+ * the messages left unacknowledged when the connection closes are sent again,
+ * with the DUP flag set, once the client is connected again.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ * @param[in] param Parameters to be used for the publish message.
+ *                  Shall not be NULL. The message id and DUP flag are ignored.
+ *
+ * @note Message ids of queued messages are assigned by the library, and shall
+ *       not be used by the application for other messages.
+ * @note The PUBREL of queued QoS 2 messages is sent by the library, calling
+ *       mqtt_publish_qos2_release() for them has no effect.
+ *
+ * @return The message id assigned to the message, 0 with QoS 0, or a
+ *         negative error code (errno.h) indicating reason of failure.
+ *         -EAGAIN is returned while the queue is full.
+ */
+int mqtt_publish_queued(struct mqtt_client *client,
+			const struct mqtt_publish_param *param);
+
+/**
+ * @brief API to get the number of messages in the outbound queue.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ *
+ * @return Number of queued messages not delivered yet, or a negative error
+ *         code (errno.h) indicating reason of failure.
+ */
+int mqtt_publish_queue_len(struct mqtt_client *client);
+#endif /* CONFIG_MQTT_OUTBOUND_QUEUE */
+
 /**
  * @brief API used by client to send acknowledgment on receiving QoS1 publish
  *        message. Should be called on reception of @ref MQTT_EVT_PUBLISH with
@@ -120,6 +120,22 @@ enum net_verdict {
  */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt);
 
+/**
+ * @brief Called by network device driver when several network packets
+ * have been received. The packets are pushed up in the network stack with
+ * one queue operation per traffic class, which amortizes the locking and
+ * thread wake up cost compared to calling net_recv_data() for each packet.
+ *
+ * @param iface Network interface where the packets were received.
+ * @param pkts Array of received network packets.
+ * @param count Number of packets in the array.
+ *
+ * @return Number of packets taken from the start of @p pkts, <0 if error.
+ *         Packets after the returned count are still owned by the caller.
+ */
+int net_recv_data_burst(struct net_if *iface, struct net_pkt **pkts,
+			size_t count);
+
 /**
  * @brief Send data to network.
  *
@@ -245,6 +245,11 @@ struct msghdr {
 	int           msg_flags;      /* flags on received message */
 };
 
+struct mmsghdr {
+	struct msghdr msg_hdr;        /* message header */
+	unsigned int  msg_len;        /* number of bytes transmitted */
+};
+
 struct cmsghdr {
 	socklen_t cmsg_len;    /* Number of bytes, including header */
 	int       cmsg_level;  /* Originating protocol */
@@ -284,6 +284,13 @@ struct net_pkt {
 	 */
 	uint8_t priority;
 
+#if defined(CONFIG_NET_TCP_GSO)
+	/* Payload size of each segment if this is a TCP super-segment that
+	 * is split before transmission. Zero for a regular packet.
+	 */
+	uint16_t gso_size;
+#endif /* CONFIG_NET_TCP_GSO */
+
 #if defined(CONFIG_NET_OFFLOAD) || defined(CONFIG_NET_L2_IPIP)
 	/* Remote address of the recived packet. This is only used by
 	 * network interfaces with an offloaded TCP/IP stack, or if we
@@ -872,6 +879,33 @@ static inline void net_pkt_set_priority(struct net_pkt *pkt,
 	pkt->priority = priority;
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+static inline uint16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	return pkt->gso_size;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt,
+					uint16_t gso_size)
+{
+	pkt->gso_size = gso_size;
+}
+#else
+static inline uint16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt,
+					uint16_t gso_size)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(gso_size);
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 #if defined(CONFIG_NET_CAPTURE_COOKED_MODE)
 static inline bool net_pkt_is_cooked_mode(struct net_pkt *pkt)
 {
@@ -27,6 +27,7 @@
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/dns_resolve.h>
 #include <zephyr/net/socket_select.h>
+#include <zephyr/net/socket_epoll.h>
 #include <zephyr/sys/iterable_sections.h>
 #include <zephyr/sys/fdtable.h>
 #include <stdlib.h>
@@ -530,6 +531,120 @@ __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
  */
 __syscall ssize_t zsock_recvmsg(int sock, struct msghdr *msg, int flags);
 
+/**
+ * @brief Send multiple messages with a single call
+ *
+ * @details
+ * The messages are sent in order as with zsock_sendmsg() while holding
+ * the socket lock once for the whole vector. On return, the msg_len
+ * field of each sent message holds the number of bytes sent.
+ * @rst
+ * This function is also exposed as ``sendmmsg()``
+ * if :kconfig:option:`CONFIG_POSIX_API` is defined.
+ * @endrst
+ *
+ * @param sock Socket descriptor.
+ * @param msgvec Vector of messages to send.
+ * @param vlen Number of messages in the vector.
+ * @param flags Flags passed to each zsock_sendmsg() call.
+ *
+ * @return Number of messages sent. If the first message could not be
+ * sent, -1 is returned and errno is set.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive multiple messages with a single call
+ *
+ * @details
+ * The first message is received as with zsock_recvmsg() using the given
+ * flags and the socket receive timeout. The remaining messages are only
+ * received if they are already queued, so the call does not block after
+ * the first message. On return, the msg_len field of each received
+ * message holds the number of bytes received. Unlike the Linux version,
+ * there is no timeout argument.
+ * @rst
+ * This function is also exposed as ``recvmmsg()``
+ * if :kconfig:option:`CONFIG_POSIX_API` is defined.
+ * @endrst
+ *
+ * @param sock Socket descriptor.
+ * @param msgvec Vector of messages to receive into.
+ * @param vlen Number of messages in the vector.
+ * @param flags Flags passed to the first zsock_recvmsg() call.
+ *
+ * @return Number of messages received. If no message could be received,
+ * -1 is returned and errno is set.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive a datagram without copying it
+ *
+ * @details
+ * For native datagram sockets used from kernel mode, the entries of
+ * msg_iov are set to point directly to the network buffers holding the
+ * datagram, and msg_iovlen is set to the number of entries used. A
+ * datagram spread over more buffers than there are entries is truncated
+ * and ZSOCK_MSG_TRUNC is set in msg_flags. The buffers stay valid until
+ * the returned token is passed to zsock_recvmsg_zc_release().
+ * The source address and the IP_PKTINFO or IPV6_RECVPKTINFO ancillary
+ * data are returned as with zsock_recvmsg().
+ *
+ * For other sockets and for user mode threads, the data is copied into
+ * the buffers given in msg_iov as with zsock_recvmsg() and the token is
+ * set to NULL. Callers should therefore always provide buffers and only
+ * use the entries as returned by this call.
+ *
+ * Requires :kconfig:option:`CONFIG_NET_SOCKETS_RECV_ZEROCOPY`.
+ * ZSOCK_MSG_PEEK is not supported.
+ *
+ * @param sock Socket descriptor.
+ * @param msg Message to receive into.
+ * @param token Token to release the borrowed buffers with.
+ * @param flags Receive flags.
+ *
+ * @return Number of bytes received, -1 on error with errno set.
+ */
+__syscall ssize_t zsock_recvmsg_zc(int sock, struct msghdr *msg,
+				   void **token, int flags);
+
+/**
+ * @brief Release the buffers borrowed with zsock_recvmsg_zc()
+ *
+ * @param token Token returned by zsock_recvmsg_zc(), NULL is accepted.
+ */
+__syscall void zsock_recvmsg_zc_release(void *token);
+
+struct fs_file_t;
+
+/**
+ * @brief Send data from a file
+ *
+ * @details
+ * Send up to count bytes from an open file. For native TCP sockets the
+ * file is read directly into the TX network buffers of the connection,
+ * other sockets go through a small bounce buffer. If offset is not NULL,
+ * reading starts at *offset, *offset is updated past the last byte sent
+ * and the file position is left unchanged, otherwise reading starts at
+ * the current file position which is then advanced.
+ *
+ * Requires :kconfig:option:`CONFIG_NET_SOCKETS_SENDFILE`. This function
+ * is not available to user mode threads.
+ *
+ * @param sock Socket descriptor.
+ * @param file Open file to send data from.
+ * @param offset Optional offset to start reading from.
+ * @param count Number of bytes to send.
+ *
+ * @return Number of bytes sent, which is less than count at the end of
+ * the file or if the socket is non blocking. -1 on error with errno set.
+ */
+ssize_t zsock_sendfile(int sock, struct fs_file_t *file, off_t *offset,
+		       size_t count);
+
 /**
  * @brief Receive data from a connected peer
  *
@@ -814,6 +929,29 @@ void zsock_freeaddrinfo(struct zsock_addrinfo *ai);
  */
 const char *zsock_gai_strerror(int errcode);
 
+/**
+ * @brief Connect a stream socket to one of several addresses
+ *
+ * @details
+ * Connect to the first address of the list that answers, as described by
+ * Happy Eyeballs (RFC 8305). IPv6 and IPv4 addresses are tried in turn,
+ * IPv6 first, and a new attempt is started every
+ * :kconfig:option:`CONFIG_NET_SOCKETS_HAPPY_EYEBALLS_DELAY` milliseconds,
+ * or as soon as an attempt fails, while the previous ones keep going.
+ * The sockets are created from the ai_family, ai_socktype and ai_protocol
+ * fields of the addresses, so the list is typically the result of
+ * zsock_getaddrinfo().
+ *
+ * Requires :kconfig:option:`CONFIG_NET_SOCKETS_HAPPY_EYEBALLS`.
+ *
+ * @param res List of addresses to connect to.
+ * @param timeout Time to wait for a connection in milliseconds, or
+ *        SYS_FOREVER_MS to wait until every attempt has failed.
+ *
+ * @return Connected blocking socket, or -1 on error with errno set.
+ */
+int zsock_connect_happy_eyeballs(const struct zsock_addrinfo *res, int32_t timeout);
+
 /**
  * @name Flags for getnameinfo()
  * @{
@@ -952,6 +1090,20 @@ static inline ssize_t recvmsg(int sock, struct msghdr *msg, int flags)
 	return zsock_recvmsg(sock, msg, flags);
 }
 
+/** POSIX wrapper for @ref zsock_sendmmsg */
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+/** POSIX wrapper for @ref zsock_recvmmsg */
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 /** POSIX wrapper for @ref zsock_poll */
 static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 {
@@ -0,0 +1,115 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+
+/**
+ * @brief BSD Sockets compatible API
+ * @defgroup bsd_sockets BSD Sockets compatible API
+ * @ingroup networking
+ * @{
+ */
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Event bits share the values of the ZSOCK_POLL* bits */
+
+/** zsock_epoll_wait(): Data is available to read */
+#define ZSOCK_EPOLLIN  0x001
+/** zsock_epoll_wait(): Data can be written */
+#define ZSOCK_EPOLLOUT 0x004
+/** zsock_epoll_wait(): Error condition, always reported */
+#define ZSOCK_EPOLLERR 0x008
+/** zsock_epoll_wait(): Peer closed the connection, always reported */
+#define ZSOCK_EPOLLHUP 0x010
+/** zsock_epoll_ctl(): Disable the file descriptor after one event */
+#define ZSOCK_EPOLLONESHOT 0x40000000U
+/** zsock_epoll_ctl(): Report only new events instead of the current level */
+#define ZSOCK_EPOLLET  0x80000000U
+
+/** zsock_epoll_ctl(): Add a file descriptor to the interest list */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl(): Remove a file descriptor from the interest list */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl(): Change the events of a file descriptor */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+/** User data returned with an event */
+typedef union zsock_epoll_data {
+	void *ptr;     /**< Pointer */
+	int fd;        /**< File descriptor */
+	uint32_t u32;  /**< 32 bit value */
+	uint64_t u64;  /**< 64 bit value */
+} zsock_epoll_data_t;
+
+/** Event reported by zsock_epoll_wait() */
+struct zsock_epoll_event {
+	uint32_t events;          /**< ZSOCK_EPOLL* bits */
+	zsock_epoll_data_t data;  /**< User data given to zsock_epoll_ctl() */
+};
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * The instance keeps a persistent interest list, so unlike zsock_poll()
+ * the sockets are not walked on every call. Native sockets are put on the
+ * ready list from the network stack callbacks, so idle sockets cost
+ * nothing while waiting. Other file descriptors (TLS sockets, eventfd,
+ * socketpair) and write interest on TCP sockets are still polled, but
+ * only those entries are. Offloaded sockets are not supported.
+ *
+ * This is not a system call, the API is only available to supervisor
+ * threads. Close the instance with zsock_close().
+ *
+ * Available if :kconfig:option:`CONFIG_NET_SOCKETS_EPOLL` is set.
+ *
+ * @param flags Must be 0.
+ *
+ * @return File descriptor of the instance, -1 and errno set on error.
+ */
+int zsock_epoll_create(int flags);
+
+/**
+ * @brief Add, change or remove a file descriptor of an epoll instance
+ *
+ * @param epfd File descriptor of the epoll instance.
+ * @param op ZSOCK_EPOLL_CTL_ADD, ZSOCK_EPOLL_CTL_MOD or ZSOCK_EPOLL_CTL_DEL.
+ * @param fd File descriptor to watch.
+ * @param event Events to watch and user data to report, ignored for
+ *        ZSOCK_EPOLL_CTL_DEL.
+ *
+ * @return 0 if ok, -1 and errno set on error.
+ */
+int zsock_epoll_ctl(int epfd, int op, int fd, struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for events on an epoll instance
+ *
+ * @param epfd File descriptor of the epoll instance.
+ * @param events Where to store the events.
+ * @param maxevents Size of the events array.
+ * @param timeout Timeout in milliseconds, -1 to wait forever.
+ *
+ * @return Number of events stored, 0 on timeout, -1 and errno set on error.
+ */
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_ */
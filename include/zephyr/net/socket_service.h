@@ -71,7 +71,7 @@ struct net_socket_service_desc {
 	struct net_socket_service_event *pev;
 	/** Length of the pollable socket array for this service. */
 	int pev_len;
-	/** Where are my pollfd entries in the global list */
+	/** Where are my entries among the entries of all the services */
 	int *idx;
 };
 
@@ -151,6 +151,46 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		       enum websocket_opcode opcode, bool mask, bool final,
 		       int32_t timeout);
 
+/**
+ * @brief Send a websocket message whose payload is already masked.
+ *
+ * @details Unlike websocket_send_msg(), the payload is not copied before it
+ * is sent, so large fragments can be streamed from the buffer of the caller.
+ * The payload must have been masked with websocket_mask() and the same key,
+ * and a new random key must be used for every frame (RFC 6455, 5.3).
+ *
+ * @param ws_sock Websocket id returned by websocket_connect().
+ * @param payload Masked websocket data to send.
+ * @param payload_len Length of the data to be sent.
+ * @param opcode Operation code (text, binary, ping, pong, close)
+ * @param masking_key Key the payload was masked with. The most significant
+ *        byte is sent first.
+ * @param final Is this final message for this message send. See
+ *        websocket_send_msg().
+ * @param timeout How long to try to send the message. The value is in
+ *        milliseconds. Value SYS_FOREVER_MS means to wait forever.
+ *
+ * @return <0 if error, >=0 amount of bytes sent
+ */
+int websocket_send_msg_masked(int ws_sock, const uint8_t *payload, size_t payload_len,
+			      enum websocket_opcode opcode, uint32_t masking_key,
+			      bool final, int32_t timeout);
+
+/**
+ * @brief Mask or unmask websocket data in place.
+ *
+ * @details Masking is its own inverse. The data is processed a machine word
+ * at a time where possible.
+ *
+ * @param data Data to mask.
+ * @param len Length of the data.
+ * @param masking_key Masking key. The most significant byte is applied to the
+ *        first byte of the payload.
+ * @param offset Position of the data within the payload of the frame, when
+ *        the payload is masked in several pieces.
+ */
+void websocket_mask(uint8_t *data, size_t len, uint32_t masking_key, size_t offset);
+
 /**
  * @brief Receive websocket msg from peer.
  *
@@ -376,6 +376,11 @@ ssize_t recvmsg(int sock, struct msghdr *msg, int flags)
 	return zsock_recvmsg(sock, msg, flags);
 }
 
+int recvmmsg(int sock, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 int select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout)
 {
 	return zsock_select(nfds, readfds, writefds, exceptfds, (struct zsock_timeval *)timeout);
@@ -391,6 +396,11 @@ ssize_t sendmsg(int sock, const struct msghdr *message, int flags)
 	return zsock_sendmsg(sock, message, flags);
 }
 
+int sendmmsg(int sock, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
 ssize_t sendto(int sock, const void *buf, size_t len, int flags, const struct sockaddr *dest_addr,
 	       socklen_t addrlen)
 {
@@ -8,13 +8,15 @@
 """Convert a file to a list of hex characters
 
 The list of hex characters can then be included to a source file. Optionally,
-the output can be compressed.
+the output can be compressed, or replaced by a C string literal holding an
+HTTP entity tag (ETag) of the content.
 
 """
 
 import argparse
 import codecs
 import gzip
+import hashlib
 import io
 
 
@@ -39,6 +41,10 @@ def parse_args():
                         Defaults to zero to keep builds deterministic. For
                         current date and time (= "now") use this option
                         without any value.""")
+    parser.add_argument("-e", "--etag", action="store_true",
+                        help="""Output a quoted entity tag derived from the
+                        SHA-256 of the (uncompressed) content as a C string
+                        literal, instead of the list of hex characters""")
     args = parser.parse_args()
 
 
@@ -52,10 +58,20 @@ def make_hex(chunk):
     print(get_nice_string(hexlist) + ',')
 
 
+def make_etag():
+    with open(args.file, "rb") as fp:
+        fp.seek(args.offset)
+        digest = hashlib.sha256(fp.read(args.length)).hexdigest()
+
+    print('"\\"' + digest[:16] + '\\""')
+
+
 def main():
     parse_args()
 
-    if args.gzip:
+    if args.etag:
+        make_etag()
+    elif args.gzip:
         with io.BytesIO() as content:
             with open(args.file, 'rb') as fg:
                 fg.seek(args.offset)
@@ -621,9 +621,9 @@ enum net_verdict net_ipv4_prepare_for_send(struct net_pkt *pkt)
 	}
 
 	/* If we have already fragmented the packet, the ID field will contain a non-zero value
-	 * and we can skip other checks.
+	 * and we can skip other checks. TCP super-segments are split by the L2 instead.
 	 */
-	if (ip_hdr->id[0] == 0 && ip_hdr->id[1] == 0) {
+	if (ip_hdr->id[0] == 0 && ip_hdr->id[1] == 0 && net_pkt_gso_size(pkt) == 0U) {
 		uint16_t mtu = net_if_get_mtu(net_pkt_iface(pkt));
 		size_t pkt_len = net_pkt_get_len(pkt);
 
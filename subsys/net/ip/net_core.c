@@ -463,7 +463,7 @@ void net_process_rx_packet(struct net_pkt *pkt)
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
-static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+static uint8_t net_rx_classify(struct net_if *iface, struct net_pkt *pkt)
 {
 	uint8_t prio = net_pkt_priority(pkt);
 	uint8_t tc = net_rx_priority2tc(prio);
@@ -478,6 +478,13 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
 #endif
 
+	return tc;
+}
+
+static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+{
+	uint8_t tc = net_rx_classify(iface, pkt);
+
 	if (NET_TC_RX_COUNT == 0) {
 		net_process_rx_packet(pkt);
 	} else {
@@ -485,6 +492,21 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	}
 }
 
+static void net_recv_prepare(struct net_if *iface, struct net_pkt *pkt)
+{
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+
+	NET_DBG("prio %d iface %p pkt %p len %zu", net_pkt_priority(pkt),
+		iface, pkt, net_pkt_get_len(pkt));
+
+	if (IS_ENABLED(CONFIG_NET_ROUTING)) {
+		net_pkt_set_orig_iface(pkt, iface);
+	}
+
+	net_pkt_set_iface(pkt, iface);
+}
+
 /* Called by driver when a packet has been received */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 {
@@ -500,17 +522,7 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 		return -ENETDOWN;
 	}
 
-	net_pkt_set_overwrite(pkt, true);
-	net_pkt_cursor_init(pkt);
-
-	NET_DBG("prio %d iface %p pkt %p len %zu", net_pkt_priority(pkt),
-		iface, pkt, net_pkt_get_len(pkt));
-
-	if (IS_ENABLED(CONFIG_NET_ROUTING)) {
-		net_pkt_set_orig_iface(pkt, iface);
-	}
-
-	net_pkt_set_iface(pkt, iface);
+	net_recv_prepare(iface, pkt);
 
 	if (!net_pkt_filter_recv_ok(pkt)) {
 		/* silently drop the packet */
@@ -522,6 +534,73 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 	return 0;
 }
 
+/* Called by driver when several packets have been received. The packets
+ * of each traffic class are chained through their fifo field and queued
+ * with one operation, so the RX thread is woken up once per burst.
+ */
+int net_recv_data_burst(struct net_if *iface, struct net_pkt **pkts,
+			size_t count)
+{
+	struct net_pkt *head[MAX(NET_TC_RX_COUNT, 1)] = { NULL };
+	struct net_pkt *tail[MAX(NET_TC_RX_COUNT, 1)] = { NULL };
+	struct net_pkt *pkt;
+	size_t i;
+	uint8_t tc;
+
+	if (!pkts || !iface) {
+		return -EINVAL;
+	}
+
+	if (!net_if_flag_is_set(iface, NET_IF_UP)) {
+		return -ENETDOWN;
+	}
+
+	for (i = 0; i < count; i++) {
+		pkt = pkts[i];
+
+		if (!pkt || net_pkt_is_empty(pkt)) {
+			break;
+		}
+
+		net_recv_prepare(iface, pkt);
+
+		if (!net_pkt_filter_recv_ok(pkt)) {
+			/* silently drop the packet */
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		tc = net_rx_classify(iface, pkt);
+
+		if (NET_TC_RX_COUNT == 0) {
+			net_process_rx_packet(pkt);
+			continue;
+		}
+
+		pkt->fifo = 0;
+
+		if (tail[tc] != NULL) {
+			tail[tc]->fifo = (intptr_t)pkt;
+		} else {
+			head[tc] = pkt;
+		}
+
+		tail[tc] = pkt;
+	}
+
+	for (tc = 0; tc < NET_TC_RX_COUNT; tc++) {
+		if (head[tc] != NULL) {
+			net_tc_submit_list_to_rx_queue(tc, head[tc], tail[tc]);
+		}
+	}
+
+	if (i == 0 && count > 0) {
+		return pkts[0] ? -ENODATA : -EINVAL;
+	}
+
+	return i;
+}
+
 static inline void l3_init(void)
 {
 	net_icmpv4_init();
@@ -541,6 +620,7 @@ static inline void l3_init(void)
 	net_tcp_init();
 
 	net_route_init();
+	net_route_ipv4_init();
 
 	NET_DBG("Network L3 init done");
 }
@@ -206,24 +206,21 @@ static void update_txtime_stats_detail(struct net_pkt *pkt,
 	}
 }
 
-static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
-{
-	struct net_linkaddr ll_dst = {
-		.addr = NULL
-	};
+/* Per packet state kept over the L2 send */
+struct net_if_tx_meta {
+	struct net_linkaddr ll_dst;
 	struct net_linkaddr_storage ll_dst_storage;
 	struct net_context *context;
 	uint32_t create_time;
-	int status;
 
 	/* We collect send statistics for each socket priority if enabled */
 	uint8_t pkt_priority;
+};
 
-	if (!pkt) {
-		return false;
-	}
-
-	create_time = net_pkt_create_time(pkt);
+static void net_if_tx_begin(struct net_pkt *pkt, struct net_if_tx_meta *meta)
+{
+	meta->ll_dst.addr = NULL;
+	meta->create_time = net_pkt_create_time(pkt);
 
 	debug_check_packet(pkt);
 
@@ -232,87 +229,115 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 	 * case packet is freed before callback is called.
 	 */
 	if (!sys_slist_is_empty(&link_callbacks)) {
-		if (net_linkaddr_set(&ll_dst_storage,
+		if (net_linkaddr_set(&meta->ll_dst_storage,
 				     net_pkt_lladdr_dst(pkt)->addr,
 				     net_pkt_lladdr_dst(pkt)->len) == 0) {
-			ll_dst.addr = ll_dst_storage.addr;
-			ll_dst.len = ll_dst_storage.len;
-			ll_dst.type = net_pkt_lladdr_dst(pkt)->type;
+			meta->ll_dst.addr = meta->ll_dst_storage.addr;
+			meta->ll_dst.len = meta->ll_dst_storage.len;
+			meta->ll_dst.type = net_pkt_lladdr_dst(pkt)->type;
 		}
 	}
 
-	context = net_pkt_context(pkt);
+	meta->context = net_pkt_context(pkt);
+}
 
-	if (net_if_flag_is_set(iface, NET_IF_LOWER_UP)) {
-		if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS)) {
-			pkt_priority = net_pkt_priority(pkt);
-
-			if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS_DETAIL)) {
-				/* Make sure the statistics information is not
-				 * lost by keeping the net_pkt over L2 send.
-				 */
-				net_pkt_ref(pkt);
-			}
-		}
+static void net_if_tx_stats_begin(struct net_pkt *pkt, struct net_if_tx_meta *meta)
+{
+	if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS)) {
+		meta->pkt_priority = net_pkt_priority(pkt);
 
-		net_if_tx_lock(iface);
-		status = net_if_l2(iface)->send(iface, pkt);
-		net_if_tx_unlock(iface);
+		if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS_DETAIL)) {
+			/* Make sure the statistics information is not
+			 * lost by keeping the net_pkt over L2 send.
+			 */
+			net_pkt_ref(pkt);
+		}
+	}
+}
 
-		if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS)) {
-			uint32_t end_tick = k_cycle_get_32();
+static void net_if_tx_stats_end(struct net_if *iface, struct net_pkt *pkt,
+				struct net_if_tx_meta *meta)
+{
+	if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS)) {
+		uint32_t end_tick = k_cycle_get_32();
 
-			net_pkt_set_tx_stats_tick(pkt, end_tick);
+		net_pkt_set_tx_stats_tick(pkt, end_tick);
 
-			net_stats_update_tc_tx_time(iface,
-						    pkt_priority,
-						    create_time,
-						    end_tick);
+		net_stats_update_tc_tx_time(iface,
+					    meta->pkt_priority,
+					    meta->create_time,
+					    end_tick);
 
-			if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS_DETAIL)) {
-				update_txtime_stats_detail(
-					pkt,
-					create_time,
-					end_tick);
+		if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS_DETAIL)) {
+			update_txtime_stats_detail(
+				pkt,
+				meta->create_time,
+				end_tick);
 
-				net_stats_update_tc_tx_time_detail(
-					iface, pkt_priority,
-					net_pkt_stats_tick(pkt));
+			net_stats_update_tc_tx_time_detail(
+				iface, meta->pkt_priority,
+				net_pkt_stats_tick(pkt));
 
-				/* For TCP connections, we might keep the pkt
-				 * longer so that we can resend it if needed.
-				 * Because of that we need to clear the
-				 * statistics here.
-				 */
-				net_pkt_stats_tick_reset(pkt);
+			/* For TCP connections, we might keep the pkt
+			 * longer so that we can resend it if needed.
+			 * Because of that we need to clear the
+			 * statistics here.
+			 */
+			net_pkt_stats_tick_reset(pkt);
 
-				net_pkt_unref(pkt);
-			}
+			net_pkt_unref(pkt);
 		}
-
-	} else {
-		/* Drop packet if interface is not up */
-		NET_WARN("iface %p is down", iface);
-		status = -ENETDOWN;
 	}
+}
 
+static void net_if_tx_end(struct net_if *iface, struct net_pkt *pkt,
+			  struct net_if_tx_meta *meta, int status)
+{
 	if (status < 0) {
 		net_pkt_unref(pkt);
 	} else {
 		net_stats_update_bytes_sent(iface, status);
 	}
 
-	if (context) {
+	if (meta->context) {
 		NET_DBG("Calling context send cb %p status %d",
-			context, status);
+			meta->context, status);
 
-		net_context_send_cb(context, status);
+		net_context_send_cb(meta->context, status);
 	}
 
-	if (ll_dst.addr) {
-		net_if_call_link_cb(iface, &ll_dst, status);
+	if (meta->ll_dst.addr) {
+		net_if_call_link_cb(iface, &meta->ll_dst, status);
+	}
+}
+
+static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct net_if_tx_meta meta;
+	int status;
+
+	if (!pkt) {
+		return false;
+	}
+
+	net_if_tx_begin(pkt, &meta);
+
+	if (net_if_flag_is_set(iface, NET_IF_LOWER_UP)) {
+		net_if_tx_stats_begin(pkt, &meta);
+
+		net_if_tx_lock(iface);
+		status = net_if_l2(iface)->send(iface, pkt);
+		net_if_tx_unlock(iface);
+
+		net_if_tx_stats_end(iface, pkt, &meta);
+	} else {
+		/* Drop packet if interface is not up */
+		NET_WARN("iface %p is down", iface);
+		status = -ENETDOWN;
 	}
 
+	net_if_tx_end(iface, pkt, &meta, status);
+
 	return true;
 }
 
@@ -331,6 +356,68 @@ void net_process_tx_packet(struct net_pkt *pkt)
 #endif
 }
 
+#if defined(CONFIG_NET_TC_TX_BURST)
+/* Send consecutive packets of one Ethernet interface under one Tx lock */
+static void net_if_tx_burst(struct net_if *iface, struct net_pkt **pkts,
+			    size_t count)
+{
+	size_t i;
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	struct net_if_tx_meta meta[CONFIG_NET_TC_TX_BURST];
+	int status[CONFIG_NET_TC_TX_BURST];
+
+	if (count > 1 && net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET) &&
+	    net_if_flag_is_set(iface, NET_IF_LOWER_UP)) {
+		for (i = 0; i < count; i++) {
+			net_if_tx_begin(pkts[i], &meta[i]);
+			net_if_tx_stats_begin(pkts[i], &meta[i]);
+		}
+
+		net_if_tx_lock(iface);
+		net_eth_send_burst(iface, pkts, status, count);
+		net_if_tx_unlock(iface);
+
+		for (i = 0; i < count; i++) {
+			net_if_tx_stats_end(iface, pkts[i], &meta[i]);
+			net_if_tx_end(iface, pkts[i], &meta[i], status[i]);
+		}
+
+		return;
+	}
+#endif /* CONFIG_NET_L2_ETHERNET */
+
+	for (i = 0; i < count; i++) {
+		net_if_tx(iface, pkts[i]);
+	}
+}
+
+void net_process_tx_burst(struct net_pkt **pkts, size_t count)
+{
+	size_t i, n;
+
+	for (i = 0; i < count; i++) {
+		net_pkt_set_tx_stats_tick(pkts[i], k_cycle_get_32());
+	}
+
+	for (i = 0; i < count; i += n) {
+		struct net_if *iface = net_pkt_iface(pkts[i]);
+
+		for (n = 1; i + n < count; n++) {
+			if (net_pkt_iface(pkts[i + n]) != iface) {
+				break;
+			}
+		}
+
+		net_if_tx_burst(iface, &pkts[i], n);
+
+#if defined(CONFIG_NET_POWER_MANAGEMENT)
+		iface->tx_pending -= n;
+#endif
+	}
+}
+#endif /* CONFIG_NET_TC_TX_BURST */
+
 void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 {
 	if (!net_pkt_filter_send_ok(pkt)) {
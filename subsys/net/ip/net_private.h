@@ -61,6 +61,7 @@ extern void net_if_stats_reset(struct net_if *iface);
 extern void net_if_stats_reset_all(void);
 extern void net_process_rx_packet(struct net_pkt *pkt);
 extern void net_process_tx_packet(struct net_pkt *pkt);
+extern void net_process_tx_burst(struct net_pkt **pkts, size_t count);
 
 extern int net_icmp_call_ipv4_handlers(struct net_pkt *pkt,
 				       struct net_ipv4_hdr *ipv4_hdr,
@@ -146,6 +147,8 @@ static inline enum net_verdict net_ipv6_input(struct net_pkt *pkt,
 #endif
 extern bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt);
+extern void net_tc_submit_list_to_rx_queue(uint8_t tc, struct net_pkt *head,
+					   struct net_pkt *tail);
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
 char *net_sprint_addr(sa_family_t af, const void *addr);
@@ -229,6 +232,23 @@ extern char *net_byte_to_hex(char *ptr, uint8_t byte, char base, bool pad);
 extern char *net_sprint_ll_addr_buf(const uint8_t *ll, uint8_t ll_len,
 				    char *buf, int buflen);
 extern uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len);
+
+#if defined(CONFIG_ARCH_HAS_NET_CHKSUM)
+/**
+ * @brief Architecture specific bulk part of the Internet checksum.
+ *
+ * Called by calc_chksum() with @p data aligned to the native word size.
+ * The implementation adds the data in memory byte order to @p sum and
+ * may leave a tail of up to 7 bytes unprocessed for the generic code.
+ *
+ * @param sum	Running 64-bit one's complement accumulator
+ * @param data	Word aligned data to add
+ * @param len	Length of the data
+ *
+ * @return Number of bytes consumed, a multiple of 4.
+ */
+size_t arch_net_calc_chksum(uint64_t *sum, const uint8_t *data, size_t len);
+#endif
 extern uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto);
 
 /**
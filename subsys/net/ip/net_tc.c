@@ -17,6 +17,7 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 #include "net_private.h"
 #include "net_stats.h"
 #include "net_tc_mapping.h"
+#include "tcp_internal.h"
 
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
@@ -72,6 +73,25 @@ void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 #endif
 }
 
+void net_tc_submit_list_to_rx_queue(uint8_t tc, struct net_pkt *head,
+				    struct net_pkt *tail)
+{
+#if NET_TC_RX_COUNT > 0
+	uint32_t tick = k_cycle_get_32();
+	struct net_pkt *pkt;
+
+	for (pkt = head; pkt != NULL; pkt = (struct net_pkt *)pkt->fifo) {
+		net_pkt_set_rx_stats_tick(pkt, tick);
+	}
+
+	k_fifo_put_list(&rx_classes[tc].fifo, head, tail);
+#else
+	ARG_UNUSED(tc);
+	ARG_UNUSED(head);
+	ARG_UNUSED(tail);
+#endif
+}
+
 int net_tx_priority2tc(enum net_priority prio)
 {
 #if NET_TC_TX_COUNT > 0
@@ -239,6 +259,48 @@ static void net_tc_rx_stats_priority_setup(struct net_if *iface,
 #endif
 #endif
 
+#if defined(CONFIG_NET_TCP_GRO)
+/* Process the packets already waiting in the queue as one batch. Consecutive
+ * in-order TCP segments of the same flow are merged into one packet so
+ * that the TCP layer handles and acknowledges them once.
+ */
+static void tc_rx_gro_batch(struct k_fifo *fifo, struct net_pkt *pkt)
+{
+	struct net_tcp_gro gro;
+	struct net_pkt *next;
+	bool coalescing;
+	int i;
+
+	coalescing = net_tcp_gro_init(&gro, pkt);
+
+	for (i = 1; i < CONFIG_NET_TCP_GRO_MAX_BATCH; i++) {
+		next = k_fifo_get(fifo, K_NO_WAIT);
+		if (next == NULL) {
+			break;
+		}
+
+		if (coalescing && net_tcp_gro_merge(&gro, next)) {
+			continue;
+		}
+
+		if (coalescing) {
+			net_tcp_gro_finish(&gro);
+		}
+
+		net_process_rx_packet(pkt);
+
+		pkt = next;
+		coalescing = net_tcp_gro_init(&gro, pkt);
+	}
+
+	if (coalescing) {
+		net_tcp_gro_finish(&gro);
+	}
+
+	net_process_rx_packet(pkt);
+}
+#endif /* CONFIG_NET_TCP_GRO */
+
 #if NET_TC_RX_COUNT > 0
 static void tc_rx_handler(void *p1, void *p2, void *p3)
 {
@@ -254,7 +316,11 @@ static void tc_rx_handler(void *p1, void *p2, void *p3)
 			continue;
 		}
 
+#if defined(CONFIG_NET_TCP_GRO)
+		tc_rx_gro_batch(fifo, pkt);
+#else
 		net_process_rx_packet(pkt);
+#endif
 	}
 }
 #endif
@@ -266,15 +332,30 @@ static void tc_tx_handler(void *p1, void *p2, void *p3)
 	ARG_UNUSED(p3);
 
 	struct k_fifo *fifo = p1;
-	struct net_pkt *pkt;
+	struct net_pkt *pkts[CONFIG_NET_TC_TX_BURST];
+	size_t count;
 
 	while (1) {
-		pkt = k_fifo_get(fifo, K_FOREVER);
-		if (pkt == NULL) {
+		pkts[0] = k_fifo_get(fifo, K_FOREVER);
+		if (pkts[0] == NULL) {
 			continue;
 		}
 
-		net_process_tx_packet(pkt);
+		/* Take the packets already waiting, up to the burst size,
+		 * so that they are handed to the L2 together.
+		 */
+		for (count = 1; count < CONFIG_NET_TC_TX_BURST; count++) {
+			pkts[count] = k_fifo_get(fifo, K_NO_WAIT);
+			if (pkts[count] == NULL) {
+				break;
+			}
+		}
+
+		if (count == 1) {
+			net_process_tx_packet(pkts[0]);
+		} else {
+			net_process_tx_burst(pkts, count);
+		}
 	}
 }
 #endif
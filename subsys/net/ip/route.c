@@ -28,6 +28,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include "icmpv6.h"
 #include "nbr.h"
 #include "route.h"
+#include "route_lpm.h"
 
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
@@ -40,6 +41,11 @@ static sys_slist_t active_route_lifetime_timers;
 /* Timer that manages expired route entries. */
 static struct k_work_delayable route_lifetime_timer;
 
+/* Longest prefix match index of the routes. Routes with the same prefix
+ * on different interfaces share a trie node and are chained via lpm_next.
+ */
+NET_ROUTE_LPM_DEFINE(route_lpm, CONFIG_NET_MAX_ROUTES);
+
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Nexthop %p removed", nbr);
@@ -102,6 +108,8 @@ static void net_route_entry_remove(struct net_nbr *nbr)
 static void net_route_entries_table_clear(struct net_nbr_table *table)
 {
 	NET_DBG("Route table %p cleared", table);
+
+	net_route_lpm_init(&route_lpm);
 }
 
 /*
@@ -267,37 +275,67 @@ static inline void update_route_access(struct net_route_entry *route)
 	sys_slist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+static int route_lpm_add(struct net_route_entry *route)
 {
-	struct net_route_entry *route, *found = NULL;
-	uint8_t longest_match = 0U;
-	int i;
+	route->lpm_next = net_route_lpm_get(&route_lpm, route->addr.s6_addr,
+					    route->prefix_len);
 
-	net_ipv6_nbr_lock();
-
-	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	return net_route_lpm_insert(&route_lpm, route->addr.s6_addr,
+				    route->prefix_len, route);
+}
 
-		if (!nbr->ref) {
-			continue;
+static void route_lpm_del(struct net_route_entry *route)
+{
+	struct net_route_entry *head, *prev;
+
+	head = net_route_lpm_get(&route_lpm, route->addr.s6_addr,
+				 route->prefix_len);
+	if (head == route) {
+		if (route->lpm_next) {
+			(void)net_route_lpm_insert(&route_lpm,
+						   route->addr.s6_addr,
+						   route->prefix_len,
+						   route->lpm_next);
+		} else {
+			(void)net_route_lpm_remove(&route_lpm,
+						   route->addr.s6_addr,
+						   route->prefix_len);
 		}
-
-		if (iface && nbr->iface != iface) {
-			continue;
+	} else {
+		for (prev = head; prev; prev = prev->lpm_next) {
+			if (prev->lpm_next == route) {
+				prev->lpm_next = route->lpm_next;
+				break;
+			}
 		}
+	}
 
-		route = net_route_data(nbr);
+	route->lpm_next = NULL;
+}
+
+static void *route_lpm_iface_filter(void *data, void *user_data)
+{
+	struct net_route_entry *route = data;
+	struct net_if *iface = user_data;
 
-		if (route->prefix_len >= longest_match &&
-		    net_ipv6_is_prefix(dst->s6_addr,
-				       route->addr.s6_addr,
-				       route->prefix_len)) {
-			found = route;
-			longest_match = route->prefix_len;
+	for (; route; route = route->lpm_next) {
+		if (!iface || route->iface == iface) {
+			return route;
 		}
 	}
 
+	return NULL;
+}
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	net_ipv6_nbr_lock();
+
+	found = net_route_lpm_lookup(&route_lpm, dst->s6_addr, 128,
+				     route_lpm_iface_filter, iface);
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -442,6 +480,14 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route->iface = iface;
 	route->preference = preference;
 
+	if (route_lpm_add(route) < 0) {
+		NET_ERR("Route index update failed!");
+		release_nexthop_route(nexthop_route);
+		nbr_free(nbr);
+		route = NULL;
+		goto exit;
+	}
+
 	net_route_update_lifetime(route, lifetime);
 
 	sys_slist_prepend(&routes, &route->node);
@@ -594,6 +640,8 @@ int net_route_del(struct net_route_entry *route)
 		return -ENOENT;
 	}
 
+	route_lpm_del(route);
+
 	net_route_info("Deleted", route, &route->addr);
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
@@ -1113,5 +1161,7 @@ void net_route_init(void)
 #if defined(CONFIG_NET_ROUTE_MCAST)
 	memset(route_mcast_entries, 0, sizeof(route_mcast_entries));
 #endif
+	net_route_lpm_init(&route_lpm);
+
 	k_work_init_delayable(&route_lifetime_timer, route_lifetime_timeout);
 }
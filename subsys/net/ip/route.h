@@ -52,6 +52,9 @@ struct net_route_entry {
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
 
+	/** Next route with the same prefix on another interface. */
+	struct net_route_entry *lpm_next;
+
 	/** Network interface for the route. */
 	struct net_if *iface;
 
@@ -328,6 +331,110 @@ int net_route_packet(struct net_pkt *pkt, struct in6_addr *nexthop);
  */
 int net_route_packet_if(struct net_pkt *pkt, struct net_if *iface);
 
+/**
+ * @brief IPv4 route entry.
+ */
+struct net_route_entry_ipv4 {
+	/** Next route with the same prefix on another interface. */
+	struct net_route_entry_ipv4 *lpm_next;
+
+	/** Network interface for the route. */
+	struct net_if *iface;
+
+	/** IPv4 address/prefix of the route. */
+	struct in_addr addr;
+
+	/** IPv4 address of the next hop router. */
+	struct in_addr nexthop;
+
+	/** IPv4 address/prefix length. */
+	uint8_t prefix_len;
+
+	/** Is this entry in use or not */
+	bool is_used;
+};
+
+typedef void (*net_route_ipv4_cb_t)(struct net_route_entry_ipv4 *entry,
+				    void *user_data);
+
+#if defined(CONFIG_NET_ROUTE_IPV4)
+/**
+ * @brief Add an IPv4 route to routing table. An existing route to the
+ * same prefix on the same interface is updated with the new next hop.
+ *
+ * @param iface Network interface that this route is tied to.
+ * @param addr IPv4 address.
+ * @param prefix_len Length of the IPv4 address/prefix.
+ * @param nexthop IPv4 address of the next hop router.
+ *
+ * @return Return created route entry, NULL if could not be created.
+ */
+struct net_route_entry_ipv4 *net_route_ipv4_add(struct net_if *iface,
+						struct in_addr *addr,
+						uint8_t prefix_len,
+						struct in_addr *nexthop);
+
+/**
+ * @brief Delete an IPv4 route from routing table.
+ *
+ * @param route Existing route entry.
+ *
+ * @return 0 if ok, <0 if error
+ */
+int net_route_ipv4_del(struct net_route_entry_ipv4 *route);
+
+/**
+ * @brief Lookup IPv4 route to a given destination.
+ *
+ * @param iface Network interface. If NULL, then check against all interfaces.
+ * @param dst Destination IPv4 address.
+ *
+ * @return Return route entry with the longest prefix matching the
+ * destination address, NULL if not found.
+ */
+struct net_route_entry_ipv4 *net_route_ipv4_lookup(struct net_if *iface,
+						   const struct in_addr *dst);
+
+/**
+ * @brief Get the next hop router towards a given IPv4 destination.
+ *
+ * @param iface Network interface.
+ * @param dst Destination IPv4 address.
+ * @param nexthop Next hop IPv4 address is returned here.
+ *
+ * @return True if there is a route to the destination, False otherwise
+ */
+bool net_route_ipv4_get_nexthop(struct net_if *iface,
+				const struct in_addr *dst,
+				struct in_addr *nexthop);
+
+/**
+ * @brief Go through all the IPv4 routing entries and call callback
+ * for each entry that is in use.
+ *
+ * @param cb User supplied callback function to call.
+ * @param user_data User specified data.
+ *
+ * @return Total number of IPv4 routing entries found.
+ */
+int net_route_ipv4_foreach(net_route_ipv4_cb_t cb, void *user_data);
+
+void net_route_ipv4_init(void);
+#else
+static inline bool net_route_ipv4_get_nexthop(struct net_if *iface,
+					      const struct in_addr *dst,
+					      struct in_addr *nexthop)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(dst);
+	ARG_UNUSED(nexthop);
+
+	return false;
+}
+
+#define net_route_ipv4_init(...)
+#endif /* CONFIG_NET_ROUTE_IPV4 */
+
 #if defined(CONFIG_NET_ROUTE) && defined(CONFIG_NET_NATIVE)
 void net_route_init(void);
 #else
@@ -0,0 +1,236 @@
+/** @file
+ * @brief IPv4 route handling.
+ */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_route_ipv4, CONFIG_NET_ROUTE_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <errno.h>
+
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_ip.h>
+
+#include "net_private.h"
+#include "route.h"
+#include "route_lpm.h"
+
+static struct net_route_entry_ipv4 routes_ipv4[CONFIG_NET_MAX_ROUTES_IPV4];
+
+/* Routes with the same prefix on different interfaces share a trie node
+ * and are chained via lpm_next.
+ */
+NET_ROUTE_LPM_DEFINE(route_ipv4_lpm, CONFIG_NET_MAX_ROUTES_IPV4);
+
+static K_MUTEX_DEFINE(route_ipv4_lock);
+
+static void *route_ipv4_iface_filter(void *data, void *user_data)
+{
+	struct net_route_entry_ipv4 *route = data;
+	struct net_if *iface = user_data;
+
+	for (; route; route = route->lpm_next) {
+		if (!iface || route->iface == iface) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+static struct net_route_entry_ipv4 *route_ipv4_find(struct net_if *iface,
+						    struct in_addr *addr,
+						    uint8_t prefix_len)
+{
+	struct net_route_entry_ipv4 *route;
+
+	route = net_route_lpm_get(&route_ipv4_lpm, addr->s4_addr, prefix_len);
+
+	for (; route; route = route->lpm_next) {
+		if (route->iface == iface) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+struct net_route_entry_ipv4 *net_route_ipv4_add(struct net_if *iface,
+						struct in_addr *addr,
+						uint8_t prefix_len,
+						struct in_addr *nexthop)
+{
+	struct net_route_entry_ipv4 *route = NULL;
+	int i;
+
+	NET_ASSERT(iface);
+	NET_ASSERT(addr);
+	NET_ASSERT(nexthop);
+
+	if (prefix_len > 32) {
+		return NULL;
+	}
+
+	k_mutex_lock(&route_ipv4_lock, K_FOREVER);
+
+	route = route_ipv4_find(iface, addr, prefix_len);
+	if (route) {
+		net_ipaddr_copy(&route->nexthop, nexthop);
+		goto out;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(routes_ipv4); i++) {
+		if (!routes_ipv4[i].is_used) {
+			route = &routes_ipv4[i];
+			break;
+		}
+	}
+
+	if (!route) {
+		NET_DBG("IPv4 routing table full");
+		goto out;
+	}
+
+	route->iface = iface;
+	route->prefix_len = prefix_len;
+	net_ipaddr_copy(&route->addr, addr);
+	net_ipaddr_copy(&route->nexthop, nexthop);
+
+	route->lpm_next = net_route_lpm_get(&route_ipv4_lpm, addr->s4_addr,
+					    prefix_len);
+	if (net_route_lpm_insert(&route_ipv4_lpm, addr->s4_addr, prefix_len,
+				 route) < 0) {
+		route = NULL;
+		goto out;
+	}
+
+	route->is_used = true;
+
+	NET_DBG("Added route to %s/%d via %s (iface %p)",
+		net_sprint_ipv4_addr(addr), prefix_len,
+		net_sprint_ipv4_addr(nexthop), iface);
+
+out:
+	k_mutex_unlock(&route_ipv4_lock);
+
+	return route;
+}
+
+int net_route_ipv4_del(struct net_route_entry_ipv4 *route)
+{
+	struct net_route_entry_ipv4 *head, *prev;
+
+	if (!route) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&route_ipv4_lock, K_FOREVER);
+
+	if (!route->is_used) {
+		k_mutex_unlock(&route_ipv4_lock);
+		return -ENOENT;
+	}
+
+	head = net_route_lpm_get(&route_ipv4_lpm, route->addr.s4_addr,
+				 route->prefix_len);
+	if (head == route) {
+		if (route->lpm_next) {
+			(void)net_route_lpm_insert(&route_ipv4_lpm,
+						   route->addr.s4_addr,
+						   route->prefix_len,
+						   route->lpm_next);
+		} else {
+			(void)net_route_lpm_remove(&route_ipv4_lpm,
+						   route->addr.s4_addr,
+						   route->prefix_len);
+		}
+	} else {
+		for (prev = head; prev; prev = prev->lpm_next) {
+			if (prev->lpm_next == route) {
+				prev->lpm_next = route->lpm_next;
+				break;
+			}
+		}
+	}
+
+	NET_DBG("Deleted route to %s/%d (iface %p)",
+		net_sprint_ipv4_addr(&route->addr), route->prefix_len,
+		route->iface);
+
+	route->lpm_next = NULL;
+	route->is_used = false;
+
+	k_mutex_unlock(&route_ipv4_lock);
+
+	return 0;
+}
+
+struct net_route_entry_ipv4 *net_route_ipv4_lookup(struct net_if *iface,
+						   const struct in_addr *dst)
+{
+	struct net_route_entry_ipv4 *route;
+
+	k_mutex_lock(&route_ipv4_lock, K_FOREVER);
+
+	route = net_route_lpm_lookup(&route_ipv4_lpm, dst->s4_addr, 32,
+				     route_ipv4_iface_filter, iface);
+
+	k_mutex_unlock(&route_ipv4_lock);
+
+	return route;
+}
+
+bool net_route_ipv4_get_nexthop(struct net_if *iface,
+				const struct in_addr *dst,
+				struct in_addr *nexthop)
+{
+	struct net_route_entry_ipv4 *route;
+
+	k_mutex_lock(&route_ipv4_lock, K_FOREVER);
+
+	route = net_route_lpm_lookup(&route_ipv4_lpm, dst->s4_addr, 32,
+				     route_ipv4_iface_filter, iface);
+	if (route) {
+		net_ipaddr_copy(nexthop, &route->nexthop);
+	}
+
+	k_mutex_unlock(&route_ipv4_lock);
+
+	return route != NULL;
+}
+
+int net_route_ipv4_foreach(net_route_ipv4_cb_t cb, void *user_data)
+{
+	int i, ret = 0;
+
+	k_mutex_lock(&route_ipv4_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(routes_ipv4); i++) {
+		if (!routes_ipv4[i].is_used) {
+			continue;
+		}
+
+		cb(&routes_ipv4[i], user_data);
+
+		ret++;
+	}
+
+	k_mutex_unlock(&route_ipv4_lock);
+
+	return ret;
+}
+
+void net_route_ipv4_init(void)
+{
+	NET_DBG("Allocated %d IPv4 routing entries (%zu bytes)",
+		CONFIG_NET_MAX_ROUTES_IPV4, sizeof(routes_ipv4));
+
+	net_route_lpm_init(&route_ipv4_lpm);
+}
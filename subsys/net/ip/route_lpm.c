@@ -0,0 +1,260 @@
+/** @file
+ * @brief Longest prefix match index for the routing tables.
+ *
+ * The index is a path compressed binary trie (a radix tree with radix 2)
+ * so a lookup visits at most one node per distinct prefix length on the
+ * path to the destination instead of every route in the table.
+ */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <string.h>
+
+#include "route_lpm.h"
+
+static inline uint8_t bit_at(const uint8_t *addr, uint8_t pos)
+{
+	return (addr[pos >> 3] >> (7 - (pos & 7))) & 1;
+}
+
+/* Return how many leading bits of a and b are equal, bits before "from"
+ * are already known to be equal and the result is capped to "max".
+ */
+static uint8_t common_len(const uint8_t *a, const uint8_t *b,
+			  uint8_t from, uint8_t max)
+{
+	unsigned int i;
+
+	for (i = from / 8U; i * 8U < max; i++) {
+		uint8_t diff = a[i] ^ b[i];
+
+		if (diff) {
+			unsigned int bits = i * 8U + __builtin_clz(diff) - 24U;
+
+			return MIN(bits, max);
+		}
+	}
+
+	return max;
+}
+
+static struct net_route_lpm_node *node_alloc(struct net_route_lpm *lpm,
+					     const uint8_t *prefix,
+					     uint8_t prefix_len,
+					     void *data)
+{
+	struct net_route_lpm_node *node = lpm->free;
+	uint8_t bytes = prefix_len / 8U;
+
+	if (!node) {
+		return NULL;
+	}
+
+	lpm->free = node->child[0];
+
+	memset(node, 0, sizeof(*node));
+	memcpy(node->prefix, prefix, bytes);
+
+	if (prefix_len % 8U) {
+		node->prefix[bytes] = prefix[bytes] &
+				      (uint8_t)(0xff << (8U - prefix_len % 8U));
+	}
+
+	node->prefix_len = prefix_len;
+	node->data = data;
+
+	return node;
+}
+
+static void node_free(struct net_route_lpm *lpm,
+		      struct net_route_lpm_node *node)
+{
+	node->child[0] = lpm->free;
+	lpm->free = node;
+}
+
+void net_route_lpm_init(struct net_route_lpm *lpm)
+{
+	size_t i;
+
+	lpm->root = NULL;
+	lpm->free = NULL;
+
+	for (i = 0; i < lpm->node_count; i++) {
+		node_free(lpm, &lpm->nodes[i]);
+	}
+}
+
+int net_route_lpm_insert(struct net_route_lpm *lpm, const uint8_t *prefix,
+			 uint8_t prefix_len, void *data)
+{
+	struct net_route_lpm_node **link = &lpm->root;
+	struct net_route_lpm_node *node, *leaf, *glue;
+	uint8_t common;
+
+	__ASSERT_NO_MSG(data != NULL);
+	__ASSERT_NO_MSG(prefix_len <= NET_ROUTE_LPM_MAX_BITS);
+
+	while ((node = *link) != NULL) {
+		common = common_len(node->prefix, prefix, 0,
+				    MIN(node->prefix_len, prefix_len));
+
+		if (common == node->prefix_len) {
+			if (node->prefix_len == prefix_len) {
+				node->data = data;
+				return 0;
+			}
+
+			link = &node->child[bit_at(prefix, node->prefix_len)];
+			continue;
+		}
+
+		/* The new prefix is either a parent of this node or
+		 * diverges from it, in both cases it goes above the node.
+		 */
+		leaf = node_alloc(lpm, prefix, prefix_len, data);
+		if (!leaf) {
+			return -ENOMEM;
+		}
+
+		if (common == prefix_len) {
+			leaf->child[bit_at(node->prefix, prefix_len)] = node;
+			*link = leaf;
+			return 0;
+		}
+
+		glue = node_alloc(lpm, prefix, common, NULL);
+		if (!glue) {
+			node_free(lpm, leaf);
+			return -ENOMEM;
+		}
+
+		glue->child[bit_at(node->prefix, common)] = node;
+		glue->child[bit_at(prefix, common)] = leaf;
+		*link = glue;
+
+		return 0;
+	}
+
+	leaf = node_alloc(lpm, prefix, prefix_len, data);
+	if (!leaf) {
+		return -ENOMEM;
+	}
+
+	*link = leaf;
+
+	return 0;
+}
+
+static struct net_route_lpm_node **find_link(struct net_route_lpm *lpm,
+					     const uint8_t *prefix,
+					     uint8_t prefix_len,
+					     struct net_route_lpm_node ***parent)
+{
+	struct net_route_lpm_node **link = &lpm->root;
+	struct net_route_lpm_node *node;
+
+	*parent = NULL;
+
+	while ((node = *link) != NULL) {
+		if (node->prefix_len > prefix_len ||
+		    common_len(node->prefix, prefix, 0,
+			       node->prefix_len) < node->prefix_len) {
+			break;
+		}
+
+		if (node->prefix_len == prefix_len) {
+			return node->data ? link : NULL;
+		}
+
+		*parent = link;
+		link = &node->child[bit_at(prefix, node->prefix_len)];
+	}
+
+	return NULL;
+}
+
+int net_route_lpm_remove(struct net_route_lpm *lpm, const uint8_t *prefix,
+			 uint8_t prefix_len)
+{
+	struct net_route_lpm_node **link, **parent_link;
+	struct net_route_lpm_node *node, *parent;
+
+	link = find_link(lpm, prefix, prefix_len, &parent_link);
+	if (!link) {
+		return -ENOENT;
+	}
+
+	node = *link;
+	node->data = NULL;
+
+	/* With two sub tries the node is still needed as a glue node */
+	if (node->child[0] && node->child[1]) {
+		return 0;
+	}
+
+	*link = node->child[0] ? node->child[0] : node->child[1];
+	node_free(lpm, node);
+
+	/* A glue parent that is left with a single child is not needed */
+	if (parent_link) {
+		parent = *parent_link;
+
+		if (!parent->data && (!parent->child[0] || !parent->child[1])) {
+			*parent_link = parent->child[0] ? parent->child[0] :
+							  parent->child[1];
+			node_free(lpm, parent);
+		}
+	}
+
+	return 0;
+}
+
+void *net_route_lpm_get(struct net_route_lpm *lpm, const uint8_t *prefix,
+			uint8_t prefix_len)
+{
+	struct net_route_lpm_node **link, **parent_link;
+
+	link = find_link(lpm, prefix, prefix_len, &parent_link);
+
+	return link ? (*link)->data : NULL;
+}
+
+void *net_route_lpm_lookup(struct net_route_lpm *lpm, const uint8_t *addr,
+			   uint8_t addr_len, net_route_lpm_filter_t filter,
+			   void *user_data)
+{
+	struct net_route_lpm_node *node = lpm->root;
+	void *found = NULL;
+	uint8_t checked = 0U;
+	void *data;
+
+	while (node && node->prefix_len <= addr_len) {
+		if (common_len(node->prefix, addr, checked,
+			       node->prefix_len) < node->prefix_len) {
+			break;
+		}
+
+		if (node->data) {
+			data = filter ? filter(node->data, user_data) : node->data;
+			if (data) {
+				found = data;
+			}
+		}
+
+		if (node->prefix_len == addr_len) {
+			break;
+		}
+
+		checked = node->prefix_len;
+		node = node->child[bit_at(addr, node->prefix_len)];
+	}
+
+	return found;
+}
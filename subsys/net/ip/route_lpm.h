@@ -0,0 +1,150 @@
+/** @file
+ * @brief Longest prefix match index for the routing tables
+ *
+ * This is not to be included by the application.
+ */
+
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __ROUTE_LPM_H
+#define __ROUTE_LPM_H
+
+#include <zephyr/types.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Longest prefix that can be stored, enough for an IPv6 address. */
+#define NET_ROUTE_LPM_MAX_BITS 128
+
+/**
+ * @brief Node of the path compressed binary trie.
+ *
+ * Nodes without data are glue nodes that only exist to split the trie
+ * where two stored prefixes diverge.
+ */
+struct net_route_lpm_node {
+	/** Sub tries for the bit following the prefix being 0 or 1. */
+	struct net_route_lpm_node *child[2];
+
+	/** User data of the stored prefix, NULL for a glue node. */
+	void *data;
+
+	/** Prefix bits, the bits after prefix_len are always zero. */
+	uint8_t prefix[NET_ROUTE_LPM_MAX_BITS / 8];
+
+	/** Prefix length in bits. */
+	uint8_t prefix_len;
+};
+
+/**
+ * @brief Longest prefix match index.
+ *
+ * The nodes come from a caller supplied array. A trie with N stored
+ * prefixes never needs more than 2 * N - 1 nodes, so sizing the array
+ * with NET_ROUTE_LPM_DEFINE() for the size of the routing table means
+ * an insert can only fail if the table itself is full.
+ */
+struct net_route_lpm {
+	struct net_route_lpm_node *root;
+	struct net_route_lpm_node *free;
+	struct net_route_lpm_node *nodes;
+	size_t node_count;
+};
+
+/**
+ * @brief Statically define a longest prefix match index.
+ *
+ * @param _name Name of the index.
+ * @param _max_prefixes Maximum number of prefixes stored in the index.
+ */
+#define NET_ROUTE_LPM_DEFINE(_name, _max_prefixes)			\
+	static struct net_route_lpm_node _name##_nodes[2 * (_max_prefixes)]; \
+	static struct net_route_lpm _name = {				\
+		.nodes = _name##_nodes,					\
+		.node_count = ARRAY_SIZE(_name##_nodes),		\
+	}
+
+/**
+ * @brief Filter callback used when looking up the longest match.
+ *
+ * @param data User data of a matching prefix.
+ * @param user_data User data given to net_route_lpm_lookup().
+ *
+ * @return Data to return for this prefix, NULL to skip the prefix and
+ * fall back to a shorter one.
+ */
+typedef void *(*net_route_lpm_filter_t)(void *data, void *user_data);
+
+/**
+ * @brief Remove all the prefixes from the index.
+ *
+ * @param lpm Longest prefix match index.
+ */
+void net_route_lpm_init(struct net_route_lpm *lpm);
+
+/**
+ * @brief Store a prefix in the index, replacing the data of an existing
+ * identical prefix.
+ *
+ * @param lpm Longest prefix match index.
+ * @param prefix Prefix bytes in network byte order.
+ * @param prefix_len Prefix length in bits.
+ * @param data User data of the prefix, must not be NULL.
+ *
+ * @return 0 if ok, -ENOMEM if there are no free nodes.
+ */
+int net_route_lpm_insert(struct net_route_lpm *lpm, const uint8_t *prefix,
+			 uint8_t prefix_len, void *data);
+
+/**
+ * @brief Remove a prefix from the index.
+ *
+ * @param lpm Longest prefix match index.
+ * @param prefix Prefix bytes in network byte order.
+ * @param prefix_len Prefix length in bits.
+ *
+ * @return 0 if ok, -ENOENT if the prefix is not stored.
+ */
+int net_route_lpm_remove(struct net_route_lpm *lpm, const uint8_t *prefix,
+			 uint8_t prefix_len);
+
+/**
+ * @brief Get the data of an exact prefix.
+ *
+ * @param lpm Longest prefix match index.
+ * @param prefix Prefix bytes in network byte order.
+ * @param prefix_len Prefix length in bits.
+ *
+ * @return User data of the prefix, NULL if not stored.
+ */
+void *net_route_lpm_get(struct net_route_lpm *lpm, const uint8_t *prefix,
+			uint8_t prefix_len);
+
+/**
+ * @brief Find the longest stored prefix of an address.
+ *
+ * @param lpm Longest prefix match index.
+ * @param addr Address bytes in network byte order.
+ * @param addr_len Address length in bits.
+ * @param filter Optional callback to accept or skip a matching prefix.
+ * @param user_data User data passed to the filter.
+ *
+ * @return User data (or filter result) of the longest matching prefix,
+ * NULL if nothing matched.
+ */
+void *net_route_lpm_lookup(struct net_route_lpm *lpm, const uint8_t *addr,
+			   uint8_t addr_len, net_route_lpm_filter_t filter,
+			   void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ROUTE_LPM_H */
@@ -19,6 +19,7 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_context.h>
 #include <zephyr/net/udp.h>
+#include <zephyr/net/ethernet.h>
 #include "ipv4.h"
 #include "ipv6.h"
 #include "connection.h"
@@ -1547,6 +1548,7 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 	if (data) {
 		/* Append the data buffer to the pkt */
 		net_pkt_append_buffer(pkt, data->buffer);
+		net_pkt_set_gso_size(pkt, net_pkt_gso_size(data));
 		data->buffer = NULL;
 	}
 
@@ -1677,6 +1679,75 @@ static int tcp_pkt_append(struct net_pkt *pkt, const uint8_t *data, size_t len)
 	return ret;
 }
 
+/* Read up to len bytes with the fill callback into new TX buffers, which
+ * are returned in frags. Called without the connection lock, so that a slow
+ * fill does not hold up the connection. Returns the number of bytes read,
+ * which is less than len if fill ran out of data.
+ */
+static int tcp_data_fill(struct tcp *conn, size_t len, net_tcp_fill_cb_t fill,
+			 void *user_data, struct net_buf **frags)
+{
+	struct net_buf *buf, *prev, *next;
+	struct net_pkt *tmp;
+	size_t filled = 0;
+	int ret = 0;
+
+	tmp = tcp_pkt_alloc(conn, 0);
+	if (!tmp) {
+		return -ENOBUFS;
+	}
+
+	if (net_pkt_alloc_buffer_raw(tmp, len, TCP_PKT_ALLOC_TIMEOUT) < 0) {
+		tcp_pkt_unref(tmp);
+		return -ENOBUFS;
+	}
+
+	for (buf = tmp->buffer; buf != NULL && filled < len; buf = buf->frags) {
+		size_t chunk = MIN(len - filled, net_buf_tailroom(buf));
+
+		ret = fill(net_buf_tail(buf), chunk, user_data);
+		if (ret < 0) {
+			break;
+		}
+
+		net_buf_add(buf, ret);
+		filled += ret;
+
+		if (ret < chunk) {
+			break;
+		}
+	}
+
+	/* Free the buffers that did not get any data */
+	prev = NULL;
+	buf = tmp->buffer;
+
+	while (buf != NULL) {
+		next = buf->frags;
+
+		if (buf->len == 0) {
+			net_buf_frag_del(prev, buf);
+			if (prev == NULL) {
+				tmp->buffer = next;
+			}
+		} else {
+			prev = buf;
+		}
+
+		buf = next;
+	}
+
+	*frags = tmp->buffer;
+	tmp->buffer = NULL;
+	tcp_pkt_unref(tmp);
+
+	if (filled == 0 && ret < 0) {
+		return ret;
+	}
+
+	return filled;
+}
+
 static bool tcp_window_full(struct tcp *conn)
 {
 	bool window_full = (conn->send_data_total >= conn->send_win);
@@ -1721,13 +1792,127 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+static bool tcp_dst_is_local(struct tcp *conn)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV4) && conn->dst.sa.sa_family == AF_INET) {
+		return net_ipv4_is_addr_loopback(&conn->dst.sin.sin_addr) ||
+		       net_ipv4_is_my_addr(&conn->dst.sin.sin_addr);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && conn->dst.sa.sa_family == AF_INET6) {
+		return net_ipv6_is_addr_loopback(&conn->dst.sin6.sin6_addr) ||
+		       net_ipv6_is_my_addr(&conn->dst.sin6.sin6_addr);
+	}
+
+	return false;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
+/* Largest amount of data sent in one packet. With GSO this is a
+ * super-segment of several MSS that the Ethernet L2 or driver splits.
+ * Locally delivered packets never reach the L2, so they are not batched.
+ */
+static int tcp_send_max_len(struct tcp *conn)
+{
+	int mss = conn_mss(conn);
+
+#if defined(CONFIG_NET_TCP_GSO)
+	if (conn->iface != NULL &&
+	    net_if_l2(conn->iface) == &NET_L2_GET_NAME(ETHERNET) &&
+	    !tcp_dst_is_local(conn)) {
+		int max_segs = MIN(CONFIG_NET_TCP_GSO_MAX_SEGMENTS,
+				   (UINT16_MAX - NET_IPV6H_LEN - NET_TCPH_LEN -
+				    NET_TCP_MAX_OPT_SIZE) / mss);
+
+		return mss * MAX(max_segs, 1);
+	}
+#endif
+
+	return mss;
+}
+
+#if defined(CONFIG_NET_TCP_GSO)
+/* Copy the unsent data into one buffer chain per segment, so that the
+ * super-segment can be split by moving whole buffers to each segment.
+ */
+static struct net_pkt *tcp_gso_data_alloc(struct tcp *conn, int len)
+{
+	int mss = conn_mss(conn);
+	struct net_pkt *pkt;
+	struct net_pkt *tmp;
+	int offset;
+
+	pkt = tcp_pkt_alloc(conn, 0);
+	tmp = tcp_pkt_alloc(conn, 0);
+	if (!pkt || !tmp) {
+		goto fail;
+	}
+
+	for (offset = 0; offset < len; offset += mss) {
+		int seg_len = MIN(mss, len - offset);
+
+		if (net_pkt_alloc_buffer_raw(tmp, seg_len, TCP_PKT_ALLOC_TIMEOUT) < 0 ||
+		    tcp_pkt_peek(tmp, conn->send_data, conn->unacked_len + offset,
+				 seg_len) < 0) {
+			goto fail;
+		}
+
+		net_pkt_append_buffer(pkt, tmp->buffer);
+		tmp->buffer = NULL;
+	}
+
+	tcp_pkt_unref(tmp);
+
+	net_pkt_set_gso_size(pkt, mss);
+
+	return pkt;
+
+fail:
+	if (tmp) {
+		tcp_pkt_unref(tmp);
+	}
+
+	if (pkt) {
+		tcp_pkt_unref(pkt);
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
+/* Copy len bytes of the unsent data into a new packet */
+static struct net_pkt *tcp_data_alloc(struct tcp *conn, int len)
+{
+	struct net_pkt *pkt;
+
+#if defined(CONFIG_NET_TCP_GSO)
+	if (len > conn_mss(conn)) {
+		return tcp_gso_data_alloc(conn, len);
+	}
+#endif
+
+	pkt = tcp_pkt_alloc(conn, len);
+	if (!pkt) {
+		return NULL;
+	}
+
+	if (tcp_pkt_peek(pkt, conn->send_data, conn->unacked_len, len) < 0) {
+		tcp_pkt_unref(pkt);
+		return NULL;
+	}
+
+	return pkt;
+}
+
 static int tcp_send_data(struct tcp *conn)
 {
 	int ret = 0;
 	int len;
+	int segs;
 	struct net_pkt *pkt;
 
-	len = MIN(tcp_unsent_len(conn), conn_mss(conn));
+	len = MIN(tcp_unsent_len(conn), tcp_send_max_len(conn));
 	if (len < 0) {
 		ret = len;
 		goto out;
@@ -1738,19 +1923,14 @@ static int tcp_send_data(struct tcp *conn)
 		goto out;
 	}
 
-	pkt = tcp_pkt_alloc(conn, len);
+	pkt = tcp_data_alloc(conn, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
 		ret = -ENOBUFS;
 		goto out;
 	}
 
-	ret = tcp_pkt_peek(pkt, conn->send_data, conn->unacked_len, len);
-	if (ret < 0) {
-		tcp_pkt_unref(pkt);
-		ret = -ENOBUFS;
-		goto out;
-	}
+	segs = DIV_ROUND_UP(len, conn_mss(conn));
 
 	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
 	if (ret == 0) {
@@ -1758,10 +1938,14 @@ static int tcp_send_data(struct tcp *conn)
 
 		if (conn->data_mode == TCP_DATA_MODE_RESEND) {
 			net_stats_update_tcp_resent(conn->iface, len);
-			net_stats_update_tcp_seg_rexmit(conn->iface);
+			while (segs-- > 0) {
+				net_stats_update_tcp_seg_rexmit(conn->iface);
+			}
 		} else {
 			net_stats_update_tcp_sent(conn->iface, len);
-			net_stats_update_tcp_seg_sent(conn->iface);
+			while (segs-- > 0) {
+				net_stats_update_tcp_seg_sent(conn->iface);
+			}
 		}
 	}
 
@@ -3683,6 +3867,32 @@ int net_tcp_update_recv_wnd(struct net_context *context, int32_t delta)
 	return ret;
 }
 
+/* Account for the data appended to send_data and try to send it out.
+ * Called with conn->lock held.
+ */
+static int tcp_queue_commit(struct tcp *conn, size_t queued_len)
+{
+	int ret;
+
+	conn->send_data_total += queued_len;
+
+	/* Successfully queued data for transmission. Even if there's a transmit
+	 * failure now (out-of-buf case), it can be ignored for now, retransmit
+	 * timer will take care of queued data retransmission.
+	 */
+	ret = tcp_send_queued_data(conn);
+	if (ret < 0 && ret != -ENOBUFS) {
+		tcp_conn_close(conn, ret);
+		return ret;
+	}
+
+	if (tcp_window_full(conn)) {
+		(void)k_sem_take(&conn->tx_sem, K_NO_WAIT);
+	}
+
+	return queued_len;
+}
+
 int net_tcp_queue(struct net_context *context, const void *data, size_t len,
 		  const struct msghdr *msg)
 {
@@ -3751,23 +3961,62 @@ int net_tcp_queue(struct net_context *context, const void *data, size_t len,
 		queued_len = len;
 	}
 
-	conn->send_data_total += queued_len;
+	ret = tcp_queue_commit(conn, queued_len);
+out:
+	k_mutex_unlock(&conn->lock);
 
-	/* Successfully queued data for transmission. Even if there's a transmit
-	 * failure now (out-of-buf case), it can be ignored for now, retransmit
-	 * timer will take care of queued data retransmission.
+	return ret;
+}
+
+int net_tcp_queue_fill(struct net_context *context, size_t len,
+		       net_tcp_fill_cb_t fill, void *user_data)
+{
+	struct tcp *conn = context->tcp;
+	struct net_buf *frags = NULL;
+	int ret;
+
+	if (!conn) {
+		return -ENOTCONN;
+	}
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	if (conn->state != TCP_ESTABLISHED) {
+		ret = -ENOTCONN;
+	} else if (tcp_window_full(conn)) {
+		ret = -EAGAIN;
+	} else {
+		len = MIN(conn->send_win - conn->send_data_total, len);
+		len = MIN(conn_mss(conn), len);
+		ret = 0;
+	}
+
+	k_mutex_unlock(&conn->lock);
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* The data is read without the lock, the lock is only taken again to
+	 * queue the read buffers. The window can change in between, the data
+	 * queued past it just waits like any other unsent data.
 	 */
-	ret = tcp_send_queued_data(conn);
-	if (ret < 0 && ret != -ENOBUFS) {
-		tcp_conn_close(conn, ret);
-		goto out;
+	ret = tcp_data_fill(conn, len, fill, user_data, &frags);
+	if (ret <= 0) {
+		return ret;
 	}
 
-	if (tcp_window_full(conn)) {
-		(void)k_sem_take(&conn->tx_sem, K_NO_WAIT);
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	if (conn->state != TCP_ESTABLISHED) {
+		net_buf_unref(frags);
+		ret = -ENOTCONN;
+		goto out;
 	}
 
-	ret = queued_len;
+	net_pkt_append_buffer(conn->send_data, frags);
+
+	ret = tcp_queue_commit(conn, ret);
 out:
 	k_mutex_unlock(&conn->lock);
 
@@ -4051,7 +4300,9 @@ int net_tcp_finalize(struct net_pkt *pkt, bool force_chksum)
 
 	tcp_hdr->chksum = 0U;
 
-	if (net_if_need_calc_tx_checksum(net_pkt_iface(pkt)) || force_chksum) {
+	/* Super-segments are checksummed per segment once they are split */
+	if ((net_if_need_calc_tx_checksum(net_pkt_iface(pkt)) &&
+	     net_pkt_gso_size(pkt) == 0U) || force_chksum) {
 		tcp_hdr->chksum = net_calc_chksum_tcp(pkt);
 		net_pkt_set_chksum_done(pkt, true);
 	}
@@ -4059,14 +4310,492 @@ int net_tcp_finalize(struct net_pkt *pkt, bool force_chksum)
 	return net_pkt_set_data(pkt, &tcp_access);
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+/* Detach the buffers holding the first len bytes of the chain in frags
+ * and leave frags pointing to the rest. A buffer crossing the end is split
+ * by copying its tail to a new buffer. This does not happen for
+ * super-segments built by TCP, where each segment starts a new buffer.
+ */
+static struct net_buf *tcp_gso_take(struct net_pkt *pkt, struct net_buf **frags,
+				    size_t len)
+{
+	struct net_buf *head = *frags;
+	struct net_buf *prev = NULL;
+	struct net_buf *buf = head;
+	struct net_buf *tail;
+	size_t tail_len;
+
+	while (buf && len >= buf->len) {
+		len -= buf->len;
+		prev = buf;
+		buf = buf->frags;
+	}
+
+	if (buf && len > 0) {
+		tail_len = buf->len - len;
+
+		tail = net_pkt_get_frag(pkt, tail_len, TCP_PKT_ALLOC_TIMEOUT);
+		if (!tail) {
+			return NULL;
+		}
+
+		if (net_buf_tailroom(tail) < tail_len) {
+			net_buf_unref(tail);
+			return NULL;
+		}
+
+		net_buf_add_mem(tail, buf->data + len, tail_len);
+		buf->len = len;
+		tail->frags = buf->frags;
+		buf->frags = NULL;
+		*frags = tail;
+
+		return head;
+	}
+
+	if (!prev) {
+		return NULL;
+	}
+
+	prev->frags = NULL;
+	*frags = buf;
+
+	return head;
+}
+
+static struct net_pkt *tcp_gso_segment_alloc(struct net_pkt *pkt,
+					     struct net_buf **payload,
+					     size_t hdr_len, size_t offset,
+					     size_t len, bool last)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
+	size_t ip_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+	struct net_buf *frags;
+	struct tcphdr *th;
+	struct net_pkt *seg;
+	uint32_t seq;
+
+	/* The IP header size is already accounted for by the family */
+	seg = net_pkt_alloc_with_buffer(net_pkt_iface(pkt),
+					hdr_len - net_pkt_ip_hdr_len(pkt),
+					net_pkt_family(pkt), 0,
+					TCP_PKT_ALLOC_TIMEOUT);
+	if (!seg) {
+		return NULL;
+	}
+
+	/* Only the headers are copied, the payload buffers are moved */
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_copy(seg, pkt, hdr_len)) {
+		goto fail;
+	}
+
+	frags = tcp_gso_take(pkt, payload, len);
+	if (!frags) {
+		goto fail;
+	}
+
+	net_pkt_append_buffer(seg, frags);
+
+	net_pkt_set_ip_hdr_len(seg, net_pkt_ip_hdr_len(pkt));
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		net_pkt_set_ipv4_opts_len(seg, net_pkt_ipv4_opts_len(pkt));
+	} else {
+		net_pkt_set_ipv6_ext_len(seg, net_pkt_ipv6_ext_len(pkt));
+	}
+
+	net_pkt_set_priority(seg, net_pkt_priority(pkt));
+	net_pkt_set_vlan_tag(seg, net_pkt_vlan_tag(pkt));
+	memcpy(net_pkt_lladdr_src(seg), net_pkt_lladdr_src(pkt),
+	       sizeof(struct net_linkaddr));
+	memcpy(net_pkt_lladdr_dst(seg), net_pkt_lladdr_dst(pkt),
+	       sizeof(struct net_linkaddr));
+
+	net_pkt_cursor_init(seg);
+	net_pkt_set_overwrite(seg, true);
+	net_pkt_skip(seg, ip_len);
+
+	th = (struct tcphdr *)net_pkt_get_data(seg, &tcp_access);
+	if (!th) {
+		goto fail;
+	}
+
+	seq = th_seq(th) + offset;
+	UNALIGNED_PUT(htonl(seq), &th->th_seq);
+
+	if (!last) {
+		UNALIGNED_PUT(th_flags(th) & ~(PSH | FIN), &th->th_flags);
+	}
+
+	if (net_pkt_set_data(seg, &tcp_access) < 0 ||
+	    tcp_finalize_pkt(seg) < 0) {
+		goto fail;
+	}
+
+	return seg;
+
+fail:
+	net_pkt_unref(seg);
+	return NULL;
+}
+
+int net_tcp_gso_segment(struct net_pkt *pkt, sys_slist_t *segments)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
+	size_t ip_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+	uint16_t mss = net_pkt_gso_size(pkt);
+	size_t hdr_len, payload_len, offset;
+	struct net_buf *payload;
+	struct net_buf *hdr;
+	struct tcphdr *th;
+	struct net_pkt *seg;
+	bool overwrite;
+	int ret = 0;
+
+	sys_slist_init(segments);
+
+	if (mss == 0U) {
+		return -EINVAL;
+	}
+
+	overwrite = net_pkt_is_being_overwritten(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_skip(pkt, ip_len)) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	th = (struct tcphdr *)net_pkt_get_data(pkt, &tcp_access);
+	if (!th) {
+		ret = -ENOBUFS;
+		goto out;
+	}
+
+	hdr_len = ip_len + th_off(th) * 4U;
+	payload_len = net_pkt_get_len(pkt) - hdr_len;
+
+	/* Keep the headers in pkt, to be copied to each segment */
+	payload = pkt->buffer;
+	hdr = tcp_gso_take(pkt, &payload, hdr_len);
+	if (!hdr) {
+		ret = -ENOBUFS;
+		goto out;
+	}
+
+	pkt->buffer = hdr;
+
+	for (offset = 0; offset < payload_len; offset += mss) {
+		size_t len = MIN(mss, payload_len - offset);
+
+		seg = tcp_gso_segment_alloc(pkt, &payload, hdr_len, offset, len,
+					    offset + len == payload_len);
+		if (!seg) {
+			ret = -ENOBUFS;
+			break;
+		}
+
+		sys_slist_append(segments, &seg->next);
+	}
+
+	/* Empty buffers left over, or the payload not sent on error */
+	if (payload) {
+		net_buf_unref(payload);
+	}
+
+	if (ret < 0) {
+		while (!sys_slist_is_empty(segments)) {
+			seg = CONTAINER_OF(sys_slist_get_not_empty(segments),
+					   struct net_pkt, next);
+			net_pkt_unref(seg);
+		}
+	}
+
+out:
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, overwrite);
+
+	return ret;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
+#if defined(CONFIG_NET_TCP_GRO)
+/* Check that the frame is a plain, unfragmented TCP data segment with all
+ * the headers in the first buffer and fill in the header offsets.
+ */
+static bool tcp_gro_parse(struct net_pkt *pkt, struct net_tcp_gro *gro)
+{
+	const size_t l3_off = sizeof(struct net_eth_hdr);
+	struct net_buf *buf = pkt->buffer;
+	struct net_eth_hdr *eth;
+	struct tcphdr *th;
+	size_t ip_len;
+
+	if (buf == NULL || buf->len < l3_off ||
+	    net_if_l2(net_pkt_iface(pkt)) != &NET_L2_GET_NAME(ETHERNET)) {
+		return false;
+	}
+
+	eth = (struct net_eth_hdr *)buf->data;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) &&
+	    ntohs(UNALIGNED_GET(&eth->type)) == NET_ETH_PTYPE_IP) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)(buf->data + l3_off);
+
+		if (buf->len < l3_off + NET_IPV4H_LEN || hdr->vhl != 0x45 ||
+		    hdr->proto != IPPROTO_TCP ||
+		    (hdr->offset[0] & 0x3f) != 0 || hdr->offset[1] != 0 ||
+		    !net_ipv4_is_my_addr((struct in_addr *)hdr->dst)) {
+			return false;
+		}
+
+		ip_len = ntohs(UNALIGNED_GET(&hdr->len));
+		gro->family = AF_INET;
+		gro->l4_off = l3_off + NET_IPV4H_LEN;
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   ntohs(UNALIGNED_GET(&eth->type)) == NET_ETH_PTYPE_IPV6) {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)(buf->data + l3_off);
+
+		if (buf->len < l3_off + NET_IPV6H_LEN ||
+		    hdr->nexthdr != IPPROTO_TCP ||
+		    !net_ipv6_is_my_addr((struct in6_addr *)hdr->dst)) {
+			return false;
+		}
+
+		ip_len = NET_IPV6H_LEN + ntohs(UNALIGNED_GET(&hdr->len));
+		gro->family = AF_INET6;
+		gro->l4_off = l3_off + NET_IPV6H_LEN;
+	} else {
+		return false;
+	}
+
+	if (buf->len < gro->l4_off + sizeof(struct tcphdr)) {
+		return false;
+	}
+
+	th = (struct tcphdr *)(buf->data + gro->l4_off);
+	gro->hdr_len = gro->l4_off + th_off(th) * 4U;
+
+	/* Frames with link layer padding are left alone */
+	if (th_off(th) < 5 || buf->len < gro->hdr_len ||
+	    l3_off + ip_len != net_pkt_get_len(pkt) ||
+	    l3_off + ip_len <= gro->hdr_len) {
+		return false;
+	}
+
+	/* Only pure data segments, PSH ends the coalescing */
+	if ((th_flags(th) & ~PSH) != ACK) {
+		return false;
+	}
+
+	gro->payload_len = l3_off + ip_len - gro->hdr_len;
+
+	return true;
+}
+
+static uint16_t tcp_gro_chksum_bufs(uint16_t sum, struct net_buf *buf,
+				    size_t offset)
+{
+	bool odd = false;
+
+	for (; buf != NULL; buf = buf->frags, offset = 0) {
+		const uint8_t *data = buf->data + offset;
+		size_t len = buf->len - offset;
+
+		if (len == 0) {
+			continue;
+		}
+
+		if (odd) {
+			sum += *data;
+			if (sum < *data) {
+				sum++;
+			}
+
+			data++;
+			len--;
+		}
+
+		sum = calc_chksum(sum, data, len);
+		odd = (len % 2) != 0;
+	}
+
+	return sum;
+}
+
+static bool tcp_gro_verify(struct net_pkt *pkt, struct net_tcp_gro *gro)
+{
+	const size_t l3_off = sizeof(struct net_eth_hdr);
+	uint8_t *data = pkt->buffer->data;
+	size_t tcp_len = gro->hdr_len - gro->l4_off + gro->payload_len;
+	uint16_t sum;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) ||
+	    !net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
+		return true;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && gro->family == AF_INET) {
+		sum = calc_chksum(0, data + l3_off, NET_IPV4H_LEN);
+		if (sum != 0xffff && sum != 0U) {
+			return false;
+		}
+
+		sum = calc_chksum(tcp_len + IPPROTO_TCP,
+				  data + l3_off + offsetof(struct net_ipv4_hdr, src),
+				  2 * sizeof(struct in_addr));
+	} else {
+		sum = calc_chksum(tcp_len + IPPROTO_TCP,
+				  data + l3_off + offsetof(struct net_ipv6_hdr, src),
+				  2 * sizeof(struct in6_addr));
+	}
+
+	sum = tcp_gro_chksum_bufs(sum, pkt->buffer, gro->l4_off);
+
+	return sum == 0xffff || sum == 0U;
+}
+
+/* IP fields that must match for segments of the same flow */
+static bool tcp_gro_same_ip(struct net_tcp_gro *gro, const uint8_t *a,
+			    const uint8_t *b)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV4) && gro->family == AF_INET) {
+		const struct net_ipv4_hdr *ha = (const struct net_ipv4_hdr *)a;
+		const struct net_ipv4_hdr *hb = (const struct net_ipv4_hdr *)b;
+
+		return ha->tos == hb->tos && ha->ttl == hb->ttl &&
+		       memcmp(ha->src, hb->src, 2 * sizeof(struct in_addr)) == 0;
+	}
+
+	/* Traffic class, flow label, hop limit and addresses */
+	return memcmp(a, b, offsetof(struct net_ipv6_hdr, len)) == 0 &&
+	       memcmp(a + offsetof(struct net_ipv6_hdr, hop_limit),
+		      b + offsetof(struct net_ipv6_hdr, hop_limit),
+		      NET_IPV6H_LEN - offsetof(struct net_ipv6_hdr, hop_limit)) == 0;
+}
+
+bool net_tcp_gro_init(struct net_tcp_gro *gro, struct net_pkt *pkt)
+{
+	if (!tcp_gro_parse(pkt, gro)) {
+		return false;
+	}
+
+	gro->head = pkt;
+	gro->merged = false;
+	gro->verified = false;
+
+	return true;
+}
+
+bool net_tcp_gro_merge(struct net_tcp_gro *gro, struct net_pkt *pkt)
+{
+	const size_t l3_off = sizeof(struct net_eth_hdr);
+	uint8_t *head_data = gro->head->buffer->data;
+	struct tcphdr *head_th = (struct tcphdr *)(head_data + gro->l4_off);
+	struct net_tcp_gro seg;
+	struct net_buf *buf;
+	struct tcphdr *th;
+	uint8_t *data;
+
+	if (net_pkt_iface(pkt) != net_pkt_iface(gro->head) ||
+	    (th_flags(head_th) & PSH) || !tcp_gro_parse(pkt, &seg) ||
+	    seg.family != gro->family || seg.hdr_len != gro->hdr_len ||
+	    gro->hdr_len + gro->payload_len + seg.payload_len > UINT16_MAX) {
+		return false;
+	}
+
+	data = pkt->buffer->data;
+	th = (struct tcphdr *)(data + seg.l4_off);
+
+	/* Same link layer header, addresses, ports, ACK, window and options,
+	 * and the segment must directly follow the data merged so far.
+	 */
+	if (memcmp(head_data, data, l3_off) != 0 ||
+	    !tcp_gro_same_ip(gro, head_data + l3_off, data + l3_off) ||
+	    memcmp(&head_th->th_sport, &th->th_sport, 2 * sizeof(uint16_t)) != 0 ||
+	    th_ack(head_th) != th_ack(th) || th_win(head_th) != th_win(th) ||
+	    memcmp(head_th + 1, th + 1,
+		   gro->hdr_len - gro->l4_off - sizeof(struct tcphdr)) != 0 ||
+	    th_seq(head_th) + gro->payload_len != th_seq(th)) {
+		return false;
+	}
+
+	if (!gro->verified) {
+		if (!tcp_gro_verify(gro->head, gro)) {
+			return false;
+		}
+
+		gro->verified = true;
+	}
+
+	if (!tcp_gro_verify(pkt, &seg)) {
+		return false;
+	}
+
+	UNALIGNED_PUT(th_flags(head_th) | (th_flags(th) & PSH), &head_th->th_flags);
+
+	/* Headers are all in the first buffer, move the payload over */
+	buf = pkt->buffer;
+	net_buf_pull(buf, seg.hdr_len);
+	if (buf->len == 0U) {
+		buf = net_buf_frag_del(NULL, buf);
+	}
+
+	pkt->buffer = NULL;
+	net_pkt_append_buffer(gro->head, buf);
+	net_pkt_unref(pkt);
+
+	gro->payload_len += seg.payload_len;
+	gro->merged = true;
+
+	return true;
+}
+
+void net_tcp_gro_finish(struct net_tcp_gro *gro)
+{
+	const size_t l3_off = sizeof(struct net_eth_hdr);
+	uint8_t *ip = gro->head->buffer->data + l3_off;
+	uint16_t ip_len = gro->hdr_len - l3_off + gro->payload_len;
+
+	if (!gro->merged) {
+		return;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && gro->family == AF_INET) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)ip;
+		uint16_t sum;
+
+		UNALIGNED_PUT(htons(ip_len), &hdr->len);
+		UNALIGNED_PUT(0, &hdr->chksum);
+
+		sum = calc_chksum(0, ip, NET_IPV4H_LEN);
+		sum = (sum == 0U) ? 0xffff : htons(sum);
+		UNALIGNED_PUT(~sum, &hdr->chksum);
+	} else {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)ip;
+
+		UNALIGNED_PUT(htons(ip_len - NET_IPV6H_LEN), &hdr->len);
+	}
+
+	/* The TCP checksum is not updated, the segments were verified
+	 * individually and the merged packet is only delivered locally.
+	 */
+	net_pkt_set_chksum_done(gro->head, true);
+}
+#endif /* CONFIG_NET_TCP_GRO */
+
 struct net_tcp_hdr *net_tcp_input(struct net_pkt *pkt,
 				  struct net_pkt_data_access *tcp_access)
 {
 	struct net_tcp_hdr *tcp_hdr;
 
+	/* Segments coalesced by GRO have been verified one by one already */
 	if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
 	    (net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) ||
 	     net_pkt_is_ip_reassembled(pkt)) &&
+	    !(IS_ENABLED(CONFIG_NET_TCP_GRO) && net_pkt_is_chksum_done(pkt)) &&
 	    net_calc_chksum_tcp(pkt) != 0U) {
 		NET_DBG("DROP: checksum mismatch");
 		goto drop;
@@ -263,6 +263,88 @@ static inline int net_tcp_finalize(struct net_pkt *pkt, bool force_chksum)
 }
 #endif
 
+/**
+ * @brief Split a TCP super-segment into MSS sized segments
+ *
+ * Used by L2 code when the driver cannot segment the packet in hardware.
+ * Each segment gets a copy of the IP and TCP headers with the sequence
+ * number, lengths and checksums fixed up. The payload buffers are moved
+ * from the original packet to the segments, so the original packet is
+ * left with its headers only. It is not released, and must be dropped
+ * by the caller if segmenting fails.
+ *
+ * @param pkt Network packet with net_pkt_gso_size() set
+ * @param segments List where the segments are appended via their next node
+ *
+ * @return 0 on success, negative errno otherwise.
+ */
+#if defined(CONFIG_NET_TCP_GSO)
+int net_tcp_gso_segment(struct net_pkt *pkt, sys_slist_t *segments);
+#else
+static inline int net_tcp_gso_segment(struct net_pkt *pkt,
+				      sys_slist_t *segments)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(segments);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Receive side TCP segment coalescing state
+ *
+ * Tracks the packet that following in-order segments of the same flow
+ * are merged into. The packets are raw Ethernet frames as queued to the
+ * RX traffic class threads.
+ */
+struct net_tcp_gro {
+	/** Packet the following segments are merged into */
+	struct net_pkt *head;
+	/** Offset of the TCP header in the first buffer */
+	uint16_t l4_off;
+	/** Length of the L2, IP and TCP headers */
+	uint16_t hdr_len;
+	/** TCP payload length, including the merged segments */
+	uint16_t payload_len;
+	/** Address family of the flow */
+	uint8_t family;
+	/** At least one segment has been merged into the head */
+	bool merged;
+	/** Checksum of the head has been verified */
+	bool verified;
+};
+
+#if defined(CONFIG_NET_TCP_GRO)
+/**
+ * @brief Start coalescing into a received packet
+ *
+ * @param gro Coalescing state to initialize
+ * @param pkt Received Ethernet frame
+ *
+ * @return True if the packet is a TCP segment that others can be merged into.
+ */
+bool net_tcp_gro_init(struct net_tcp_gro *gro, struct net_pkt *pkt);
+
+/**
+ * @brief Try to merge a received packet into the current head
+ *
+ * @param gro Coalescing state
+ * @param pkt Received Ethernet frame following the head
+ *
+ * @return True if the payload was merged and @p pkt released, false if
+ *         @p pkt was left untouched.
+ */
+bool net_tcp_gro_merge(struct net_tcp_gro *gro, struct net_pkt *pkt);
+
+/**
+ * @brief Fix up the headers of the head packet after merging
+ *
+ * @param gro Coalescing state
+ */
+void net_tcp_gro_finish(struct net_tcp_gro *gro);
+#endif /* CONFIG_NET_TCP_GRO */
+
 /**
  * @brief Get pointer to TCP header in net_pkt
  *
@@ -312,6 +394,49 @@ static inline int net_tcp_queue(struct net_context *context, const void *data,
 }
 #endif
 
+/**
+ * @typedef net_tcp_fill_cb_t
+ * @brief Callback that writes data to be queued directly into a TX buffer.
+ *
+ * @param dst Where to write the data.
+ * @param len Maximum number of bytes to write.
+ * @param user_data User data given to net_tcp_queue_fill().
+ *
+ * @return Number of bytes written, less than len when there is no more
+ * data, < 0 if error
+ */
+typedef int (*net_tcp_fill_cb_t)(void *dst, size_t len, void *user_data);
+
+/**
+ * @brief Enqueue data for transmission, written in place by a callback
+ *
+ * The data is written directly into new TX buffers so the caller does
+ * not need an intermediate buffer. The callback is called without the
+ * connection lock held, and at most one MSS is queued per call.
+ *
+ * @param context	Network context
+ * @param len		Maximum number of bytes to queue
+ * @param fill		Callback writing the data
+ * @param user_data	User data passed to the callback
+ *
+ * @return Number of bytes queued, 0 if fill had no data, < 0 if error
+ */
+#if defined(CONFIG_NET_NATIVE_TCP)
+int net_tcp_queue_fill(struct net_context *context, size_t len,
+		       net_tcp_fill_cb_t fill, void *user_data);
+#else
+static inline int net_tcp_queue_fill(struct net_context *context, size_t len,
+				     net_tcp_fill_cb_t fill, void *user_data)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(len);
+	ARG_UNUSED(fill);
+	ARG_UNUSED(user_data);
+
+	return -EPROTONOSUPPORT;
+}
+#endif
+
 /**
  * @brief Update TCP receive window
  *
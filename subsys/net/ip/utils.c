@@ -522,16 +522,90 @@ int z_vrfy_net_addr_pton(sa_family_t family, const char *src,
 #define CHECKSUM_BIG_ENDIAN 1
 #endif
 
-static uint16_t offset_based_swap8(const uint8_t *data)
+static inline uint16_t offset_based_swap8(const uint8_t *data)
 {
 	uint16_t data16 = (uint16_t)*data;
 
-	if (((uintptr_t)(data) & 1) == CHECKSUM_BIG_ENDIAN) {
-		return data16;
-	} else {
-		return data16 << 8;
+	/* Shift the odd byte into the upper half unless its address parity
+	 * already matches the working byte order.
+	 */
+	return data16 << (((((uintptr_t)data) ^ CHECKSUM_BIG_ENDIAN) & 1) << 3);
+}
+
+#if defined(CONFIG_64BIT)
+/* One's complement addition of a 64-bit word, the carry out of the top bit
+ * is wrapped around to bit 0.
+ */
+static inline uint64_t chksum_add64(uint64_t sum, uint64_t data)
+{
+	sum += data;
+
+	return sum + (sum < data);
+}
+
+static uint64_t chksum_words(uint64_t sum, const uint8_t *data, size_t len)
+{
+	const uint64_t *p = (const uint64_t *)data;
+	uint64_t sum_a = 0U, sum_b = 0U, sum_c = 0U;
+
+	/* Four independent accumulators so the add-with-carry chains can
+	 * run in parallel on superscalar cores.
+	 */
+	while (len >= sizeof(uint64_t) * 8) {
+		sum = chksum_add64(sum, p[0]);
+		sum_a = chksum_add64(sum_a, p[1]);
+		sum_b = chksum_add64(sum_b, p[2]);
+		sum_c = chksum_add64(sum_c, p[3]);
+		sum = chksum_add64(sum, p[4]);
+		sum_a = chksum_add64(sum_a, p[5]);
+		sum_b = chksum_add64(sum_b, p[6]);
+		sum_c = chksum_add64(sum_c, p[7]);
+		p += 8;
+		len -= sizeof(uint64_t) * 8;
+	}
+
+	while (len >= sizeof(uint64_t)) {
+		sum = chksum_add64(sum, *p++);
+		len -= sizeof(uint64_t);
+	}
+
+	sum = chksum_add64(sum, sum_a);
+	sum = chksum_add64(sum, sum_b);
+	sum = chksum_add64(sum, sum_c);
+
+	return sum;
+}
+#else
+static uint64_t chksum_words(uint64_t sum, const uint8_t *data, size_t len)
+{
+	const uint32_t *p = (const uint32_t *)data;
+
+	/* 32-bit words are accumulated into 64-bit sums, so no carry handling
+	 * is needed until the final fold.
+	 */
+	while (len >= sizeof(uint32_t) * 8) {
+		uint64_t sum_a = p[0];
+		uint64_t sum_b = p[1];
+
+		sum_a += p[2];
+		sum_b += p[3];
+		sum_a += p[4];
+		sum_b += p[5];
+		sum_a += p[6];
+		sum_b += p[7];
+		p += 8;
+		len -= sizeof(uint32_t) * 8;
+		sum += sum_a + sum_b;
+	}
+
+	while (len >= sizeof(uint32_t)) {
+		sum += *p++;
+		len -= sizeof(uint32_t);
 	}
+
+	return sum;
 }
+#endif /* CONFIG_64BIT */
 
 /* Word based checksum calculation based on:
  * https://blogs.igalia.com/dpino/2018/06/14/fast-checksum-computation/
@@ -539,13 +613,15 @@ static uint16_t offset_based_swap8(const uint8_t *data)
  * it is possible to do parallel addition using larger word sizes such as 32-bit or 64-bit words.
  * In those cases the variable that stores the accumulative sum has to be bigger too.
  * Once the sum is computed a final step folds the sum to a 16-bit word (adding carry if any).
+ *
+ * Architectures selecting CONFIG_ARCH_HAS_NET_CHKSUM provide arch_net_calc_chksum()
+ * (typically a SIMD variant) which is used for the bulk of the data instead.
  */
 uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len)
 {
 	uint64_t sum;
-	uint32_t *p;
-	size_t i = 0;
 	size_t pending = len;
+	size_t words;
 	int odd_start = ((uintptr_t)data & 0x01);
 
 	/* Sum in is in host endiannes, working order endiannes is both dependent on endianness
@@ -557,7 +633,7 @@ uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len)
 		sum = sum_in;
 	}
 
-	/* Process up to 3 data elements up front, so the data is aligned further down the line */
+	/* Process up to 7 data elements up front, so the data is aligned further down the line */
 	if ((((uintptr_t)data & 0x01) != 0) && (pending >= 1)) {
 		sum += offset_based_swap8(data);
 		data++;
@@ -568,25 +644,31 @@ uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len)
 		sum = sum + *((uint16_t *)data);
 		data += sizeof(uint16_t);
 	}
-	p = (uint32_t *)data;
+	if (IS_ENABLED(CONFIG_64BIT) &&
+	    (((uintptr_t)data & 0x04) != 0) && (pending >= sizeof(uint32_t))) {
+		pending -= sizeof(uint32_t);
+		sum = sum + *((uint32_t *)data);
+		data += sizeof(uint32_t);
+	}
 
-	/* Do loop unrolling for the very large data sets */
-	while (pending >= sizeof(uint32_t) * 4) {
-		uint64_t sum_a = p[i];
-		uint64_t sum_b = p[i + 1];
+#if defined(CONFIG_ARCH_HAS_NET_CHKSUM)
+	words = arch_net_calc_chksum(&sum, data, pending);
+#else
+	words = pending & ~(sizeof(uintptr_t) - 1);
+	sum = chksum_words(sum, data, words);
+#endif
+	data += words;
+	pending -= words;
 
-		pending -= sizeof(uint32_t) * 4;
-		sum_a += p[i + 2];
-		sum_b += p[i + 3];
-		i += 4;
-		sum += sum_a + sum_b;
-	}
-	while (pending >= sizeof(uint32_t)) {
+	/* Leave headroom for the remaining tail bytes */
+	sum = (sum & 0xffffffff) + (sum >> 32);
+
+	if (pending >= sizeof(uint32_t)) {
 		pending -= sizeof(uint32_t);
-		sum = sum + p[i++];
+		sum = sum + *((uint32_t *)data);
+		data += sizeof(uint32_t);
 	}
-	data = (uint8_t *)(p + i);
-	if (pending >= 2) {
+	if (pending >= sizeof(uint16_t)) {
 		pending -= sizeof(uint16_t);
 		sum = sum + *((uint16_t *)data);
 		data += sizeof(uint16_t);
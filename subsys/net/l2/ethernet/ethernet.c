@@ -27,6 +27,7 @@ LOG_MODULE_REGISTER(net_ethernet, CONFIG_NET_L2_ETHERNET_LOG_LEVEL);
 #include "net_private.h"
 #include "ipv6.h"
 #include "ipv4_autoconf_internal.h"
+#include "tcp_internal.h"
 #include "bridge.h"
 
 #define NET_BUF_TIMEOUT K_MSEC(100)
@@ -599,32 +600,84 @@ static void ethernet_remove_l2_header(struct net_pkt *pkt)
 	net_pkt_frag_unref(buf);
 }
 
-static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
+static int ethernet_send(struct net_if *iface, struct net_pkt *pkt);
+
+#if defined(CONFIG_NET_TCP_GSO)
+/* Software fallback for TCP super-segments when the driver does not
+ * support TSO. Each segment is sent as a regular packet.
+ */
+static int ethernet_send_gso(struct net_if *iface, struct net_pkt *pkt)
 {
-	const struct ethernet_api *api = net_if_get_device(iface)->api;
-	struct ethernet_context *ctx = net_if_l2_data(iface);
-	uint16_t ptype = 0;
+	sys_slist_t segments;
+	struct net_pkt *seg;
+	int total = 0;
 	int ret;
-	struct net_pkt *orig_pkt = pkt;
 
-	if (!api) {
-		ret = -ENOENT;
-		goto error;
+	ret = net_tcp_gso_segment(pkt, &segments);
+	if (ret < 0) {
+		NET_DBG("Cannot segment pkt %p (%d)", pkt, ret);
+		return ret;
 	}
 
-	if (IS_ENABLED(CONFIG_NET_ETHERNET_BRIDGE) &&
-	    net_pkt_is_l2_bridged(pkt)) {
-		net_pkt_cursor_init(pkt);
-		ret = net_l2_send(api->send, net_if_get_device(iface), iface, pkt);
-		if (ret != 0) {
-			eth_stats_update_errors_tx(iface);
-			goto error;
+	while (!sys_slist_is_empty(&segments)) {
+		seg = CONTAINER_OF(sys_slist_get_not_empty(&segments),
+				   struct net_pkt, next);
+
+		if (ret < 0) {
+			net_pkt_unref(seg);
+			continue;
 		}
-		ethernet_update_tx_stats(iface, pkt);
-		ret = net_pkt_get_len(pkt);
-		net_pkt_unref(pkt);
+
+		ret = ethernet_send(iface, seg);
+		if (ret < 0) {
+			net_pkt_unref(seg);
+			continue;
+		}
+
+		total += ret;
+	}
+
+	if (ret < 0) {
 		return ret;
-	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+	}
+
+	net_pkt_unref(pkt);
+
+	return total;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
+static void ethernet_arp_error(struct net_if *iface, struct net_pkt *orig_pkt,
+			       struct net_pkt *pkt, uint16_t ptype)
+{
+	if (IS_ENABLED(CONFIG_NET_ARP) && ptype == htons(NET_ETH_PTYPE_ARP)) {
+		/* Original packet was added to ARP's pending Q, so, to avoid it
+		 * being freed, take a reference, the reference is dropped when we
+		 * clear the pending Q in ARP and then it will be freed by net_if.
+		 */
+		net_pkt_ref(orig_pkt);
+		if (net_arp_clear_pending(
+			    iface, (struct in_addr *)NET_IPV4_HDR(pkt)->dst)) {
+			NET_DBG("Could not find pending ARP entry");
+		}
+		/* Free the ARP request */
+		net_pkt_unref(pkt);
+	}
+}
+
+/* Add the Ethernet header to the packet. The packet is replaced by an ARP
+ * request if the IPv4 destination is not resolved yet. Returns <0 if the
+ * packet cannot be sent.
+ */
+static int ethernet_tx_prepare(struct net_if *iface, struct net_pkt **pkt_ptr,
+			       uint16_t *ptype_ptr)
+{
+	struct ethernet_context *ctx = net_if_l2_data(iface);
+	struct net_pkt *orig_pkt = *pkt_ptr;
+	struct net_pkt *pkt = orig_pkt;
+	uint16_t ptype = 0;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) &&
 	    net_pkt_family(pkt) == AF_INET) {
 		struct net_pkt *tmp;
 
@@ -633,8 +686,7 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 		} else {
 			tmp = ethernet_ll_prepare_on_ipv4(iface, pkt);
 			if (!tmp) {
-				ret = -ENOMEM;
-				goto error;
+				return -ENOMEM;
 			} else if (IS_ENABLED(CONFIG_NET_ARP) && tmp != pkt) {
 				/* Original pkt got queued and is replaced
 				 * by an ARP request packet.
@@ -671,7 +723,7 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 						sizeof(struct net_eth_addr);
 			ptype = dst_addr->sll_protocol;
 		} else {
-			goto send;
+			goto out;
 		}
 	} else if (IS_ENABLED(CONFIG_NET_L2_PTP) && net_pkt_is_ptp(pkt)) {
 		ptype = htons(NET_ETH_PTYPE_PTP);
@@ -683,8 +735,7 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 		ptype = htons(NET_ETH_PTYPE_ARP);
 		net_pkt_set_family(pkt, AF_INET);
 	} else {
-		ret = -ENOTSUP;
-		goto error;
+		return -ENOTSUP;
 	}
 
 	/* If the ll dst addr has not been set before, let's assume
@@ -701,18 +752,30 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 	 * is used to determine if the VLAN header is added to Ethernet frame.
 	 */
 	if (!ethernet_fill_header(ctx, iface, pkt, ptype)) {
-		ret = -ENOMEM;
-		goto arp_error;
+		ethernet_arp_error(iface, orig_pkt, pkt, ptype);
+		return -ENOMEM;
 	}
 
 	net_pkt_cursor_init(pkt);
 
-send:
-	ret = net_l2_send(api->send, net_if_get_device(iface), iface, pkt);
+out:
+	*pkt_ptr = pkt;
+	*ptype_ptr = ptype;
+
+	return 0;
+}
+
+/* Complete the send of a packet prepared by ethernet_tx_prepare(), ret is
+ * the result of the driver.
+ */
+static int ethernet_tx_done(struct net_if *iface, struct net_pkt *orig_pkt,
+			    struct net_pkt *pkt, uint16_t ptype, int ret)
+{
 	if (ret != 0) {
 		eth_stats_update_errors_tx(iface);
 		ethernet_remove_l2_header(pkt);
-		goto arp_error;
+		ethernet_arp_error(iface, orig_pkt, pkt, ptype);
+		return ret;
 	}
 
 	ethernet_update_tx_stats(iface, pkt);
@@ -721,26 +784,136 @@ send:
 	ethernet_remove_l2_header(pkt);
 
 	net_pkt_unref(pkt);
-error:
+
 	return ret;
+}
 
-arp_error:
-	if (IS_ENABLED(CONFIG_NET_ARP) && ptype == htons(NET_ETH_PTYPE_ARP)) {
-		/* Original packet was added to ARP's pending Q, so, to avoid it
-		 * being freed, take a reference, the reference is dropped when we
-		 * clear the pending Q in ARP and then it will be freed by net_if.
-		 */
-		net_pkt_ref(orig_pkt);
-		if (net_arp_clear_pending(
-			    iface, (struct in_addr *)NET_IPV4_HDR(pkt)->dst)) {
-			NET_DBG("Could not find pending ARP entry");
+static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	const struct ethernet_api *api = net_if_get_device(iface)->api;
+	struct net_pkt *orig_pkt = pkt;
+	uint16_t ptype;
+	int ret;
+
+	if (!api) {
+		return -ENOENT;
+	}
+
+#if defined(CONFIG_NET_TCP_GSO)
+	if (net_pkt_gso_size(pkt) > 0U &&
+	    !(net_eth_get_hw_capabilities(iface) &
+	      ETHERNET_HW_TX_TCP_SEGMENTATION)) {
+		return ethernet_send_gso(iface, pkt);
+	}
+#endif
+
+	if (IS_ENABLED(CONFIG_NET_ETHERNET_BRIDGE) &&
+	    net_pkt_is_l2_bridged(pkt)) {
+		net_pkt_cursor_init(pkt);
+		ret = net_l2_send(api->send, net_if_get_device(iface), iface, pkt);
+		if (ret != 0) {
+			eth_stats_update_errors_tx(iface);
+			return ret;
 		}
-		/* Free the ARP request */
+		ethernet_update_tx_stats(iface, pkt);
+		ret = net_pkt_get_len(pkt);
 		net_pkt_unref(pkt);
+		return ret;
 	}
 
-	return ret;
+	ret = ethernet_tx_prepare(iface, &pkt, &ptype);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = net_l2_send(api->send, net_if_get_device(iface), iface, pkt);
+
+	return ethernet_tx_done(iface, orig_pkt, pkt, ptype, ret);
+}
+
+#if defined(CONFIG_NET_TC_TX_BURST)
+/* Packets that are split, or bridged, are sent on their own */
+static bool ethernet_tx_single(struct net_if *iface, struct net_pkt *pkt)
+{
+	if (IS_ENABLED(CONFIG_NET_ETHERNET_BRIDGE) &&
+	    net_pkt_is_l2_bridged(pkt)) {
+		return true;
+	}
+
+	return net_pkt_gso_size(pkt) > 0U &&
+	       !(net_eth_get_hw_capabilities(iface) &
+		 ETHERNET_HW_TX_TCP_SEGMENTATION);
+}
+
+void net_eth_send_burst(struct net_if *iface, struct net_pkt **pkts,
+			int *status, size_t count)
+{
+	const struct device *dev = net_if_get_device(iface);
+	const struct ethernet_api *api = dev->api;
+	struct net_pkt *frames[CONFIG_NET_TC_TX_BURST];
+	uint16_t ptypes[CONFIG_NET_TC_TX_BURST];
+	size_t idx[CONFIG_NET_TC_TX_BURST];
+	size_t ready = 0;
+	size_t i, j;
+	int sent;
+
+	__ASSERT_NO_MSG(count <= CONFIG_NET_TC_TX_BURST);
+
+	if (!api || !api->send_burst) {
+		for (i = 0; i < count; i++) {
+			status[i] = ethernet_send(iface, pkts[i]);
+		}
+
+		return;
+	}
+
+	for (i = 0; i <= count; i++) {
+		/* Hand over the frames prepared so far before a packet that
+		 * is sent on its own, and at the end, to keep the order.
+		 */
+		if (ready > 0 &&
+		    (i == count || ethernet_tx_single(iface, pkts[i]))) {
+			for (j = 0; j < ready; j++) {
+				net_capture_pkt(iface, frames[j]);
+			}
+
+			sent = api->send_burst(dev, frames, ready);
+
+			for (j = 0; j < ready; j++) {
+				int ret = 0;
+
+				if (sent < 0 || j >= sent) {
+					ret = api->send(dev, frames[j]);
+				}
+
+				status[idx[j]] = ethernet_tx_done(iface, pkts[idx[j]],
+								 frames[j], ptypes[j],
+								 ret);
+			}
+
+			ready = 0;
+		}
+
+		if (i == count) {
+			break;
+		}
+
+		if (ethernet_tx_single(iface, pkts[i])) {
+			status[i] = ethernet_send(iface, pkts[i]);
+			continue;
+		}
+
+		frames[ready] = pkts[i];
+
+		status[i] = ethernet_tx_prepare(iface, &frames[ready], &ptypes[ready]);
+		if (status[i] < 0) {
+			continue;
+		}
+
+		idx[ready++] = i;
+	}
 }
+#endif /* CONFIG_NET_TC_TX_BURST */
 
 static inline int ethernet_enable(struct net_if *iface, bool state)
 {
@@ -20,6 +20,7 @@ LOG_MODULE_REGISTER(net_coap, CONFIG_COAP_LOG_LEVEL);
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/math_extras.h>
 
+#include <zephyr/net/buf.h>
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/coap.h>
@@ -101,19 +102,6 @@ static inline bool append_u8(struct coap_packet *cpkt, uint8_t data)
 	return true;
 }
 
-static inline bool insert_u8(struct coap_packet *cpkt, uint8_t data, uint16_t offset)
-{
-	if (!enough_space(cpkt, 1)) {
-		return false;
-	}
-
-	memmove(&cpkt->data[offset + 1], &cpkt->data[offset], cpkt->offset - offset);
-
-	encode_u8(cpkt, offset, data);
-
-	return true;
-}
-
 static inline bool append_be16(struct coap_packet *cpkt, uint16_t data)
 {
 	if (!enough_space(cpkt, 2)) {
@@ -125,19 +113,6 @@ static inline bool append_be16(struct coap_packet *cpkt, uint16_t data)
 	return true;
 }
 
-static inline bool insert_be16(struct coap_packet *cpkt, uint16_t data, size_t offset)
-{
-	if (!enough_space(cpkt, 2)) {
-		return false;
-	}
-
-	memmove(&cpkt->data[offset + 2], &cpkt->data[offset], cpkt->offset - offset);
-
-	encode_be16(cpkt, cpkt->offset, data);
-
-	return true;
-}
-
 static inline bool append(struct coap_packet *cpkt, const uint8_t *data, uint16_t len)
 {
 	if (data == NULL || !enough_space(cpkt, len)) {
@@ -149,20 +124,6 @@ static inline bool append(struct coap_packet *cpkt, const uint8_t *data, uint16_
 	return true;
 }
 
-static inline bool insert(struct coap_packet *cpkt, const uint8_t *data, uint16_t len,
-			  size_t offset)
-{
-	if (data == NULL || !enough_space(cpkt, len)) {
-		return false;
-	}
-
-	memmove(&cpkt->data[offset + len], &cpkt->data[offset], cpkt->offset - offset);
-
-	encode_buffer(cpkt, offset, data, len);
-
-	return true;
-}
-
 int coap_packet_init(struct coap_packet *cpkt, uint8_t *data, uint16_t max_len,
 		     uint8_t ver, uint8_t type, uint8_t token_len,
 		     const uint8_t *token, uint8_t code, uint16_t id)
@@ -229,6 +190,18 @@ int coap_ack_init(struct coap_packet *cpkt, const struct coap_packet *req,
 				token, code, id);
 }
 
+int coap_packet_init_net_buf(struct coap_packet *cpkt, struct net_buf *buf,
+			     uint8_t ver, uint8_t type, uint8_t token_len,
+			     const uint8_t *token, uint8_t code, uint16_t id)
+{
+	if (!buf || buf->len != 0U) {
+		return -EINVAL;
+	}
+
+	return coap_packet_init(cpkt, buf->data, MIN(net_buf_tailroom(buf), UINT16_MAX), ver,
+				type, token_len, token, code, id);
+}
+
 static void option_header_set_delta(uint8_t *opt, uint8_t delta)
 {
 	*opt = (delta & 0xF) << 4;
@@ -259,11 +232,17 @@ static uint8_t encode_extended_option(uint16_t num, uint8_t *opt, uint16_t *ext)
 	return 2;
 }
 
-/* Insert an option at position `offset`. This is not adjusting the code delta of the
- * option that follows the inserted one!
- */
-static int encode_option(struct coap_packet *cpkt, uint16_t code, const uint8_t *value,
-			 uint16_t len, size_t offset)
+static int option_size(uint16_t code, uint16_t len)
+{
+	uint16_t ext;
+	uint8_t opt;
+
+	return 1 + encode_extended_option(code, &opt, &ext) +
+	       encode_extended_option(len, &opt, &ext) + len;
+}
+
+/* Write an option at `data`, the room for it has to be made already */
+static void write_option(uint8_t *data, uint16_t code, const uint8_t *value, uint16_t len)
 {
 	uint16_t delta_ext; /* Extended delta */
 	uint16_t len_ext; /* Extended length */
@@ -272,7 +251,6 @@ static int encode_option(struct coap_packet *cpkt, uint16_t code, const uint8_t
 	uint8_t opt_len;
 	uint8_t delta_size;
 	uint8_t len_size;
-	bool res;
 
 	delta_size = encode_extended_option(code, &opt_delta, &delta_ext);
 	len_size = encode_extended_option(len, &opt_len, &len_ext);
@@ -280,49 +258,59 @@ static int encode_option(struct coap_packet *cpkt, uint16_t code, const uint8_t
 	option_header_set_delta(&opt, opt_delta);
 	option_header_set_len(&opt, opt_len);
 
-	res = insert_u8(cpkt, opt, offset);
-	++offset;
-	if (!res) {
-		return -EINVAL;
-	}
+	*data++ = opt;
 
 	if (delta_size == 1U) {
-		res = insert_u8(cpkt, (uint8_t)delta_ext, offset);
-		++offset;
-		if (!res) {
-			return -EINVAL;
-		}
+		*data++ = (uint8_t)delta_ext;
 	} else if (delta_size == 2U) {
-		res = insert_be16(cpkt, delta_ext, offset);
-		offset += 2;
-		if (!res) {
-			return -EINVAL;
-		}
+		sys_put_be16(delta_ext, data);
+		data += 2;
 	}
 
 	if (len_size == 1U) {
-		res = insert_u8(cpkt, (uint8_t)len_ext, offset);
-		++offset;
-		if (!res) {
-			return -EINVAL;
-		}
+		*data++ = (uint8_t)len_ext;
 	} else if (len_size == 2U) {
-		res = insert_be16(cpkt, len_ext, offset);
-		offset += 2;
-		if (!res) {
-			return -EINVAL;
-		}
+		sys_put_be16(len_ext, data);
+		data += 2;
 	}
 
 	if (len && value) {
-		res = insert(cpkt, value, len, offset);
-		/* no need to update local offset */
-		if (!res) {
-			return -EINVAL;
-		}
+		memcpy(data, value, len);
+	}
+}
+
+/* Move the data from `offset` on by `diff` bytes, to make room or to close a gap */
+static bool move_tail(struct coap_packet *cpkt, uint16_t offset, int diff)
+{
+	if (diff > 0 && cpkt->max_len - cpkt->offset < diff) {
+		return false;
 	}
 
-	return  (1 + delta_size + len_size + len);
+	if (diff != 0 && offset < cpkt->offset) {
+		memmove(cpkt->data + offset + diff, cpkt->data + offset, cpkt->offset - offset);
+	}
+
+	cpkt->offset += diff;
+
+	return true;
+}
+
+/* Insert an option at position `offset`. Appending moves no data, inserting moves what
+ * follows once. This is not adjusting the code delta of the option that follows the
+ * inserted one!
+ */
+static int encode_option(struct coap_packet *cpkt, uint16_t code, const uint8_t *value,
+			 uint16_t len, size_t offset)
+{
+	int size = option_size(code, len);
+
+	if (!move_tail(cpkt, offset, size)) {
+		return -EINVAL;
+	}
+
+	write_option(cpkt->data + offset, code, value, len);
+
+	return size;
 }
 
 int coap_packet_append_option(struct coap_packet *cpkt, uint16_t code,
@@ -642,6 +630,7 @@ static int remove_middle_option(struct coap_packet *cpkt,
 				const uint16_t previous_code)
 {
 	int r;
+	int diff;
 	struct coap_option option;
 	uint16_t opt_len = 0;
 
@@ -652,16 +641,17 @@ static int remove_middle_option(struct coap_packet *cpkt,
 		return -EILSEQ;
 	}
 
-	/* clear requested option and the one after (delta changed) */
-	remove_option_data(cpkt, previous_offset, offset);
+	/* replace requested option and the one after with the latter (delta changed) */
+	r = option_size(option.delta - previous_code, option.len);
+	diff = previous_offset + r - offset;
 
-	/* reinsert option that comes after the removed option (with adjusted delta) */
-	r = encode_option(cpkt, option.delta - previous_code, option.value, option.len,
-			  previous_offset);
-	if (r < 0) {
+	if (!move_tail(cpkt, offset, diff)) {
 		return -EINVAL;
 	}
-	cpkt->opt_len += r;
+	cpkt->opt_len += diff;
+
+	write_option(cpkt->data + previous_offset, option.delta - previous_code, option.value,
+		     option.len);
 
 	return 0;
 }
@@ -1394,27 +1384,21 @@ int insert_option(struct coap_packet *cpkt, uint16_t code, const uint8_t *value,
 		last_offset = offset;
 	}
 
-	const uint16_t option_size = offset - last_offset;
-	/* clear option after new option (delta changed) */
-	memmove(cpkt->data + last_offset, cpkt->data + offset, cpkt->offset - offset);
-	cpkt->opt_len -= option_size;
-	cpkt->offset -= option_size;
-
-	/* add the new option */
-	const uint16_t new_option_delta = code - last_opt;
+	/* replace option after new option with both of them (delta changed), the data
+	 * after them is moved only once
+	 */
+	const int new_size = option_size(code - last_opt, len);
+	const int next_size = option_size(option.delta - code, option.len);
+	const int diff = last_offset + new_size + next_size - offset;
 
-	r = encode_option(cpkt, new_option_delta, value, len, last_offset);
-	if (r < 0) {
+	if (!move_tail(cpkt, offset, diff)) {
 		return -EINVAL;
 	}
-	cpkt->opt_len += r;
+	cpkt->opt_len += diff;
 
-	/* reinsert option that comes after the new option (with adjusted delta) */
-	r = encode_option(cpkt, option.delta - code, option.value, option.len, last_offset + r);
-	if (r < 0) {
-		return -EINVAL;
-	}
-	cpkt->opt_len += r;
+	write_option(cpkt->data + last_offset, code - last_opt, value, len);
+	write_option(cpkt->data + last_offset + new_size, option.delta - code, option.value,
+		     option.len);
 
 	return 0;
 }
@@ -55,11 +55,27 @@ static void reset_block_contexts(struct coap_client_internal_request *request)
 	request->send_blk_ctx.current = 0;
 }
 
+#if CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1
+static void block2_window_reset(struct coap_client_internal_request *request)
+{
+	for (int i = 0; i < ARRAY_SIZE(request->block2); i++) {
+		request->block2[i].ongoing = false;
+		request->block2[i].received = false;
+		coap_pending_clear(&request->block2[i].pending);
+	}
+
+	request->block2_next = 0;
+}
+#endif
+
 static void reset_internal_request(struct coap_client_internal_request *request)
 {
 	request->offset = 0;
 	request->last_id = 0;
 	reset_block_contexts(request);
+#if CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1
+	block2_window_reset(request);
+#endif
 }
 
 static int coap_client_schedule_poll(struct coap_client *client, int sock,
@@ -385,6 +401,158 @@ static void report_callback_error(struct coap_client_internal_request *internal_
 	}
 }
 
+#if CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1
+/* The next blocks are requested ahead once the size of the resource is known */
+static bool block2_window_usable(struct coap_client_internal_request *internal_req)
+{
+	return internal_req->recv_blk_ctx.total_size > 0 &&
+	       internal_req->coap_request.payload == NULL &&
+	       !coap_request_is_observe(&internal_req->request);
+}
+
+static bool block2_window_busy(struct coap_client_internal_request *internal_req)
+{
+	for (int i = 0; i < ARRAY_SIZE(internal_req->block2); i++) {
+		if (internal_req->block2[i].ongoing || internal_req->block2[i].received) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int block2_send(struct coap_client *client,
+		       struct coap_client_internal_request *internal_req,
+		       struct coap_client_block2_request *block)
+{
+	struct coap_client_request *req = &internal_req->coap_request;
+	struct coap_block_context ctx = internal_req->recv_blk_ctx;
+	struct coap_packet request;
+	int ret;
+
+	ctx.current = block->num * coap_block_size_to_bytes(ctx.block_size);
+
+	k_mutex_lock(&client->send_mutex, K_FOREVER);
+
+	ret = coap_packet_init(&request, client->send_buf, MAX_COAP_MSG_LEN, COAP_VERSION,
+			       req->confirmable ? COAP_TYPE_CON : COAP_TYPE_NON_CON,
+			       COAP_TOKEN_MAX_LEN, block->token, req->method, block->id);
+	if (ret < 0) {
+		LOG_ERR("Failed to init CoAP message %d", ret);
+		goto out;
+	}
+
+	ret = coap_packet_set_path(&request, req->path);
+	if (ret < 0) {
+		LOG_ERR("Failed to parse path to options %d", ret);
+		goto out;
+	}
+
+	ret = coap_append_block2_option(&request, &ctx);
+	if (ret < 0) {
+		LOG_ERR("Failed to append block 2 option");
+		goto out;
+	}
+
+	for (int i = 0; i < req->num_options; i++) {
+		ret = coap_packet_append_option(&request, req->options[i].code,
+						req->options[i].value, req->options[i].len);
+		if (ret < 0) {
+			LOG_ERR("Failed to append %d option", req->options[i].code);
+			goto out;
+		}
+	}
+
+	/* First transmission, retransmissions are cycled by the resend handler */
+	if (req->confirmable && block->pending.timeout == 0) {
+		struct coap_transmission_parameters params = internal_req->pending.params;
+
+		ret = coap_pending_init(&block->pending, &request, &client->address, &params);
+		if (ret < 0) {
+			LOG_ERR("Error creating pending");
+			goto out;
+		}
+
+		coap_pending_cycle(&block->pending);
+	}
+
+	ret = send_request(client->fd, request.data, request.offset, 0, &client->address,
+			   client->socklen);
+	if (ret < 0) {
+		LOG_ERR("Failed to send request for block %u, %d", block->num, errno);
+	} else {
+		ret = 0;
+	}
+
+out:
+	k_mutex_unlock(&client->send_mutex);
+
+	return ret;
+}
+
+/* Requests the next blocks of the resource, as long as there are free slots */
+static int block2_window_fill(struct coap_client *client,
+			      struct coap_client_internal_request *internal_req)
+{
+	size_t block_bytes = coap_block_size_to_bytes(internal_req->recv_blk_ctx.block_size);
+	uint32_t blocks = DIV_ROUND_UP(internal_req->recv_blk_ctx.total_size, block_bytes);
+	int ret;
+
+	for (int i = 0; i < ARRAY_SIZE(internal_req->block2); i++) {
+		struct coap_client_block2_request *block = &internal_req->block2[i];
+
+		if (block->ongoing || block->received) {
+			continue;
+		}
+
+		/* Past the announced size, blocks are requested one at a time */
+		if (internal_req->block2_next >= blocks && block2_window_busy(internal_req)) {
+			break;
+		}
+
+		memcpy(block->token, coap_next_token(), COAP_TOKEN_MAX_LEN);
+		block->id = coap_next_id();
+		block->num = internal_req->block2_next++;
+		block->ongoing = true;
+
+		ret = block2_send(client, internal_req, block);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int block2_window_resend(struct coap_client *client,
+				struct coap_client_internal_request *internal_req)
+{
+	int ret = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(internal_req->block2); i++) {
+		struct coap_client_block2_request *block = &internal_req->block2[i];
+
+		if (!block->ongoing || block->pending.timeout == 0 ||
+		    block->pending.timeout > (k_uptime_get() - block->pending.t0)) {
+			continue;
+		}
+
+		if (!coap_pending_cycle(&block->pending)) {
+			LOG_ERR("Timeout for block %u, no more retries left", block->num);
+			report_callback_error(internal_req, -ETIMEDOUT);
+			internal_req->request_ongoing = false;
+			block2_window_reset(internal_req);
+			return -ETIMEDOUT;
+		}
+
+		LOG_WRN("Timeout for block %u, retrying send", block->num);
+		ret = block2_send(client, internal_req, block);
+	}
+
+	return ret;
+}
+#endif /* CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1 */
+
 static bool timeout_expired(struct coap_client_internal_request *internal_req)
 {
 	if (internal_req->pending.timeout == 0) {
@@ -442,6 +610,15 @@ static int coap_client_resend_handler(void)
 			if (timeout_expired(&clients[i]->requests[j])) {
 				ret = resend_request(clients[i], &clients[i]->requests[j]);
 			}
+#if CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1
+			if (clients[i]->requests[j].request_ongoing) {
+				int err = block2_window_resend(clients[i], &clients[i]->requests[j]);
+
+				if (err < 0) {
+					ret = err;
+				}
+			}
+#endif
 		}
 	}
 
@@ -612,6 +789,156 @@ static bool find_echo_option(const struct coap_packet *response, struct coap_opt
 	return coap_find_options(response, COAP_OPTION_ECHO, option, 1);
 }
 
+#if CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1
+/* Finds the block a response is for, piggybacked responses need to match the message id too */
+static struct coap_client_block2_request *get_block2_request(
+	struct coap_client *client, const struct coap_packet *resp,
+	struct coap_client_internal_request **internal_req)
+{
+	uint8_t response_token[COAP_TOKEN_MAX_LEN];
+	uint8_t response_tkl;
+	uint16_t id = coap_header_get_id(resp);
+	bool ack = coap_header_get_type(resp) == COAP_TYPE_ACK;
+
+	response_tkl = coap_header_get_token(resp, response_token);
+	if (response_tkl != COAP_TOKEN_MAX_LEN) {
+		return NULL;
+	}
+
+	for (int i = 0; i < CONFIG_COAP_CLIENT_MAX_REQUESTS; i++) {
+		if (!client->requests[i].request_ongoing) {
+			continue;
+		}
+
+		for (int j = 0; j < ARRAY_SIZE(client->requests[i].block2); j++) {
+			struct coap_client_block2_request *block = &client->requests[i].block2[j];
+
+			if (!block->ongoing || (ack && block->id != id) ||
+			    memcmp(block->token, response_token, response_tkl) != 0) {
+				continue;
+			}
+
+			*internal_req = &client->requests[i];
+			return block;
+		}
+	}
+
+	return NULL;
+}
+
+/* Passes the blocks received in a row to the callback, returns true after the last one */
+static bool block2_window_deliver(struct coap_client_internal_request *internal_req)
+{
+	struct coap_block_context *ctx = &internal_req->recv_blk_ctx;
+	size_t block_bytes = coap_block_size_to_bytes(ctx->block_size);
+	bool found;
+
+	do {
+		found = false;
+
+		for (int i = 0; i < ARRAY_SIZE(internal_req->block2); i++) {
+			struct coap_client_block2_request *block = &internal_req->block2[i];
+
+			if (!block->received || block->num != ctx->current / block_bytes) {
+				continue;
+			}
+
+			if (internal_req->coap_request.cb) {
+				internal_req->coap_request.cb(block->code, internal_req->offset,
+							      block->len > 0 ? block->payload : NULL,
+							      block->len, block->last,
+							      internal_req->coap_request.user_data);
+			}
+
+			block->received = false;
+			internal_req->offset += block->len;
+			ctx->current += block_bytes;
+			found = true;
+
+			if (block->last) {
+				return true;
+			}
+		}
+	} while (found);
+
+	return false;
+}
+
+static int handle_block2_response(struct coap_client *client,
+				  struct coap_client_internal_request *internal_req,
+				  struct coap_client_block2_request *block,
+				  const struct coap_packet *response)
+{
+	int response_type = coap_header_get_type(response);
+	int block_option = coap_get_option_int(response, COAP_OPTION_BLOCK2);
+	uint16_t payload_len;
+	const uint8_t *payload = coap_packet_get_payload(response, &payload_len);
+	int ret = 0;
+
+	/* Separate response coming */
+	if (payload_len == 0 && response_type == COAP_TYPE_ACK &&
+	    coap_header_get_code(response) == COAP_CODE_EMPTY) {
+		block->pending.t0 = k_uptime_get();
+		block->pending.timeout = COAP_SEPARATE_TIMEOUT;
+		block->pending.retries = 0;
+		return 1;
+	}
+
+	block->ongoing = false;
+	coap_pending_clear(&block->pending);
+
+	if (response_type == COAP_TYPE_RESET) {
+		ret = -ECONNRESET;
+		goto fail;
+	}
+
+	/* CON response is always a separate response, respond with empty ACK. */
+	if (response_type == COAP_TYPE_CON) {
+		ret = send_ack(client, response, COAP_CODE_EMPTY);
+		if (ret < 0) {
+			goto fail;
+		}
+	}
+
+	if (block_option >= 0 && GET_BLOCK_NUM(block_option) != block->num) {
+		LOG_ERR("Received block %d, requested %u", GET_BLOCK_NUM(block_option),
+			block->num);
+		ret = -EBADMSG;
+		goto fail;
+	}
+
+	if (payload_len > sizeof(block->payload)) {
+		LOG_ERR("Block %u too large, %u bytes", block->num, payload_len);
+		ret = -EMSGSIZE;
+		goto fail;
+	}
+
+	memcpy(block->payload, payload, payload_len);
+	block->len = payload_len;
+	block->code = coap_header_get_code(response);
+	block->last = block_option < 0 || !GET_MORE(block_option);
+	block->received = true;
+
+	if (block2_window_deliver(internal_req)) {
+		internal_req->request_ongoing = false;
+		block2_window_reset(internal_req);
+		return 0;
+	}
+
+	ret = block2_window_fill(client, internal_req);
+	if (ret == 0) {
+		return 1;
+	}
+
+fail:
+	report_callback_error(internal_req, ret);
+	internal_req->request_ongoing = false;
+	block2_window_reset(internal_req);
+
+	return ret;
+}
+#endif /* CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1 */
+
 static int handle_response(struct coap_client *client, const struct coap_packet *response)
 {
 	int ret = 0;
@@ -621,6 +948,15 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 	bool blockwise_transfer = false;
 	bool last_block = false;
 	struct coap_client_internal_request *internal_req;
+#if CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1
+	struct coap_client_block2_request *block;
+
+	/* Blocks requested ahead have tokens of their own */
+	block = get_block2_request(client, response, &internal_req);
+	if (block != NULL) {
+		return handle_block2_response(client, internal_req, block, response);
+	}
+#endif
 
 	/* Handle different types, ACK might be separate or piggybacked
 	 * CON and NCON contains a separate response, CON needs an empty response
@@ -777,6 +1113,19 @@ static int handle_response(struct coap_client *client, const struct coap_packet
 
 	/* If this wasn't last block, send the next request */
 	if (blockwise_transfer && !last_block) {
+#if CONFIG_COAP_CLIENT_BLOCK2_WINDOW > 1
+		if (block2_window_usable(internal_req)) {
+			internal_req->block2_next = internal_req->recv_blk_ctx.current /
+				coap_block_size_to_bytes(internal_req->recv_blk_ctx.block_size);
+
+			ret = block2_window_fill(client, internal_req);
+			if (ret < 0) {
+				goto fail;
+			}
+
+			return 1;
+		}
+#endif
 		k_mutex_lock(&client->send_mutex, K_FOREVER);
 		ret = coap_client_init_request(client, &internal_req->coap_request, internal_req,
 					       false);
@@ -12,11 +12,13 @@ LOG_MODULE_DECLARE(net_coap, CONFIG_COAP_LOG_LEVEL);
 
 #include <zephyr/init.h>
 #include <zephyr/kernel.h>
+#include <zephyr/net/buf.h>
 #include <zephyr/net/coap.h>
 #include <zephyr/net/coap_link_format.h>
 #include <zephyr/net/coap_mgmt.h>
 #include <zephyr/net/coap_service.h>
 #include <zephyr/posix/fcntl.h>
+#include <zephyr/sys/hash_function.h>
 
 #if defined(CONFIG_NET_TC_THREAD_COOPERATIVE)
 /* Lowest priority cooperative thread */
@@ -81,6 +83,374 @@ static inline void coap_server_free(void *ptr)
 #endif
 }
 
+/* Free the data of a pending message, either a copy or a network buffer */
+static void coap_service_pending_free(struct coap_service_data *data,
+				      struct coap_pending *pending)
+{
+	struct net_buf **buf = &data->pending_buf[pending - data->pending];
+
+	if (*buf != NULL) {
+		net_buf_unref(*buf);
+		*buf = NULL;
+	} else {
+		coap_server_free(pending->data);
+	}
+}
+
+#if CONFIG_COAP_SERVICE_HASH_SIZE > 0
+
+#define HASH_SIZE      CONFIG_COAP_SERVICE_HASH_SIZE
+#define WHEEL_SLOTS    CONFIG_COAP_SERVICE_TIMER_WHEEL_SLOTS
+#define WHEEL_TICK     CONFIG_COAP_SERVICE_TIMER_WHEEL_TICK
+
+BUILD_ASSERT(MAX_OBSERVERS < UINT16_MAX && MAX_PENDINGS < UINT16_MAX,
+	     "Too many observers or pending messages to index");
+
+/* Removes ref from the chain starting at head, linked through next */
+static void chain_remove(uint16_t *head, uint16_t *next, uint16_t ref)
+{
+	while (*head != 0) {
+		if (*head == ref) {
+			*head = next[ref - 1];
+			return;
+		}
+
+		head = &next[*head - 1];
+	}
+}
+
+static inline uint32_t observer_bucket(const uint8_t *token, uint8_t tkl)
+{
+	return sys_hash32(token, tkl) % HASH_SIZE;
+}
+
+static struct coap_observer *coap_service_observer_add(struct coap_service_data *data,
+						     const struct coap_packet *request,
+						     const struct sockaddr *addr)
+{
+	struct coap_service_index *idx = &data->index;
+	struct coap_observer *observer;
+	uint32_t bucket;
+	uint16_t ref;
+
+	if (idx->observer_free != 0) {
+		ref = idx->observer_free;
+		idx->observer_free = idx->observer_next[ref - 1];
+	} else if (idx->observers_used < MAX_OBSERVERS) {
+		ref = ++idx->observers_used;
+	} else {
+		return NULL;
+	}
+
+	observer = &data->observers[ref - 1];
+	coap_observer_init(observer, request, addr);
+
+	bucket = observer_bucket(observer->token, observer->tkl);
+	idx->observer_next[ref - 1] = idx->observer_bucket[bucket];
+	idx->observer_bucket[bucket] = ref;
+
+	return observer;
+}
+
+static void coap_service_observer_release(struct coap_service_data *data,
+					  struct coap_observer *observer)
+{
+	struct coap_service_index *idx = &data->index;
+	uint16_t ref = observer - data->observers + 1;
+
+	chain_remove(&idx->observer_bucket[observer_bucket(observer->token, observer->tkl)],
+		     idx->observer_next, ref);
+	memset(observer, 0, sizeof(*observer));
+
+	idx->observer_next[ref - 1] = idx->observer_free;
+	idx->observer_free = ref;
+}
+
+/* Finds an observer by token, and by address too if addr is given */
+static struct coap_observer *coap_service_find_observer(struct coap_service_data *data,
+						      const struct sockaddr *addr,
+						      const uint8_t *token, uint8_t tkl)
+{
+	struct coap_service_index *idx = &data->index;
+
+	if (tkl == 0U || tkl > COAP_TOKEN_MAX_LEN) {
+		return NULL;
+	}
+
+	for (uint16_t ref = idx->observer_bucket[observer_bucket(token, tkl)]; ref != 0;
+	     ref = idx->observer_next[ref - 1]) {
+		struct coap_observer *o = &data->observers[ref - 1];
+
+		if (addr != NULL ? coap_find_observer(o, 1, addr, token, tkl) != NULL
+				 : coap_find_observer_by_token(o, 1, token, tkl) != NULL) {
+			return o;
+		}
+	}
+
+	return NULL;
+}
+
+static struct coap_pending *coap_service_pending_alloc(struct coap_service_data *data)
+{
+	struct coap_service_index *idx = &data->index;
+	uint16_t ref;
+
+	if (idx->pending_free != 0) {
+		ref = idx->pending_free;
+		idx->pending_free = idx->pending_next[ref - 1];
+	} else if (idx->pendings_used < MAX_PENDINGS) {
+		ref = ++idx->pendings_used;
+	} else {
+		return NULL;
+	}
+
+	return &data->pending[ref - 1];
+}
+
+static void coap_service_pending_schedule(struct coap_service_data *data,
+					  struct coap_pending *pending)
+{
+	struct coap_service_index *idx = &data->index;
+	uint16_t ref = pending - data->pending + 1;
+	int64_t tick = (pending->t0 + pending->timeout) / WHEEL_TICK;
+	uint16_t slot;
+
+	if (idx->wheel_count++ == 0) {
+		idx->wheel_tick = k_uptime_get() / WHEEL_TICK;
+	}
+
+	/* Overdue messages go to the slot checked next */
+	slot = MAX(tick, idx->wheel_tick) % WHEEL_SLOTS;
+
+	idx->wheel_next[ref - 1] = idx->wheel[slot];
+	idx->wheel[slot] = ref;
+	idx->wheel_slot[ref - 1] = slot + 1;
+}
+
+static void coap_service_pending_unschedule(struct coap_service_data *data,
+					    struct coap_pending *pending)
+{
+	struct coap_service_index *idx = &data->index;
+	uint16_t ref = pending - data->pending + 1;
+	uint16_t slot = idx->wheel_slot[ref - 1];
+
+	if (slot == 0) {
+		return;
+	}
+
+	chain_remove(&idx->wheel[slot - 1], idx->wheel_next, ref);
+	idx->wheel_slot[ref - 1] = 0;
+	idx->wheel_count--;
+}
+
+/* Starts tracking a pending message after its first transmission */
+static void coap_service_pending_add(struct coap_service_data *data,
+				     struct coap_pending *pending)
+{
+	struct coap_service_index *idx = &data->index;
+	uint16_t ref = pending - data->pending + 1;
+	uint32_t bucket = pending->id % HASH_SIZE;
+
+	idx->pending_next[ref - 1] = idx->pending_bucket[bucket];
+	idx->pending_bucket[bucket] = ref;
+
+	coap_service_pending_schedule(data, pending);
+}
+
+static void coap_service_pending_release(struct coap_service_data *data,
+					 struct coap_pending *pending)
+{
+	struct coap_service_index *idx = &data->index;
+	uint16_t ref = pending - data->pending + 1;
+
+	/* Only messages sent once are tracked */
+	if (pending->timeout != 0) {
+		chain_remove(&idx->pending_bucket[pending->id % HASH_SIZE], idx->pending_next,
+			     ref);
+		coap_service_pending_unschedule(data, pending);
+	}
+
+	coap_pending_clear(pending);
+
+	idx->pending_next[ref - 1] = idx->pending_free;
+	idx->pending_free = ref;
+}
+
+static struct coap_pending *coap_service_pending_received(struct coap_service_data *data,
+							 const struct coap_packet *response)
+{
+	struct coap_service_index *idx = &data->index;
+	uint16_t id = coap_header_get_id(response);
+
+	for (uint16_t ref = idx->pending_bucket[id % HASH_SIZE]; ref != 0;
+	     ref = idx->pending_next[ref - 1]) {
+		if (data->pending[ref - 1].id == id) {
+			return &data->pending[ref - 1];
+		}
+	}
+
+	return NULL;
+}
+
+/* Returns a pending message due at now, taken off the timer wheel */
+static struct coap_pending *coap_service_pending_expired(struct coap_service_data *data,
+							int64_t now)
+{
+	struct coap_service_index *idx = &data->index;
+	int64_t now_tick = now / WHEEL_TICK;
+
+	if (idx->wheel_count == 0) {
+		return NULL;
+	}
+
+	/* Catching up on more than a revolution visits each slot once */
+	if (now_tick - idx->wheel_tick > WHEEL_SLOTS) {
+		idx->wheel_tick = now_tick - WHEEL_SLOTS;
+	}
+
+	while (true) {
+		uint16_t slot = idx->wheel_tick % WHEEL_SLOTS;
+
+		for (uint16_t ref = idx->wheel[slot]; ref != 0; ref = idx->wheel_next[ref - 1]) {
+			struct coap_pending *pending = &data->pending[ref - 1];
+
+			if (pending->t0 + pending->timeout <= now) {
+				coap_service_pending_unschedule(data, pending);
+				return pending;
+			}
+		}
+
+		if (idx->wheel_tick >= now_tick) {
+			return NULL;
+		}
+
+		idx->wheel_tick++;
+	}
+}
+
+/* Returns when to check the timer wheel next, INT64_MAX if it is empty */
+static int64_t coap_service_pending_next_expiry(struct coap_service_data *data)
+{
+	struct coap_service_index *idx = &data->index;
+
+	if (idx->wheel_count == 0) {
+		return INT64_MAX;
+	}
+
+	for (int64_t tick = idx->wheel_tick; tick < idx->wheel_tick + WHEEL_SLOTS; tick++) {
+		int64_t expiry = INT64_MAX;
+
+		for (uint16_t ref = idx->wheel[tick % WHEEL_SLOTS]; ref != 0;
+		     ref = idx->wheel_next[ref - 1]) {
+			struct coap_pending *pending = &data->pending[ref - 1];
+
+			expiry = MIN(expiry, pending->t0 + pending->timeout);
+		}
+
+		if (expiry != INT64_MAX) {
+			/* Messages of a later revolution are skipped when the slot is over */
+			return MIN(expiry, (tick + 1) * WHEEL_TICK);
+		}
+	}
+
+	return INT64_MAX;
+}
+
+#else /* CONFIG_COAP_SERVICE_HASH_SIZE > 0 */
+
+static struct coap_observer *coap_service_observer_add(struct coap_service_data *data,
+						     const struct coap_packet *request,
+						     const struct sockaddr *addr)
+{
+	struct coap_observer *observer;
+
+	observer = coap_observer_next_unused(data->observers, MAX_OBSERVERS);
+	if (observer != NULL) {
+		coap_observer_init(observer, request, addr);
+	}
+
+	return observer;
+}
+
+static void coap_service_observer_release(struct coap_service_data *data,
+					  struct coap_observer *observer)
+{
+	ARG_UNUSED(data);
+
+	memset(observer, 0, sizeof(*observer));
+}
+
+static struct coap_observer *coap_service_find_observer(struct coap_service_data *data,
+						      const struct sockaddr *addr,
+						      const uint8_t *token, uint8_t tkl)
+{
+	if (addr != NULL) {
+		return coap_find_observer(data->observers, MAX_OBSERVERS, addr, token, tkl);
+	}
+
+	return coap_find_observer_by_token(data->observers, MAX_OBSERVERS, token, tkl);
+}
+
+static struct coap_pending *coap_service_pending_alloc(struct coap_service_data *data)
+{
+	return coap_pending_next_unused(data->pending, MAX_PENDINGS);
+}
+
+static void coap_service_pending_schedule(struct coap_service_data *data,
+					  struct coap_pending *pending)
+{
+	ARG_UNUSED(data);
+	ARG_UNUSED(pending);
+}
+
+static void coap_service_pending_add(struct coap_service_data *data,
+				     struct coap_pending *pending)
+{
+	ARG_UNUSED(data);
+	ARG_UNUSED(pending);
+}
+
+static void coap_service_pending_release(struct coap_service_data *data,
+					 struct coap_pending *pending)
+{
+	ARG_UNUSED(data);
+
+	coap_pending_clear(pending);
+}
+
+static struct coap_pending *coap_service_pending_received(struct coap_service_data *data,
+							 const struct coap_packet *response)
+{
+	return coap_pending_received(response, data->pending, MAX_PENDINGS);
+}
+
+static struct coap_pending *coap_service_pending_expired(struct coap_service_data *data,
+							int64_t now)
+{
+	struct coap_pending *pending;
+
+	pending = coap_pending_next_to_expire(data->pending, MAX_PENDINGS);
+	if (pending == NULL || pending->t0 + pending->timeout > now) {
+		return NULL;
+	}
+
+	return pending;
+}
+
+static int64_t coap_service_pending_next_expiry(struct coap_service_data *data)
+{
+	struct coap_pending *pending;
+
+	pending = coap_pending_next_to_expire(data->pending, MAX_PENDINGS);
+	if (pending == NULL) {
+		return INT64_MAX;
+	}
+
+	return pending->t0 + pending->timeout;
+}
+
+#endif /* CONFIG_COAP_SERVICE_HASH_SIZE > 0 */
+
 static int coap_service_remove_observer(const struct coap_service *service,
 					struct coap_resource *resource,
 					const struct sockaddr *addr,
@@ -88,13 +458,9 @@ static int coap_service_remove_observer(const struct coap_service *service,
 {
 	struct coap_observer *obs;
 
-	if (tkl > 0 && addr != NULL) {
-		/* Prefer addr+token to find the observer */
-		obs = coap_find_observer(service->data->observers, MAX_OBSERVERS, addr, token, tkl);
-	} else if (tkl > 0) {
-		/* Then try to to find the observer by token */
-		obs = coap_find_observer_by_token(service->data->observers, MAX_OBSERVERS, token,
-						  tkl);
+	if (tkl > 0) {
+		/* Prefer addr+token to find the observer, then try the token alone */
+		obs = coap_service_find_observer(service->data, addr, token, tkl);
 	} else if (addr != NULL) {
 		obs = coap_find_observer_by_addr(service->data->observers, MAX_OBSERVERS, addr);
 	} else {
@@ -109,12 +475,12 @@ static int coap_service_remove_observer(const struct coap_service *service,
 	if (resource == NULL) {
 		COAP_SERVICE_FOREACH_RESOURCE(service, it) {
 			if (coap_remove_observer(it, obs)) {
-				memset(obs, 0, sizeof(*obs));
+				coap_service_observer_release(service->data, obs);
 				return 1;
 			}
 		}
 	} else if (coap_remove_observer(resource, obs)) {
-		memset(obs, 0, sizeof(*obs));
+		coap_service_observer_release(service->data, obs);
 		return 1;
 	}
 
@@ -170,7 +536,7 @@ static int coap_server_process(int sock_fd)
 
 	type = coap_header_get_type(&request);
 
-	pending = coap_pending_received(&request, service->data->pending, MAX_PENDINGS);
+	pending = coap_service_pending_received(service->data, &request);
 	if (pending) {
 		uint8_t token[COAP_TOKEN_MAX_LEN];
 		uint8_t tkl;
@@ -181,8 +547,8 @@ static int coap_server_process(int sock_fd)
 			coap_service_remove_observer(service, NULL, &client_addr, token, tkl);
 			__fallthrough;
 		case COAP_TYPE_ACK:
-			coap_server_free(pending->data);
-			coap_pending_clear(pending);
+			coap_service_pending_free(service->data, pending);
+			coap_service_pending_release(service->data, pending);
 			break;
 		default:
 			LOG_WRN("Unexpected pending type %d", type);
@@ -256,7 +622,6 @@ unlock:
 static void coap_server_retransmit(void)
 {
 	struct coap_pending *pending;
-	int64_t remaining;
 	int64_t now = k_uptime_get();
 	int ret;
 
@@ -267,32 +632,26 @@ static void coap_server_retransmit(void)
 			continue;
 		}
 
-		pending = coap_pending_next_to_expire(service->data->pending, MAX_PENDINGS);
-		if (pending == NULL) {
-			/* No work to be done */
-			continue;
-		}
-
-		/* Check if the pending request has expired */
-		remaining = pending->t0 + pending->timeout - now;
-		if (remaining > 0) {
-			continue;
-		}
-
-		if (coap_pending_cycle(pending)) {
-			ret = zsock_sendto(service->data->sock_fd, pending->data, pending->len, 0,
-					   &pending->addr, ADDRLEN(&pending->addr));
-			if (ret < 0) {
-				LOG_ERR("Failed to send pending retransmission for %s (%d)",
-					service->name, ret);
+		while ((pending = coap_service_pending_expired(service->data, now)) != NULL) {
+			if (coap_pending_cycle(pending)) {
+				ret = zsock_sendto(service->data->sock_fd, pending->data,
+						   pending->len, 0, &pending->addr,
+						   ADDRLEN(&pending->addr));
+				if (ret < 0) {
+					LOG_ERR("Failed to send pending retransmission for %s (%d)",
+						service->name, ret);
+				}
+				__ASSERT_NO_MSG(ret == pending->len);
+
+				coap_service_pending_schedule(service->data, pending);
+			} else {
+				LOG_WRN("Packet retransmission failed for %s", service->name);
+
+				coap_service_remove_observer(service, NULL, &pending->addr, NULL,
+							     0U);
+				coap_service_pending_free(service->data, pending);
+				coap_service_pending_release(service->data, pending);
 			}
-			__ASSERT_NO_MSG(ret == pending->len);
-		} else {
-			LOG_WRN("Packet retransmission failed for %s", service->name);
-
-			coap_service_remove_observer(service, NULL, &pending->addr, NULL, 0U);
-			coap_server_free(pending->data);
-			coap_pending_clear(pending);
 		}
 	}
 
@@ -301,27 +660,31 @@ static void coap_server_retransmit(void)
 
 static int coap_server_poll_timeout(void)
 {
-	struct coap_pending *pending;
 	int64_t result = INT64_MAX;
+	int64_t expiry;
 	int64_t remaining;
 	int64_t now = k_uptime_get();
 
+	(void)k_mutex_lock(&lock, K_FOREVER);
+
 	COAP_SERVICE_FOREACH(svc) {
 		if (svc->data->sock_fd < -1) {
 			continue;
 		}
 
-		pending = coap_pending_next_to_expire(svc->data->pending, MAX_PENDINGS);
-		if (pending == NULL) {
+		expiry = coap_service_pending_next_expiry(svc->data);
+		if (expiry == INT64_MAX) {
 			continue;
 		}
 
-		remaining = pending->t0 + pending->timeout - now;
+		remaining = expiry - now;
 		if (result > remaining) {
 			result = remaining;
 		}
 	}
 
+	(void)k_mutex_unlock(&lock);
+
 	if (result == INT64_MAX) {
 		return -1;
 	}
@@ -519,9 +882,10 @@ int coap_service_is_running(const struct coap_service *service)
 	return ret;
 }
 
-int coap_service_send(const struct coap_service *service, const struct coap_packet *cpkt,
-		      const struct sockaddr *addr, socklen_t addr_len,
-		      const struct coap_transmission_parameters *params)
+static int coap_service_send_data(const struct coap_service *service,
+				  const struct coap_packet *cpkt, struct net_buf *buf,
+				  const struct sockaddr *addr, socklen_t addr_len,
+				  const struct coap_transmission_parameters *params)
 {
 	int ret;
 
@@ -542,8 +906,7 @@ int coap_service_send(const struct coap_service *service, const struct coap_pack
 	 * try to send.
 	 */
 	if (coap_header_get_type(cpkt) == COAP_TYPE_CON) {
-		struct coap_pending *pending = coap_pending_next_unused(service->data->pending,
-									MAX_PENDINGS);
+		struct coap_pending *pending = coap_service_pending_alloc(service->data);
 
 		if (pending == NULL) {
 			LOG_WRN("No pending message available for %s", service->name);
@@ -553,19 +916,28 @@ int coap_service_send(const struct coap_service *service, const struct coap_pack
 		ret = coap_pending_init(pending, cpkt, addr, params);
 		if (ret < 0) {
 			LOG_WRN("Failed to init pending message for %s (%d)", service->name, ret);
+			coap_service_pending_release(service->data, pending);
 			goto send;
 		}
 
-		/* Replace tracked data with our allocated copy */
-		pending->data = coap_server_alloc(pending->len);
-		if (pending->data == NULL) {
-			LOG_WRN("Failed to allocate pending message data for %s", service->name);
-			coap_pending_clear(pending);
-			goto send;
+		if (buf != NULL) {
+			/* Keep the buffer the message is built in */
+			service->data->pending_buf[pending - service->data->pending] =
+				net_buf_ref(buf);
+		} else {
+			/* Replace tracked data with our allocated copy */
+			pending->data = coap_server_alloc(pending->len);
+			if (pending->data == NULL) {
+				LOG_WRN("Failed to allocate pending message data for %s",
+					service->name);
+				coap_service_pending_release(service->data, pending);
+				goto send;
+			}
+			memcpy(pending->data, cpkt->data, pending->len);
 		}
-		memcpy(pending->data, cpkt->data, pending->len);
 
 		coap_pending_cycle(pending);
+		coap_service_pending_add(service->data, pending);
 
 		/* Trigger event in receive loop to schedule retransmit */
 		coap_server_update_services();
@@ -584,6 +956,26 @@ send:
 	return 0;
 }
 
+int coap_service_send(const struct coap_service *service, const struct coap_packet *cpkt,
+		      const struct sockaddr *addr, socklen_t addr_len,
+		      const struct coap_transmission_parameters *params)
+{
+	return coap_service_send_data(service, cpkt, NULL, addr, addr_len, params);
+}
+
+int coap_service_send_buf(const struct coap_service *service, const struct coap_packet *cpkt,
+			  struct net_buf *buf, const struct sockaddr *addr, socklen_t addr_len,
+			  const struct coap_transmission_parameters *params)
+{
+	if (buf == NULL || cpkt->data != buf->data) {
+		return -EINVAL;
+	}
+
+	buf->len = cpkt->offset;
+
+	return coap_service_send_data(service, cpkt, buf, addr, addr_len, params);
+}
+
 int coap_resource_send(const struct coap_resource *resource, const struct coap_packet *cpkt,
 		       const struct sockaddr *addr, socklen_t addr_len,
 		       const struct coap_transmission_parameters *params)
@@ -598,6 +990,20 @@ int coap_resource_send(const struct coap_resource *resource, const struct coap_p
 	return -ENOENT;
 }
 
+int coap_resource_send_buf(const struct coap_resource *resource, const struct coap_packet *cpkt,
+			   struct net_buf *buf, const struct sockaddr *addr, socklen_t addr_len,
+			   const struct coap_transmission_parameters *params)
+{
+	/* Find owning service */
+	COAP_SERVICE_FOREACH(svc) {
+		if (COAP_SERVICE_HAS_RESOURCE(svc, resource)) {
+			return coap_service_send_buf(svc, cpkt, buf, addr, addr_len, params);
+		}
+	}
+
+	return -ENOENT;
+}
+
 int coap_resource_parse_observe(struct coap_resource *resource, const struct coap_packet *request,
 				const struct sockaddr *addr)
 {
@@ -638,21 +1044,19 @@ int coap_resource_parse_observe(struct coap_resource *resource, const struct coa
 		struct coap_observer *observer;
 
 		/* RFC7641 section 4.1 - Check if the current observer already exists */
-		observer = coap_find_observer(service->data->observers, MAX_OBSERVERS, addr, token,
-					      tkl);
+		observer = coap_service_find_observer(service->data, addr, token, tkl);
 		if (observer != NULL) {
 			/* Client refresh */
 			goto unlock;
 		}
 
 		/* New client */
-		observer = coap_observer_next_unused(service->data->observers, MAX_OBSERVERS);
+		observer = coap_service_observer_add(service->data, request, addr);
 		if (observer == NULL) {
 			ret = -ENOMEM;
 			goto unlock;
 		}
 
-		coap_observer_init(observer, request, addr);
 		coap_register_observer(resource, observer);
 	} else if (ret == 1) {
 		ret = coap_service_remove_observer(service, resource, addr, token, tkl);
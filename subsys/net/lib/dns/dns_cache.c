@@ -5,18 +5,150 @@
  */
 
 #include <zephyr/net/dns_resolve.h>
+#include <zephyr/sys/hash_function.h>
 #include "dns_cache.h"
 
 LOG_MODULE_REGISTER(net_dns_cache, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 
-static void dns_cache_clean(struct dns_cache const *cache);
+void *dns_cache_index_alloc(struct sys_heap *heap, void *mem, size_t bytes, void *ptr,
+			    size_t size)
+{
+	/* Only called by the index, with the cache lock held */
+	if (heap->heap == NULL) {
+		sys_heap_init(heap, mem, bytes);
+	}
 
-int dns_cache_flush(struct dns_cache *cache)
+	if (size == 0) {
+		sys_heap_free(heap, ptr);
+		return NULL;
+	}
+
+	return sys_heap_realloc(heap, ptr, size);
+}
+
+/* Needs to be called when lock is already acquired */
+static void dns_cache_init(struct dns_cache *cache)
 {
-	k_mutex_lock(cache->lock, K_FOREVER);
+	if (cache->initialized) {
+		return;
+	}
+
+	sys_dlist_init(&cache->lru);
+	sys_dlist_init(&cache->free);
+
 	for (size_t i = 0; i < cache->size; i++) {
 		cache->entries[i].in_use = false;
+		sys_dnode_init(&cache->entries[i].node);
+		sys_dlist_append(&cache->free, &cache->entries[i].node);
+	}
+
+	cache->initialized = true;
+}
+
+static uint32_t dns_cache_hash(char const *query)
+{
+	return sys_hash32_murmur3(query, strlen(query));
+}
+
+static struct dns_cache_entry *dns_cache_chain(struct dns_cache *cache, uint32_t hash)
+{
+	uint64_t value;
+
+	if (!sys_hashmap_get(cache->index, hash, &value)) {
+		return NULL;
+	}
+
+	return (struct dns_cache_entry *)(uintptr_t)value;
+}
+
+/* Needs to be called when lock is already acquired */
+static int dns_cache_link(struct dns_cache *cache, struct dns_cache_entry *entry)
+{
+	struct dns_cache_entry *tail = dns_cache_chain(cache, entry->hash);
+	int ret;
+
+	entry->next = NULL;
+
+	if (tail == NULL) {
+		ret = sys_hashmap_insert(cache->index, entry->hash, (uintptr_t)entry, NULL);
+		if (ret < 0) {
+			return ret;
+		}
+	} else {
+		/* Keep the entries of a query in the order they were added */
+		while (tail->next != NULL) {
+			tail = tail->next;
+		}
+
+		tail->next = entry;
+	}
+
+	entry->in_use = true;
+	sys_dlist_remove(&entry->node);
+	sys_dlist_append(&cache->lru, &entry->node);
+
+	return 0;
+}
+
+/* Needs to be called when lock is already acquired */
+static void dns_cache_unlink(struct dns_cache *cache, struct dns_cache_entry *entry)
+{
+	struct dns_cache_entry *head = dns_cache_chain(cache, entry->hash);
+	struct dns_cache_entry *prev = NULL;
+
+	for (struct dns_cache_entry *it = head; it != entry; it = it->next) {
+		__ASSERT_NO_MSG(it != NULL);
+		prev = it;
+	}
+
+	if (prev != NULL) {
+		prev->next = entry->next;
+	} else if (entry->next != NULL) {
+		(void)sys_hashmap_insert(cache->index, entry->hash, (uintptr_t)entry->next, NULL);
+	} else {
+		(void)sys_hashmap_remove(cache->index, entry->hash, NULL);
+	}
+
+	entry->in_use = false;
+	sys_dlist_remove(&entry->node);
+	sys_dlist_append(&cache->free, &entry->node);
+}
+
+/* Needs to be called when lock is already acquired */
+static struct dns_cache_entry *dns_cache_evict(struct dns_cache *cache)
+{
+	struct dns_cache_entry *entry;
+
+	if (!sys_dlist_is_empty(&cache->free)) {
+		return CONTAINER_OF(sys_dlist_peek_head(&cache->free), struct dns_cache_entry,
+				    node);
+	}
+
+	/* Expired entries go first, then the least recently used one */
+	SYS_DLIST_FOR_EACH_CONTAINER(&cache->lru, entry, node) {
+		if (sys_timepoint_expired(entry->expiry)) {
+			NET_DBG("Remove \"%s\"", entry->query);
+			dns_cache_unlink(cache, entry);
+			return entry;
+		}
 	}
+
+	entry = CONTAINER_OF(sys_dlist_peek_head(&cache->lru), struct dns_cache_entry, node);
+
+	NET_DBG("Overwrite \"%s\"", entry->query);
+	dns_cache_unlink(cache, entry);
+
+	return entry;
+}
+
+int dns_cache_flush(struct dns_cache *cache)
+{
+	k_mutex_lock(cache->lock, K_FOREVER);
+
+	sys_hashmap_clear(cache->index, NULL, NULL);
+	cache->initialized = false;
+	dns_cache_init(cache);
+
 	k_mutex_unlock(cache->lock);
 
 	return 0;
@@ -25,9 +157,9 @@ int dns_cache_flush(struct dns_cache *cache)
 int dns_cache_add(struct dns_cache *cache, char const *query, struct dns_addrinfo const *addrinfo,
 		  uint32_t ttl)
 {
-	k_timepoint_t closest_to_expiry = sys_timepoint_calc(K_FOREVER);
-	size_t index_to_replace = 0;
-	bool found_empty = false;
+	struct dns_cache_entry *entry;
+	uint32_t hash;
+	int ret;
 
 	if (cache == NULL || query == NULL || addrinfo == NULL || ttl == 0) {
 		return -EINVAL;
@@ -40,40 +172,55 @@ int dns_cache_add(struct dns_cache *cache, char const *query, struct dns_addrinf
 		return -EINVAL;
 	}
 
+	hash = dns_cache_hash(query);
+
 	k_mutex_lock(cache->lock, K_FOREVER);
 
 	NET_DBG("Add \"%s\" with TTL %" PRIu32, query, ttl);
 
-	dns_cache_clean(cache);
+	dns_cache_init(cache);
 
-	for (size_t i = 0; i < cache->size; i++) {
-		if (!cache->entries[i].in_use) {
-			index_to_replace = i;
-			found_empty = true;
-			break;
-		} else if (sys_timepoint_cmp(closest_to_expiry, cache->entries[i].expiry) > 0) {
-			index_to_replace = i;
-			closest_to_expiry = cache->entries[i].expiry;
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+	/* A fresh answer replaces the entries it was queried for */
+	for (struct dns_cache_entry *it = dns_cache_chain(cache, hash), *next; it != NULL;
+	     it = next) {
+		next = it->next;
+
+		if (it->refreshing && it->data.ai_family == addrinfo->ai_family &&
+		    strcmp(it->query, query) == 0) {
+			dns_cache_unlink(cache, it);
 		}
 	}
-
-	if (!found_empty) {
-		NET_DBG("Overwrite \"%s\"", cache->entries[index_to_replace].query);
+#endif /* CONFIG_DNS_RESOLVER_CACHE_PREFETCH */
+
+	entry = dns_cache_evict(cache);
+
+	strncpy(entry->query, query, CONFIG_DNS_RESOLVER_MAX_QUERY_LEN - 1);
+	entry->query[CONFIG_DNS_RESOLVER_MAX_QUERY_LEN - 1] = '\0';
+	entry->data = *addrinfo;
+	entry->expiry = sys_timepoint_calc(K_SECONDS(ttl));
+	entry->hash = hash;
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+	entry->refresh = sys_timepoint_calc(
+		K_MSEC((uint64_t)ttl * 10U * (100U - CONFIG_DNS_RESOLVER_CACHE_PREFETCH_PERCENT)));
+	entry->hits = 0U;
+	entry->refreshing = false;
+#endif
+
+	ret = dns_cache_link(cache, entry);
+	if (ret < 0) {
+		NET_WARN("Cannot index \"%s\" (%d)", query, ret);
 	}
 
-	strncpy(cache->entries[index_to_replace].query, query,
-		CONFIG_DNS_RESOLVER_MAX_QUERY_LEN - 1);
-	cache->entries[index_to_replace].data = *addrinfo;
-	cache->entries[index_to_replace].expiry = sys_timepoint_calc(K_SECONDS(ttl));
-	cache->entries[index_to_replace].in_use = true;
-
 	k_mutex_unlock(cache->lock);
 
-	return 0;
+	return ret;
 }
 
 int dns_cache_remove(struct dns_cache *cache, char const *query)
 {
+	uint32_t hash;
+
 	NET_DBG("Remove all entries with query \"%s\"", query);
 	if (strlen(query) >= CONFIG_DNS_RESOLVER_MAX_QUERY_LEN) {
 		NET_WARN("Query string to big to be processed %u >= "
@@ -82,13 +229,18 @@ int dns_cache_remove(struct dns_cache *cache, char const *query)
 		return -EINVAL;
 	}
 
+	hash = dns_cache_hash(query);
+
 	k_mutex_lock(cache->lock, K_FOREVER);
 
-	dns_cache_clean(cache);
+	dns_cache_init(cache);
 
-	for (size_t i = 0; i < cache->size; i++) {
-		if (cache->entries[i].in_use && strcmp(cache->entries[i].query, query) == 0) {
-			cache->entries[i].in_use = false;
+	for (struct dns_cache_entry *it = dns_cache_chain(cache, hash), *next; it != NULL;
+	     it = next) {
+		next = it->next;
+
+		if (strcmp(it->query, query) == 0) {
+			dns_cache_unlink(cache, it);
 		}
 	}
 
@@ -97,10 +249,12 @@ int dns_cache_remove(struct dns_cache *cache, char const *query)
 	return 0;
 }
 
-int dns_cache_find(struct dns_cache const *cache, const char *query, struct dns_addrinfo *addrinfo,
-		   size_t addrinfo_array_len)
+static int dns_cache_lookup(struct dns_cache *cache, const char *query, sa_family_t family,
+			    struct dns_addrinfo *addrinfo, size_t addrinfo_array_len,
+			    bool *prefetch)
 {
 	size_t found = 0;
+	uint32_t hash;
 
 	NET_DBG("Find \"%s\"", query);
 	if (cache == NULL || query == NULL || addrinfo == NULL || addrinfo_array_len <= 0) {
@@ -113,27 +267,67 @@ int dns_cache_find(struct dns_cache const *cache, const char *query, struct dns_
 		return -EINVAL;
 	}
 
+	hash = dns_cache_hash(query);
+
 	k_mutex_lock(cache->lock, K_FOREVER);
 
-	dns_cache_clean(cache);
+	dns_cache_init(cache);
 
-	for (size_t i = 0; i < cache->size; i++) {
-		if (!cache->entries[i].in_use) {
+	for (struct dns_cache_entry *it = dns_cache_chain(cache, hash), *next; it != NULL;
+	     it = next) {
+		next = it->next;
+
+		if (it->hash != hash || strcmp(it->query, query) != 0) {
 			continue;
 		}
-		if (strcmp(cache->entries[i].query, query) != 0) {
+
+		if (sys_timepoint_expired(it->expiry)) {
+			NET_DBG("Remove \"%s\"", it->query);
+			dns_cache_unlink(cache, it);
 			continue;
 		}
+
+		sys_dlist_remove(&it->node);
+		sys_dlist_append(&cache->lru, &it->node);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+		if (it->hits < UINT16_MAX) {
+			it->hits++;
+		}
+
+		if (prefetch != NULL && !it->refreshing && it->data.ai_family == family &&
+		    it->hits >= CONFIG_DNS_RESOLVER_CACHE_PREFETCH_HITS &&
+		    sys_timepoint_expired(it->refresh)) {
+			*prefetch = true;
+		}
+#endif /* CONFIG_DNS_RESOLVER_CACHE_PREFETCH */
+
 		if (found >= addrinfo_array_len) {
 			NET_WARN("Found \"%s\" but not enough space in provided buffer.", query);
 			found++;
 		} else {
-			addrinfo[found] = cache->entries[i].data;
+			addrinfo[found] = it->data;
 			found++;
 			NET_DBG("Found \"%s\"", query);
 		}
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+	if (prefetch != NULL && *prefetch) {
+		NET_DBG("Refresh \"%s\"", query);
+
+		for (struct dns_cache_entry *it = dns_cache_chain(cache, hash); it != NULL;
+		     it = it->next) {
+			if (it->data.ai_family == family && strcmp(it->query, query) == 0) {
+				it->refreshing = true;
+			}
+		}
+	}
+#else
+	ARG_UNUSED(family);
+	ARG_UNUSED(prefetch);
+#endif /* CONFIG_DNS_RESOLVER_CACHE_PREFETCH */
+
 	k_mutex_unlock(cache->lock);
 
 	if (found > addrinfo_array_len) {
@@ -146,17 +340,19 @@ int dns_cache_find(struct dns_cache const *cache, const char *query, struct dns_
 	return found;
 }
 
-/* Needs to be called when lock is already acquired */
-static void dns_cache_clean(struct dns_cache const *cache)
+int dns_cache_find(struct dns_cache *cache, const char *query, struct dns_addrinfo *addrinfo,
+		   size_t addrinfo_array_len)
 {
-	for (size_t i = 0; i < cache->size; i++) {
-		if (!cache->entries[i].in_use) {
-			continue;
-		}
+	return dns_cache_lookup(cache, query, AF_UNSPEC, addrinfo, addrinfo_array_len, NULL);
+}
 
-		if (sys_timepoint_expired(cache->entries[i].expiry)) {
-			NET_DBG("Remove \"%s\"", cache->entries[i].query);
-			cache->entries[i].in_use = false;
-		}
-	}
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+int dns_cache_find_prefetch(struct dns_cache *cache, const char *query, sa_family_t family,
+			    struct dns_addrinfo *addrinfo, size_t addrinfo_array_len,
+			    bool *prefetch)
+{
+	*prefetch = false;
+
+	return dns_cache_lookup(cache, query, family, addrinfo, addrinfo_array_len, prefetch);
 }
+#endif /* CONFIG_DNS_RESOLVER_CACHE_PREFETCH */
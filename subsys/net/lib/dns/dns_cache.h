@@ -17,11 +17,24 @@
 #include <zephyr/net/dns_resolve.h>
 #include <zephyr/kernel.h>
 #include <zephyr/sys_clock.h>
+#include <zephyr/sys/dlist.h>
+#include <zephyr/sys/hash_map.h>
+#include <zephyr/sys/sys_heap.h>
 
 struct dns_cache_entry {
 	char query[CONFIG_DNS_RESOLVER_MAX_QUERY_LEN];
 	struct dns_addrinfo data;
 	k_timepoint_t expiry;
+	/** Node in the LRU list while in use, in the free list otherwise */
+	sys_dnode_t node;
+	/** Next entry with the same query hash */
+	struct dns_cache_entry *next;
+	uint32_t hash;
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+	k_timepoint_t refresh;
+	uint16_t hits;
+	bool refreshing;
+#endif
 	bool in_use;
 };
 
@@ -29,8 +42,31 @@ struct dns_cache {
 	size_t size;
 	struct dns_cache_entry *entries;
 	struct k_mutex *lock;
+	/** Query hash to first entry with that hash */
+	struct sys_hashmap *index;
+	/** Entries in use, least recently used first */
+	sys_dlist_t lru;
+	sys_dlist_t free;
+	bool initialized;
 };
 
+/**
+ * @brief Size of the heap backing the index of a cache.
+ *
+ * Covers one hashmap node per entry and the bucket array while it is
+ * being resized, including allocation overhead.
+ *
+ * @param cache_size Number of entries of the cache.
+ */
+#define DNS_CACHE_INDEX_HEAP_SIZE(cache_size)                                                      \
+	(Z_HEAP_MIN_SIZE + 64 + (cache_size) * (3 * sizeof(uint64_t) + 18 * sizeof(void *)))
+
+/**
+ * @brief Allocator of the index of a cache. Used by DNS_CACHE_DEFINE().
+ */
+void *dns_cache_index_alloc(struct sys_heap *heap, void *mem, size_t bytes, void *ptr,
+			    size_t size);
+
 /**
  * @brief Statically define and initialize a DNS queue.
  *
@@ -43,8 +79,18 @@ struct dns_cache {
 #define DNS_CACHE_DEFINE(name, cache_size)                                                         \
 	static K_MUTEX_DEFINE(name##_mutex);                                                       \
 	static struct dns_cache_entry name##_entries[cache_size];                                  \
+	static uint8_t name##_heap_mem[DNS_CACHE_INDEX_HEAP_SIZE(cache_size)] __aligned(8);        \
+	static struct sys_heap name##_heap;                                                        \
+	static void *name##_alloc(void *ptr, size_t size)                                          \
+	{                                                                                          \
+		return dns_cache_index_alloc(&name##_heap, name##_heap_mem,                        \
+					     sizeof(name##_heap_mem), ptr, size);                  \
+	}                                                                                          \
+	SYS_HASHMAP_SC_DEFINE_STATIC_ADVANCED(name##_index, sys_hash32_identity, name##_alloc,     \
+		SYS_HASHMAP_CONFIG(cache_size, SYS_HASHMAP_DEFAULT_LOAD_FACTOR));                  \
 	static struct dns_cache name = {                                                           \
-		.entries = name##_entries, .size = cache_size, .lock = &name##_mutex};
+		.entries = name##_entries, .size = cache_size, .lock = &name##_mutex,              \
+		.index = &name##_index};
 
 /**
  * @brief Flushes the dns cache removing all its entries.
@@ -56,8 +102,8 @@ struct dns_cache {
 int dns_cache_flush(struct dns_cache *cache);
 
 /**
- * @brief Adds a new entry to the dns cache removing the one closest to expiry
- * if no free space is available.
+ * @brief Adds a new entry to the dns cache removing an expired entry, or else
+ * the least recently used one, if no free space is available.
  *
  * @param cache Cache where the entry should be added.
  * @param query Query which should be persisted in the cache.
@@ -94,7 +140,31 @@ int dns_cache_remove(struct dns_cache *cache, char const *query);
  * -ENOSR means there was not enough space in the addrinfo array to accommodate all cache hits the
  * array will however be filled with valid data.
  */
-int dns_cache_find(struct dns_cache const *cache, const char *query, struct dns_addrinfo *addrinfo,
+int dns_cache_find(struct dns_cache *cache, const char *query, struct dns_addrinfo *addrinfo,
 		   size_t addrinfo_array_len);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+/**
+ * @brief Tries to find the specified query entry within the cache and checks
+ * whether it should be refreshed.
+ *
+ * Works like dns_cache_find(). In addition, if entries of the given family were
+ * found often enough and are close to expiry, they are marked as being refreshed
+ * and @p prefetch is set. The caller is then expected to resolve the query for
+ * that family again. The first entry added for the query and family afterwards
+ * replaces the marked ones.
+ *
+ * @param cache Cache where the entry should be searched.
+ * @param query Query which should be searched for.
+ * @param family Address family the query is resolved for.
+ * @param addrinfo dns_addrinfo array which will be written if the query was found.
+ * @param addrinfo_array_len Array size of the dns_addrinfo array
+ * @param prefetch Set to true if the query should be resolved again, false otherwise.
+ * @retval Same as for dns_cache_find().
+ */
+int dns_cache_find_prefetch(struct dns_cache *cache, const char *query, sa_family_t family,
+			    struct dns_addrinfo *addrinfo, size_t addrinfo_array_len,
+			    bool *prefetch);
+#endif /* CONFIG_DNS_RESOLVER_CACHE_PREFETCH */
+
 #endif /* ZEPHYR_INCLUDE_NET_DNS_CACHE_H_ */
@@ -1111,13 +1111,99 @@ static void query_timeout(struct k_work *work)
 	k_mutex_unlock(&pending_query->ctx->lock);
 }
 
-int dns_resolve_name(struct dns_resolve_context *ctx,
-		     const char *query,
-		     enum dns_query_type type,
-		     uint16_t *dns_id,
-		     dns_resolve_cb_t cb,
-		     void *user_data,
-		     int32_t timeout)
+static int dns_resolve_name_internal(struct dns_resolve_context *ctx,
+				     const char *query,
+				     enum dns_query_type type,
+				     uint16_t *dns_id,
+				     dns_resolve_cb_t cb,
+				     void *user_data,
+				     int32_t timeout,
+				     bool use_cache);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+static struct dns_prefetch {
+	char query[CONFIG_DNS_RESOLVER_MAX_QUERY_LEN];
+	bool in_use;
+} dns_prefetch[CONFIG_DNS_RESOLVER_CACHE_PREFETCH_QUERIES];
+
+static sa_family_t dns_prefetch_family(enum dns_query_type type)
+{
+	if (type == DNS_QUERY_TYPE_A) {
+		return AF_INET;
+	}
+
+	if (type == DNS_QUERY_TYPE_AAAA) {
+		return AF_INET6;
+	}
+
+	return AF_UNSPEC;
+}
+
+static void dns_prefetch_cb(enum dns_resolve_status status,
+			    struct dns_addrinfo *info,
+			    void *user_data)
+{
+	struct dns_prefetch *prefetch = user_data;
+
+	ARG_UNUSED(info);
+
+	/* The answers are added to the cache while the response is parsed */
+	if (status != DNS_EAI_INPROGRESS) {
+		prefetch->in_use = false;
+	}
+}
+
+/* Resolve a cached query again in the background. The query string of the
+ * caller may go away before the answer arrives, so it is copied into one
+ * of the prefetch slots.
+ */
+static void dns_prefetch_start(struct dns_resolve_context *ctx,
+			       const char *query,
+			       enum dns_query_type type,
+			       int32_t timeout)
+{
+	struct dns_prefetch *prefetch = NULL;
+	int ret;
+
+	k_mutex_lock(&ctx->lock, K_FOREVER);
+
+	ARRAY_FOR_EACH(dns_prefetch, i) {
+		if (!dns_prefetch[i].in_use) {
+			prefetch = &dns_prefetch[i];
+			break;
+		}
+	}
+
+	if (prefetch == NULL) {
+		NET_DBG("No free prefetch slot for %s", query);
+		goto out;
+	}
+
+	strncpy(prefetch->query, query, sizeof(prefetch->query) - 1);
+	prefetch->query[sizeof(prefetch->query) - 1] = '\0';
+	prefetch->in_use = true;
+
+	ret = dns_resolve_name_internal(ctx, prefetch->query, type, NULL,
+					dns_prefetch_cb, prefetch, timeout,
+					false);
+	if (ret < 0) {
+		NET_DBG("Cannot refresh %s (%d)", query, ret);
+		prefetch->in_use = false;
+	}
+
+out:
+	k_mutex_unlock(&ctx->lock);
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE_PREFETCH */
+
+static int dns_resolve_name_internal(struct dns_resolve_context *ctx,
+				     const char *query,
+				     enum dns_query_type type,
+				     uint16_t *dns_id,
+				     dns_resolve_cb_t cb,
+				     void *user_data,
+				     int32_t timeout,
+				     bool use_cache)
 {
 	k_timeout_t tout;
 	struct net_buf *dns_data = NULL;
@@ -1130,6 +1216,9 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 #ifdef CONFIG_DNS_RESOLVER_CACHE
 	struct dns_addrinfo cached_info[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES] = {0};
 #endif /* CONFIG_DNS_RESOLVER_CACHE */
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+	bool prefetch;
+#endif
 
 	if (!ctx || !query || !cb) {
 		return -EINVAL;
@@ -1192,7 +1281,19 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 
 try_resolve:
 #ifdef CONFIG_DNS_RESOLVER_CACHE
-	ret = dns_cache_find(&dns_cache, query, cached_info, sizeof(cached_info));
+	if (!use_cache) {
+		goto skip_cache;
+	}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+	ret = dns_cache_find_prefetch(&dns_cache, query,
+				      dns_prefetch_family(type),
+				      cached_info, ARRAY_SIZE(cached_info),
+				      &prefetch);
+#else
+	ret = dns_cache_find(&dns_cache, query, cached_info,
+			     ARRAY_SIZE(cached_info));
+#endif
 	if (ret > 0) {
 		/* The query was cached, no
 		 * need to continue further.
@@ -1202,8 +1303,17 @@ try_resolve:
 		}
 		cb(DNS_EAI_ALLDONE, NULL, user_data);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+		if (prefetch) {
+			dns_prefetch_start(ctx, query, type, timeout);
+		}
+#endif
 		return 0;
 	}
+
+skip_cache:
+#else
+	ARG_UNUSED(use_cache);
 #endif /* CONFIG_DNS_RESOLVER_CACHE */
 
 	k_mutex_lock(&ctx->lock, K_FOREVER);
@@ -1348,6 +1458,18 @@ fail:
 	return ret;
 }
 
+int dns_resolve_name(struct dns_resolve_context *ctx,
+		     const char *query,
+		     enum dns_query_type type,
+		     uint16_t *dns_id,
+		     dns_resolve_cb_t cb,
+		     void *user_data,
+		     int32_t timeout)
+{
+	return dns_resolve_name_internal(ctx, query, type, dns_id, cb,
+					 user_data, timeout, true);
+}
+
 /* Must be invoked with context lock held */
 static int dns_resolve_close_locked(struct dns_resolve_context *ctx)
 {
@@ -30,6 +30,8 @@ int handle_http1_request(struct http_client_ctx *client);
 int handle_http1_to_http2_upgrade(struct http_client_ctx *client);
 int handle_http1_to_websocket_upgrade(struct http_client_ctx *client);
 void http_server_release_client(struct http_client_ctx *client);
+int send_http2_pending_data(struct http_client_ctx *client, int max_frames);
+void release_http2_streams(struct http_client_ctx *client);
 
 int enter_http1_request(struct http_client_ctx *client);
 int enter_http2_request(struct http_client_ctx *client);
@@ -37,8 +39,30 @@ int enter_http_done_state(struct http_client_ctx *client);
 
 /* Others */
 struct http_resource_detail *get_resource_detail(const char *path, int *len, bool is_ws);
+int http_server_route_init(void);
+bool http_server_route_ready(void);
+struct http_resource_desc *http_server_route_lookup(const char *path, int *path_len,
+						    bool is_websocket);
 int http_server_sendall(struct http_client_ctx *client, const void *buf, size_t len);
+void http_server_parse_accept_encoding(struct http_client_ctx *client,
+				       const char *value, size_t len);
+void http_server_set_if_none_match(struct http_client_ctx *client,
+				   const char *value, size_t len);
+bool http_server_static_use_gzip(struct http_client_ctx *client,
+				 struct http_resource_detail_static *detail);
+const char *http_server_static_etag(struct http_client_ctx *client,
+				    struct http_resource_detail_static *detail,
+				    char *buf, size_t size);
+bool http_server_static_not_modified(struct http_client_ctx *client,
+				     const char *etag);
+struct fs_file_t;
+int http_server_sendfile(struct http_client_ctx *client, struct fs_file_t *file,
+			 size_t len);
 void http_client_timer_restart(struct http_client_ctx *client);
+bool http_server_dynamic_claim(struct http_resource_detail_dynamic *detail,
+			       struct http_client_ctx *client);
+bool http_server_dynamic_release(struct http_resource_detail_dynamic *detail,
+				 struct http_client_ctx *client);
 
 /* TODO Could be static, but currently used in tests. */
 int parse_http_frame_header(struct http_client_ctx *client);
@@ -468,7 +468,7 @@ static int hpack_integer_encode(uint8_t *buf, size_t buflen, int value,
 			return -ENOBUFS;
 		}
 
-		*buf = (uint8_t)((value % 128) + 128);
+		*buf++ = (uint8_t)((value % 128) + 128);
 		len++;
 		value /= 128;
 	}
@@ -532,14 +532,16 @@ static int hpack_string_encode(uint8_t *buf, size_t buflen,
 	return len;
 }
 
-static int hpack_encode_literal(uint8_t *buf, size_t buflen,
+/* Literal header field, with the name taken from the table when index is
+ * non-zero (RFC7541, ch 6.2).
+ */
+static int hpack_encode_literal(uint8_t *buf, size_t buflen, uint8_t prefix,
+				uint8_t n, int index,
 				struct http_hpack_header_buf *header)
 {
 	int ret, len = 0;
 
-	ret = hpack_integer_encode(buf, buflen, 0,
-				   HPACK_PREFIX_LITERAL_NEVER_INDEXED,
-				   HPACK_PREFIX_LEN_LITERAL_NEVER_INDEXED);
+	ret = hpack_integer_encode(buf, buflen, index, prefix, n);
 	if (ret < 0) {
 		return ret;
 	}
@@ -548,41 +550,17 @@ static int hpack_encode_literal(uint8_t *buf, size_t buflen,
 	buflen -= ret;
 	len += ret;
 
-	ret = hpack_string_encode(buf, buflen, HPACK_HEADER_NAME, header);
-	if (ret < 0) {
-		return ret;
-	}
-
-	buf += ret;
-	buflen -= ret;
-	len += ret;
-
-	ret = hpack_string_encode(buf, buflen, HPACK_HEADER_VALUE, header);
-	if (ret < 0) {
-		return ret;
-	}
-
-	len += ret;
-
-	return len;
-}
-
-static int hpack_encode_literal_value(uint8_t *buf, size_t buflen, int index,
-				      struct http_hpack_header_buf *header)
-{
-	int ret, len = 0;
+	if (index == 0) {
+		ret = hpack_string_encode(buf, buflen, HPACK_HEADER_NAME, header);
+		if (ret < 0) {
+			return ret;
+		}
 
-	ret = hpack_integer_encode(buf, buflen, index,
-				   HPACK_PREFIX_LITERAL_NEVER_INDEXED,
-				   HPACK_PREFIX_LEN_LITERAL_NEVER_INDEXED);
-	if (ret < 0) {
-		return ret;
+		buf += ret;
+		buflen -= ret;
+		len += ret;
 	}
 
-	buf += ret;
-	buflen -= ret;
-	len += ret;
-
 	ret = hpack_string_encode(buf, buflen, HPACK_HEADER_VALUE, header);
 	if (ret < 0) {
 		return ret;
@@ -618,10 +596,16 @@ int http_hpack_encode_header(uint8_t *buf, size_t buflen,
 	ret = http_hpack_find_index(header, &name_only);
 	if (ret < 0) {
 		/* All literal */
-		len = hpack_encode_literal(buf, buflen, header);
+		len = hpack_encode_literal(buf, buflen,
+					   HPACK_PREFIX_LITERAL_NEVER_INDEXED,
+					   HPACK_PREFIX_LEN_LITERAL_NEVER_INDEXED,
+					   0, header);
 	} else if (name_only) {
 		/* Literal value */
-		len = hpack_encode_literal_value(buf, buflen, ret, header);
+		len = hpack_encode_literal(buf, buflen,
+					   HPACK_PREFIX_LITERAL_NEVER_INDEXED,
+					   HPACK_PREFIX_LEN_LITERAL_NEVER_INDEXED,
+					   ret, header);
 	} else {
 		/* Indexed */
 		len = hpack_encode_indexed(buf, buflen, ret);
@@ -629,3 +613,211 @@ int http_hpack_encode_header(uint8_t *buf, size_t buflen,
 
 	return len;
 }
+
+/* Dynamic table of the encoder (RFC7541, ch 2.3.2 and 4). Entries are kept
+ * newest first in a flat buffer, so an entry index is its position in the
+ * buffer walk. The tables are small, a linear lookup is cheaper than keeping
+ * a hash next to them.
+ */
+#define HPACK_DEFAULT_TABLE_SIZE   4096
+#define HPACK_ENTRY_OVERHEAD       32
+#define HPACK_ENTRY_HEADER_LEN     2
+#define HPACK_DYNAMIC_INDEX_FIRST  (HTTP_SERVER_HPACK_WWW_AUTHENTICATE + 1)
+
+static size_t hpack_entry_size(size_t name_len, size_t value_len)
+{
+	return name_len + value_len + HPACK_ENTRY_OVERHEAD;
+}
+
+/* Evict the oldest entries until an entry of the given size fits. */
+static void hpack_encoder_evict(struct http_hpack_encoder *encoder,
+				size_t needed)
+{
+	uint16_t offset = 0;
+	uint16_t size = 0;
+	uint8_t count = 0;
+	size_t entry_size;
+	uint8_t *entry;
+
+	while (count < encoder->count) {
+		entry = &encoder->table[offset];
+		entry_size = hpack_entry_size(entry[0], entry[1]);
+
+		if (size + entry_size + needed > encoder->max_size) {
+			break;
+		}
+
+		size += entry_size;
+		offset += HPACK_ENTRY_HEADER_LEN + entry[0] + entry[1];
+		count++;
+	}
+
+	encoder->table_len = offset;
+	encoder->size = size;
+	encoder->count = count;
+}
+
+static bool hpack_encoder_can_insert(struct http_hpack_encoder *encoder,
+				     struct http_hpack_header_buf *header)
+{
+	return header->name_len <= UINT8_MAX && header->value_len <= UINT8_MAX &&
+	       hpack_entry_size(header->name_len, header->value_len) <=
+	       encoder->max_size;
+}
+
+static void hpack_encoder_insert(struct http_hpack_encoder *encoder,
+				 struct http_hpack_header_buf *header)
+{
+	size_t entry_len = HPACK_ENTRY_HEADER_LEN + header->name_len +
+			   header->value_len;
+	uint8_t *entry = encoder->table;
+
+	hpack_encoder_evict(encoder, hpack_entry_size(header->name_len,
+						      header->value_len));
+
+	/* The table buffer is never smaller than max_size, and every entry
+	 * takes less buffer space than it adds to the table size.
+	 */
+	memmove(entry + entry_len, entry, encoder->table_len);
+
+	entry[0] = header->name_len;
+	entry[1] = header->value_len;
+	memcpy(&entry[HPACK_ENTRY_HEADER_LEN], header->name, header->name_len);
+	memcpy(&entry[HPACK_ENTRY_HEADER_LEN + header->name_len], header->value,
+	       header->value_len);
+
+	encoder->table_len += entry_len;
+	encoder->size += hpack_entry_size(header->name_len, header->value_len);
+	encoder->count++;
+}
+
+static int hpack_encoder_find_index(struct http_hpack_encoder *encoder,
+				    struct http_hpack_header_buf *header,
+				    bool *name_only)
+{
+	const uint8_t *entry = encoder->table;
+	int candidate = -1;
+
+	for (int i = 0; i < encoder->count; i++) {
+		if (entry[0] == header->name_len &&
+		    memcmp(&entry[HPACK_ENTRY_HEADER_LEN], header->name,
+			   header->name_len) == 0) {
+			if (entry[1] == header->value_len &&
+			    memcmp(&entry[HPACK_ENTRY_HEADER_LEN + entry[0]],
+				   header->value, header->value_len) == 0) {
+				*name_only = false;
+				return HPACK_DYNAMIC_INDEX_FIRST + i;
+			}
+
+			if (candidate < 0) {
+				candidate = HPACK_DYNAMIC_INDEX_FIRST + i;
+			}
+		}
+
+		entry += HPACK_ENTRY_HEADER_LEN + entry[0] + entry[1];
+	}
+
+	if (candidate > 0) {
+		*name_only = true;
+		return candidate;
+	}
+
+	return -ENOENT;
+}
+
+void http_hpack_encoder_init(struct http_hpack_encoder *encoder)
+{
+	memset(encoder, 0, sizeof(*encoder));
+
+	/* The peer starts with the default table size, so a smaller table is
+	 * signaled in the first header block.
+	 */
+	encoder->max_size = MIN(sizeof(encoder->table), HPACK_DEFAULT_TABLE_SIZE);
+	encoder->size_update = encoder->max_size != HPACK_DEFAULT_TABLE_SIZE;
+}
+
+void http_hpack_encoder_set_max_size(struct http_hpack_encoder *encoder,
+				     uint32_t max_size)
+{
+	max_size = MIN(sizeof(encoder->table), max_size);
+	if (max_size == encoder->max_size) {
+		return;
+	}
+
+	encoder->max_size = max_size;
+	encoder->size_update = true;
+	hpack_encoder_evict(encoder, 0);
+}
+
+int http_hpack_encoder_encode(struct http_hpack_encoder *encoder,
+			      uint8_t *buf, size_t buflen,
+			      struct http_hpack_header_buf *header)
+{
+	bool static_name_only = false;
+	bool name_only = false;
+	int static_index;
+	int ret, len = 0;
+	int index;
+
+	if (encoder == NULL || buf == NULL || header == NULL ||
+	    header->name == NULL || header->name_len == 0 ||
+	    header->value == NULL || header->value_len == 0) {
+		return -EINVAL;
+	}
+
+	if (encoder->size_update) {
+		ret = hpack_integer_encode(buf, buflen, encoder->max_size,
+					   HPACK_PREFIX_DYNAMIC_TABLE_SIZE_UPDATE,
+					   HPACK_PREFIX_LEN_DYNAMIC_TABLE_SIZE_UPDATE);
+		if (ret < 0) {
+			return ret;
+		}
+
+		buf += ret;
+		buflen -= ret;
+		len += ret;
+	}
+
+	static_index = http_hpack_find_index(header, &static_name_only);
+	if (static_index > 0 && !static_name_only) {
+		ret = hpack_encode_indexed(buf, buflen, static_index);
+		goto out;
+	}
+
+	index = hpack_encoder_find_index(encoder, header, &name_only);
+	if (index > 0 && !name_only) {
+		ret = hpack_encode_indexed(buf, buflen, index);
+		goto out;
+	}
+
+	/* Prefer the static name index, it never gets evicted */
+	if (static_index > 0) {
+		index = static_index;
+	} else if (index < 0) {
+		index = 0;
+	}
+
+	if (!hpack_encoder_can_insert(encoder, header)) {
+		ret = hpack_encode_literal(buf, buflen,
+					   HPACK_PREFIX_LITERAL_NEVER_INDEXED,
+					   HPACK_PREFIX_LEN_LITERAL_NEVER_INDEXED,
+					   index, header);
+		goto out;
+	}
+
+	ret = hpack_encode_literal(buf, buflen, HPACK_PREFIX_LITERAL_INDEXING,
+				   HPACK_PREFIX_LEN_LITERAL_INDEXING, index,
+				   header);
+	if (ret >= 0) {
+		hpack_encoder_insert(encoder, header);
+	}
+
+out:
+	if (ret < 0) {
+		return ret;
+	}
+
+	encoder->size_update = false;
+
+	return len + ret;
+}
@@ -8,382 +8,288 @@
 #include <stdint.h>
 
 #include <zephyr/logging/log.h>
-#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
 
 LOG_MODULE_DECLARE(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
 
-struct decode_elem {
-	uint8_t bitlen;
+/* The HPACK Huffman code (RFC 7541, Appendix B) is canonical, codes of the
+ * same length are consecutive numbers and shorter codes sort first. Short
+ * codes are decoded with a single lookup on the next 8 bits of input, the
+ * rest by finding the code length, as the left aligned input is below the
+ * first code of the next length, and indexing the symbols of that length.
+ */
+struct huffman_fast_elem {
 	uint8_t symbol;
-	uint8_t code[4];
+	uint8_t bitlen;
 };
 
-static const struct decode_elem decode_table[] = {
-	{  5,  48, { 0b00000000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  5,  49, { 0b00001000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  5,  50, { 0b00010000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  5,  97, { 0b00011000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  5,  99, { 0b00100000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  5, 101, { 0b00101000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  5, 105, { 0b00110000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  5, 111, { 0b00111000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  5, 115, { 0b01000000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  5, 116, { 0b01001000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  32, { 0b01010000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  37, { 0b01010100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  45, { 0b01011000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  46, { 0b01011100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  47, { 0b01100000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  51, { 0b01100100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  52, { 0b01101000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  53, { 0b01101100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  54, { 0b01110000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  55, { 0b01110100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  56, { 0b01111000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  57, { 0b01111100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  61, { 0b10000000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  65, { 0b10000100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  95, { 0b10001000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6,  98, { 0b10001100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6, 100, { 0b10010000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6, 102, { 0b10010100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6, 103, { 0b10011000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6, 104, { 0b10011100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6, 108, { 0b10100000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6, 109, { 0b10100100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6, 110, { 0b10101000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6, 112, { 0b10101100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6, 114, { 0b10110000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  6, 117, { 0b10110100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  58, { 0b10111000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  66, { 0b10111010, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  67, { 0b10111100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  68, { 0b10111110, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  69, { 0b11000000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  70, { 0b11000010, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  71, { 0b11000100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  72, { 0b11000110, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  73, { 0b11001000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  74, { 0b11001010, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  75, { 0b11001100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  76, { 0b11001110, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  77, { 0b11010000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  78, { 0b11010010, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  79, { 0b11010100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  80, { 0b11010110, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  81, { 0b11011000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  82, { 0b11011010, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  83, { 0b11011100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  84, { 0b11011110, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  85, { 0b11100000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  86, { 0b11100010, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  87, { 0b11100100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7,  89, { 0b11100110, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7, 106, { 0b11101000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7, 107, { 0b11101010, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7, 113, { 0b11101100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7, 118, { 0b11101110, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7, 119, { 0b11110000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7, 120, { 0b11110010, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7, 121, { 0b11110100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  7, 122, { 0b11110110, 0b00000000, 0b00000000, 0b00000000 } },
-	{  8,  38, { 0b11111000, 0b00000000, 0b00000000, 0b00000000 } },
-	{  8,  42, { 0b11111001, 0b00000000, 0b00000000, 0b00000000 } },
-	{  8,  44, { 0b11111010, 0b00000000, 0b00000000, 0b00000000 } },
-	{  8,  59, { 0b11111011, 0b00000000, 0b00000000, 0b00000000 } },
-	{  8,  88, { 0b11111100, 0b00000000, 0b00000000, 0b00000000 } },
-	{  8,  90, { 0b11111101, 0b00000000, 0b00000000, 0b00000000 } },
-	{ 10,  33, { 0b11111110, 0b00000000, 0b00000000, 0b00000000 } },
-	{ 10,  34, { 0b11111110, 0b01000000, 0b00000000, 0b00000000 } },
-	{ 10,  40, { 0b11111110, 0b10000000, 0b00000000, 0b00000000 } },
-	{ 10,  41, { 0b11111110, 0b11000000, 0b00000000, 0b00000000 } },
-	{ 10,  63, { 0b11111111, 0b00000000, 0b00000000, 0b00000000 } },
-	{ 11,  39, { 0b11111111, 0b01000000, 0b00000000, 0b00000000 } },
-	{ 11,  43, { 0b11111111, 0b01100000, 0b00000000, 0b00000000 } },
-	{ 11, 124, { 0b11111111, 0b10000000, 0b00000000, 0b00000000 } },
-	{ 12,  35, { 0b11111111, 0b10100000, 0b00000000, 0b00000000 } },
-	{ 12,  62, { 0b11111111, 0b10110000, 0b00000000, 0b00000000 } },
-	{ 13,   0, { 0b11111111, 0b11000000, 0b00000000, 0b00000000 } },
-	{ 13,  36, { 0b11111111, 0b11001000, 0b00000000, 0b00000000 } },
-	{ 13,  64, { 0b11111111, 0b11010000, 0b00000000, 0b00000000 } },
-	{ 13,  91, { 0b11111111, 0b11011000, 0b00000000, 0b00000000 } },
-	{ 13,  93, { 0b11111111, 0b11100000, 0b00000000, 0b00000000 } },
-	{ 13, 126, { 0b11111111, 0b11101000, 0b00000000, 0b00000000 } },
-	{ 14,  94, { 0b11111111, 0b11110000, 0b00000000, 0b00000000 } },
-	{ 14, 125, { 0b11111111, 0b11110100, 0b00000000, 0b00000000 } },
-	{ 15,  60, { 0b11111111, 0b11111000, 0b00000000, 0b00000000 } },
-	{ 15,  96, { 0b11111111, 0b11111010, 0b00000000, 0b00000000 } },
-	{ 15, 123, { 0b11111111, 0b11111100, 0b00000000, 0b00000000 } },
-	{ 19,  92, { 0b11111111, 0b11111110, 0b00000000, 0b00000000 } },
-	{ 19, 195, { 0b11111111, 0b11111110, 0b00100000, 0b00000000 } },
-	{ 19, 208, { 0b11111111, 0b11111110, 0b01000000, 0b00000000 } },
-	{ 20, 128, { 0b11111111, 0b11111110, 0b01100000, 0b00000000 } },
-	{ 20, 130, { 0b11111111, 0b11111110, 0b01110000, 0b00000000 } },
-	{ 20, 131, { 0b11111111, 0b11111110, 0b10000000, 0b00000000 } },
-	{ 20, 162, { 0b11111111, 0b11111110, 0b10010000, 0b00000000 } },
-	{ 20, 184, { 0b11111111, 0b11111110, 0b10100000, 0b00000000 } },
-	{ 20, 194, { 0b11111111, 0b11111110, 0b10110000, 0b00000000 } },
-	{ 20, 224, { 0b11111111, 0b11111110, 0b11000000, 0b00000000 } },
-	{ 20, 226, { 0b11111111, 0b11111110, 0b11010000, 0b00000000 } },
-	{ 21, 153, { 0b11111111, 0b11111110, 0b11100000, 0b00000000 } },
-	{ 21, 161, { 0b11111111, 0b11111110, 0b11101000, 0b00000000 } },
-	{ 21, 167, { 0b11111111, 0b11111110, 0b11110000, 0b00000000 } },
-	{ 21, 172, { 0b11111111, 0b11111110, 0b11111000, 0b00000000 } },
-	{ 21, 176, { 0b11111111, 0b11111111, 0b00000000, 0b00000000 } },
-	{ 21, 177, { 0b11111111, 0b11111111, 0b00001000, 0b00000000 } },
-	{ 21, 179, { 0b11111111, 0b11111111, 0b00010000, 0b00000000 } },
-	{ 21, 209, { 0b11111111, 0b11111111, 0b00011000, 0b00000000 } },
-	{ 21, 216, { 0b11111111, 0b11111111, 0b00100000, 0b00000000 } },
-	{ 21, 217, { 0b11111111, 0b11111111, 0b00101000, 0b00000000 } },
-	{ 21, 227, { 0b11111111, 0b11111111, 0b00110000, 0b00000000 } },
-	{ 21, 229, { 0b11111111, 0b11111111, 0b00111000, 0b00000000 } },
-	{ 21, 230, { 0b11111111, 0b11111111, 0b01000000, 0b00000000 } },
-	{ 22, 129, { 0b11111111, 0b11111111, 0b01001000, 0b00000000 } },
-	{ 22, 132, { 0b11111111, 0b11111111, 0b01001100, 0b00000000 } },
-	{ 22, 133, { 0b11111111, 0b11111111, 0b01010000, 0b00000000 } },
-	{ 22, 134, { 0b11111111, 0b11111111, 0b01010100, 0b00000000 } },
-	{ 22, 136, { 0b11111111, 0b11111111, 0b01011000, 0b00000000 } },
-	{ 22, 146, { 0b11111111, 0b11111111, 0b01011100, 0b00000000 } },
-	{ 22, 154, { 0b11111111, 0b11111111, 0b01100000, 0b00000000 } },
-	{ 22, 156, { 0b11111111, 0b11111111, 0b01100100, 0b00000000 } },
-	{ 22, 160, { 0b11111111, 0b11111111, 0b01101000, 0b00000000 } },
-	{ 22, 163, { 0b11111111, 0b11111111, 0b01101100, 0b00000000 } },
-	{ 22, 164, { 0b11111111, 0b11111111, 0b01110000, 0b00000000 } },
-	{ 22, 169, { 0b11111111, 0b11111111, 0b01110100, 0b00000000 } },
-	{ 22, 170, { 0b11111111, 0b11111111, 0b01111000, 0b00000000 } },
-	{ 22, 173, { 0b11111111, 0b11111111, 0b01111100, 0b00000000 } },
-	{ 22, 178, { 0b11111111, 0b11111111, 0b10000000, 0b00000000 } },
-	{ 22, 181, { 0b11111111, 0b11111111, 0b10000100, 0b00000000 } },
-	{ 22, 185, { 0b11111111, 0b11111111, 0b10001000, 0b00000000 } },
-	{ 22, 186, { 0b11111111, 0b11111111, 0b10001100, 0b00000000 } },
-	{ 22, 187, { 0b11111111, 0b11111111, 0b10010000, 0b00000000 } },
-	{ 22, 189, { 0b11111111, 0b11111111, 0b10010100, 0b00000000 } },
-	{ 22, 190, { 0b11111111, 0b11111111, 0b10011000, 0b00000000 } },
-	{ 22, 196, { 0b11111111, 0b11111111, 0b10011100, 0b00000000 } },
-	{ 22, 198, { 0b11111111, 0b11111111, 0b10100000, 0b00000000 } },
-	{ 22, 228, { 0b11111111, 0b11111111, 0b10100100, 0b00000000 } },
-	{ 22, 232, { 0b11111111, 0b11111111, 0b10101000, 0b00000000 } },
-	{ 22, 233, { 0b11111111, 0b11111111, 0b10101100, 0b00000000 } },
-	{ 23,   1, { 0b11111111, 0b11111111, 0b10110000, 0b00000000 } },
-	{ 23, 135, { 0b11111111, 0b11111111, 0b10110010, 0b00000000 } },
-	{ 23, 137, { 0b11111111, 0b11111111, 0b10110100, 0b00000000 } },
-	{ 23, 138, { 0b11111111, 0b11111111, 0b10110110, 0b00000000 } },
-	{ 23, 139, { 0b11111111, 0b11111111, 0b10111000, 0b00000000 } },
-	{ 23, 140, { 0b11111111, 0b11111111, 0b10111010, 0b00000000 } },
-	{ 23, 141, { 0b11111111, 0b11111111, 0b10111100, 0b00000000 } },
-	{ 23, 143, { 0b11111111, 0b11111111, 0b10111110, 0b00000000 } },
-	{ 23, 147, { 0b11111111, 0b11111111, 0b11000000, 0b00000000 } },
-	{ 23, 149, { 0b11111111, 0b11111111, 0b11000010, 0b00000000 } },
-	{ 23, 150, { 0b11111111, 0b11111111, 0b11000100, 0b00000000 } },
-	{ 23, 151, { 0b11111111, 0b11111111, 0b11000110, 0b00000000 } },
-	{ 23, 152, { 0b11111111, 0b11111111, 0b11001000, 0b00000000 } },
-	{ 23, 155, { 0b11111111, 0b11111111, 0b11001010, 0b00000000 } },
-	{ 23, 157, { 0b11111111, 0b11111111, 0b11001100, 0b00000000 } },
-	{ 23, 158, { 0b11111111, 0b11111111, 0b11001110, 0b00000000 } },
-	{ 23, 165, { 0b11111111, 0b11111111, 0b11010000, 0b00000000 } },
-	{ 23, 166, { 0b11111111, 0b11111111, 0b11010010, 0b00000000 } },
-	{ 23, 168, { 0b11111111, 0b11111111, 0b11010100, 0b00000000 } },
-	{ 23, 174, { 0b11111111, 0b11111111, 0b11010110, 0b00000000 } },
-	{ 23, 175, { 0b11111111, 0b11111111, 0b11011000, 0b00000000 } },
-	{ 23, 180, { 0b11111111, 0b11111111, 0b11011010, 0b00000000 } },
-	{ 23, 182, { 0b11111111, 0b11111111, 0b11011100, 0b00000000 } },
-	{ 23, 183, { 0b11111111, 0b11111111, 0b11011110, 0b00000000 } },
-	{ 23, 188, { 0b11111111, 0b11111111, 0b11100000, 0b00000000 } },
-	{ 23, 191, { 0b11111111, 0b11111111, 0b11100010, 0b00000000 } },
-	{ 23, 197, { 0b11111111, 0b11111111, 0b11100100, 0b00000000 } },
-	{ 23, 231, { 0b11111111, 0b11111111, 0b11100110, 0b00000000 } },
-	{ 23, 239, { 0b11111111, 0b11111111, 0b11101000, 0b00000000 } },
-	{ 24,   9, { 0b11111111, 0b11111111, 0b11101010, 0b00000000 } },
-	{ 24, 142, { 0b11111111, 0b11111111, 0b11101011, 0b00000000 } },
-	{ 24, 144, { 0b11111111, 0b11111111, 0b11101100, 0b00000000 } },
-	{ 24, 145, { 0b11111111, 0b11111111, 0b11101101, 0b00000000 } },
-	{ 24, 148, { 0b11111111, 0b11111111, 0b11101110, 0b00000000 } },
-	{ 24, 159, { 0b11111111, 0b11111111, 0b11101111, 0b00000000 } },
-	{ 24, 171, { 0b11111111, 0b11111111, 0b11110000, 0b00000000 } },
-	{ 24, 206, { 0b11111111, 0b11111111, 0b11110001, 0b00000000 } },
-	{ 24, 215, { 0b11111111, 0b11111111, 0b11110010, 0b00000000 } },
-	{ 24, 225, { 0b11111111, 0b11111111, 0b11110011, 0b00000000 } },
-	{ 24, 236, { 0b11111111, 0b11111111, 0b11110100, 0b00000000 } },
-	{ 24, 237, { 0b11111111, 0b11111111, 0b11110101, 0b00000000 } },
-	{ 25, 199, { 0b11111111, 0b11111111, 0b11110110, 0b00000000 } },
-	{ 25, 207, { 0b11111111, 0b11111111, 0b11110110, 0b10000000 } },
-	{ 25, 234, { 0b11111111, 0b11111111, 0b11110111, 0b00000000 } },
-	{ 25, 235, { 0b11111111, 0b11111111, 0b11110111, 0b10000000 } },
-	{ 26, 192, { 0b11111111, 0b11111111, 0b11111000, 0b00000000 } },
-	{ 26, 193, { 0b11111111, 0b11111111, 0b11111000, 0b01000000 } },
-	{ 26, 200, { 0b11111111, 0b11111111, 0b11111000, 0b10000000 } },
-	{ 26, 201, { 0b11111111, 0b11111111, 0b11111000, 0b11000000 } },
-	{ 26, 202, { 0b11111111, 0b11111111, 0b11111001, 0b00000000 } },
-	{ 26, 205, { 0b11111111, 0b11111111, 0b11111001, 0b01000000 } },
-	{ 26, 210, { 0b11111111, 0b11111111, 0b11111001, 0b10000000 } },
-	{ 26, 213, { 0b11111111, 0b11111111, 0b11111001, 0b11000000 } },
-	{ 26, 218, { 0b11111111, 0b11111111, 0b11111010, 0b00000000 } },
-	{ 26, 219, { 0b11111111, 0b11111111, 0b11111010, 0b01000000 } },
-	{ 26, 238, { 0b11111111, 0b11111111, 0b11111010, 0b10000000 } },
-	{ 26, 240, { 0b11111111, 0b11111111, 0b11111010, 0b11000000 } },
-	{ 26, 242, { 0b11111111, 0b11111111, 0b11111011, 0b00000000 } },
-	{ 26, 243, { 0b11111111, 0b11111111, 0b11111011, 0b01000000 } },
-	{ 26, 255, { 0b11111111, 0b11111111, 0b11111011, 0b10000000 } },
-	{ 27, 203, { 0b11111111, 0b11111111, 0b11111011, 0b11000000 } },
-	{ 27, 204, { 0b11111111, 0b11111111, 0b11111011, 0b11100000 } },
-	{ 27, 211, { 0b11111111, 0b11111111, 0b11111100, 0b00000000 } },
-	{ 27, 212, { 0b11111111, 0b11111111, 0b11111100, 0b00100000 } },
-	{ 27, 214, { 0b11111111, 0b11111111, 0b11111100, 0b01000000 } },
-	{ 27, 221, { 0b11111111, 0b11111111, 0b11111100, 0b01100000 } },
-	{ 27, 222, { 0b11111111, 0b11111111, 0b11111100, 0b10000000 } },
-	{ 27, 223, { 0b11111111, 0b11111111, 0b11111100, 0b10100000 } },
-	{ 27, 241, { 0b11111111, 0b11111111, 0b11111100, 0b11000000 } },
-	{ 27, 244, { 0b11111111, 0b11111111, 0b11111100, 0b11100000 } },
-	{ 27, 245, { 0b11111111, 0b11111111, 0b11111101, 0b00000000 } },
-	{ 27, 246, { 0b11111111, 0b11111111, 0b11111101, 0b00100000 } },
-	{ 27, 247, { 0b11111111, 0b11111111, 0b11111101, 0b01000000 } },
-	{ 27, 248, { 0b11111111, 0b11111111, 0b11111101, 0b01100000 } },
-	{ 27, 250, { 0b11111111, 0b11111111, 0b11111101, 0b10000000 } },
-	{ 27, 251, { 0b11111111, 0b11111111, 0b11111101, 0b10100000 } },
-	{ 27, 252, { 0b11111111, 0b11111111, 0b11111101, 0b11000000 } },
-	{ 27, 253, { 0b11111111, 0b11111111, 0b11111101, 0b11100000 } },
-	{ 27, 254, { 0b11111111, 0b11111111, 0b11111110, 0b00000000 } },
-	{ 28,   2, { 0b11111111, 0b11111111, 0b11111110, 0b00100000 } },
-	{ 28,   3, { 0b11111111, 0b11111111, 0b11111110, 0b00110000 } },
-	{ 28,   4, { 0b11111111, 0b11111111, 0b11111110, 0b01000000 } },
-	{ 28,   5, { 0b11111111, 0b11111111, 0b11111110, 0b01010000 } },
-	{ 28,   6, { 0b11111111, 0b11111111, 0b11111110, 0b01100000 } },
-	{ 28,   7, { 0b11111111, 0b11111111, 0b11111110, 0b01110000 } },
-	{ 28,   8, { 0b11111111, 0b11111111, 0b11111110, 0b10000000 } },
-	{ 28,  11, { 0b11111111, 0b11111111, 0b11111110, 0b10010000 } },
-	{ 28,  12, { 0b11111111, 0b11111111, 0b11111110, 0b10100000 } },
-	{ 28,  14, { 0b11111111, 0b11111111, 0b11111110, 0b10110000 } },
-	{ 28,  15, { 0b11111111, 0b11111111, 0b11111110, 0b11000000 } },
-	{ 28,  16, { 0b11111111, 0b11111111, 0b11111110, 0b11010000 } },
-	{ 28,  17, { 0b11111111, 0b11111111, 0b11111110, 0b11100000 } },
-	{ 28,  18, { 0b11111111, 0b11111111, 0b11111110, 0b11110000 } },
-	{ 28,  19, { 0b11111111, 0b11111111, 0b11111111, 0b00000000 } },
-	{ 28,  20, { 0b11111111, 0b11111111, 0b11111111, 0b00010000 } },
-	{ 28,  21, { 0b11111111, 0b11111111, 0b11111111, 0b00100000 } },
-	{ 28,  23, { 0b11111111, 0b11111111, 0b11111111, 0b00110000 } },
-	{ 28,  24, { 0b11111111, 0b11111111, 0b11111111, 0b01000000 } },
-	{ 28,  25, { 0b11111111, 0b11111111, 0b11111111, 0b01010000 } },
-	{ 28,  26, { 0b11111111, 0b11111111, 0b11111111, 0b01100000 } },
-	{ 28,  27, { 0b11111111, 0b11111111, 0b11111111, 0b01110000 } },
-	{ 28,  28, { 0b11111111, 0b11111111, 0b11111111, 0b10000000 } },
-	{ 28,  29, { 0b11111111, 0b11111111, 0b11111111, 0b10010000 } },
-	{ 28,  30, { 0b11111111, 0b11111111, 0b11111111, 0b10100000 } },
-	{ 28,  31, { 0b11111111, 0b11111111, 0b11111111, 0b10110000 } },
-	{ 28, 127, { 0b11111111, 0b11111111, 0b11111111, 0b11000000 } },
-	{ 28, 220, { 0b11111111, 0b11111111, 0b11111111, 0b11010000 } },
-	{ 28, 249, { 0b11111111, 0b11111111, 0b11111111, 0b11100000 } },
-	{ 30,  10, { 0b11111111, 0b11111111, 0b11111111, 0b11110000 } },
-	{ 30,  13, { 0b11111111, 0b11111111, 0b11111111, 0b11110100 } },
-	{ 30,  22, { 0b11111111, 0b11111111, 0b11111111, 0b11111000 } },
+struct huffman_group {
+	/* First code of the next length, left aligned */
+	uint32_t limit;
+	uint32_t first_code;
+	uint8_t base;
+	uint8_t bitlen;
 };
 
-static const struct decode_elem eos = {
-	30,   0, { 0b11111111, 0b11111111, 0b11111111, 0b11111100 }
+/* Codes of up to 8 bits, indexed by the next 8 bits of input. A zero
+ * bitlen means the code is longer and is looked up by length.
+ */
+static const struct huffman_fast_elem decode_fast[256] = {
+	{  48, 5 }, {  48, 5 }, {  48, 5 }, {  48, 5 },
+	{  48, 5 }, {  48, 5 }, {  48, 5 }, {  48, 5 },
+	{  49, 5 }, {  49, 5 }, {  49, 5 }, {  49, 5 },
+	{  49, 5 }, {  49, 5 }, {  49, 5 }, {  49, 5 },
+	{  50, 5 }, {  50, 5 }, {  50, 5 }, {  50, 5 },
+	{  50, 5 }, {  50, 5 }, {  50, 5 }, {  50, 5 },
+	{  97, 5 }, {  97, 5 }, {  97, 5 }, {  97, 5 },
+	{  97, 5 }, {  97, 5 }, {  97, 5 }, {  97, 5 },
+	{  99, 5 }, {  99, 5 }, {  99, 5 }, {  99, 5 },
+	{  99, 5 }, {  99, 5 }, {  99, 5 }, {  99, 5 },
+	{ 101, 5 }, { 101, 5 }, { 101, 5 }, { 101, 5 },
+	{ 101, 5 }, { 101, 5 }, { 101, 5 }, { 101, 5 },
+	{ 105, 5 }, { 105, 5 }, { 105, 5 }, { 105, 5 },
+	{ 105, 5 }, { 105, 5 }, { 105, 5 }, { 105, 5 },
+	{ 111, 5 }, { 111, 5 }, { 111, 5 }, { 111, 5 },
+	{ 111, 5 }, { 111, 5 }, { 111, 5 }, { 111, 5 },
+	{ 115, 5 }, { 115, 5 }, { 115, 5 }, { 115, 5 },
+	{ 115, 5 }, { 115, 5 }, { 115, 5 }, { 115, 5 },
+	{ 116, 5 }, { 116, 5 }, { 116, 5 }, { 116, 5 },
+	{ 116, 5 }, { 116, 5 }, { 116, 5 }, { 116, 5 },
+	{  32, 6 }, {  32, 6 }, {  32, 6 }, {  32, 6 },
+	{  37, 6 }, {  37, 6 }, {  37, 6 }, {  37, 6 },
+	{  45, 6 }, {  45, 6 }, {  45, 6 }, {  45, 6 },
+	{  46, 6 }, {  46, 6 }, {  46, 6 }, {  46, 6 },
+	{  47, 6 }, {  47, 6 }, {  47, 6 }, {  47, 6 },
+	{  51, 6 }, {  51, 6 }, {  51, 6 }, {  51, 6 },
+	{  52, 6 }, {  52, 6 }, {  52, 6 }, {  52, 6 },
+	{  53, 6 }, {  53, 6 }, {  53, 6 }, {  53, 6 },
+	{  54, 6 }, {  54, 6 }, {  54, 6 }, {  54, 6 },
+	{  55, 6 }, {  55, 6 }, {  55, 6 }, {  55, 6 },
+	{  56, 6 }, {  56, 6 }, {  56, 6 }, {  56, 6 },
+	{  57, 6 }, {  57, 6 }, {  57, 6 }, {  57, 6 },
+	{  61, 6 }, {  61, 6 }, {  61, 6 }, {  61, 6 },
+	{  65, 6 }, {  65, 6 }, {  65, 6 }, {  65, 6 },
+	{  95, 6 }, {  95, 6 }, {  95, 6 }, {  95, 6 },
+	{  98, 6 }, {  98, 6 }, {  98, 6 }, {  98, 6 },
+	{ 100, 6 }, { 100, 6 }, { 100, 6 }, { 100, 6 },
+	{ 102, 6 }, { 102, 6 }, { 102, 6 }, { 102, 6 },
+	{ 103, 6 }, { 103, 6 }, { 103, 6 }, { 103, 6 },
+	{ 104, 6 }, { 104, 6 }, { 104, 6 }, { 104, 6 },
+	{ 108, 6 }, { 108, 6 }, { 108, 6 }, { 108, 6 },
+	{ 109, 6 }, { 109, 6 }, { 109, 6 }, { 109, 6 },
+	{ 110, 6 }, { 110, 6 }, { 110, 6 }, { 110, 6 },
+	{ 112, 6 }, { 112, 6 }, { 112, 6 }, { 112, 6 },
+	{ 114, 6 }, { 114, 6 }, { 114, 6 }, { 114, 6 },
+	{ 117, 6 }, { 117, 6 }, { 117, 6 }, { 117, 6 },
+	{  58, 7 }, {  58, 7 }, {  66, 7 }, {  66, 7 },
+	{  67, 7 }, {  67, 7 }, {  68, 7 }, {  68, 7 },
+	{  69, 7 }, {  69, 7 }, {  70, 7 }, {  70, 7 },
+	{  71, 7 }, {  71, 7 }, {  72, 7 }, {  72, 7 },
+	{  73, 7 }, {  73, 7 }, {  74, 7 }, {  74, 7 },
+	{  75, 7 }, {  75, 7 }, {  76, 7 }, {  76, 7 },
+	{  77, 7 }, {  77, 7 }, {  78, 7 }, {  78, 7 },
+	{  79, 7 }, {  79, 7 }, {  80, 7 }, {  80, 7 },
+	{  81, 7 }, {  81, 7 }, {  82, 7 }, {  82, 7 },
+	{  83, 7 }, {  83, 7 }, {  84, 7 }, {  84, 7 },
+	{  85, 7 }, {  85, 7 }, {  86, 7 }, {  86, 7 },
+	{  87, 7 }, {  87, 7 }, {  89, 7 }, {  89, 7 },
+	{ 106, 7 }, { 106, 7 }, { 107, 7 }, { 107, 7 },
+	{ 113, 7 }, { 113, 7 }, { 118, 7 }, { 118, 7 },
+	{ 119, 7 }, { 119, 7 }, { 120, 7 }, { 120, 7 },
+	{ 121, 7 }, { 121, 7 }, { 122, 7 }, { 122, 7 },
+	{  38, 8 }, {  42, 8 }, {  44, 8 }, {  59, 8 },
+	{  88, 8 }, {  90, 8 }, {   0, 0 }, {   0, 0 },
 };
 
-#define UINT32_BITLEN 32
+static const struct huffman_group decode_groups[] = {
+	{ 0xff400000, 0x000003f8,  74, 10 },
+	{ 0xffa00000, 0x000007fa,  79, 11 },
+	{ 0xffc00000, 0x00000ffa,  82, 12 },
+	{ 0xfff00000, 0x00001ff8,  84, 13 },
+	{ 0xfff80000, 0x00003ffc,  90, 14 },
+	{ 0xfffe0000, 0x00007ffc,  92, 15 },
+	{ 0xfffe6000, 0x0007fff0,  95, 19 },
+	{ 0xfffee000, 0x000fffe6,  98, 20 },
+	{ 0xffff4800, 0x001fffdc, 106, 21 },
+	{ 0xffffb000, 0x003fffd2, 119, 22 },
+	{ 0xffffea00, 0x007fffd8, 145, 23 },
+	{ 0xfffff600, 0x00ffffea, 174, 24 },
+	{ 0xfffff800, 0x01ffffec, 186, 25 },
+	{ 0xfffffbc0, 0x03ffffe0, 190, 26 },
+	{ 0xfffffe20, 0x07ffffde, 205, 27 },
+	{ 0xfffffff0, 0x0fffffe2, 224, 28 },
+	{ 0xfffffffc, 0x3ffffffc, 253, 30 },
+};
 
-#define MSB_MASK(len) (UINT32_MAX << (UINT32_BITLEN - len))
-#define LSB_MASK(len) ((1UL << len) - 1UL)
+/* Symbols in canonical code order */
+static const uint8_t decode_symbols[256] = {
+	 48,  49,  50,  97,  99, 101, 105, 111, 115, 116,  32,  37,
+	 45,  46,  47,  51,  52,  53,  54,  55,  56,  57,  61,  65,
+	 95,  98, 100, 102, 103, 104, 108, 109, 110, 112, 114, 117,
+	 58,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  76,
+	 77,  78,  79,  80,  81,  82,  83,  84,  85,  86,  87,  89,
+	106, 107, 113, 118, 119, 120, 121, 122,  38,  42,  44,  59,
+	 88,  90,  33,  34,  40,  41,  63,  39,  43, 124,  35,  62,
+	  0,  36,  64,  91,  93, 126,  94, 125,  60,  96, 123,  92,
+	195, 208, 128, 130, 131, 162, 184, 194, 224, 226, 153, 161,
+	167, 172, 176, 177, 179, 209, 216, 217, 227, 229, 230, 129,
+	132, 133, 134, 136, 146, 154, 156, 160, 163, 164, 169, 170,
+	173, 178, 181, 185, 186, 187, 189, 190, 196, 198, 228, 232,
+	233,   1, 135, 137, 138, 139, 140, 141, 143, 147, 149, 150,
+	151, 152, 155, 157, 158, 165, 166, 168, 174, 175, 180, 182,
+	183, 188, 191, 197, 231, 239,   9, 142, 144, 145, 148, 159,
+	171, 206, 215, 225, 236, 237, 199, 207, 234, 235, 192, 193,
+	200, 201, 202, 205, 210, 213, 218, 219, 238, 240, 242, 243,
+	255, 203, 204, 211, 212, 214, 221, 222, 223, 241, 244, 245,
+	246, 247, 248, 250, 251, 252, 253, 254,   2,   3,   4,   5,
+	  6,   7,   8,  11,  12,  14,  15,  16,  17,  18,  19,  20,
+	 21,  23,  24,  25,  26,  27,  28,  29,  30,  31, 127, 220,
+	249,  10,  13,  22,
+};
 
-static bool huffman_bits_compare(uint32_t bits, const struct decode_elem *entry)
-{
-	uint32_t mask = MSB_MASK(entry->bitlen);
-	uint32_t code = sys_get_be32(entry->code);
+/* Codes indexed by symbol, right aligned */
+static const uint32_t encode_codes[256] = {
+	0x00001ff8, 0x007fffd8, 0x0fffffe2, 0x0fffffe3, 0x0fffffe4, 0x0fffffe5,
+	0x0fffffe6, 0x0fffffe7, 0x0fffffe8, 0x00ffffea, 0x3ffffffc, 0x0fffffe9,
+	0x0fffffea, 0x3ffffffd, 0x0fffffeb, 0x0fffffec, 0x0fffffed, 0x0fffffee,
+	0x0fffffef, 0x0ffffff0, 0x0ffffff1, 0x0ffffff2, 0x3ffffffe, 0x0ffffff3,
+	0x0ffffff4, 0x0ffffff5, 0x0ffffff6, 0x0ffffff7, 0x0ffffff8, 0x0ffffff9,
+	0x0ffffffa, 0x0ffffffb, 0x00000014, 0x000003f8, 0x000003f9, 0x00000ffa,
+	0x00001ff9, 0x00000015, 0x000000f8, 0x000007fa, 0x000003fa, 0x000003fb,
+	0x000000f9, 0x000007fb, 0x000000fa, 0x00000016, 0x00000017, 0x00000018,
+	0x00000000, 0x00000001, 0x00000002, 0x00000019, 0x0000001a, 0x0000001b,
+	0x0000001c, 0x0000001d, 0x0000001e, 0x0000001f, 0x0000005c, 0x000000fb,
+	0x00007ffc, 0x00000020, 0x00000ffb, 0x000003fc, 0x00001ffa, 0x00000021,
+	0x0000005d, 0x0000005e, 0x0000005f, 0x00000060, 0x00000061, 0x00000062,
+	0x00000063, 0x00000064, 0x00000065, 0x00000066, 0x00000067, 0x00000068,
+	0x00000069, 0x0000006a, 0x0000006b, 0x0000006c, 0x0000006d, 0x0000006e,
+	0x0000006f, 0x00000070, 0x00000071, 0x00000072, 0x000000fc, 0x00000073,
+	0x000000fd, 0x00001ffb, 0x0007fff0, 0x00001ffc, 0x00003ffc, 0x00000022,
+	0x00007ffd, 0x00000003, 0x00000023, 0x00000004, 0x00000024, 0x00000005,
+	0x00000025, 0x00000026, 0x00000027, 0x00000006, 0x00000074, 0x00000075,
+	0x00000028, 0x00000029, 0x0000002a, 0x00000007, 0x0000002b, 0x00000076,
+	0x0000002c, 0x00000008, 0x00000009, 0x0000002d, 0x00000077, 0x00000078,
+	0x00000079, 0x0000007a, 0x0000007b, 0x00007ffe, 0x000007fc, 0x00003ffd,
+	0x00001ffd, 0x0ffffffc, 0x000fffe6, 0x003fffd2, 0x000fffe7, 0x000fffe8,
+	0x003fffd3, 0x003fffd4, 0x003fffd5, 0x007fffd9, 0x003fffd6, 0x007fffda,
+	0x007fffdb, 0x007fffdc, 0x007fffdd, 0x007fffde, 0x00ffffeb, 0x007fffdf,
+	0x00ffffec, 0x00ffffed, 0x003fffd7, 0x007fffe0, 0x00ffffee, 0x007fffe1,
+	0x007fffe2, 0x007fffe3, 0x007fffe4, 0x001fffdc, 0x003fffd8, 0x007fffe5,
+	0x003fffd9, 0x007fffe6, 0x007fffe7, 0x00ffffef, 0x003fffda, 0x001fffdd,
+	0x000fffe9, 0x003fffdb, 0x003fffdc, 0x007fffe8, 0x007fffe9, 0x001fffde,
+	0x007fffea, 0x003fffdd, 0x003fffde, 0x00fffff0, 0x001fffdf, 0x003fffdf,
+	0x007fffeb, 0x007fffec, 0x001fffe0, 0x001fffe1, 0x003fffe0, 0x001fffe2,
+	0x007fffed, 0x003fffe1, 0x007fffee, 0x007fffef, 0x000fffea, 0x003fffe2,
+	0x003fffe3, 0x003fffe4, 0x007ffff0, 0x003fffe5, 0x003fffe6, 0x007ffff1,
+	0x03ffffe0, 0x03ffffe1, 0x000fffeb, 0x0007fff1, 0x003fffe7, 0x007ffff2,
+	0x003fffe8, 0x01ffffec, 0x03ffffe2, 0x03ffffe3, 0x03ffffe4, 0x07ffffde,
+	0x07ffffdf, 0x03ffffe5, 0x00fffff1, 0x01ffffed, 0x0007fff2, 0x001fffe3,
+	0x03ffffe6, 0x07ffffe0, 0x07ffffe1, 0x03ffffe7, 0x07ffffe2, 0x00fffff2,
+	0x001fffe4, 0x001fffe5, 0x03ffffe8, 0x03ffffe9, 0x0ffffffd, 0x07ffffe3,
+	0x07ffffe4, 0x07ffffe5, 0x000fffec, 0x00fffff3, 0x000fffed, 0x001fffe6,
+	0x003fffe9, 0x001fffe7, 0x001fffe8, 0x007ffff3, 0x003fffea, 0x003fffeb,
+	0x01ffffee, 0x01ffffef, 0x00fffff4, 0x00fffff5, 0x03ffffea, 0x007ffff4,
+	0x03ffffeb, 0x07ffffe6, 0x03ffffec, 0x03ffffed, 0x07ffffe7, 0x07ffffe8,
+	0x07ffffe9, 0x07ffffea, 0x07ffffeb, 0x0ffffffe, 0x07ffffec, 0x07ffffed,
+	0x07ffffee, 0x07ffffef, 0x07fffff0, 0x03ffffee,
+};
 
-	if (code == (bits & mask)) {
-		return true;
-	}
+static const uint8_t encode_bitlens[256] = {
+	13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+	28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+	 6, 10, 10, 12, 13,  6,  8, 11, 10, 10,  8, 11,  8,  6,  6,  6,
+	 5,  5,  5,  6,  6,  6,  6,  6,  6,  6,  7,  8, 15,  6, 12, 10,
+	13,  6,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+	 7,  7,  7,  7,  7,  7,  7,  7,  8,  7,  8, 13, 19, 13, 14,  6,
+	15,  5,  6,  5,  6,  5,  6,  6,  6,  5,  7,  7,  6,  6,  6,  5,
+	 6,  7,  6,  5,  5,  6,  7,  7,  7,  7,  7, 15, 11, 14, 13, 28,
+	20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+	24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+	22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+	21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+	26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+	19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+	20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+	26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+};
 
-	return false;
-}
+#define UINT32_BITLEN 32
+#define FAST_BITLEN 8
 
-static const struct decode_elem *huffman_decode_bits(uint32_t bits)
+#define LSB_MASK(len) ((1UL << (len)) - 1UL)
+
+/* 30 bits all ones, left aligned */
+#define EOS_CODE 0xfffffffcU
+
+#define MAX_PADDING_LEN 7
+
+static int huffman_decode_symbol(uint32_t bits, uint8_t *symbol)
 {
-	for (int i = 0; i < ARRAY_SIZE(decode_table); i++) {
-		if (huffman_bits_compare(bits, &decode_table[i])) {
-			return &decode_table[i];
-		}
-	}
+	const struct huffman_fast_elem *fast;
+	const struct huffman_group *group;
 
-	if (huffman_bits_compare(bits, &eos)) {
-		return &eos;
+	fast = &decode_fast[bits >> (UINT32_BITLEN - FAST_BITLEN)];
+
+	if (fast->bitlen > 0) {
+		*symbol = fast->symbol;
+		return fast->bitlen;
 	}
 
-	return NULL;
-}
+	for (int i = 0; i < ARRAY_SIZE(decode_groups); i++) {
+		group = &decode_groups[i];
 
-static const struct decode_elem *huffman_find_entry(uint8_t symbol)
-{
-	for (int i = 0; i < ARRAY_SIZE(decode_table); i++) {
-		if (decode_table[i].symbol == symbol) {
-			return &decode_table[i];
+		if (bits < group->limit) {
+			*symbol = decode_symbols[group->base +
+						 (bits >> (UINT32_BITLEN - group->bitlen)) -
+						 group->first_code];
+			return group->bitlen;
 		}
 	}
 
-	return NULL;
-}
+	if (bits >= EOS_CODE) {
+		return 0;
+	}
 
-#define MAX_PADDING_LEN 7
+	return -EBADMSG;
+}
 
 int http_hpack_huffman_decode(const uint8_t *encoded_buf, size_t encoded_len,
 			      uint8_t *buf, size_t buflen)
 {
-	size_t encoded_bits_len = encoded_len * 8;
-	uint8_t bits_needed = UINT32_BITLEN;
-	const struct decode_elem *decoded;
-	uint8_t bits_in_byte_left = 8;
 	size_t decoded_len = 0;
-	uint32_t bits = 0;
+	uint8_t acc_bits = 0;
+	uint64_t acc = 0;
+	uint32_t bits;
+	uint8_t symbol;
+	int bitlen;
 
 	if (encoded_buf == NULL || buf == NULL || encoded_len == 0) {
 		return -EINVAL;
 	}
 
-	while (encoded_bits_len > 0) {
-		/* Refill the bits variable */
-		while (bits_needed > 0) {
-			if (encoded_len > 0) {
-				if (bits_in_byte_left <= bits_needed) {
-					/* Consume rest of the byte */
-					bits <<= bits_in_byte_left;
-					bits |= *encoded_buf &
-						    LSB_MASK(bits_in_byte_left);
-					bits_needed -= bits_in_byte_left;
-					bits_in_byte_left = 0;
-				} else {
-					/* Consume part of the byte */
-					bits <<= bits_needed;
-					bits |= (*encoded_buf >>
-						 (bits_in_byte_left - bits_needed)) &
-						LSB_MASK(bits_needed);
-					bits_in_byte_left -= bits_needed;
-					bits_needed = 0;
-				}
-			} else {
-				/* Pad with ones */
-				bits <<= bits_needed;
-				bits |= LSB_MASK(bits_needed);
-				bits_needed = 0;
-			}
+	while (acc_bits > 0 || encoded_len > 0) {
+		/* Keep the accumulator left aligned and as full as possible */
+		while (acc_bits <= 56 && encoded_len > 0) {
+			acc |= (uint64_t)*encoded_buf << (56 - acc_bits);
+			acc_bits += 8;
+			encoded_buf++;
+			encoded_len--;
+		}
 
-			/* Move to next encoded byte */
-			if (bits_in_byte_left == 0) {
-				encoded_buf++;
-				encoded_len--;
-				bits_in_byte_left = 8;
-			}
+		bits = (uint32_t)(acc >> UINT32_BITLEN);
+		if (acc_bits < UINT32_BITLEN) {
+			/* Pad with ones */
+			bits |= UINT32_MAX >> acc_bits;
 		}
 
-		/* Pass to decoder */
-		decoded = huffman_decode_bits(bits);
-		if (decoded == NULL) {
+		bitlen = huffman_decode_symbol(bits, &symbol);
+		if (bitlen < 0) {
 			LOG_ERR("No symbol found");
 			return -EBADMSG;
 		}
 
-		if (decoded == &eos) {
-			if (encoded_bits_len > MAX_PADDING_LEN) {
+		if (bitlen == 0) {
+			if (acc_bits > MAX_PADDING_LEN) {
 				LOG_ERR("eos reached prematurely");
 				return -EBADMSG;
 			}
@@ -391,25 +297,20 @@ int http_hpack_huffman_decode(const uint8_t *encoded_buf, size_t encoded_len,
 			break;
 		}
 
-		if (encoded_bits_len < decoded->bitlen) {
+		if (acc_bits < bitlen) {
 			LOG_ERR("Invalid symbol used for padding");
 			return -EBADMSG;
 		}
 
-		/* Remove consumed bits from bits variable. */
-		bits_needed += decoded->bitlen;
-		encoded_bits_len -= decoded->bitlen;
+		acc <<= bitlen;
+		acc_bits -= bitlen;
 
-		/* Store decoded symbol */
-		if (buflen == 0) {
+		if (decoded_len == buflen) {
 			LOG_ERR("Not enough buffer to decode string");
 			return -ENOBUFS;
 		}
 
-		*buf = decoded->symbol;
-		buf++;
-		buflen--;
-		decoded_len++;
+		buf[decoded_len++] = symbol;
 	}
 
 	return decoded_len;
@@ -418,62 +319,40 @@ int http_hpack_huffman_decode(const uint8_t *encoded_buf, size_t encoded_len,
 int http_hpack_huffman_encode(const uint8_t *str, size_t str_len,
 			      uint8_t *buf, size_t buflen)
 {
-	const struct decode_elem *entry;
-	size_t buflen_bits = buflen * 8;
-	uint8_t bit_offset = 0;
-	int len = 0;
+	uint8_t acc_bits = 0;
+	uint64_t acc = 0;
+	size_t len = 0;
 
 	if (str == NULL || buf == NULL || str_len == 0) {
 		return -EINVAL;
 	}
 
 	while (str_len > 0) {
-		uint32_t code;
-		uint8_t bitlen;
-
-		entry = huffman_find_entry(*str);
-		if (entry == NULL) {
-			return -EINVAL;
-		}
+		/* At most 7 + 30 bits are held at a time */
+		acc = (acc << encode_bitlens[*str]) | encode_codes[*str];
+		acc_bits += encode_bitlens[*str];
 
-		if (entry->bitlen > buflen_bits) {
-			return -ENOBUFS;
-		}
-
-		bitlen = entry->bitlen;
-		code = sys_get_be32(entry->code);
-
-		while (bitlen > 0) {
-			uint8_t to_copy = MIN(8 - bit_offset, bitlen);
-			uint8_t byte = (uint8_t)((code & MSB_MASK(to_copy)) >>
-						 (24 + bit_offset));
-
-			/* This is way suboptimal */
-			if (bit_offset == 0) {
-				*buf = byte;
-			} else {
-				*buf |= byte;
+		while (acc_bits >= 8) {
+			if (len == buflen) {
+				return -ENOBUFS;
 			}
 
-			code <<= to_copy;
-			bitlen -= to_copy;
-			bit_offset  = (bit_offset + to_copy) % 8;
-
-			if (bit_offset == 0) {
-				buf++;
-				len++;
-			}
+			acc_bits -= 8;
+			buf[len++] = (uint8_t)(acc >> acc_bits);
 		}
 
-		buflen_bits -= entry->bitlen;
 		str_len--;
 		str++;
 	}
 
 	/* Pad with ones. */
-	if (bit_offset > 0) {
-		*buf |= LSB_MASK((8 - bit_offset));
-		len++;
+	if (acc_bits > 0) {
+		if (len == buflen) {
+			return -ENOBUFS;
+		}
+
+		buf[len++] = (uint8_t)((acc << (8 - acc_bits)) |
+				       LSB_MASK(8 - acc_bits));
 	}
 
 	return len;
@@ -32,6 +32,14 @@
 #include <limits.h>
 #include <zephyr/toolchain.h>
 
+#if defined(CONFIG_HTTP_PARSER_FAST_SCAN)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+#endif
+#endif
+
 #ifndef ULLONG_MAX
 # define ULLONG_MAX ((uint64_t) -1) /* 2^64-1 */
 #endif
@@ -476,6 +484,90 @@ int parser_header_state(struct http_parser *parser, char ch, char c)
 	return 0;
 }
 
+#if defined(CONFIG_HTTP_PARSER_FAST_SCAN)
+#define WORD_ONES (UINTPTR_MAX / 0xFF)
+
+/* Any byte of the word below n, n <= 128 */
+#define WORD_HAS_LESS(v, n) (((v) - WORD_ONES * (n)) & ~(v) & (WORD_ONES * 0x80))
+
+/* Find the first CR or LF in [p, end), or end if there is none. The bulk of
+ * a header value is skipped 16 bytes at a time where SSE2 or Helium (MVE)
+ * is available, and a word at a time otherwise. A word holding any control
+ * character below CR, like a tab, is checked byte by byte.
+ */
+static const char *find_line_end(const char *p, const char *end)
+{
+	uintptr_t word;
+
+#if defined(__SSE2__)
+	const __m128i cr = _mm_set1_epi8(CR);
+	const __m128i lf = _mm_set1_epi8(LF);
+
+	while (end - p >= sizeof(__m128i)) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+		int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, cr),
+							  _mm_cmpeq_epi8(v, lf)));
+
+		if (mask != 0) {
+			return p + __builtin_ctz(mask);
+		}
+
+		p += sizeof(__m128i);
+	}
+#elif defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+	while (end - p >= sizeof(uint8x16_t)) {
+		uint8x16_t v = vld1q_u8((const uint8_t *)p);
+		/* One predicate bit per byte lane */
+		mve_pred16_t mask = vcmpeqq_n_u8(v, CR) | vcmpeqq_n_u8(v, LF);
+
+		if (mask != 0) {
+			return p + __builtin_ctz(mask);
+		}
+
+		p += sizeof(uint8x16_t);
+	}
+#endif
+
+	while (p < end) {
+		if ((uintptr_t)p % sizeof(word) == 0 && end - p >= sizeof(word)) {
+			memcpy(&word, p, sizeof(word));
+			if (!WORD_HAS_LESS(word, CR + 1)) {
+				p += sizeof(word);
+				continue;
+			}
+		}
+
+		if (*p == CR || *p == LF) {
+			return p;
+		}
+
+		p++;
+	}
+
+	return end;
+}
+#else
+static const char *find_line_end(const char *p, const char *end)
+{
+	const char *p_cr;
+	const char *p_lf;
+
+	p_cr = (const char *)memchr(p, CR, end - p);
+	p_lf = (const char *)memchr(p, LF, end - p);
+	if (p_cr != NULL) {
+		if (p_lf != NULL && p_cr >= p_lf) {
+			return p_lf;
+		}
+
+		return p_cr;
+	} else if (UNLIKELY(p_lf != NULL)) {
+		return p_lf;
+	}
+
+	return end;
+}
+#endif
+
 static
 int header_states(struct http_parser *parser, const char *data, size_t len,
 		  const char **ptr, enum state *p_state,
@@ -488,23 +580,17 @@ int header_states(struct http_parser *parser, const char *data, size_t len,
 	switch (h_state) {
 	case h_general: {
 		size_t limit = data + len - p;
-		const char *p_cr;
-		const char *p_lf;
+		const char *end;
 
 		limit = MIN(limit, HTTP_MAX_HEADER_SIZE);
-		p_cr = (const char *)memchr(p, CR, limit);
-		p_lf = (const char *)memchr(p, LF, limit);
-		if (p_cr != NULL) {
-			if (p_lf != NULL && p_cr >= p_lf) {
-				p = p_lf;
-			} else {
-				p = p_cr;
-			}
-		} else if (UNLIKELY(p_lf != NULL)) {
-			p = p_lf;
-		} else {
+		end = p + limit;
+
+		p = find_line_end(p, end);
+		if (p == end) {
+			/* No line end, the rest of the buffer is header value */
 			p = data + len;
 		}
+
 		--p;
 
 		break;
@@ -1544,6 +1630,19 @@ reexecute:
 			const char *start = p;
 
 			for (; p != data + len; p++) {
+#if defined(CONFIG_HTTP_PARSER_FAST_SCAN)
+				if (parser->header_state == h_general) {
+					/* Nothing left to match, skip to ':' */
+					while (p != data + len && TOKEN(*p)) {
+						p++;
+					}
+
+					if (p == data + len) {
+						break;
+					}
+				}
+#endif
+
 				ch = *p;
 				c = TOKEN(ch);
 
@@ -55,6 +55,48 @@ static struct http_server_ctx server_ctx;
 static K_SEM_DEFINE(server_start, 0, 1);
 static bool server_running;
 
+#define HTTP_SERVER_NUM_WORKERS CONFIG_HTTP_SERVER_NUM_WORKERS
+
+#if HTTP_SERVER_NUM_WORKERS > 1
+/* Preemptible, so that a resource handler busy on the CPU does not stall
+ * the clients of the other workers. The state shared between the workers
+ * is protected by locks.
+ */
+#define WORKER_THREAD_PRIORITY K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1)
+#define HTTP_SERVER_WORKER_SLOTS \
+	DIV_ROUND_UP(HTTP_SERVER_MAX_CLIENTS, HTTP_SERVER_NUM_WORKERS)
+
+/* The server thread only accepts new connections and hands them over to
+ * the workers. Each worker owns a shard of server_ctx.clients and polls the
+ * sockets of its shard.
+ */
+struct http_server_worker {
+	struct k_thread thread;
+	struct k_msgq handover;
+	int handover_buf[HTTP_SERVER_WORKER_SLOTS];
+	struct k_sem start;
+	struct k_sem stopped;
+
+	/* First pollfd is an eventfd used to wake up the worker, then one
+	 * pollfd per client slot of the shard.
+	 */
+	struct zsock_pollfd fds[1 + HTTP_SERVER_WORKER_SLOTS];
+
+	/* Clients handed over, incremented by the server thread */
+	atomic_t num_clients;
+	int first_slot;
+	int num_slots;
+	bool stop;
+};
+
+static struct http_server_worker workers[HTTP_SERVER_NUM_WORKERS];
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, HTTP_SERVER_NUM_WORKERS,
+				   CONFIG_HTTP_SERVER_STACK_SIZE);
+
+static int workers_init(void);
+static void workers_stop(void);
+#endif
+
 int http_server_init(struct http_server_ctx *ctx)
 {
 	int proto;
@@ -73,6 +115,9 @@ int http_server_init(struct http_server_ctx *ctx)
 
 	HTTP_SERVICE_COUNT(&svc_count);
 
+	/* Failing here is not fatal, resources are then matched exactly */
+	(void)http_server_route_init();
+
 	/* Initialize fds */
 	memset(ctx->fds, 0, sizeof(ctx->fds));
 	memset(ctx->clients, 0, sizeof(ctx->clients));
@@ -214,7 +259,11 @@ int http_server_init(struct http_server_ctx *ctx)
 	ctx->listen_fds = count;
 	ctx->num_clients = 0;
 
+#if HTTP_SERVER_NUM_WORKERS > 1
+	return workers_init();
+#else
 	return 0;
+#endif
 }
 
 static int accept_new_client(int server_fd)
@@ -242,6 +291,10 @@ static int accept_new_client(int server_fd)
 
 static int close_all_sockets(struct http_server_ctx *ctx)
 {
+#if HTTP_SERVER_NUM_WORKERS > 1
+	workers_stop();
+#endif
+
 	zsock_close(ctx->fds[0].fd); /* close eventfd */
 	ctx->fds[0].fd = -1;
 
@@ -257,6 +310,49 @@ static int close_all_sockets(struct http_server_ctx *ctx)
 	return 0;
 }
 
+/* Protects the holder of the dynamic resources, which are shared by the
+ * worker threads.
+ */
+static struct k_spinlock holder_lock;
+
+/* Take the resource for the client, fails if another client holds it */
+bool http_server_dynamic_claim(struct http_resource_detail_dynamic *detail,
+			       struct http_client_ctx *client)
+{
+	k_spinlock_key_t key;
+	bool claimed = false;
+
+	key = k_spin_lock(&holder_lock);
+
+	if (detail->holder == NULL || detail->holder == client) {
+		detail->holder = client;
+		claimed = true;
+	}
+
+	k_spin_unlock(&holder_lock, key);
+
+	return claimed;
+}
+
+/* Give the resource back, returns false if the client did not hold it */
+bool http_server_dynamic_release(struct http_resource_detail_dynamic *detail,
+				 struct http_client_ctx *client)
+{
+	k_spinlock_key_t key;
+	bool released = false;
+
+	key = k_spin_lock(&holder_lock);
+
+	if (detail->holder == client) {
+		detail->holder = NULL;
+		released = true;
+	}
+
+	k_spin_unlock(&holder_lock, key);
+
+	return released;
+}
+
 static void client_release_resources(struct http_client_ctx *client)
 {
 	struct http_resource_detail *detail;
@@ -272,15 +368,13 @@ static void client_release_resources(struct http_client_ctx *client)
 
 			dynamic_detail = (struct http_resource_detail_dynamic *)detail;
 
-			if (dynamic_detail->holder != client) {
-				continue;
-			}
-
 			/* If the client still holds the resource at this point,
 			 * it means the transaction was not complete. Release
 			 * the resource and notify application.
 			 */
-			dynamic_detail->holder = NULL;
+			if (!http_server_dynamic_release(dynamic_detail, client)) {
+				continue;
+			}
 
 			if (dynamic_detail->cb == NULL) {
 				continue;
@@ -292,24 +386,36 @@ static void client_release_resources(struct http_client_ctx *client)
 	}
 }
 
+static struct zsock_pollfd *client_pollfd(struct http_client_ctx *client)
+{
+	int i = client - server_ctx.clients;
+#if HTTP_SERVER_NUM_WORKERS > 1
+	struct http_server_worker *worker = &workers[i / HTTP_SERVER_WORKER_SLOTS];
+
+	return &worker->fds[1 + i - worker->first_slot];
+#else
+	return &server_ctx.fds[server_ctx.listen_fds + i];
+#endif
+}
+
 void http_server_release_client(struct http_client_ctx *client)
 {
-	int i;
 	struct k_work_sync sync;
 
 	__ASSERT_NO_MSG(IS_ARRAY_ELEMENT(server_ctx.clients, client));
 
 	k_work_cancel_delayable_sync(&client->inactivity_timer, &sync);
 	client_release_resources(client);
+	release_http2_streams(client);
 
-	server_ctx.num_clients--;
+	client_pollfd(client)->fd = INVALID_SOCK;
 
-	for (i = server_ctx.listen_fds; i < ARRAY_SIZE(server_ctx.fds); i++) {
-		if (server_ctx.fds[i].fd == client->fd) {
-			server_ctx.fds[i].fd = INVALID_SOCK;
-			break;
-		}
-	}
+#if HTTP_SERVER_NUM_WORKERS > 1
+	atomic_dec(&workers[(client - server_ctx.clients) /
+			    HTTP_SERVER_WORKER_SLOTS].num_clients);
+#else
+	server_ctx.num_clients--;
+#endif
 
 	memset(client, 0, sizeof(struct http_client_ctx));
 	client->fd = INVALID_SOCK;
@@ -461,13 +567,330 @@ static int handle_http_request(struct http_client_ctx *client)
 	return 0;
 }
 
-static int http_server_run(struct http_server_ctx *ctx)
+/* Returns a negative value if the client connection was closed */
+static int receive_client_data(struct http_client_ctx *client)
+{
+	int ret;
+
+	ret = zsock_recv(client->fd, client->buffer + client->data_len,
+			 sizeof(client->buffer) - client->data_len, 0);
+	if (ret <= 0) {
+		if (ret == 0) {
+			LOG_DBG("Connection closed by peer for client %p", client);
+			ret = -ENOTCONN;
+		} else {
+			ret = -errno;
+			LOG_DBG("ERROR reading from socket (%d)", ret);
+		}
+
+		close_client_connection(client);
+		return ret;
+	}
+
+	client->data_len += ret;
+
+	http_client_timer_restart(client);
+
+	ret = handle_http_request(client);
+	if (ret < 0 && ret != -EAGAIN) {
+		if (ret == -ENOTCONN) {
+			LOG_DBG("Client closed connection while handling request");
+		} else {
+			LOG_ERR("HTTP request handling error (%d)", ret);
+		}
+		close_client_connection(client);
+		return ret;
+	}
+
+	if (client->data_len == sizeof(client->buffer)) {
+		/* If the RX buffer is still full after parsing,
+		 * it means we won't be able to handle this request
+		 * with the current buffer size.
+		 */
+		LOG_ERR("RX buffer too small to handle request");
+		close_client_connection(client);
+		return -ENOBUFS;
+	}
+
+	/* The request handling may have closed the connection as well */
+	return client->fd == INVALID_SOCK ? -ENOTCONN : 0;
+}
+
+static void handle_client_event(struct http_client_ctx *client, short revents)
+{
+	socklen_t optlen = sizeof(int);
+	int sock_error;
+	int ret;
+
+	if (revents == 0) {
+		return;
+	}
+
+	if (revents & ZSOCK_POLLHUP) {
+		LOG_DBG("Client %p has disconnected", client);
+		close_client_connection(client);
+		return;
+	}
+
+	if (revents & ZSOCK_POLLERR) {
+		(void)zsock_getsockopt(client->fd, SOL_SOCKET, SO_ERROR,
+				       &sock_error, &optlen);
+		LOG_DBG("Error on fd %d %d", client->fd, sock_error);
+		close_client_connection(client);
+		return;
+	}
+
+	if (revents & ZSOCK_POLLIN) {
+		ret = receive_client_data(client);
+		if (ret < 0) {
+			return;
+		}
+	}
+
+	/* Interleave the pending HTTP/2 responses. While data remains ready to
+	 * be sent, wait for the socket to be writable as well, so requests
+	 * and window updates of the client are handled between the bursts.
+	 */
+	ret = send_http2_pending_data(client, HTTP_SERVER_MAX_STREAMS);
+	if (ret < 0) {
+		LOG_DBG("Cannot write to socket (%d)", ret);
+		close_client_connection(client);
+		return;
+	}
+
+	client_pollfd(client)->events = ZSOCK_POLLIN | (ret > 0 ? ZSOCK_POLLOUT : 0);
+}
+
+#if HTTP_SERVER_NUM_WORKERS > 1
+static int handover_new_client(int new_socket)
+{
+	static int next;
+	struct http_server_worker *worker;
+	int i;
+
+	/* Round robin over the workers, skipping the ones with a full shard */
+	for (i = 0; i < HTTP_SERVER_NUM_WORKERS; i++) {
+		worker = &workers[next];
+		next = (next + 1) % HTTP_SERVER_NUM_WORKERS;
+
+		if (atomic_inc(&worker->num_clients) >= worker->num_slots) {
+			atomic_dec(&worker->num_clients);
+			continue;
+		}
+
+		/* Cannot fail, the queue has room for the whole shard */
+		(void)k_msgq_put(&worker->handover, &new_socket, K_NO_WAIT);
+		eventfd_write(worker->fds[0].fd, 1);
+
+		return 0;
+	}
+
+	return -ENOMEM;
+}
+
+static void worker_add_clients(struct http_server_worker *worker)
 {
 	struct http_client_ctx *client;
+	int new_socket;
+	int i;
+
+	while (k_msgq_get(&worker->handover, &new_socket, K_NO_WAIT) == 0) {
+		for (i = 0; i < worker->num_slots; i++) {
+			if (worker->fds[i + 1].fd != INVALID_SOCK) {
+				continue;
+			}
+
+			client = &server_ctx.clients[worker->first_slot + i];
+
+			worker->fds[i + 1].fd = new_socket;
+			worker->fds[i + 1].events = ZSOCK_POLLIN;
+			worker->fds[i + 1].revents = 0;
+
+			LOG_DBG("Init client #%d", worker->first_slot + i);
+
+			init_client_ctx(client, new_socket);
+			break;
+		}
+	}
+}
+
+static void worker_close_clients(struct http_server_worker *worker)
+{
+	for (int i = 0; i < worker->num_slots; i++) {
+		if (worker->fds[i + 1].fd == INVALID_SOCK) {
+			continue;
+		}
+
+		close_client_connection(&server_ctx.clients[worker->first_slot + i]);
+	}
+}
+
+static int worker_run(struct http_server_worker *worker)
+{
+	eventfd_t value;
+	int ret, i;
+
+	while (true) {
+		ret = zsock_poll(worker->fds, worker->num_slots + 1, -1);
+		if (ret < 0) {
+			ret = -errno;
+			LOG_DBG("poll failed (%d)", ret);
+			return ret;
+		}
+
+		if (worker->fds[0].revents) {
+			eventfd_read(worker->fds[0].fd, &value);
+
+			if (worker->stop) {
+				return 0;
+			}
+
+			worker_add_clients(worker);
+		}
+
+		for (i = 1; i <= worker->num_slots; i++) {
+			if (worker->fds[i].fd < 0 || worker->fds[i].revents == 0) {
+				continue;
+			}
+
+			handle_client_event(
+				&server_ctx.clients[worker->first_slot + i - 1],
+				worker->fds[i].revents);
+		}
+	}
+}
+
+static void worker_thread(void *p1, void *p2, void *p3)
+{
+	struct http_server_worker *worker = p1;
+	int ret;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&worker->start, K_FOREVER);
+
+		ret = worker_run(worker);
+		if (ret < 0) {
+			/* Have the server thread restart everything */
+			LOG_ERR("Worker %d failed (%d)", (int)(worker - workers), ret);
+			eventfd_write(server_ctx.fds[0].fd, 1);
+		}
+
+		worker_close_clients(worker);
+		k_sem_give(&worker->stopped);
+	}
+}
+
+static int workers_init(void)
+{
+	static bool threads_created;
+	struct http_server_worker *worker;
+	int fd, i;
+
+	for (i = 0; i < HTTP_SERVER_NUM_WORKERS; i++) {
+		worker = &workers[i];
+
+		fd = eventfd(0, 0);
+		if (fd < 0) {
+			fd = -errno;
+			LOG_ERR("eventfd failed (%d)", fd);
+			return fd;
+		}
+
+		ARRAY_FOR_EACH(worker->fds, j) {
+			worker->fds[j].fd = INVALID_SOCK;
+		}
+
+		worker->fds[0].fd = fd;
+		worker->fds[0].events = ZSOCK_POLLIN;
+		worker->first_slot = i * HTTP_SERVER_WORKER_SLOTS;
+		worker->num_slots = MIN(HTTP_SERVER_WORKER_SLOTS,
+					HTTP_SERVER_MAX_CLIENTS - worker->first_slot);
+		worker->stop = false;
+		atomic_set(&worker->num_clients, 0);
+
+		if (!threads_created) {
+			k_msgq_init(&worker->handover, (char *)worker->handover_buf,
+				    sizeof(int), ARRAY_SIZE(worker->handover_buf));
+			k_sem_init(&worker->start, 0, 1);
+			k_sem_init(&worker->stopped, 0, 1);
+			k_thread_create(&worker->thread, worker_stacks[i],
+					K_THREAD_STACK_SIZEOF(worker_stacks[i]),
+					worker_thread, worker, NULL, NULL,
+					WORKER_THREAD_PRIORITY, 0, K_NO_WAIT);
+			k_thread_name_set(&worker->thread, "http_server_worker");
+		}
+
+		k_sem_reset(&worker->stopped);
+		k_sem_give(&worker->start);
+	}
+
+	threads_created = true;
+
+	return 0;
+}
+
+static void workers_stop(void)
+{
+	struct http_server_worker *worker;
+	int new_socket;
+
+	for (int i = 0; i < HTTP_SERVER_NUM_WORKERS; i++) {
+		worker = &workers[i];
+
+		if (worker->fds[0].fd < 0) {
+			continue;
+		}
+
+		worker->stop = true;
+		eventfd_write(worker->fds[0].fd, 1);
+		k_sem_take(&worker->stopped, K_FOREVER);
+
+		/* Sockets handed over but never picked up by the worker */
+		while (k_msgq_get(&worker->handover, &new_socket, K_NO_WAIT) == 0) {
+			zsock_close(new_socket);
+		}
+
+		zsock_close(worker->fds[0].fd);
+		worker->fds[0].fd = INVALID_SOCK;
+	}
+}
+#endif /* HTTP_SERVER_NUM_WORKERS > 1 */
+
+static int add_new_client(struct http_server_ctx *ctx, int new_socket)
+{
+#if HTTP_SERVER_NUM_WORKERS > 1
+	return handover_new_client(new_socket);
+#else
+	for (int j = ctx->listen_fds; j < ARRAY_SIZE(ctx->fds); j++) {
+		if (ctx->fds[j].fd != INVALID_SOCK) {
+			continue;
+		}
+
+		ctx->fds[j].fd = new_socket;
+		ctx->fds[j].events = ZSOCK_POLLIN;
+		ctx->fds[j].revents = 0;
+
+		ctx->num_clients++;
+
+		LOG_DBG("Init client #%d", j - ctx->listen_fds);
+
+		init_client_ctx(&ctx->clients[j - ctx->listen_fds], new_socket);
+
+		return 0;
+	}
+
+	return -ENOMEM;
+#endif
+}
+
+static int http_server_run(struct http_server_ctx *ctx)
+{
 	eventfd_t value;
-	bool found_slot;
 	int new_socket;
-	int ret, i, j;
+	int ret, i;
 	int sock_error;
 	socklen_t optlen = sizeof(int);
 
@@ -497,15 +920,14 @@ static int http_server_run(struct http_server_ctx *ctx)
 				continue;
 			}
 
-			if (ctx->fds[i].revents & ZSOCK_POLLHUP) {
-				if (i >= ctx->listen_fds) {
-					LOG_DBG("Client #%d has disconnected",
-						i - ctx->listen_fds);
-
-					client = &ctx->clients[i - ctx->listen_fds];
-					close_client_connection(client);
-				}
+			/* Client sock */
+			if (i >= ctx->listen_fds) {
+				handle_client_event(&ctx->clients[i - ctx->listen_fds],
+						    ctx->fds[i].revents);
+				continue;
+			}
 
+			if (ctx->fds[i].revents & ZSOCK_POLLHUP) {
 				continue;
 			}
 
@@ -514,97 +936,25 @@ static int http_server_run(struct http_server_ctx *ctx)
 						       SO_ERROR, &sock_error, &optlen);
 				LOG_DBG("Error on fd %d %d", ctx->fds[i].fd, sock_error);
 
-				if (i >= ctx->listen_fds) {
-					client = &ctx->clients[i - ctx->listen_fds];
-					close_client_connection(client);
-					continue;
-				}
-
 				/* Listening socket error, abort. */
 				LOG_ERR("Listening socket error, aborting.");
 				return -sock_error;
-
 			}
 
 			if (!(ctx->fds[i].revents & ZSOCK_POLLIN)) {
 				continue;
 			}
 
-			/* First check if we have something to accept */
-			if (i < ctx->listen_fds) {
-				new_socket = accept_new_client(ctx->fds[i].fd);
-				if (new_socket < 0) {
-					ret = -errno;
-					LOG_DBG("accept: %d", ret);
-					continue;
-				}
-
-				found_slot = false;
-
-				for (j = ctx->listen_fds; j < ARRAY_SIZE(ctx->fds); j++) {
-					if (ctx->fds[j].fd != INVALID_SOCK) {
-						continue;
-					}
-
-					ctx->fds[j].fd = new_socket;
-					ctx->fds[j].events = ZSOCK_POLLIN;
-					ctx->fds[j].revents = 0;
-
-					ctx->num_clients++;
-
-					LOG_DBG("Init client #%d", j - ctx->listen_fds);
-
-					init_client_ctx(&ctx->clients[j - ctx->listen_fds],
-							new_socket);
-					found_slot = true;
-					break;
-				}
-
-				if (!found_slot) {
-					LOG_DBG("No free slot found.");
-					zsock_close(new_socket);
-				}
-
-				continue;
-			}
-
-			/* Client sock */
-			client = &ctx->clients[i - ctx->listen_fds];
-
-			ret = zsock_recv(client->fd, client->buffer + client->data_len,
-					 sizeof(client->buffer) - client->data_len, 0);
-			if (ret <= 0) {
-				if (ret == 0) {
-					LOG_DBG("Connection closed by peer for client #%d",
-						i - ctx->listen_fds);
-				} else {
-					ret = -errno;
-					LOG_DBG("ERROR reading from socket (%d)", ret);
-				}
-
-				close_client_connection(client);
+			new_socket = accept_new_client(ctx->fds[i].fd);
+			if (new_socket < 0) {
+				ret = -errno;
+				LOG_DBG("accept: %d", ret);
 				continue;
 			}
 
-			client->data_len += ret;
-
-			http_client_timer_restart(client);
-
-			ret = handle_http_request(client);
-			if (ret < 0 && ret != -EAGAIN) {
-				if (ret == -ENOTCONN) {
-					LOG_DBG("Client closed connection while handling request");
-				} else {
-					LOG_ERR("HTTP request handling error (%d)", ret);
-				}
-				close_client_connection(client);
-			} else if (client->data_len == sizeof(client->buffer)) {
-				/* If the RX buffer is still full after parsing,
-				 * it means we won't be able to handle this request
-				 * with the current buffer size.
-				 */
-				LOG_ERR("RX buffer too small to handle request");
-				close_client_connection(client);
+			if (add_new_client(ctx, new_socket) < 0) {
+				LOG_DBG("No free slot found.");
+				zsock_close(new_socket);
 			}
 		}
 	}
@@ -651,10 +1001,40 @@ static bool skip_this(struct http_resource_desc *resource, bool is_websocket)
 	return false;
 }
 
+/* Kept for the applications reading http_resource_detail::path_len. Only
+ * done with a single thread, as then there is one request at a time.
+ */
+static void update_detail_path_len(struct http_resource_detail *detail,
+				   int path_len)
+{
+#if HTTP_SERVER_NUM_WORKERS == 1
+	detail->path_len = path_len;
+#else
+	ARG_UNUSED(detail);
+	ARG_UNUSED(path_len);
+#endif
+}
+
 struct http_resource_detail *get_resource_detail(const char *path,
 						 int *path_len,
 						 bool is_websocket)
 {
+	struct http_resource_desc *match;
+
+	if (http_server_route_ready()) {
+		match = http_server_route_lookup(path, path_len, is_websocket);
+		if (match != NULL) {
+			NET_DBG("Got match for %s", match->resource);
+			update_detail_path_len(match->detail, *path_len);
+			return match->detail;
+		}
+
+		NET_DBG("No match for %s", path);
+
+		return NULL;
+	}
+
+	/* Resource tree not built, fall back to exact matching */
 	HTTP_SERVICE_FOREACH(service) {
 		HTTP_SERVICE_FOREACH_RESOURCE(service, resource) {
 			if (skip_this(resource, is_websocket)) {
@@ -665,6 +1045,7 @@ struct http_resource_detail *get_resource_detail(const char *path,
 				NET_DBG("Got match for %s", resource->resource);
 
 				*path_len = strlen(resource->resource);
+				update_detail_path_len(resource->detail, *path_len);
 				return resource->detail;
 			}
 		}
@@ -675,6 +1056,172 @@ struct http_resource_detail *get_resource_detail(const char *path,
 	return NULL;
 }
 
+static bool is_zero_qvalue(const char *start, const char *end)
+{
+	for (; start < end; start++) {
+		if (*start != '0' && *start != '.' && *start != ' ') {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void http_server_parse_accept_encoding(struct http_client_ctx *client,
+				       const char *value, size_t len)
+{
+	const char *end = value + len;
+	const char *token, *qvalue;
+	size_t token_len;
+	bool any = false;
+
+	client->accept_gzip = false;
+
+	while (value < end) {
+		while (value < end && (*value == ' ' || *value == ',')) {
+			value++;
+		}
+
+		token = value;
+		while (value < end && *value != ',' && *value != ';' &&
+		       *value != ' ') {
+			value++;
+		}
+
+		token_len = value - token;
+		qvalue = NULL;
+
+		while (value < end && *value != ',') {
+			if (*value == '=' && value[-1] == 'q') {
+				qvalue = value + 1;
+			}
+
+			value++;
+		}
+
+		if (token_len == sizeof("gzip") - 1 &&
+		    strncasecmp(token, "gzip", token_len) == 0) {
+			/* Explicit entry takes precedence over the wildcard */
+			client->accept_gzip = qvalue == NULL ||
+					      !is_zero_qvalue(qvalue, value);
+			return;
+		}
+
+		if (token_len == 1 && token[0] == '*') {
+			any = qvalue == NULL || !is_zero_qvalue(qvalue, value);
+		}
+	}
+
+	client->accept_gzip = any;
+}
+
+void http_server_set_if_none_match(struct http_client_ctx *client,
+				   const char *value, size_t len)
+{
+	/* A value that does not fit can only cost a full response */
+	if (len > sizeof(client->if_none_match) - 1) {
+		client->if_none_match[0] = '\0';
+		return;
+	}
+
+	memcpy(client->if_none_match, value, len);
+	client->if_none_match[len] = '\0';
+}
+
+bool http_server_static_use_gzip(struct http_client_ctx *client,
+				 struct http_resource_detail_static *detail)
+{
+	return detail->static_gzip_data != NULL && client->accept_gzip;
+}
+
+const char *http_server_static_etag(struct http_client_ctx *client,
+				    struct http_resource_detail_static *detail,
+				    char *buf, size_t size)
+{
+	size_t len;
+
+	if (detail->etag == NULL || !http_server_static_use_gzip(client, detail)) {
+		return detail->etag;
+	}
+
+	/* The gzip variant is a different representation, "tag" becomes
+	 * "tag-gz" so that caches do not mix up the two.
+	 */
+	len = strlen(detail->etag);
+	if (len < 2 || len + sizeof("-gz") - 1 >= size) {
+		return NULL;
+	}
+
+	memcpy(buf, detail->etag, len - 1);
+	strcpy(&buf[len - 1], "-gz\"");
+
+	return buf;
+}
+
+bool http_server_static_not_modified(struct http_client_ctx *client,
+				     const char *etag)
+{
+	const char *value = (const char *)client->if_none_match;
+	const char *end;
+	size_t etag_len;
+	bool match;
+
+	if (etag == NULL) {
+		return false;
+	}
+
+	etag_len = strlen(etag);
+
+	/* If-None-Match is "*" or a comma separated list of entity tags */
+	while (*value != '\0') {
+		while (*value == ' ' || *value == '\t' || *value == ',') {
+			value++;
+		}
+
+		if (*value == '\0') {
+			break;
+		}
+
+		if (*value == '*') {
+			return true;
+		}
+
+		/* If-None-Match uses the weak comparison, W/ is ignored */
+		if (strncmp(value, "W/", 2) == 0) {
+			value += 2;
+		}
+
+		if (*value != '"') {
+			return false;
+		}
+
+		end = strchr(value + 1, '"');
+		if (end == NULL) {
+			return false;
+		}
+
+		end++;
+
+		match = end - value == etag_len && memcmp(value, etag, etag_len) == 0;
+
+		value = end;
+
+		while (*value == ' ' || *value == '\t') {
+			value++;
+		}
+
+		if (*value != ',' && *value != '\0') {
+			return false;
+		}
+
+		if (match) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 int http_server_sendall(struct http_client_ctx *client, const void *buf, size_t len)
 {
 	while (len) {
@@ -693,6 +1240,31 @@ int http_server_sendall(struct http_client_ctx *client, const void *buf, size_t
 	return 0;
 }
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+int http_server_sendfile(struct http_client_ctx *client, struct fs_file_t *file,
+			 size_t len)
+{
+	while (len) {
+		ssize_t out_len = zsock_sendfile(client->fd, file, NULL, len);
+
+		if (out_len < 0) {
+			return -errno;
+		}
+
+		if (out_len == 0) {
+			/* File is shorter than announced to the client */
+			return -EIO;
+		}
+
+		len -= out_len;
+
+		http_client_timer_restart(client);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_HTTP_SERVER_STATIC_FS */
+
 int http_server_start(void)
 {
 	if (server_running) {
@@ -20,53 +20,136 @@ LOG_MODULE_DECLARE(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
 
 #include "headers/server_internal.h"
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+#include <zephyr/fs/fs.h>
+#endif
+
 #define TEMP_BUF_LEN 64
 
 static const char final_chunk[] = "0\r\n\r\n";
 static const char *crlf = &final_chunk[3];
 
-static int handle_http1_static_resource(
-	struct http_resource_detail_static *static_detail,
-	struct http_client_ctx *client)
-{
 #define RESPONSE_TEMPLATE			\
-	"HTTP/1.1 200 OK\r\n"			\
+	"HTTP/1.1 %s\r\n"			\
 	"%s%s\r\n"				\
 	"Content-Length: %d\r\n"
 
+#define STATUS_200 "200 OK"
+#define STATUS_304 "304 Not Modified"
+
+/* Append a header line, or the empty line ending the headers if name is NULL.
+ * Returns the new offset, which is past the buffer size if it did not fit.
+ */
+static int append_header(char *buf, size_t size, int offset, const char *name,
+			 const char *value)
+{
+	if (offset >= size) {
+		return offset;
+	}
+
+	if (name == NULL) {
+		return offset + snprintk(buf + offset, size - offset, "\r\n");
+	}
+
+	return offset + snprintk(buf + offset, size - offset, "%s: %s\r\n",
+				 name, value);
+}
+
+static int send_http1_static_headers(struct http_resource_detail *common,
+				     const char *status, const char *encoding,
+				     const char *etag, int len,
+				     struct http_client_ctx *client)
+{
+	struct http_resource_detail_static *static_detail = NULL;
 	/* Add couple of bytes to total response */
-	char http_response[sizeof(RESPONSE_TEMPLATE) +
+	char http_response[sizeof(RESPONSE_TEMPLATE) + sizeof(STATUS_304) +
 			   sizeof("Content-Encoding: 01234567890123456789\r\n") +
 			   sizeof("Content-Type: \r\n") + HTTP_SERVER_MAX_CONTENT_TYPE_LEN +
 			   sizeof("xxxx") +
+			   sizeof("ETag: \r\n") + HTTP_SERVER_MAX_ETAG_LEN +
+			   sizeof("Cache-Control: \r\n") + 64 +
+			   sizeof("Vary: Accept-Encoding\r\n") +
 			   sizeof("\r\n")];
+	int offset;
+
+	if (common->type == HTTP_RESOURCE_TYPE_STATIC) {
+		static_detail = (struct http_resource_detail_static *)common;
+	}
+
+	offset = snprintk(http_response, sizeof(http_response),
+			  RESPONSE_TEMPLATE, status, "Content-Type: ",
+			  common->content_type == NULL ?
+			  "text/html" : common->content_type,
+			  len);
+
+	if (encoding != NULL && encoding[0] != '\0') {
+		offset = append_header(http_response, sizeof(http_response),
+				       offset, "Content-Encoding", encoding);
+	}
+
+	if (etag != NULL) {
+		offset = append_header(http_response, sizeof(http_response),
+				       offset, "ETag", etag);
+	}
+
+	if (static_detail != NULL && static_detail->cache_control != NULL) {
+		offset = append_header(http_response, sizeof(http_response),
+				       offset, "Cache-Control",
+				       static_detail->cache_control);
+	}
+
+	if (static_detail != NULL && static_detail->static_gzip_data != NULL) {
+		offset = append_header(http_response, sizeof(http_response),
+				       offset, "Vary", "Accept-Encoding");
+	}
+
+	offset = append_header(http_response, sizeof(http_response), offset,
+			       NULL, NULL);
+	if (offset >= sizeof(http_response)) {
+		LOG_DBG("Response headers too long");
+		return -ENOBUFS;
+	}
+
+	return http_server_sendall(client, http_response, offset);
+}
+
+static int handle_http1_static_resource(
+	struct http_resource_detail_static *static_detail,
+	struct http_client_ctx *client)
+{
+	char etag_buf[HTTP_SERVER_MAX_ETAG_LEN];
+	const char *encoding;
+	const char *etag;
 	const char *data;
 	int len;
 	int ret;
 
 	if (static_detail->common.bitmask_of_supported_http_methods & BIT(HTTP_GET)) {
-		data = static_detail->static_data;
-		len = static_detail->static_data_len;
-
-		if (static_detail->common.content_encoding != NULL &&
-		    static_detail->common.content_encoding[0] != '\0') {
-			snprintk(http_response, sizeof(http_response),
-				 RESPONSE_TEMPLATE "Content-Encoding: %s\r\n\r\n",
-				 "Content-Type: ",
-				 static_detail->common.content_type == NULL ?
-				 "text/html" : static_detail->common.content_type,
-				 len, static_detail->common.content_encoding);
+		if (http_server_static_use_gzip(client, static_detail)) {
+			data = static_detail->static_gzip_data;
+			len = static_detail->static_gzip_data_len;
+			encoding = "gzip";
 		} else {
-			snprintk(http_response, sizeof(http_response),
-				 RESPONSE_TEMPLATE "\r\n",
-				 "Content-Type: ",
-				 static_detail->common.content_type == NULL ?
-				 "text/html" : static_detail->common.content_type,
-				 len);
+			data = static_detail->static_data;
+			len = static_detail->static_data_len;
+			encoding = static_detail->common.content_encoding;
+		}
+
+		etag = http_server_static_etag(client, static_detail, etag_buf,
+					       sizeof(etag_buf));
+
+		/* Content-Length of a 304 response is the one of the variant
+		 * the client would have received.
+		 */
+		if (http_server_static_not_modified(client, etag)) {
+			return send_http1_static_headers(&static_detail->common,
+							 STATUS_304, encoding,
+							 etag, len, client);
 		}
 
-		ret = http_server_sendall(client, http_response,
-					  strlen(http_response));
+		ret = send_http1_static_headers(&static_detail->common,
+						STATUS_200, encoding, etag,
+						len, client);
 		if (ret < 0) {
 			return ret;
 		}
@@ -80,6 +163,48 @@ static int handle_http1_static_resource(
 	return 0;
 }
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+static int handle_http1_static_fs_resource(
+	struct http_resource_detail_static_fs *static_fs_detail,
+	struct http_client_ctx *client)
+{
+	struct fs_dirent entry;
+	struct fs_file_t file;
+	int ret;
+
+	if (!(static_fs_detail->common.bitmask_of_supported_http_methods & BIT(HTTP_GET))) {
+		return 0;
+	}
+
+	ret = fs_stat(static_fs_detail->fs_path, &entry);
+	if (ret < 0 || entry.type != FS_DIR_ENTRY_FILE) {
+		return -ENOENT;
+	}
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, static_fs_detail->fs_path, FS_O_READ);
+	if (ret < 0) {
+		LOG_DBG("Cannot open %s (%d)", static_fs_detail->fs_path, ret);
+		return -ENOENT;
+	}
+
+	ret = send_http1_static_headers(&static_fs_detail->common, STATUS_200,
+					static_fs_detail->common.content_encoding,
+					NULL, entry.size, client);
+	if (ret < 0) {
+		goto out;
+	}
+
+	ret = http_server_sendfile(client, &file, entry.size);
+
+out:
+	(void)fs_close(&file);
+
+	return ret;
+}
+#endif /* CONFIG_HTTP_SERVER_STATIC_FS */
+
 #define RESPONSE_TEMPLATE_CHUNKED			\
 	"HTTP/1.1 200 OK\r\n"				\
 	"%s%s\r\n"					\
@@ -109,7 +234,7 @@ static int dynamic_get_req(struct http_resource_detail_dynamic *dynamic_detail,
 			   struct http_client_ctx *client)
 {
 	/* offset tells from where the GET params start */
-	int ret, remaining, offset = dynamic_detail->common.path_len;
+	int ret, remaining, offset = client->path_len;
 	char *ptr;
 	char tmp[TEMP_BUF_LEN];
 
@@ -119,7 +244,7 @@ static int dynamic_get_req(struct http_resource_detail_dynamic *dynamic_detail,
 		return ret;
 	}
 
-	remaining = strlen(&client->url_buffer[dynamic_detail->common.path_len]);
+	remaining = strlen(&client->url_buffer[client->path_len]);
 
 	/* Pass URL to the client */
 	while (1) {
@@ -165,7 +290,7 @@ static int dynamic_get_req(struct http_resource_detail_dynamic *dynamic_detail,
 		break;
 	}
 
-	dynamic_detail->holder = NULL;
+	(void)http_server_dynamic_release(dynamic_detail, client);
 
 	ret = http_server_sendall(client, final_chunk,
 				  sizeof(final_chunk) - 1);
@@ -248,7 +373,7 @@ static int dynamic_post_req(struct http_resource_detail_dynamic *dynamic_detail,
 			return ret;
 		}
 
-		dynamic_detail->holder = NULL;
+		(void)http_server_dynamic_release(dynamic_detail, client);
 	}
 
 	return 0;
@@ -271,7 +396,7 @@ static int handle_http1_dynamic_resource(
 		return -ENOPROTOOPT;
 	}
 
-	if (dynamic_detail->holder != NULL && dynamic_detail->holder != client) {
+	if (!http_server_dynamic_claim(dynamic_detail, client)) {
 		static const char conflict_response[] =
 				"HTTP/1.1 409 Conflict\r\n\r\n";
 
@@ -285,8 +410,6 @@ static int handle_http1_dynamic_resource(
 		return enter_http_done_state(client);
 	}
 
-	dynamic_detail->holder = client;
-
 	switch (client->method) {
 	case HTTP_HEAD:
 		if (user_method & BIT(HTTP_HEAD)) {
@@ -296,7 +419,7 @@ static int handle_http1_dynamic_resource(
 				return ret;
 			}
 
-			dynamic_detail->holder = NULL;
+			(void)http_server_dynamic_release(dynamic_detail, client);
 
 			return 0;
 		}
@@ -358,6 +481,14 @@ static int on_header_field(struct http_parser *parser, const char *at,
 					       "Sec-WebSocket-Key",
 					       sizeof("Sec-WebSocket-Key") - 1) == 0) {
 				ctx->websocket_sec_key_next = true;
+			} else if (strncasecmp(ctx->header_buffer,
+					       "Accept-Encoding",
+					       sizeof("Accept-Encoding") - 1) == 0) {
+				ctx->accept_encoding_next = true;
+			} else if (strncasecmp(ctx->header_buffer,
+					       "If-None-Match",
+					       sizeof("If-None-Match") - 1) == 0) {
+				ctx->if_none_match_next = true;
 			}
 
 			ctx->header_buffer[0] = '\0';
@@ -381,6 +512,8 @@ static int on_header_value(struct http_parser *parser,
 		LOG_DBG("Header %s too long (by %zu bytes)", "value",
 			offset + length - sizeof(ctx->header_buffer) - 1U);
 		ctx->header_buffer[0] = '\0';
+		ctx->accept_encoding_next = false;
+		ctx->if_none_match_next = false;
 	} else {
 		memcpy(ctx->header_buffer + offset, at, length);
 		offset += length;
@@ -408,6 +541,20 @@ static int on_header_value(struct http_parser *parser,
 				ctx->websocket_sec_key_next = false;
 			}
 
+			if (ctx->accept_encoding_next) {
+				http_server_parse_accept_encoding(
+					ctx, (const char *)ctx->header_buffer,
+					offset);
+				ctx->accept_encoding_next = false;
+			}
+
+			if (ctx->if_none_match_next) {
+				http_server_set_if_none_match(
+					ctx, (const char *)ctx->header_buffer,
+					offset);
+				ctx->if_none_match_next = false;
+			}
+
 			ctx->header_buffer[0] = '\0';
 		}
 	}
@@ -487,14 +634,16 @@ int enter_http1_request(struct http_client_ctx *client)
 	client->parser_state = HTTP1_INIT_HEADER_STATE;
 
 	memset(client->header_buffer, 0, sizeof(client->header_buffer));
+	memset(client->if_none_match, 0, sizeof(client->if_none_match));
+	client->accept_gzip = false;
 
 	return 0;
 }
 
 int handle_http1_request(struct http_client_ctx *client)
 {
-	int ret, path_len = 0;
 	struct http_resource_detail *detail;
+	int ret;
 	bool skip_headers = (client->parser_state < HTTP1_RECEIVING_DATA_STATE);
 	size_t parsed;
 
@@ -553,7 +702,8 @@ int handle_http1_request(struct http_client_ctx *client)
 		if (client->websocket_upgrade) {
 			if (IS_ENABLED(CONFIG_HTTP_SERVER_WEBSOCKET)) {
 				detail = get_resource_detail(client->url_buffer,
-							     &path_len, true);
+							     &client->path_len,
+							     true);
 				if (detail == NULL) {
 					goto not_found;
 				}
@@ -592,10 +742,9 @@ upgrade_not_found:
 		}
 	}
 
-	detail = get_resource_detail(client->url_buffer, &path_len, false);
+	detail = get_resource_detail(client->url_buffer, &client->path_len,
+				     false);
 	if (detail != NULL) {
-		detail->path_len = path_len;
-
 		if (detail->type == HTTP_RESOURCE_TYPE_STATIC) {
 			ret = handle_http1_static_resource(
 				(struct http_resource_detail_static *)detail,
@@ -610,6 +759,19 @@ upgrade_not_found:
 			if (ret < 0) {
 				return ret;
 			}
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+		} else if (detail->type == HTTP_RESOURCE_TYPE_STATIC_FS) {
+			ret = handle_http1_static_fs_resource(
+				(struct http_resource_detail_static_fs *)detail,
+				client);
+			if (ret == -ENOENT) {
+				goto not_found;
+			}
+
+			if (ret < 0) {
+				return ret;
+			}
+#endif
 		}
 	} else {
 not_found: ; /* Add extra semicolon to make clang to compile when using label */
@@ -20,6 +20,10 @@ LOG_MODULE_DECLARE(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
 
 #include "headers/server_internal.h"
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+#include <zephyr/fs/fs.h>
+#endif
+
 static const char content_404[] = {
 #ifdef INCLUDE_HTML_CONTENT
 #include "not_found_page.html.gz.inc"
@@ -79,6 +83,11 @@ static void print_http_frames(struct http_client_ctx *client)
 static struct http_stream_ctx *find_http_stream_context(
 			struct http_client_ctx *client, uint32_t stream_id)
 {
+	/* Free slots have stream ID 0, which refers to the connection */
+	if (stream_id == 0) {
+		return NULL;
+	}
+
 	ARRAY_FOR_EACH(client->streams, i) {
 		if (client->streams[i].stream_id == stream_id) {
 			return &client->streams[i];
@@ -97,6 +106,13 @@ static struct http_stream_ctx *allocate_http_stream_context(
 			client->streams[i].stream_state = HTTP_SERVER_STREAM_OPEN;
 			client->streams[i].window_size =
 				HTTP_SERVER_INITIAL_WINDOW_SIZE;
+			client->streams[i].send_window_size =
+				client->peer_initial_window_size;
+			client->streams[i].depends_on = 0;
+			client->streams[i].weight = HTTP_SERVER_DEFAULT_WEIGHT;
+			client->streams[i].vtime = client->sched_vtime;
+			client->streams[i].pending_data = NULL;
+			client->streams[i].pending_len = 0;
 			return &client->streams[i];
 		}
 	}
@@ -104,16 +120,119 @@ static struct http_stream_ctx *allocate_http_stream_context(
 	return NULL;
 }
 
+static void drop_pending_data(struct http_stream_ctx *stream)
+{
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+	if (stream->pending_file) {
+		(void)fs_close(&stream->file);
+		stream->pending_file = false;
+	}
+#endif
+
+	stream->pending_data = NULL;
+	stream->pending_len = 0;
+}
+
 static void release_http_stream_context(struct http_client_ctx *client,
 					uint32_t stream_id)
 {
+	struct http_stream_ctx *stream;
+
+	stream = find_http_stream_context(client, stream_id);
+	if (stream == NULL) {
+		return;
+	}
+
+	drop_pending_data(stream);
+
+	/* Streams depending on the released one move up to its parent */
 	ARRAY_FOR_EACH(client->streams, i) {
-		if (client->streams[i].stream_id == stream_id) {
-			client->streams[i].stream_id = 0;
-			client->streams[i].stream_state = HTTP_SERVER_STREAM_IDLE;
+		if (client->streams[i].depends_on == stream_id) {
+			client->streams[i].depends_on = stream->depends_on;
+		}
+	}
+
+	stream->stream_id = 0;
+	stream->stream_state = HTTP_SERVER_STREAM_IDLE;
+}
+
+/* The remote end closed the stream, release it unless a response is still
+ * being sent on it.
+ */
+static void end_remote_stream(struct http_client_ctx *client,
+			      struct http_stream_ctx *stream)
+{
+	if (stream->pending_len > 0) {
+		stream->stream_state = HTTP_SERVER_STREAM_HALF_CLOSED_REMOTE;
+	} else {
+		release_http_stream_context(client, stream->stream_id);
+	}
+}
+
+void release_http2_streams(struct http_client_ctx *client)
+{
+	ARRAY_FOR_EACH(client->streams, i) {
+		if (client->streams[i].stream_state != HTTP_SERVER_STREAM_IDLE) {
+			drop_pending_data(&client->streams[i]);
+		}
+	}
+}
+
+static void init_http2_connection_state(struct http_client_ctx *client)
+{
+	client->send_window_size = HTTP_SERVER_DEFAULT_WINDOW_SIZE;
+	client->peer_initial_window_size = HTTP_SERVER_DEFAULT_WINDOW_SIZE;
+	client->sched_vtime = 0;
+	http_hpack_encoder_init(&client->hpack_encoder);
+}
+
+/* Apply the 5 bytes of priority fields of a PRIORITY or HEADERS frame, using
+ * the RFC 7540 dependency tree. A stream is not scheduled while the stream it
+ * depends on has data pending, and streams sharing a parent get a share of
+ * the connection proportional to their weight.
+ */
+static int set_stream_priority(struct http_client_ctx *client,
+			       struct http_stream_ctx *stream,
+			       const uint8_t *fields)
+{
+	uint32_t depends_on = sys_get_be32(fields) & 0x7FFFFFFF;
+	bool exclusive = (fields[0] & 0x80) != 0;
+	struct http_stream_ctx *parent, *ancestor;
+	int depth = 0;
+
+	if (depends_on == stream->stream_id) {
+		LOG_DBG("Stream %d depends on itself", stream->stream_id);
+		return -EBADMSG;
+	}
+
+	/* If the new parent is a descendant of the stream, it is moved to the
+	 * former parent of the stream first.
+	 */
+	parent = find_http_stream_context(client, depends_on);
+	ancestor = parent;
+	while (ancestor != NULL && depth++ < ARRAY_SIZE(client->streams)) {
+		if (ancestor->depends_on == stream->stream_id) {
+			parent->depends_on = stream->depends_on;
 			break;
 		}
+
+		ancestor = find_http_stream_context(client, ancestor->depends_on);
+	}
+
+	if (exclusive) {
+		ARRAY_FOR_EACH(client->streams, i) {
+			if (client->streams[i].stream_state != HTTP_SERVER_STREAM_IDLE &&
+			    client->streams[i].depends_on == depends_on &&
+			    &client->streams[i] != stream) {
+				client->streams[i].depends_on = stream->stream_id;
+			}
+		}
 	}
+
+	stream->depends_on = depends_on;
+	stream->weight = fields[4] + 1;
+
+	return 0;
 }
 
 static int add_header_field(struct http_client_ctx *client, uint8_t **buf,
@@ -126,7 +245,8 @@ static int add_header_field(struct http_client_ctx *client, uint8_t **buf,
 	client->header_field.value = value;
 	client->header_field.value_len = strlen(value);
 
-	ret = http_hpack_encode_header(*buf, *buflen, &client->header_field);
+	ret = http_hpack_encoder_encode(&client->hpack_encoder, *buf, *buflen,
+					&client->header_field);
 	if (ret < 0) {
 		return ret;
 	}
@@ -152,7 +272,11 @@ static int send_headers_frame(struct http_client_ctx *client,
 			      struct http_resource_detail *detail_common,
 			      uint8_t flags)
 {
-	uint8_t headers_frame[64];
+	struct http_resource_detail_static *static_detail = NULL;
+	char etag_buf[HTTP_SERVER_MAX_ETAG_LEN];
+	uint8_t headers_frame[128];
+	const char *encoding = NULL;
+	const char *etag = NULL;
 	uint8_t status_str[4];
 	uint8_t *buf = headers_frame + HTTP_SERVER_FRAME_HEADER_SIZE;
 	size_t buflen = sizeof(headers_frame) - HTTP_SERVER_FRAME_HEADER_SIZE;
@@ -169,9 +293,19 @@ static int send_headers_frame(struct http_client_ctx *client,
 		return ret;
 	}
 
-	if (detail_common && detail_common->content_encoding != NULL) {
+	if (detail_common && detail_common->type == HTTP_RESOURCE_TYPE_STATIC) {
+		static_detail = (struct http_resource_detail_static *)detail_common;
+	}
+
+	if (static_detail && http_server_static_use_gzip(client, static_detail)) {
+		encoding = "gzip";
+	} else if (detail_common) {
+		encoding = detail_common->content_encoding;
+	}
+
+	if (encoding != NULL && encoding[0] != '\0') {
 		ret = add_header_field(client, &buf, &buflen, "content-encoding",
-				       "gzip");
+				       encoding);
 		if (ret < 0) {
 			return ret;
 		}
@@ -185,6 +319,34 @@ static int send_headers_frame(struct http_client_ctx *client,
 		}
 	}
 
+	if (static_detail) {
+		etag = http_server_static_etag(client, static_detail, etag_buf,
+					       sizeof(etag_buf));
+	}
+
+	if (etag != NULL) {
+		ret = add_header_field(client, &buf, &buflen, "etag", etag);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if (static_detail && static_detail->cache_control != NULL) {
+		ret = add_header_field(client, &buf, &buflen, "cache-control",
+				       static_detail->cache_control);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if (static_detail && static_detail->static_gzip_data != NULL) {
+		ret = add_header_field(client, &buf, &buflen, "vary",
+				       "accept-encoding");
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
 	payload_len = sizeof(headers_frame) - buflen - HTTP_SERVER_FRAME_HEADER_SIZE;
 	flags |= HTTP_SERVER_FLAG_END_HEADERS;
 
@@ -201,12 +363,27 @@ static int send_headers_frame(struct http_client_ctx *client,
 	return 0;
 }
 
+static void consume_send_window(struct http_client_ctx *client,
+				uint32_t stream_id, size_t length)
+{
+	struct http_stream_ctx *stream;
+
+	client->send_window_size -= length;
+
+	stream = find_http_stream_context(client, stream_id);
+	if (stream != NULL) {
+		stream->send_window_size -= length;
+	}
+}
+
 static int send_data_frame(struct http_client_ctx *client, const char *payload,
 			   size_t length, uint32_t stream_id, uint8_t flags)
 {
 	uint8_t frame_header[HTTP_SERVER_FRAME_HEADER_SIZE];
 	int ret;
 
+	consume_send_window(client, stream_id, length);
+
 	encode_frame_header(frame_header, length, HTTP_SERVER_DATA_FRAME,
 			    end_stream_flag(flags) ?
 			    HTTP_SERVER_FLAG_END_STREAM : 0,
@@ -305,6 +482,183 @@ int send_window_update_frame(struct http_client_ctx *client,
 	return 0;
 }
 
+/* Tell the peer that the connection is closed because of a connection error.
+ * The caller closes the connection when it gets the error back.
+ */
+static int send_goaway_frame(struct http_client_ctx *client,
+			     enum http_frame_error_code error_code)
+{
+	uint8_t goaway_frame[HTTP_SERVER_FRAME_HEADER_SIZE +
+			     2 * sizeof(uint32_t)];
+	uint32_t last_stream_id = 0;
+	int ret;
+
+	ARRAY_FOR_EACH(client->streams, i) {
+		if (client->streams[i].stream_state != HTTP_SERVER_STREAM_IDLE) {
+			last_stream_id = MAX(last_stream_id,
+					     client->streams[i].stream_id);
+		}
+	}
+
+	encode_frame_header(goaway_frame, 2 * sizeof(uint32_t),
+			    HTTP_SERVER_GOAWAY_FRAME, 0, 0);
+	sys_put_be32(last_stream_id,
+		     goaway_frame + HTTP_SERVER_FRAME_HEADER_SIZE);
+	sys_put_be32(error_code, goaway_frame + HTTP_SERVER_FRAME_HEADER_SIZE +
+				 sizeof(uint32_t));
+
+	ret = http_server_sendall(client, goaway_frame, sizeof(goaway_frame));
+	if (ret < 0) {
+		LOG_DBG("Cannot write to socket (%d)", ret);
+		return ret;
+	}
+
+	return 0;
+}
+
+/* A stream may send when it has data pending and window left, and none of
+ * the streams it depends on could send instead.
+ */
+static bool stream_can_send(struct http_client_ctx *client,
+			    struct http_stream_ctx *stream)
+{
+	struct http_stream_ctx *parent;
+	int depth = 0;
+
+	if (stream->stream_state == HTTP_SERVER_STREAM_IDLE ||
+	    stream->pending_len == 0 || stream->send_window_size <= 0) {
+		return false;
+	}
+
+	parent = find_http_stream_context(client, stream->depends_on);
+	while (parent != NULL && depth++ < ARRAY_SIZE(client->streams)) {
+		if (parent->pending_len > 0 && parent->send_window_size > 0) {
+			return false;
+		}
+
+		parent = find_http_stream_context(client, parent->depends_on);
+	}
+
+	return true;
+}
+
+/* Weighted fair queueing: each stream advances its virtual time by the amount
+ * of data sent divided by its weight, and the stream furthest behind goes
+ * next. A stream joining the connection starts at the current virtual time,
+ * so a long running download does not starve it, nor the other way around.
+ */
+static struct http_stream_ctx *next_stream_to_send(struct http_client_ctx *client)
+{
+	struct http_stream_ctx *next = NULL;
+
+	if (client->send_window_size <= 0) {
+		return NULL;
+	}
+
+	ARRAY_FOR_EACH(client->streams, i) {
+		struct http_stream_ctx *stream = &client->streams[i];
+
+		if (!stream_can_send(client, stream)) {
+			continue;
+		}
+
+		if (next == NULL || (int32_t)(stream->vtime - next->vtime) < 0) {
+			next = stream;
+		}
+	}
+
+	return next;
+}
+
+static int send_pending_frame(struct http_client_ctx *client,
+			      struct http_stream_ctx *stream)
+{
+	uint8_t flags = 0;
+	size_t len;
+	int ret;
+
+	len = MIN(stream->pending_len, CONFIG_HTTP_SERVER_HTTP2_DATA_CHUNK_SIZE);
+	len = MIN(len, stream->send_window_size);
+	len = MIN(len, client->send_window_size);
+
+	if (len == stream->pending_len) {
+		flags = HTTP_SERVER_FLAG_END_STREAM;
+	}
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+	if (stream->pending_file) {
+		uint8_t frame_header[HTTP_SERVER_FRAME_HEADER_SIZE];
+
+		/* Only the frame header is built here, the payload goes
+		 * straight from the file to the socket.
+		 */
+		encode_frame_header(frame_header, len, HTTP_SERVER_DATA_FRAME,
+				    flags, stream->stream_id);
+
+		ret = http_server_sendall(client, frame_header,
+					  sizeof(frame_header));
+		if (ret < 0) {
+			LOG_DBG("Cannot write to socket (%d)", ret);
+			return ret;
+		}
+
+		ret = http_server_sendfile(client, &stream->file, len);
+		if (ret < 0) {
+			LOG_DBG("Cannot write to socket (%d)", ret);
+			return ret;
+		}
+
+		consume_send_window(client, stream->stream_id, len);
+	} else
+#endif
+	{
+		ret = send_data_frame(client, stream->pending_data, len,
+				      stream->stream_id, flags);
+		if (ret < 0) {
+			return ret;
+		}
+
+		stream->pending_data += len;
+	}
+
+	stream->pending_len -= len;
+
+	client->sched_vtime = stream->vtime;
+	stream->vtime += (len * HTTP_SERVER_MAX_WEIGHT) / stream->weight;
+
+	if (stream->pending_len == 0) {
+		drop_pending_data(stream);
+
+		if (stream->stream_state == HTTP_SERVER_STREAM_HALF_CLOSED_REMOTE) {
+			release_http_stream_context(client, stream->stream_id);
+		} else {
+			stream->stream_state = HTTP_SERVER_STREAM_HALF_CLOSED_LOCAL;
+		}
+	}
+
+	return 0;
+}
+
+int send_http2_pending_data(struct http_client_ctx *client, int max_frames)
+{
+	struct http_stream_ctx *stream;
+	int ret;
+
+	for (int i = 0; i < max_frames; i++) {
+		stream = next_stream_to_send(client);
+		if (stream == NULL) {
+			return 0;
+		}
+
+		ret = send_pending_frame(client, stream);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return next_stream_to_send(client) != NULL ? 1 : 0;
+}
+
 static int send_http2_404(struct http_client_ctx *client,
 			  struct http_frame *frame)
 {
@@ -346,41 +700,117 @@ static int handle_http2_static_resource(
 	struct http_resource_detail_static *static_detail,
 	struct http_frame *frame, struct http_client_ctx *client)
 {
+	char etag_buf[HTTP_SERVER_MAX_ETAG_LEN];
+	struct http_stream_ctx *stream;
 	const char *content_200;
 	size_t content_len;
+	const char *etag;
 	int ret;
 
 	if (!(static_detail->common.bitmask_of_supported_http_methods & BIT(HTTP_GET))) {
 		return -ENOTSUP;
 	}
 
-	content_200 = static_detail->static_data;
-	content_len = static_detail->static_data_len;
+	stream = find_http_stream_context(client, frame->stream_identifier);
+	if (stream == NULL) {
+		return -EBADMSG;
+	}
+
+	etag = http_server_static_etag(client, static_detail, etag_buf,
+				       sizeof(etag_buf));
+	if (http_server_static_not_modified(client, etag)) {
+		return send_headers_frame(client, HTTP_304_NOT_MODIFIED,
+					  frame->stream_identifier,
+					  &static_detail->common,
+					  HTTP_SERVER_FLAG_END_STREAM);
+	}
+
+	if (http_server_static_use_gzip(client, static_detail)) {
+		content_200 = static_detail->static_gzip_data;
+		content_len = static_detail->static_gzip_data_len;
+	} else {
+		content_200 = static_detail->static_data;
+		content_len = static_detail->static_data_len;
+	}
 
 	ret = send_headers_frame(client, HTTP_200_OK, frame->stream_identifier,
-				 &static_detail->common, 0);
+				 &static_detail->common,
+				 content_len == 0 ? HTTP_SERVER_FLAG_END_STREAM : 0);
 	if (ret < 0) {
 		LOG_DBG("Cannot write to socket (%d)", ret);
-		goto out;
+		return ret;
 	}
 
-	ret = send_data_frame(client, content_200, content_len,
-			      frame->stream_identifier,
-			      HTTP_SERVER_FLAG_END_STREAM);
+	if (content_len == 0) {
+		return 0;
+	}
+
+	/* The body is sent by the scheduler, interleaved with the other
+	 * streams. Send the first frame right away, small responses are
+	 * then complete without another round through poll().
+	 */
+	stream->pending_data = content_200;
+	stream->pending_len = content_len;
+
+	ret = send_http2_pending_data(client, 1);
+
+	return ret < 0 ? ret : 0;
+}
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+static int handle_http2_static_fs_resource(
+	struct http_resource_detail_static_fs *static_fs_detail,
+	struct http_frame *frame, struct http_client_ctx *client)
+{
+	struct http_stream_ctx *stream;
+	struct fs_dirent entry;
+	int ret;
+
+	if (!(static_fs_detail->common.bitmask_of_supported_http_methods & BIT(HTTP_GET))) {
+		return -ENOTSUP;
+	}
+
+	stream = find_http_stream_context(client, frame->stream_identifier);
+	if (stream == NULL) {
+		return -EBADMSG;
+	}
+
+	ret = fs_stat(static_fs_detail->fs_path, &entry);
+	if (ret < 0 || entry.type != FS_DIR_ENTRY_FILE) {
+		return send_http2_404(client, frame);
+	}
+
+	fs_file_t_init(&stream->file);
+
+	ret = fs_open(&stream->file, static_fs_detail->fs_path, FS_O_READ);
 	if (ret < 0) {
-		LOG_DBG("Cannot write to socket (%d)", ret);
-		goto out;
+		LOG_DBG("Cannot open %s (%d)", static_fs_detail->fs_path, ret);
+		return send_http2_404(client, frame);
 	}
 
-out:
-	return ret;
+	stream->pending_file = true;
+	stream->pending_len = entry.size;
+
+	ret = send_headers_frame(client, HTTP_200_OK, frame->stream_identifier,
+				 &static_fs_detail->common,
+				 entry.size == 0 ? HTTP_SERVER_FLAG_END_STREAM : 0);
+	if (ret < 0 || entry.size == 0) {
+		drop_pending_data(stream);
+		return ret;
+	}
+
+	/* The file stays open until the scheduler has sent all of it */
+	ret = send_http2_pending_data(client, 1);
+
+	return ret < 0 ? ret : 0;
 }
+#endif /* CONFIG_HTTP_SERVER_STATIC_FS */
 
 static int dynamic_get_req_v2(struct http_resource_detail_dynamic *dynamic_detail,
 			      struct http_client_ctx *client)
 {
 	struct http_frame *frame = &client->current_frame;
-	int ret, remaining, offset = dynamic_detail->common.path_len;
+	int ret, remaining, offset = client->path_len;
 	char *ptr;
 
 	ret = send_headers_frame(client, HTTP_200_OK, frame->stream_identifier,
@@ -390,7 +820,7 @@ static int dynamic_get_req_v2(struct http_resource_detail_dynamic *dynamic_detai
 		return ret;
 	}
 
-	remaining = strlen(&client->url_buffer[dynamic_detail->common.path_len]);
+	remaining = strlen(&client->url_buffer[client->path_len]);
 
 	/* Pass URL to the client */
 	while (1) {
@@ -437,7 +867,7 @@ static int dynamic_get_req_v2(struct http_resource_detail_dynamic *dynamic_detai
 			LOG_DBG("Cannot send last frame (%d)", ret);
 		}
 
-		dynamic_detail->holder = NULL;
+		(void)http_server_dynamic_release(dynamic_detail, client);
 
 		break;
 	}
@@ -537,7 +967,7 @@ static int dynamic_post_req_v2(struct http_resource_detail_dynamic *dynamic_deta
 			client->headers_sent = true;
 		}
 
-		dynamic_detail->holder = NULL;
+		(void)http_server_dynamic_release(dynamic_detail, client);
 	}
 
 
@@ -561,7 +991,7 @@ static int handle_http2_dynamic_resource(
 		return -ENOPROTOOPT;
 	}
 
-	if (dynamic_detail->holder != NULL && dynamic_detail->holder != client) {
+	if (!http_server_dynamic_claim(dynamic_detail, client)) {
 		ret = send_http2_409(client, frame);
 		if (ret < 0) {
 			return ret;
@@ -570,8 +1000,6 @@ static int handle_http2_dynamic_resource(
 		return enter_http_done_state(client);
 	}
 
-	dynamic_detail->holder = client;
-
 	switch (client->method) {
 	case HTTP_GET:
 		if (user_method & BIT(HTTP_GET)) {
@@ -621,6 +1049,7 @@ int enter_http2_request(struct http_client_ctx *client)
 			return ret;
 		}
 
+		init_http2_connection_state(client);
 		client->preface_sent = true;
 	}
 
@@ -638,6 +1067,7 @@ static int enter_http_frame_data_state(struct http_client_ctx *client)
 {
 	struct http_frame *frame = &client->current_frame;
 	struct http_stream_ctx *stream;
+	uint32_t flow_len;
 
 	if (frame->stream_identifier == 0) {
 		LOG_DBG("Stream ID 0 is forbidden for data frames.");
@@ -652,14 +1082,21 @@ static int enter_http_frame_data_state(struct http_client_ctx *client)
 	}
 
 	if (stream->stream_state != HTTP_SERVER_STREAM_OPEN &&
-	    stream->stream_state != HTTP_SERVER_STREAM_HALF_CLOSED_REMOTE) {
+	    stream->stream_state != HTTP_SERVER_STREAM_HALF_CLOSED_LOCAL) {
 		LOG_DBG("Stream ID %d in a wrong state %d", stream->stream_id,
 			stream->stream_state);
 		return -EBADMSG;
 	}
 
-	stream->window_size -= frame->length;
-	client->window_size -= frame->length;
+	flow_len = frame->length;
+
+	/* The Pad Length field and the padding count toward flow control */
+	if (frame->flags & HTTP_SERVER_FLAG_PADDED) {
+		flow_len += 1 + frame->padding;
+	}
+
+	stream->window_size -= flow_len;
+	client->window_size -= flow_len;
 	client->server_state = HTTP_SERVER_FRAME_DATA_STATE;
 
 	return 0;
@@ -670,6 +1107,11 @@ static int enter_http_frame_headers_state(struct http_client_ctx *client)
 	struct http_frame *frame = &client->current_frame;
 	struct http_stream_ctx *stream;
 
+	if (frame->stream_identifier == 0) {
+		LOG_DBG("Stream ID 0 is forbidden for headers frames.");
+		return -EBADMSG;
+	}
+
 	stream = find_http_stream_context(client, frame->stream_identifier);
 	if (!stream) {
 		LOG_DBG("|| stream ID ||  %d", frame->stream_identifier);
@@ -724,11 +1166,26 @@ static int enter_http_frame_goaway_state(struct http_client_ctx *client)
 
 int handle_http_frame_header(struct http_client_ctx *client)
 {
+	struct http_frame *frame = &client->current_frame;
+	bool padded;
 	int bytes_consumed;
 	int parse_result;
 
 	LOG_DBG("HTTP_SERVER_FRAME_HEADER");
 
+	/* Skip the padding at the end of the previous frame */
+	if (frame->padding > 0) {
+		bytes_consumed = MIN(frame->padding, client->data_len);
+
+		client->cursor += bytes_consumed;
+		client->data_len -= bytes_consumed;
+		frame->padding -= bytes_consumed;
+
+		if (frame->padding > 0) {
+			return -EAGAIN;
+		}
+	}
+
 	parse_result = parse_http_frame_header(client);
 	if (parse_result == 0) {
 		return -EAGAIN;
@@ -736,12 +1193,39 @@ int handle_http_frame_header(struct http_client_ctx *client)
 		return parse_result;
 	}
 
+	padded = (frame->type == HTTP_SERVER_DATA_FRAME ||
+		  frame->type == HTTP_SERVER_HEADERS_FRAME) &&
+		 (frame->flags & HTTP_SERVER_FLAG_PADDED);
+
 	bytes_consumed = HTTP_SERVER_FRAME_HEADER_SIZE;
 
+	if (padded) {
+		/* The Pad Length field follows the frame header */
+		if (frame->length == 0) {
+			goto padding_error;
+		}
+
+		if (client->data_len < HTTP_SERVER_FRAME_HEADER_SIZE + 1) {
+			return -EAGAIN;
+		}
+
+		frame->padding = client->cursor[HTTP_SERVER_FRAME_HEADER_SIZE];
+		if (frame->padding >= frame->length) {
+			goto padding_error;
+		}
+
+		/* The handlers see the payload only, the padding is skipped
+		 * when the next frame header is parsed.
+		 */
+		frame->length -= 1 + frame->padding;
+		frame->payload++;
+		bytes_consumed++;
+	}
+
 	client->cursor += bytes_consumed;
 	client->data_len -= bytes_consumed;
 
-	switch (client->current_frame.type) {
+	switch (frame->type) {
 	case HTTP_SERVER_DATA_FRAME:
 		return enter_http_frame_data_state(client);
 	case HTTP_SERVER_HEADERS_FRAME:
@@ -763,6 +1247,12 @@ int handle_http_frame_header(struct http_client_ctx *client)
 	}
 
 	return 0;
+
+padding_error:
+	LOG_DBG("Padding longer than the frame");
+	(void)send_goaway_frame(client, HTTP_SERVER_PROTOCOL_ERROR);
+
+	return -EBADMSG;
 }
 
 /* This feature is theoretically obsoleted in RFC9113, but curl for instance
@@ -777,7 +1267,7 @@ int handle_http1_to_http2_upgrade(struct http_client_ctx *client)
 		"\r\n";
 	struct http_frame *frame = &client->current_frame;
 	struct http_resource_detail *detail;
-	int path_len;
+	struct http_stream_ctx *stream;
 	int ret;
 
 	/* Create an artificial Data frame, so that we can proceed with HTTP2
@@ -787,6 +1277,7 @@ int handle_http1_to_http2_upgrade(struct http_client_ctx *client)
 	frame->stream_identifier = 1;
 	frame->type = HTTP_SERVER_DATA_FRAME;
 	frame->length = client->http1_frag_data_len;
+	frame->padding = 0;
 	if (client->parser_state == HTTP1_MESSAGE_COMPLETE_STATE) {
 		frame->flags = HTTP_SERVER_FLAG_END_STREAM;
 	} else {
@@ -808,13 +1299,24 @@ int handle_http1_to_http2_upgrade(struct http_client_ctx *client)
 			goto error;
 		}
 
+		init_http2_connection_state(client);
 		client->preface_sent = true;
 	}
 
-	detail = get_resource_detail(client->url_buffer, &path_len, false);
-	if (detail != NULL) {
-		detail->path_len = path_len;
+	/* The response goes out on stream 1 like any other HTTP/2 response */
+	stream = find_http_stream_context(client, frame->stream_identifier);
+	if (stream == NULL) {
+		stream = allocate_http_stream_context(client,
+						      frame->stream_identifier);
+		if (stream == NULL) {
+			ret = -ENOMEM;
+			goto error;
+		}
+	}
 
+	detail = get_resource_detail(client->url_buffer, &client->path_len,
+				     false);
+	if (detail != NULL) {
 		if (detail->type == HTTP_RESOURCE_TYPE_STATIC) {
 			ret = handle_http2_static_resource(
 				(struct http_resource_detail_static *)detail,
@@ -838,7 +1340,15 @@ int handle_http1_to_http2_upgrade(struct http_client_ctx *client)
 					goto error;
 				}
 			}
-
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+		} else if (detail->type == HTTP_RESOURCE_TYPE_STATIC_FS) {
+			ret = handle_http2_static_fs_resource(
+				(struct http_resource_detail_static_fs *)detail,
+				frame, client);
+			if (ret < 0) {
+				goto error;
+			}
+#endif
 		}
 	} else {
 		ret = send_http2_404(client, frame);
@@ -851,6 +1361,7 @@ int handle_http1_to_http2_upgrade(struct http_client_ctx *client)
 	 * to HTTP2.
 	 */
 	if (client->parser_state == HTTP1_MESSAGE_COMPLETE_STATE) {
+		end_remote_stream(client, stream);
 		client->current_detail = NULL;
 		client->server_state = HTTP_SERVER_PREFACE_STATE;
 		client->cursor += client->data_len;
@@ -915,7 +1426,7 @@ int handle_http_frame_data(struct http_client_ctx *client)
 
 		if (end_stream_flag(frame->flags)) {
 			client->current_detail = NULL;
-			release_http_stream_context(client, frame->stream_identifier);
+			end_remote_stream(client, stream);
 		}
 	}
 
@@ -971,6 +1482,14 @@ static int process_header(struct http_client_ctx *client,
 		}
 
 		client->content_len = (size_t)len;
+	} else if (header->name_len == (sizeof("accept-encoding") - 1) &&
+		   memcmp(header->name, "accept-encoding", header->name_len) == 0) {
+		http_server_parse_accept_encoding(client, header->value,
+						  header->value_len);
+	} else if (header->name_len == (sizeof("if-none-match") - 1) &&
+		   memcmp(header->name, "if-none-match", header->name_len) == 0) {
+		http_server_set_if_none_match(client, header->value,
+					      header->value_len);
 	} else {
 		/* Just ignore for now. */
 		LOG_DBG("Ignoring field %.*s", (int)header->name_len, header->name);
@@ -983,12 +1502,40 @@ int handle_http_frame_headers(struct http_client_ctx *client)
 {
 	struct http_frame *frame = &client->current_frame;
 	struct http_resource_detail *detail;
-	int ret, path_len;
+	struct http_stream_ctx *stream;
+	int ret;
 
 	LOG_DBG("HTTP_SERVER_FRAME_HEADERS");
 
 	print_http_frames(client);
 
+	if (frame->flags & HTTP_SERVER_FLAG_PRIORITY) {
+		if (frame->length < HTTP_SERVER_PRIORITY_FIELDS_LEN) {
+			return -EBADMSG;
+		}
+
+		if (client->data_len < HTTP_SERVER_PRIORITY_FIELDS_LEN) {
+			return -EAGAIN;
+		}
+
+		stream = find_http_stream_context(client, frame->stream_identifier);
+		if (stream == NULL) {
+			return -EBADMSG;
+		}
+
+		ret = set_stream_priority(client, stream, client->cursor);
+		if (ret < 0) {
+			return ret;
+		}
+
+		frame->length -= HTTP_SERVER_PRIORITY_FIELDS_LEN;
+		client->cursor += HTTP_SERVER_PRIORITY_FIELDS_LEN;
+		client->data_len -= HTTP_SERVER_PRIORITY_FIELDS_LEN;
+
+		/* The header block may need more data, parse the fields once */
+		frame->flags &= ~HTTP_SERVER_FLAG_PRIORITY;
+	}
+
 	while (frame->length > 0) {
 		struct http_hpack_header_buf *header = &client->header_field;
 
@@ -1026,10 +1573,9 @@ int handle_http_frame_headers(struct http_client_ctx *client)
 		return 0;
 	}
 
-	detail = get_resource_detail(client->url_buffer, &path_len, false);
+	detail = get_resource_detail(client->url_buffer, &client->path_len,
+				     false);
 	if (detail != NULL) {
-		detail->path_len = path_len;
-
 		if (detail->type == HTTP_RESOURCE_TYPE_STATIC) {
 			ret = handle_http2_static_resource(
 				(struct http_resource_detail_static *)detail,
@@ -1044,6 +1590,15 @@ int handle_http_frame_headers(struct http_client_ctx *client)
 			if (ret < 0) {
 				return ret;
 			}
+#if defined(CONFIG_HTTP_SERVER_STATIC_FS)
+		} else if (detail->type == HTTP_RESOURCE_TYPE_STATIC_FS) {
+			ret = handle_http2_static_fs_resource(
+				(struct http_resource_detail_static_fs *)detail,
+				frame, client);
+			if (ret < 0) {
+				return ret;
+			}
+#endif
 		}
 
 	} else {
@@ -1053,8 +1608,15 @@ int handle_http_frame_headers(struct http_client_ctx *client)
 		}
 	}
 
+	/* Request headers apply to this stream only */
+	client->accept_gzip = false;
+	client->if_none_match[0] = '\0';
+
 	if (end_stream_flag(frame->flags)) {
-		release_http_stream_context(client, frame->stream_identifier);
+		stream = find_http_stream_context(client, frame->stream_identifier);
+		if (stream != NULL) {
+			end_remote_stream(client, stream);
+		}
 	}
 
 	client->server_state = HTTP_SERVER_FRAME_HEADER_STATE;
@@ -1065,16 +1627,32 @@ int handle_http_frame_headers(struct http_client_ctx *client)
 int handle_http_frame_priority(struct http_client_ctx *client)
 {
 	struct http_frame *frame = &client->current_frame;
+	struct http_stream_ctx *stream;
 	int bytes_consumed;
+	int ret;
 
 	LOG_DBG("HTTP_SERVER_FRAME_PRIORITY_STATE");
 
 	print_http_frames(client);
 
+	if (frame->stream_identifier == 0 ||
+	    frame->length != HTTP_SERVER_PRIORITY_FIELDS_LEN) {
+		return -EBADMSG;
+	}
+
 	if (client->data_len < frame->length) {
 		return -EAGAIN;
 	}
 
+	/* Priority of idle or closed streams is not tracked */
+	stream = find_http_stream_context(client, frame->stream_identifier);
+	if (stream != NULL) {
+		ret = set_stream_priority(client, stream, client->cursor);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
 	bytes_consumed = client->current_frame.length;
 	client->data_len -= bytes_consumed;
 	client->cursor += bytes_consumed;
@@ -1101,11 +1679,92 @@ int handle_http_frame_rst_frame(struct http_client_ctx *client)
 	client->data_len -= bytes_consumed;
 	client->cursor += bytes_consumed;
 
+	/* Stop sending whatever is still pending on the stream */
+	release_http_stream_context(client, frame->stream_identifier);
+
 	client->server_state = HTTP_SERVER_FRAME_HEADER_STATE;
 
 	return 0;
 }
 
+/* Only the settings affecting the responses are applied. The DATA frames
+ * are never larger than the default SETTINGS_MAX_FRAME_SIZE, so a valid
+ * maximum frame size needs no further action.
+ */
+static int apply_settings(struct http_client_ctx *client, const uint8_t *buf,
+			  size_t len)
+{
+	const size_t field_len = sizeof(struct http_settings_field);
+	uint16_t id;
+	uint32_t value;
+	int delta;
+
+	if (len % field_len != 0) {
+		return -EBADMSG;
+	}
+
+	for (; len > 0; buf += field_len, len -= field_len) {
+		id = sys_get_be16(buf);
+		value = sys_get_be32(buf + sizeof(id));
+
+		switch (id) {
+		case HTTP_SETTINGS_HEADER_TABLE_SIZE:
+			http_hpack_encoder_set_max_size(&client->hpack_encoder,
+							value);
+			break;
+
+		case HTTP_SETTINGS_INITIAL_WINDOW_SIZE:
+			if (value > HTTP_SERVER_MAX_WINDOW_SIZE) {
+				(void)send_goaway_frame(client,
+							HTTP_SERVER_FLOW_CONTROL_ERROR);
+				return -EBADMSG;
+			}
+
+			/* The change applies to the windows of all open streams,
+			 * none of which may grow past the maximum window size.
+			 */
+			delta = (int)value - client->peer_initial_window_size;
+
+			ARRAY_FOR_EACH(client->streams, i) {
+				if (client->streams[i].stream_state !=
+				    HTTP_SERVER_STREAM_IDLE &&
+				    (int64_t)client->streams[i].send_window_size + delta >
+				    HTTP_SERVER_MAX_WINDOW_SIZE) {
+					(void)send_goaway_frame(
+						client, HTTP_SERVER_FLOW_CONTROL_ERROR);
+					return -EBADMSG;
+				}
+			}
+
+			client->peer_initial_window_size = value;
+
+			ARRAY_FOR_EACH(client->streams, i) {
+				if (client->streams[i].stream_state !=
+				    HTTP_SERVER_STREAM_IDLE) {
+					client->streams[i].send_window_size += delta;
+				}
+			}
+
+			break;
+
+		case HTTP_SETTINGS_MAX_FRAME_SIZE:
+			if (value < HTTP_SERVER_MIN_MAX_FRAME_SIZE ||
+			    value > HTTP_SERVER_MAX_MAX_FRAME_SIZE) {
+				(void)send_goaway_frame(client,
+							HTTP_SERVER_PROTOCOL_ERROR);
+				return -EBADMSG;
+			}
+
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	return 0;
+}
+
 int handle_http_frame_settings(struct http_client_ctx *client)
 {
 	struct http_frame *frame = &client->current_frame;
@@ -1119,6 +1778,16 @@ int handle_http_frame_settings(struct http_client_ctx *client)
 		return -EAGAIN;
 	}
 
+	if (!settings_ack_flag(frame->flags)) {
+		int ret;
+
+		ret = apply_settings(client, client->cursor, frame->length);
+		if (ret < 0) {
+			LOG_DBG("Invalid settings (%d)", ret);
+			return ret;
+		}
+	}
+
 	bytes_consumed = client->current_frame.length;
 	client->data_len -= bytes_consumed;
 	client->cursor += bytes_consumed;
@@ -1155,6 +1824,12 @@ int handle_http_frame_goaway(struct http_client_ctx *client)
 	client->data_len -= bytes_consumed;
 	client->cursor += bytes_consumed;
 
+	/* Streams already being answered are completed before closing, as
+	 * far as the flow control windows allow.
+	 */
+	while (send_http2_pending_data(client, ARRAY_SIZE(client->streams)) > 0) {
+	}
+
 	enter_http_done_state(client);
 
 	return 0;
@@ -1163,18 +1838,45 @@ int handle_http_frame_goaway(struct http_client_ctx *client)
 int handle_http_frame_window_update(struct http_client_ctx *client)
 {
 	struct http_frame *frame = &client->current_frame;
+	struct http_stream_ctx *stream;
+	uint32_t increment;
 	int bytes_consumed;
+	int *window;
 
 	LOG_DBG("HTTP_SERVER_FRAME_WINDOW_UPDATE");
 
 	print_http_frames(client);
 
-	/* TODO Implement flow control, for now just ignore. */
+	if (frame->length != sizeof(uint32_t)) {
+		return -EBADMSG;
+	}
 
 	if (client->data_len < frame->length) {
 		return -EAGAIN;
 	}
 
+	increment = sys_get_be32(client->cursor) & 0x7FFFFFFF;
+	if (increment == 0) {
+		return -EBADMSG;
+	}
+
+	if (frame->stream_identifier == 0) {
+		window = &client->send_window_size;
+	} else {
+		/* Updates for streams already closed are ignored */
+		stream = find_http_stream_context(client, frame->stream_identifier);
+		window = stream != NULL ? &stream->send_window_size : NULL;
+	}
+
+	if (window != NULL) {
+		if ((int64_t)*window + increment > HTTP_SERVER_MAX_WINDOW_SIZE) {
+			LOG_DBG("Flow control window overflow");
+			return -EBADMSG;
+		}
+
+		*window += increment;
+	}
+
 	bytes_consumed = client->current_frame.length;
 	client->data_len -= bytes_consumed;
 	client->cursor += bytes_consumed;
@@ -1228,6 +1930,7 @@ int parse_http_frame_header(struct http_client_ctx *client)
 
 	frame->length = 0;
 	frame->stream_identifier = 0;
+	frame->padding = 0;
 
 	if (buffer_len < HTTP_SERVER_FRAME_HEADER_SIZE) {
 		return 0;
@@ -0,0 +1,287 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/http/service.h>
+
+LOG_MODULE_DECLARE(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include "headers/server_internal.h"
+
+/* Radix tree over the resource paths of all services, built once when the
+ * server is started. Literal path fragments are stored as compressed edges,
+ * a "{name}" segment is a separate parameter child matching any single path
+ * segment, and a trailing "*" marks the node as a prefix route. Edge labels
+ * point into the resource strings, which live in ROM for the whole system
+ * lifetime.
+ */
+struct http_route_node {
+	const char *label;
+	struct http_route_node *child;
+	struct http_route_node *next;
+	struct http_route_node *param;
+	/* Indexed by is_websocket */
+	struct http_resource_desc *exact[2];
+	struct http_resource_desc *prefix[2];
+	uint16_t label_len;
+};
+
+static struct http_route_node route_nodes[CONFIG_HTTP_SERVER_ROUTE_NODES];
+static int route_nodes_used;
+static struct http_route_node *route_root;
+
+static struct http_route_node *route_node_alloc(const char *label, size_t len)
+{
+	struct http_route_node *node;
+
+	if (route_nodes_used >= ARRAY_SIZE(route_nodes)) {
+		return NULL;
+	}
+
+	node = &route_nodes[route_nodes_used++];
+	memset(node, 0, sizeof(*node));
+	node->label = label;
+	node->label_len = len;
+
+	return node;
+}
+
+static struct http_route_node *route_insert_literal(struct http_route_node *node,
+						    const char *str, size_t len)
+{
+	struct http_route_node **link;
+	struct http_route_node *child;
+	struct http_route_node *split;
+	size_t common;
+
+	while (len > 0) {
+		for (link = &node->child; *link != NULL; link = &(*link)->next) {
+			if ((*link)->label[0] == str[0]) {
+				break;
+			}
+		}
+
+		child = *link;
+		if (child == NULL) {
+			child = route_node_alloc(str, len);
+			if (child == NULL) {
+				return NULL;
+			}
+
+			*link = child;
+			return child;
+		}
+
+		common = 1;
+		while (common < MIN(len, child->label_len) &&
+		       child->label[common] == str[common]) {
+			common++;
+		}
+
+		if (common < child->label_len) {
+			/* Split the edge, the new node takes the common part */
+			split = route_node_alloc(child->label, common);
+			if (split == NULL) {
+				return NULL;
+			}
+
+			split->next = child->next;
+			split->child = child;
+			child->next = NULL;
+			child->label += common;
+			child->label_len -= common;
+			*link = split;
+			child = split;
+		}
+
+		node = child;
+		str += common;
+		len -= common;
+	}
+
+	return node;
+}
+
+static int route_insert(struct http_resource_desc *resource)
+{
+	struct http_resource_detail *detail = resource->detail;
+	bool is_ws = detail->type == HTTP_RESOURCE_TYPE_WEBSOCKET;
+	struct http_route_node *node = route_root;
+	const char *str = resource->resource;
+	struct http_resource_desc **slot;
+	const char *end;
+
+	while (*str != '\0') {
+		if (*str == '*' && str[1] == '\0') {
+			break;
+		}
+
+		if (*str == '{') {
+			end = strchr(str, '}');
+			if (end == NULL || (end[1] != '\0' && end[1] != '/')) {
+				LOG_ERR("Invalid parameter in resource %s",
+					resource->resource);
+				return -EINVAL;
+			}
+
+			if (node->param == NULL) {
+				node->param = route_node_alloc(NULL, 0);
+				if (node->param == NULL) {
+					return -ENOMEM;
+				}
+			}
+
+			node = node->param;
+			str = end + 1;
+			continue;
+		}
+
+		end = str + 1;
+		while (*end != '\0' && *end != '{' &&
+		       !(*end == '*' && end[1] == '\0')) {
+			end++;
+		}
+
+		node = route_insert_literal(node, str, end - str);
+		if (node == NULL) {
+			return -ENOMEM;
+		}
+
+		str = end;
+	}
+
+	slot = (*str == '*') ? &node->prefix[is_ws] : &node->exact[is_ws];
+
+	/* First service registering a path wins, as with a linear scan */
+	if (*slot == NULL) {
+		*slot = resource;
+	} else {
+		LOG_DBG("Resource %s shadowed by an earlier one",
+			resource->resource);
+	}
+
+	return 0;
+}
+
+int http_server_route_init(void)
+{
+	int ret;
+
+	if (route_root != NULL) {
+		return 0;
+	}
+
+	route_nodes_used = 0;
+
+	route_root = route_node_alloc(NULL, 0);
+	if (route_root == NULL) {
+		return -ENOMEM;
+	}
+
+	HTTP_SERVICE_FOREACH(service) {
+		HTTP_SERVICE_FOREACH_RESOURCE(service, resource) {
+			ret = route_insert(resource);
+			if (ret == -ENOMEM) {
+				LOG_ERR("Out of route nodes, increase "
+					"CONFIG_HTTP_SERVER_ROUTE_NODES");
+				route_root = NULL;
+				return ret;
+			}
+		}
+	}
+
+	LOG_DBG("Resource tree uses %d of %d nodes", route_nodes_used,
+		CONFIG_HTTP_SERVER_ROUTE_NODES);
+
+	return 0;
+}
+
+static bool is_path_end(char c)
+{
+	return c == '\0' || c == '?';
+}
+
+/* Exact matches are preferred over parameters, which are preferred over
+ * prefix routes, so backtracking is only needed when a path walks into a
+ * literal or parameter branch that dead-ends.
+ */
+static struct http_resource_desc *route_match(const struct http_route_node *node,
+					      const char *path, int pos,
+					      bool is_ws, int *path_len)
+{
+	const struct http_route_node *child;
+	struct http_resource_desc *resource;
+	int end;
+
+	if (is_path_end(path[pos])) {
+		if (node->exact[is_ws] != NULL) {
+			*path_len = pos;
+			return node->exact[is_ws];
+		}
+
+		goto prefix;
+	}
+
+	for (child = node->child; child != NULL; child = child->next) {
+		if (child->label[0] != path[pos]) {
+			continue;
+		}
+
+		/* Labels never contain '?' or '\0', so a terminator in the
+		 * path always shows up as a mismatch here.
+		 */
+		if (strncmp(&path[pos], child->label, child->label_len) == 0) {
+			resource = route_match(child, path, pos + child->label_len,
+					       is_ws, path_len);
+			if (resource != NULL) {
+				return resource;
+			}
+		}
+
+		break;
+	}
+
+	if (node->param != NULL && path[pos] != '/') {
+		end = pos;
+		while (!is_path_end(path[end]) && path[end] != '/') {
+			end++;
+		}
+
+		resource = route_match(node->param, path, end, is_ws, path_len);
+		if (resource != NULL) {
+			return resource;
+		}
+	}
+
+prefix:
+	if (node->prefix[is_ws] != NULL) {
+		*path_len = pos;
+		return node->prefix[is_ws];
+	}
+
+	return NULL;
+}
+
+struct http_resource_desc *http_server_route_lookup(const char *path,
+						    int *path_len,
+						    bool is_websocket)
+{
+	if (route_root == NULL) {
+		return NULL;
+	}
+
+	return route_match(route_root, path, 0, is_websocket, path_len);
+}
+
+bool http_server_route_ready(void)
+{
+	return route_root != NULL;
+}
@@ -583,12 +583,18 @@ void lwm2m_socket_del(struct lwm2m_ctx *ctx)
 	lwm2m_engine_wake_up();
 }
 
-/* Generate notify messages. Return timestamp of next Notify event */
+/* Generate notify messages. Return timestamp of next Notify event
+ *
+ * Notifications of the context due before the end of its current batch are
+ * sent along with the ones that are due now, so that the radio is woken up
+ * once for all of them.
+ */
 static int64_t check_notifications(struct lwm2m_ctx *ctx, const int64_t timestamp)
 {
 	struct observe_node *obs;
 	int rc;
 	int64_t next = INT64_MAX;
+	int64_t due = MAX(timestamp, ctx->notify_batch_end);
 
 	lwm2m_registry_lock();
 	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->observer, obs, node) {
@@ -600,7 +606,15 @@ static int64_t check_notifications(struct lwm2m_ctx *ctx, const int64_t timestam
 			next = obs->event_timestamp;
 		}
 
-		if (timestamp < obs->event_timestamp) {
+		if (due < obs->event_timestamp) {
+			continue;
+		}
+		/* Only periodic notifications join a batch early, and not
+		 * before pmin. Resource changes get their whole coalescing
+		 * window.
+		 */
+		if (timestamp < obs->event_timestamp &&
+		    (obs->resource_update || timestamp < obs->min_timestamp)) {
 			continue;
 		}
 		/* Check That There is not pending process*/
@@ -618,7 +632,15 @@ static int64_t check_notifications(struct lwm2m_ctx *ctx, const int64_t timestam
 		obs->last_timestamp = timestamp;
 
 		if (!rc) {
-			/* create at most one notification */
+			if (ctx->notify_batch_end < timestamp) {
+				ctx->notify_batch_end =
+					timestamp + CONFIG_LWM2M_ENGINE_NOTIFY_COALESCE_WINDOW;
+			}
+
+			/* create at most one notification, and come back for the
+			 * rest of the batch
+			 */
+			next = timestamp;
 			goto cleanup;
 		}
 	}
@@ -458,6 +458,7 @@ void lwm2m_engine_context_init(struct lwm2m_ctx *client_ctx)
 {
 	sys_slist_init(&client_ctx->pending_sends);
 	sys_slist_init(&client_ctx->observer);
+	client_ctx->notify_batch_end = 0;
 	client_ctx->connection_suspended = false;
 #if defined(CONFIG_LWM2M_QUEUE_MODE_ENABLED)
 	client_ctx->buffer_client_messages = true;
@@ -1640,6 +1641,7 @@ static int lwm2m_perform_read_object_instance(struct lwm2m_message *msg,
 {
 	struct lwm2m_engine_res *res = NULL;
 	struct lwm2m_engine_obj_field *obj_field;
+	int first, end;
 	int ret = 0;
 
 	while (obj_inst) {
@@ -1655,12 +1657,17 @@ static int lwm2m_perform_read_object_instance(struct lwm2m_message *msg,
 			return ret;
 		}
 
-		for (int index = 0; index < obj_inst->resource_count; index++) {
-			if (msg->path.level > LWM2M_PATH_LEVEL_OBJECT_INST &&
-			    msg->path.res_id != obj_inst->resources[index].res_id) {
-				continue;
-			}
+		first = 0;
+		end = obj_inst->resource_count;
+
+		/* A resource path only reads that resource */
+		if (msg->path.level > LWM2M_PATH_LEVEL_OBJECT_INST) {
+			res = lwm2m_get_engine_res(obj_inst, msg->path.res_id);
+			first = res ? res - obj_inst->resources : end;
+			end = res ? first + 1 : end;
+		}
 
+		for (int index = first; index < end; index++) {
 			res = &obj_inst->resources[index];
 			msg->path.res_id = res->res_id;
 			obj_field = lwm2m_get_engine_obj_field(obj_inst->obj, res->res_id);
@@ -213,6 +213,14 @@ struct lwm2m_engine_obj {
 
 	/* Object is a core object (defined in the official LwM2M spec.) */
 	bool is_core : 1;
+
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+	/* Fields are sorted by resource ID */
+	bool fields_sorted : 1;
+
+	/* next object in the same index bucket */
+	struct lwm2m_engine_obj *index_next;
+#endif
 };
 
 /* Resource instances with this value are considered "not created" yet */
@@ -418,6 +426,14 @@ struct lwm2m_engine_obj_inst {
 	/* object instance member data */
 	uint16_t obj_inst_id;
 	uint16_t resource_count;
+
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+	/* Resources are sorted by resource ID */
+	bool resources_sorted;
+
+	/* next object instance in the same index bucket */
+	struct lwm2m_engine_obj_inst *index_next;
+#endif
 };
 
 /* Initialize resource instances prior to use */
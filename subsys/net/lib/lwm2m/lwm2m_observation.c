@@ -204,8 +204,9 @@ static int engine_observe_get_attributes(const struct lwm2m_obj_path *path,
 	struct lwm2m_engine_obj *obj;
 	struct lwm2m_engine_obj_field *obj_field = NULL;
 	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+	struct lwm2m_engine_res *res;
 	struct lwm2m_engine_res_inst *res_inst = NULL;
-	int ret, i;
+	int ret;
 
 	/* defaults from server object */
 	attrs->pmin = lwm2m_server_get_pmin(srv_obj_inst);
@@ -241,20 +242,15 @@ static int engine_observe_get_attributes(const struct lwm2m_obj_path *path,
 
 	/* check if resource exists */
 	if (path->level >= LWM2M_PATH_LEVEL_RESOURCE) {
-		for (i = 0; i < obj_inst->resource_count; i++) {
-			if (obj_inst->resources[i].res_id == path->res_id) {
-				break;
-			}
-		}
-
-		if (i == obj_inst->resource_count) {
+		res = lwm2m_get_engine_res(obj_inst, path->res_id);
+		if (!res) {
 			LOG_ERR("unable to find res_id: %u/%u/%u", path->obj_id, path->obj_inst_id,
 				path->res_id);
 			return -ENOENT;
 		}
 
 		/* load object field data */
-		obj_field = lwm2m_get_engine_obj_field(obj, obj_inst->resources[i].res_id);
+		obj_field = lwm2m_get_engine_obj_field(obj, res->res_id);
 		if (!obj_field) {
 			LOG_ERR("unable to find obj_field: %u/%u/%u", path->obj_id,
 				path->obj_inst_id, path->res_id);
@@ -266,7 +262,7 @@ static int engine_observe_get_attributes(const struct lwm2m_obj_path *path,
 			return -EPERM;
 		}
 
-		ret = update_attrs(&obj_inst->resources[i], attrs);
+		ret = update_attrs(res, attrs);
 		if (ret < 0) {
 			return ret;
 		}
@@ -358,12 +354,13 @@ int lwm2m_notify_observer_path(const struct lwm2m_obj_path *path)
 					return ret;
 				}
 
+				/* Leave time for the other resources changing with
+				 * this one, unless pmin already makes us wait.
+				 */
+				timestamp = k_uptime_get() + CONFIG_LWM2M_ENGINE_NOTIFY_COALESCE_WINDOW;
 				if (nattrs.pmin) {
-					timestamp =
-						obs->last_timestamp + MSEC_PER_SEC * nattrs.pmin;
-				} else {
-					/* Trig immediately */
-					timestamp = k_uptime_get();
+					timestamp = MAX(timestamp, obs->last_timestamp +
+								   MSEC_PER_SEC * nattrs.pmin);
 				}
 
 				if (!obs->event_timestamp || obs->event_timestamp > timestamp) {
@@ -425,7 +422,7 @@ static struct observe_node *engine_allocate_observer(sys_slist_t *path_list, boo
 
 static void engine_observe_node_init(struct observe_node *obs, const uint8_t *token,
 				     struct lwm2m_ctx *ctx, uint8_t tkl, uint16_t format,
-				     int32_t att_pmax)
+				     const struct notification_attrs *attrs)
 {
 	struct lwm2m_obj_path_list *tmp;
 
@@ -433,8 +430,9 @@ static void engine_observe_node_init(struct observe_node *obs, const uint8_t *to
 	obs->tkl = tkl;
 
 	obs->last_timestamp = k_uptime_get();
-	if (att_pmax) {
-		obs->event_timestamp = obs->last_timestamp + MSEC_PER_SEC * att_pmax;
+	obs->min_timestamp = obs->last_timestamp + MSEC_PER_SEC * attrs->pmin;
+	if (attrs->pmax) {
+		obs->event_timestamp = obs->last_timestamp + MSEC_PER_SEC * attrs->pmax;
 	} else {
 		obs->event_timestamp = 0;
 	}
@@ -621,7 +619,7 @@ static int engine_add_observer(struct lwm2m_message *msg, const uint8_t *token,
 		return -ENOMEM;
 	}
 
-	engine_observe_node_init(obs, token, msg->ctx, tkl, format, attrs.pmax);
+	engine_observe_node_init(obs, token, msg->ctx, tkl, format, &attrs);
 	return 0;
 }
 
@@ -707,7 +705,7 @@ static int engine_add_composite_observer(struct lwm2m_message *msg, const uint8_
 	if (!obs) {
 		return -ENOMEM;
 	}
-	engine_observe_node_init(obs, token, msg->ctx, tkl, format, attrs.pmax);
+	engine_observe_node_init(obs, token, msg->ctx, tkl, format, &attrs);
 	return do_composite_read_op_for_parsed_list(msg, format, &lwm2m_path_list);
 }
 
@@ -942,6 +940,8 @@ static int lwm2m_engine_observer_timestamp_update(sys_slist_t *observer,
 			return ret;
 		}
 
+		obs->min_timestamp = obs->last_timestamp + MSEC_PER_SEC * nattrs.pmin;
+
 		/* Update based on by PMax */
 		if (nattrs.pmax) {
 			/* Update Current */
@@ -1465,6 +1465,8 @@ int64_t engine_observe_shedule_next_event(struct observe_node *obs, uint16_t srv
 		return 0;
 	}
 
+	obs->min_timestamp = timestamp + MSEC_PER_SEC * attrs.pmin;
+
 	if (attrs.pmax) {
 		t_s = timestamp + MSEC_PER_SEC * attrs.pmax;
 	}
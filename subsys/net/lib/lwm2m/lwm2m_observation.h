@@ -18,6 +18,7 @@ struct observe_node {
 	uint8_t token[MAX_TOKEN_LEN];        /* Observation Token */
 	int64_t event_timestamp;             /* Timestamp for trig next Notify  */
 	int64_t last_timestamp;	             /* Timestamp from last Notify */
+	int64_t min_timestamp;               /* Earliest Notify allowed by pmin */
 	struct lwm2m_message *active_notify; /* Currently active notification */
 	uint32_t counter;
 	uint16_t format;
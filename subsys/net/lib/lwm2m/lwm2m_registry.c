@@ -89,6 +89,89 @@ static const struct default_obj_version default_obj_versions[] = {
 static sys_slist_t engine_obj_list;
 static sys_slist_t engine_obj_inst_list;
 
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+#define INDEX_SIZE CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE
+
+/* Hash tables over the lists above, chained through index_next */
+static struct lwm2m_engine_obj *engine_obj_index[INDEX_SIZE];
+static struct lwm2m_engine_obj_inst *engine_obj_inst_index[INDEX_SIZE];
+
+static inline size_t obj_index_bucket(int obj_id)
+{
+	return (uint32_t)obj_id % INDEX_SIZE;
+}
+
+static inline size_t obj_inst_index_bucket(int obj_id, int obj_inst_id)
+{
+	return ((uint32_t)obj_id * 31U + (uint32_t)obj_inst_id) % INDEX_SIZE;
+}
+
+static void obj_index_add(struct lwm2m_engine_obj *obj)
+{
+	size_t bucket = obj_index_bucket(obj->obj_id);
+
+	obj->fields_sorted = true;
+	for (int i = 1; i < obj->field_count; i++) {
+		if (obj->fields[i - 1].res_id >= obj->fields[i].res_id) {
+			obj->fields_sorted = false;
+			break;
+		}
+	}
+
+	obj->index_next = engine_obj_index[bucket];
+	engine_obj_index[bucket] = obj;
+}
+
+static void obj_index_remove(struct lwm2m_engine_obj *obj)
+{
+	struct lwm2m_engine_obj **it = &engine_obj_index[obj_index_bucket(obj->obj_id)];
+
+	while (*it != NULL) {
+		if (*it == obj) {
+			*it = obj->index_next;
+			break;
+		}
+
+		it = &(*it)->index_next;
+	}
+
+	obj->index_next = NULL;
+}
+
+static void obj_inst_index_add(struct lwm2m_engine_obj_inst *obj_inst)
+{
+	size_t bucket = obj_inst_index_bucket(obj_inst->obj->obj_id, obj_inst->obj_inst_id);
+
+	obj_inst->resources_sorted = true;
+	for (int i = 1; i < obj_inst->resource_count; i++) {
+		if (obj_inst->resources[i - 1].res_id >= obj_inst->resources[i].res_id) {
+			obj_inst->resources_sorted = false;
+			break;
+		}
+	}
+
+	obj_inst->index_next = engine_obj_inst_index[bucket];
+	engine_obj_inst_index[bucket] = obj_inst;
+}
+
+static void obj_inst_index_remove(struct lwm2m_engine_obj_inst *obj_inst)
+{
+	struct lwm2m_engine_obj_inst **it = &engine_obj_inst_index[obj_inst_index_bucket(
+		obj_inst->obj->obj_id, obj_inst->obj_inst_id)];
+
+	while (*it != NULL) {
+		if (*it == obj_inst) {
+			*it = obj_inst->index_next;
+			break;
+		}
+
+		it = &(*it)->index_next;
+	}
+
+	obj_inst->index_next = NULL;
+}
+#endif /* CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0 */
+
 /* Resource wrappers */
 sys_slist_t *lwm2m_engine_obj_list(void) { return &engine_obj_list; }
 
@@ -113,6 +196,9 @@ void lwm2m_register_obj(struct lwm2m_engine_obj *obj)
 #endif /* CONFIG_LWM2M_RD_CLIENT_SUPPORT_BOOTSTRAP */
 #endif /* CONFIG_LWM2M_ACCESS_CONTROL_ENABLE */
 	sys_slist_append(&engine_obj_list, &obj->node);
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+	obj_index_add(obj);
+#endif
 	k_mutex_unlock(&registry_lock);
 }
 
@@ -123,7 +209,11 @@ void lwm2m_unregister_obj(struct lwm2m_engine_obj *obj)
 	access_control_remove_obj(obj->obj_id);
 #endif
 	engine_remove_observer_by_id(obj->obj_id, -1);
-	sys_slist_find_and_remove(&engine_obj_list, &obj->node);
+	if (sys_slist_find_and_remove(&engine_obj_list, &obj->node)) {
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+		obj_index_remove(obj);
+#endif
+	}
 	k_mutex_unlock(&registry_lock);
 }
 
@@ -131,11 +221,20 @@ struct lwm2m_engine_obj *get_engine_obj(int obj_id)
 {
 	struct lwm2m_engine_obj *obj;
 
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+	for (obj = engine_obj_index[obj_index_bucket(obj_id)]; obj != NULL;
+	     obj = obj->index_next) {
+		if (obj->obj_id == obj_id) {
+			return obj;
+		}
+	}
+#else
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_list, obj, node) {
 		if (obj->obj_id == obj_id) {
 			return obj;
 		}
 	}
+#endif
 
 	return NULL;
 }
@@ -145,6 +244,26 @@ struct lwm2m_engine_obj_field *lwm2m_get_engine_obj_field(struct lwm2m_engine_ob
 	int i;
 
 	if (obj && obj->fields && obj->field_count > 0) {
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+		if (obj->fields_sorted) {
+			int lo = 0, hi = obj->field_count - 1;
+
+			while (lo <= hi) {
+				i = lo + (hi - lo) / 2;
+
+				if (obj->fields[i].res_id == res_id) {
+					return &obj->fields[i];
+				} else if (obj->fields[i].res_id < res_id) {
+					lo = i + 1;
+				} else {
+					hi = i - 1;
+				}
+			}
+
+			return NULL;
+		}
+#endif
+
 		for (i = 0; i < obj->field_count; i++) {
 			if (obj->fields[i].res_id == res_id) {
 				return &obj->fields[i];
@@ -155,6 +274,41 @@ struct lwm2m_engine_obj_field *lwm2m_get_engine_obj_field(struct lwm2m_engine_ob
 	return NULL;
 }
 
+struct lwm2m_engine_res *lwm2m_get_engine_res(struct lwm2m_engine_obj_inst *obj_inst, int res_id)
+{
+	int i;
+
+	if (obj_inst && obj_inst->resources && obj_inst->resource_count > 0) {
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+		if (obj_inst->resources_sorted) {
+			int lo = 0, hi = obj_inst->resource_count - 1;
+
+			while (lo <= hi) {
+				i = lo + (hi - lo) / 2;
+
+				if (obj_inst->resources[i].res_id == res_id) {
+					return &obj_inst->resources[i];
+				} else if (obj_inst->resources[i].res_id < res_id) {
+					lo = i + 1;
+				} else {
+					hi = i - 1;
+				}
+			}
+
+			return NULL;
+		}
+#endif
+
+		for (i = 0; i < obj_inst->resource_count; i++) {
+			if (obj_inst->resources[i].res_id == res_id) {
+				return &obj_inst->resources[i];
+			}
+		}
+	}
+
+	return NULL;
+}
+
 struct lwm2m_engine_obj *lwm2m_engine_get_obj(const struct lwm2m_obj_path *path)
 {
 	if (path->level < LWM2M_PATH_LEVEL_OBJECT) {
@@ -176,6 +330,9 @@ static void engine_register_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 #endif /* CONFIG_LWM2M_RD_CLIENT_SUPPORT_BOOTSTRAP */
 #endif /* CONFIG_LWM2M_ACCESS_CONTROL_ENABLE */
 	sys_slist_append(&engine_obj_inst_list, &obj_inst->node);
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+	obj_inst_index_add(obj_inst);
+#endif
 }
 
 static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
@@ -184,18 +341,31 @@ static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 	access_control_remove(obj_inst->obj->obj_id, obj_inst->obj_inst_id);
 #endif
 	engine_remove_observer_by_id(obj_inst->obj->obj_id, obj_inst->obj_inst_id);
-	sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node);
+	if (sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node)) {
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+		obj_inst_index_remove(obj_inst);
+#endif
+	}
 }
 
 struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id, int obj_inst_id)
 {
 	struct lwm2m_engine_obj_inst *obj_inst;
 
+#if CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE > 0
+	for (obj_inst = engine_obj_inst_index[obj_inst_index_bucket(obj_id, obj_inst_id)];
+	     obj_inst != NULL; obj_inst = obj_inst->index_next) {
+		if (obj_inst->obj->obj_id == obj_id && obj_inst->obj_inst_id == obj_inst_id) {
+			return obj_inst;
+		}
+	}
+#else
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst, node) {
 		if (obj_inst->obj->obj_id == obj_id && obj_inst->obj_inst_id == obj_inst_id) {
 			return obj_inst;
 		}
 	}
+#endif
 
 	return NULL;
 }
@@ -402,7 +572,7 @@ int path_to_objs(const struct lwm2m_obj_path *path, struct lwm2m_engine_obj_inst
 {
 	struct lwm2m_engine_obj_inst *oi;
 	struct lwm2m_engine_obj_field *of;
-	struct lwm2m_engine_res *r = NULL;
+	struct lwm2m_engine_res *r;
 	struct lwm2m_engine_res_inst *ri = NULL;
 	int i;
 
@@ -427,13 +597,7 @@ int path_to_objs(const struct lwm2m_obj_path *path, struct lwm2m_engine_obj_inst
 		return -ENOENT;
 	}
 
-	for (i = 0; i < oi->resource_count; i++) {
-		if (oi->resources[i].res_id == path->res_id) {
-			r = &oi->resources[i];
-			break;
-		}
-	}
-
+	r = lwm2m_get_engine_res(oi, path->res_id);
 	if (!r) {
 		if (LWM2M_HAS_PERM(of, BIT(LWM2M_FLAG_OPTIONAL))) {
 			LOG_DBG("resource %d not found", path->res_id);
@@ -25,6 +25,24 @@ static void client_reset(struct mqtt_client *client)
 	client->internal.last_activity = 0U;
 	client->internal.rx_buf_datalen = 0U;
 	client->internal.remaining_payload = 0U;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/* Topic aliases and the flow control window only live as long as
+	 * the connection. Unacknowledged messages sent again with DUP set on
+	 * the next connection take a slot again when they are sent, those
+	 * the broker holds for PUBREL are added back by the queue below.
+	 */
+	client->internal.tx_inflight = 0U;
+	client->internal.tx_alias_next = 0U;
+	client->internal.server_topic_alias_max = 0U;
+	memset(client->internal.tx_alias, 0, sizeof(client->internal.tx_alias));
+	memset(client->internal.rx_alias, 0, sizeof(client->internal.rx_alias));
+#endif
+
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+	/* Queued messages outlive the connection, and are sent again. */
+	mqtt_queue_requeue(client);
+#endif
 }
 
 /** @brief Initialize tx buffer. */
@@ -236,13 +254,163 @@ static int verify_tx_state(const struct mqtt_client *client)
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+static int inflight_find(const struct mqtt_client *client, uint16_t message_id)
+{
+	for (uint16_t i = 0U; i < client->internal.tx_inflight; i++) {
+		if (client->internal.tx_inflight_id[i] == message_id) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+bool mqtt_inflight_has(const struct mqtt_client *client, uint16_t message_id)
+{
+	return inflight_find(client, message_id) >= 0;
+}
+
+bool mqtt_inflight_window_open(const struct mqtt_client *client)
+{
+	return client->internal.tx_inflight <
+	       MIN(client->internal.server_receive_max,
+		   CONFIG_MQTT_TX_INFLIGHT_MAX);
+}
+
+void mqtt_inflight_add(struct mqtt_client *client, uint16_t message_id)
+{
+	if (mqtt_inflight_has(client, message_id)) {
+		return;
+	}
+
+	if (client->internal.tx_inflight >= CONFIG_MQTT_TX_INFLIGHT_MAX) {
+		NET_WARN("[CID %p]: Message %u not tracked, too many in flight",
+			 client, message_id);
+		return;
+	}
+
+	client->internal.tx_inflight_id[client->internal.tx_inflight++] =
+								message_id;
+}
+
+void mqtt_inflight_release(struct mqtt_client *client, uint16_t message_id)
+{
+	int i = inflight_find(client, message_id);
+
+	if (i < 0) {
+		return;
+	}
+
+	client->internal.tx_inflight--;
+	client->internal.tx_inflight_id[i] =
+		client->internal.tx_inflight_id[client->internal.tx_inflight];
+}
+
+/* Returns the outgoing alias of a topic, or the alias to assign to it with
+ * new_alias set, 0 if the topic cannot be aliased. Aliases are assigned in
+ * round-robin order once all are in use.
+ */
+static uint16_t topic_alias_find(const struct mqtt_client *client,
+				 const struct mqtt_utf8 *topic, bool *new_alias)
+{
+	uint16_t alias_max = client->internal.server_topic_alias_max;
+	const struct mqtt_topic_alias *entry;
+
+	*new_alias = false;
+
+	if ((alias_max == 0U) || (topic->size == 0U) ||
+	    (topic->size > CONFIG_MQTT_TOPIC_ALIAS_TOPIC_LEN)) {
+		return 0U;
+	}
+
+	for (uint16_t i = 0U; i < alias_max; i++) {
+		entry = &client->internal.tx_alias[i];
+
+		if ((entry->topic_len == topic->size) &&
+		    (memcmp(entry->topic, topic->utf8, topic->size) == 0)) {
+			return i + 1U;
+		}
+	}
+
+	*new_alias = true;
+
+	return client->internal.tx_alias_next + 1U;
+}
+
+static void topic_alias_store(struct mqtt_client *client, uint16_t alias,
+			      const struct mqtt_utf8 *topic)
+{
+	struct mqtt_topic_alias *entry = &client->internal.tx_alias[alias - 1];
+
+	memcpy(entry->topic, topic->utf8, topic->size);
+	entry->topic_len = topic->size;
+
+	client->internal.tx_alias_next =
+		alias % client->internal.server_topic_alias_max;
+}
+
+/* Applies the limits announced by the server to a message, and replaces its
+ * topic with an alias when possible. The original parameters are left
+ * untouched, as the alias is only committed once the message is sent.
+ */
+static int publish_prepare(const struct mqtt_client *client,
+			   const struct mqtt_publish_param *param,
+			   struct mqtt_publish_param *out, bool *new_alias)
+{
+	uint8_t qos = param->message.topic.qos;
+
+	if (qos > client->internal.server_max_qos) {
+		return -EINVAL;
+	}
+
+	/* Retransmissions on the same connection already hold a slot in the
+	 * window, those on a new connection need one like any new message.
+	 */
+	if ((qos > MQTT_QOS_0_AT_MOST_ONCE) &&
+	    !mqtt_inflight_has(client, param->message_id) &&
+	    !mqtt_inflight_window_open(client)) {
+		return -EAGAIN;
+	}
+
+	*out = *param;
+	out->prop.topic_alias = topic_alias_find(client, &param->message.topic.topic,
+						 new_alias);
+
+	if ((out->prop.topic_alias != 0U) && !*new_alias) {
+		out->message.topic.topic.size = 0U;
+	}
+
+	return 0;
+}
+
+static void publish_sent(struct mqtt_client *client,
+			 const struct mqtt_publish_param *param,
+			 uint16_t topic_alias, bool new_alias)
+{
+	if (new_alias) {
+		topic_alias_store(client, topic_alias,
+				  &param->message.topic.topic);
+	}
+
+	if (param->message.topic.qos > MQTT_QOS_0_AT_MOST_ONCE) {
+		mqtt_inflight_add(client, param->message_id);
+	}
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param)
 {
+	const struct mqtt_publish_param *publish = param;
 	int err_code;
 	struct buf_ctx packet;
 	struct iovec io_vector[2];
 	struct msghdr msg;
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	struct mqtt_publish_param publish_v5;
+	bool new_alias = false;
+#endif
 
 	NULL_PARAM_CHECK(client);
 	NULL_PARAM_CHECK(param);
@@ -261,11 +429,33 @@ int mqtt_publish(struct mqtt_client *client,
 		goto error;
 	}
 
-	err_code = publish_encode(param, &packet);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client)) {
+		err_code = publish_prepare(client, param, &publish_v5,
+					   &new_alias);
+		if (err_code < 0) {
+			goto error;
+		}
+
+		publish = &publish_v5;
+	}
+#endif
+
+	err_code = publish_encode(client, publish, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client) &&
+	    (client->internal.server_max_packet_size != 0U) &&
+	    ((packet.end - packet.cur) + param->message.payload.len >
+	     client->internal.server_max_packet_size)) {
+		err_code = -EMSGSIZE;
+		goto error;
+	}
+#endif
+
 	io_vector[0].iov_base = packet.cur;
 	io_vector[0].iov_len = packet.end - packet.cur;
 	io_vector[1].iov_base = param->message.payload.data;
@@ -278,6 +468,13 @@ int mqtt_publish(struct mqtt_client *client,
 
 	err_code = client_write_msg(client, &msg);
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if ((err_code == 0) && MQTT_IS_VERSION_5_0(client)) {
+		publish_sent(client, param, publish_v5.prop.topic_alias,
+			     new_alias);
+	}
+#endif
+
 error:
 	NET_DBG("[CID %p]:[State 0x%02x]: << result 0x%08x",
 			 client, client->internal.state, err_code);
@@ -287,6 +484,63 @@ error:
 	return err_code;
 }
 
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+int mqtt_publish_queued(struct mqtt_client *client,
+			const struct mqtt_publish_param *param)
+{
+	int err_code;
+	int ret;
+
+	NULL_PARAM_CHECK(client);
+	NULL_PARAM_CHECK(param);
+
+	NET_DBG("[CID %p]:[State 0x%02x]: >> Topic size 0x%08x, "
+		 "Data size 0x%08x", client, client->internal.state,
+		 param->message.topic.topic.size,
+		 param->message.payload.len);
+
+	mqtt_mutex_lock(client);
+
+	ret = mqtt_queue_push(client, param);
+	if (ret < 0) {
+		goto error;
+	}
+
+	/* The message is queued either way, a write error only closes the
+	 * connection.
+	 */
+	err_code = mqtt_queue_flush(client, true);
+	if (err_code < 0) {
+		NET_ERR("Transport write failed, err_code = %d, "
+			 "closing connection", err_code);
+		client_disconnect(client, err_code, true);
+	}
+
+error:
+	NET_DBG("[CID %p]:[State 0x%02x]: << result 0x%08x",
+		 client, client->internal.state, ret);
+
+	mqtt_mutex_unlock(client);
+
+	return ret;
+}
+
+int mqtt_publish_queue_len(struct mqtt_client *client)
+{
+	int len;
+
+	NULL_PARAM_CHECK(client);
+
+	mqtt_mutex_lock(client);
+
+	len = mqtt_queue_len(client);
+
+	mqtt_mutex_unlock(client);
+
+	return len;
+}
+#endif /* CONFIG_MQTT_OUTBOUND_QUEUE */
+
 int mqtt_publish_qos1_ack(struct mqtt_client *client,
 			  const struct mqtt_puback_param *param)
 {
@@ -382,6 +636,13 @@ int mqtt_publish_qos2_release(struct mqtt_client *client,
 		goto error;
 	}
 
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+	/* Already released by the outbound queue. */
+	if (mqtt_queue_released(client, param->message_id)) {
+		goto error;
+	}
+#endif
+
 	err_code = publish_release_encode(param, &packet);
 	if (err_code < 0) {
 		goto error;
@@ -494,7 +755,7 @@ int mqtt_subscribe(struct mqtt_client *client,
 		goto error;
 	}
 
-	err_code = subscribe_encode(param, &packet);
+	err_code = subscribe_encode(client, param, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -528,7 +789,7 @@ int mqtt_unsubscribe(struct mqtt_client *client,
 		goto error;
 	}
 
-	err_code = unsubscribe_encode(param, &packet);
+	err_code = unsubscribe_encode(client, param, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -69,6 +69,35 @@ static int unpack_uint16(struct buf_ctx *buf, uint16_t *val)
 	return 0;
 }
 
+/**
+ * @brief Unpacks unsigned 32 bit value from the buffer from the offset
+ *        requested.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] val Memory where the value is to be unpacked.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the buffer would be exceeded during the read
+ */
+static int unpack_uint32(struct buf_ctx *buf, uint32_t *val)
+{
+	NET_DBG(">> cur:%p, end:%p", (void *)buf->cur, (void *)buf->end);
+
+	if ((buf->end - buf->cur) < sizeof(uint32_t)) {
+		return -EINVAL;
+	}
+
+	*val = (uint32_t)*(buf->cur++) << 24;
+	*val |= (uint32_t)*(buf->cur++) << 16;
+	*val |= (uint32_t)*(buf->cur++) << 8;
+	*val |= *(buf->cur++);
+
+	NET_DBG("<< val:%08x", *val);
+
+	return 0;
+}
+
 /**
  * @brief Unpacks utf8 string from the buffer from the offset requested.
  *
@@ -188,6 +217,277 @@ static int packet_length_decode(struct buf_ctx *buf, uint32_t *length)
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/** Value of a single MQTT 5.0 property. */
+struct mqtt_property {
+	uint8_t id;
+	union {
+		uint32_t uint;
+		struct mqtt_utf8 str;
+		struct mqtt_utf8_pair pair;
+		struct mqtt_binstr bin;
+	};
+};
+
+/**
+ * @brief Unpacks the property list at the current buffer position.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position. Advanced past the property list.
+ * @param[out] props Buffer context covering the properties only, to be
+ *                   iterated with @ref unpack_property.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the buffer would be exceeded during the read
+ */
+static int unpack_properties(struct buf_ctx *buf, struct buf_ctx *props)
+{
+	uint32_t length;
+	int err_code;
+
+	err_code = packet_length_decode(buf, &length);
+	if (err_code != 0) {
+		return -EINVAL;
+	}
+
+	if ((buf->end - buf->cur) < length) {
+		return -EINVAL;
+	}
+
+	props->cur = buf->cur;
+	props->end = buf->cur + length;
+	buf->cur += length;
+
+	return 0;
+}
+
+/**
+ * @brief Unpacks a single property, the value type depends on the property
+ *        identifier.
+ *
+ * @param[inout] props A pointer to the buf_ctx structure containing current
+ *                     property list position.
+ * @param[out] prop Unpacked property.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the property is unknown or malformed.
+ */
+static int unpack_property(struct buf_ctx *props, struct mqtt_property *prop)
+{
+	uint16_t val16;
+	uint16_t len;
+	uint8_t val8;
+	int err_code;
+
+	err_code = unpack_uint8(props, &prop->id);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	switch (prop->id) {
+	case MQTT_PROP_PAYLOAD_FORMAT_INDICATOR:
+	case MQTT_PROP_REQUEST_PROBLEM_INFORMATION:
+	case MQTT_PROP_REQUEST_RESPONSE_INFORMATION:
+	case MQTT_PROP_MAXIMUM_QOS:
+	case MQTT_PROP_RETAIN_AVAILABLE:
+	case MQTT_PROP_WILDCARD_SUBSCRIPTION_AVAILABLE:
+	case MQTT_PROP_SUBSCRIPTION_IDENTIFIER_AVAILABLE:
+	case MQTT_PROP_SHARED_SUBSCRIPTION_AVAILABLE:
+		err_code = unpack_uint8(props, &val8);
+		prop->uint = val8;
+		break;
+
+	case MQTT_PROP_SERVER_KEEP_ALIVE:
+	case MQTT_PROP_RECEIVE_MAXIMUM:
+	case MQTT_PROP_TOPIC_ALIAS_MAXIMUM:
+	case MQTT_PROP_TOPIC_ALIAS:
+		err_code = unpack_uint16(props, &val16);
+		prop->uint = val16;
+		break;
+
+	case MQTT_PROP_MESSAGE_EXPIRY_INTERVAL:
+	case MQTT_PROP_SESSION_EXPIRY_INTERVAL:
+	case MQTT_PROP_WILL_DELAY_INTERVAL:
+	case MQTT_PROP_MAXIMUM_PACKET_SIZE:
+		err_code = unpack_uint32(props, &prop->uint);
+		break;
+
+	case MQTT_PROP_SUBSCRIPTION_IDENTIFIER:
+		err_code = packet_length_decode(props, &prop->uint);
+		if (err_code != 0) {
+			err_code = -EINVAL;
+		}
+		break;
+
+	case MQTT_PROP_CONTENT_TYPE:
+	case MQTT_PROP_RESPONSE_TOPIC:
+	case MQTT_PROP_ASSIGNED_CLIENT_IDENTIFIER:
+	case MQTT_PROP_AUTHENTICATION_METHOD:
+	case MQTT_PROP_RESPONSE_INFORMATION:
+	case MQTT_PROP_SERVER_REFERENCE:
+	case MQTT_PROP_REASON_STRING:
+		err_code = unpack_utf8_str(props, &prop->str);
+		break;
+
+	case MQTT_PROP_CORRELATION_DATA:
+	case MQTT_PROP_AUTHENTICATION_DATA:
+		err_code = unpack_uint16(props, &len);
+		if (err_code == 0) {
+			err_code = unpack_data(len, props, &prop->bin);
+		}
+		break;
+
+	case MQTT_PROP_USER_PROPERTY:
+		err_code = unpack_utf8_str(props, &prop->pair.name);
+		if (err_code == 0) {
+			err_code = unpack_utf8_str(props, &prop->pair.value);
+		}
+		break;
+
+	default:
+		NET_ERR("Unknown property 0x%02x", prop->id);
+		err_code = -EINVAL;
+		break;
+	}
+
+	return err_code;
+}
+
+static int connect_ack_properties_decode(struct buf_ctx *buf,
+					 struct mqtt_connack_param *param)
+{
+	struct mqtt_property prop;
+	struct buf_ctx props;
+	int err_code;
+
+	param->prop.receive_maximum = MQTT_RECEIVE_MAXIMUM_DEFAULT;
+	param->prop.maximum_qos = MQTT_QOS_2_EXACTLY_ONCE;
+	param->prop.retain_available = 1U;
+
+	err_code = unpack_properties(buf, &props);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	while (props.cur < props.end) {
+		err_code = unpack_property(&props, &prop);
+		if (err_code != 0) {
+			return err_code;
+		}
+
+		switch (prop.id) {
+		case MQTT_PROP_SESSION_EXPIRY_INTERVAL:
+			param->prop.session_expiry_interval = prop.uint;
+			break;
+		case MQTT_PROP_MAXIMUM_PACKET_SIZE:
+			param->prop.maximum_packet_size = prop.uint;
+			break;
+		case MQTT_PROP_ASSIGNED_CLIENT_IDENTIFIER:
+			param->prop.assigned_client_id = prop.str;
+			break;
+		case MQTT_PROP_REASON_STRING:
+			param->prop.reason_string = prop.str;
+			break;
+		case MQTT_PROP_RECEIVE_MAXIMUM:
+			if (prop.uint == 0U) {
+				return -EINVAL;
+			}
+
+			param->prop.receive_maximum = prop.uint;
+			break;
+		case MQTT_PROP_TOPIC_ALIAS_MAXIMUM:
+			param->prop.topic_alias_maximum = prop.uint;
+			break;
+		case MQTT_PROP_SERVER_KEEP_ALIVE:
+			param->prop.server_keep_alive = prop.uint;
+			break;
+		case MQTT_PROP_MAXIMUM_QOS:
+			param->prop.maximum_qos = prop.uint;
+			break;
+		case MQTT_PROP_RETAIN_AVAILABLE:
+			param->prop.retain_available = prop.uint;
+			break;
+		default:
+			/* Not used by the client. */
+			break;
+		}
+	}
+
+	return 0;
+}
+
+static int publish_properties_decode(struct buf_ctx *buf,
+				     struct mqtt_publish_param *param)
+{
+	struct mqtt_property prop;
+	struct buf_ctx props;
+	int user_props = 0;
+	int err_code;
+
+	memset(&param->prop, 0, sizeof(param->prop));
+
+	err_code = unpack_properties(buf, &props);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	while (props.cur < props.end) {
+		err_code = unpack_property(&props, &prop);
+		if (err_code != 0) {
+			return err_code;
+		}
+
+		switch (prop.id) {
+		case MQTT_PROP_PAYLOAD_FORMAT_INDICATOR:
+			param->prop.payload_format_indicator = prop.uint;
+			break;
+		case MQTT_PROP_MESSAGE_EXPIRY_INTERVAL:
+			param->prop.message_expiry_interval = prop.uint;
+			break;
+		case MQTT_PROP_TOPIC_ALIAS:
+			param->prop.topic_alias = prop.uint;
+			break;
+		case MQTT_PROP_CONTENT_TYPE:
+			param->prop.content_type = prop.str;
+			break;
+		case MQTT_PROP_USER_PROPERTY:
+			if (user_props < ARRAY_SIZE(param->prop.user_prop)) {
+				param->prop.user_prop[user_props++] = prop.pair;
+			}
+			break;
+		default:
+			/* Not used by the client. */
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Decodes the optional reason code following the message id of an
+ *        acknowledgment. MQTT 3.1.x packets end with the message id, and
+ *        MQTT 5.0 ones may omit the reason code on success. The properties
+ *        that may follow are not used by the client.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] reason_code Decoded reason code, 0 if not present.
+ *
+ * @retval 0 if the procedure is successful.
+ */
+static int ack_reason_code_decode(struct buf_ctx *buf, uint8_t *reason_code)
+{
+	*reason_code = 0U;
+
+	if (buf->cur >= buf->end) {
+		return 0;
+	}
+
+	return unpack_uint8(buf, reason_code);
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 int fixed_header_decode(struct buf_ctx *buf, uint8_t *type_and_flags,
 			uint32_t *length)
 {
@@ -217,7 +517,7 @@ int connect_ack_decode(const struct mqtt_client *client, struct buf_ctx *buf,
 		return err_code;
 	}
 
-	if (client->protocol_version == MQTT_VERSION_3_1_1) {
+	if (client->protocol_version != MQTT_VERSION_3_1_0) {
 		param->session_present_flag =
 			flags & MQTT_CONNACK_FLAG_SESSION_PRESENT;
 
@@ -227,12 +527,25 @@ int connect_ack_decode(const struct mqtt_client *client, struct buf_ctx *buf,
 
 	param->return_code = (enum mqtt_conn_return_code)ret_code;
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client)) {
+		memset(&param->prop, 0, sizeof(param->prop));
+
+		/* Properties may be omitted when the connection is refused. */
+		if (buf->cur < buf->end) {
+			return connect_ack_properties_decode(buf, param);
+		}
+	}
+#endif
+
 	return 0;
 }
 
-int publish_decode(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
+int publish_decode(const struct mqtt_client *client, uint8_t flags,
+		   uint32_t var_length, struct buf_ctx *buf,
 		   struct mqtt_publish_param *param)
 {
+	uint8_t *start = buf->cur;
 	int err_code;
 	uint32_t var_header_length;
 
@@ -245,16 +558,23 @@ int publish_decode(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
 		return err_code;
 	}
 
-	var_header_length = param->message.topic.topic.size + sizeof(uint16_t);
-
 	if (param->message.topic.qos > MQTT_QOS_0_AT_MOST_ONCE) {
 		err_code = unpack_uint16(buf, &param->message_id);
 		if (err_code != 0) {
 			return err_code;
 		}
+	}
 
-		var_header_length += sizeof(uint16_t);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client)) {
+		err_code = publish_properties_decode(buf, param);
+		if (err_code != 0) {
+			return err_code;
+		}
 	}
+#endif
+
+	var_header_length = buf->cur - start;
 
 	if (var_length < var_header_length) {
 		NET_ERR("Corrupted PUBLISH message, header length (%u) larger "
@@ -271,26 +591,63 @@ int publish_decode(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
 
 int publish_ack_decode(struct buf_ctx *buf, struct mqtt_puback_param *param)
 {
-	return unpack_uint16(buf, &param->message_id);
+	int err_code;
+
+	err_code = unpack_uint16(buf, &param->message_id);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (err_code == 0) {
+		err_code = ack_reason_code_decode(buf, &param->reason_code);
+	}
+#endif
+
+	return err_code;
 }
 
 int publish_receive_decode(struct buf_ctx *buf, struct mqtt_pubrec_param *param)
 {
-	return unpack_uint16(buf, &param->message_id);
+	int err_code;
+
+	err_code = unpack_uint16(buf, &param->message_id);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (err_code == 0) {
+		err_code = ack_reason_code_decode(buf, &param->reason_code);
+	}
+#endif
+
+	return err_code;
 }
 
 int publish_release_decode(struct buf_ctx *buf, struct mqtt_pubrel_param *param)
 {
-	return unpack_uint16(buf, &param->message_id);
+	int err_code;
+
+	err_code = unpack_uint16(buf, &param->message_id);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (err_code == 0) {
+		err_code = ack_reason_code_decode(buf, &param->reason_code);
+	}
+#endif
+
+	return err_code;
 }
 
 int publish_complete_decode(struct buf_ctx *buf,
 			    struct mqtt_pubcomp_param *param)
 {
-	return unpack_uint16(buf, &param->message_id);
+	int err_code;
+
+	err_code = unpack_uint16(buf, &param->message_id);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (err_code == 0) {
+		err_code = ack_reason_code_decode(buf, &param->reason_code);
+	}
+#endif
+
+	return err_code;
 }
 
-int subscribe_ack_decode(struct buf_ctx *buf, struct mqtt_suback_param *param)
+int subscribe_ack_decode(const struct mqtt_client *client,
+			 struct buf_ctx *buf, struct mqtt_suback_param *param)
 {
 	int err_code;
 
@@ -299,11 +656,51 @@ int subscribe_ack_decode(struct buf_ctx *buf, struct mqtt_suback_param *param)
 		return err_code;
 	}
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client)) {
+		struct buf_ctx props;
+
+		err_code = unpack_properties(buf, &props);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+#endif
+
 	return unpack_data(buf->end - buf->cur, buf, &param->return_codes);
 }
 
-int unsubscribe_ack_decode(struct buf_ctx *buf,
+int unsubscribe_ack_decode(const struct mqtt_client *client,
+			   struct buf_ctx *buf,
 			   struct mqtt_unsuback_param *param)
 {
-	return unpack_uint16(buf, &param->message_id);
+	int err_code;
+
+	err_code = unpack_uint16(buf, &param->message_id);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client)) {
+		struct buf_ctx props;
+
+		err_code = unpack_properties(buf, &props);
+		if (err_code != 0) {
+			return err_code;
+		}
+
+		return unpack_data(buf->end - buf->cur, buf,
+				   &param->reason_codes);
+	}
+#endif
+
+	return 0;
+}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+int disconnect_decode(struct buf_ctx *buf, uint8_t *reason_code)
+{
+	return ack_reason_code_decode(buf, reason_code);
 }
+#endif /* CONFIG_MQTT_VERSION_5_0 */
@@ -82,6 +82,33 @@ static int pack_uint16(uint16_t val, struct buf_ctx *buf)
 	return 0;
 }
 
+/**
+ * @brief Packs unsigned 32 bit value to the buffer at the offset requested.
+ *
+ * @param[in] val Value to be packed.
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -ENOMEM if there is no place in the buffer to store the value.
+ */
+static int pack_uint32(uint32_t val, struct buf_ctx *buf)
+{
+	if ((buf->end - buf->cur) < sizeof(uint32_t)) {
+		return -ENOMEM;
+	}
+
+	NET_DBG(">> val:%08x cur:%p, end:%p", val, (void *)buf->cur, (void *)buf->end);
+
+	/* Pack value. */
+	*(buf->cur++) = (val >> 24) & 0xFF;
+	*(buf->cur++) = (val >> 16) & 0xFF;
+	*(buf->cur++) = (val >> 8) & 0xFF;
+	*(buf->cur++) = val & 0xFF;
+
+	return 0;
+}
+
 /**
  * @brief Packs utf8 string to the buffer at the offset requested.
  *
@@ -162,6 +189,211 @@ static uint8_t packet_length_encode(uint32_t length, struct buf_ctx *buf)
 	return encoded_bytes;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**
+ * @brief Starts an MQTT 5.0 property list, leaving one byte for its length.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] length_pos Position of the property length in the buffer.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -ENOMEM if there is no place in the buffer to store the length.
+ */
+static int properties_start(struct buf_ctx *buf, uint8_t **length_pos)
+{
+	*length_pos = buf->cur;
+
+	return pack_uint8(0, buf);
+}
+
+/**
+ * @brief Encodes the length of a property list started with
+ *        @ref properties_start. The properties are moved forward in the rare
+ *        case their length does not fit in a single byte.
+ *
+ * @param[in] length_pos Position of the property length in the buffer.
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -ENOMEM if there is no place in the buffer to store the length.
+ */
+static int properties_finish(uint8_t *length_pos, struct buf_ctx *buf)
+{
+	uint32_t length = buf->cur - length_pos - 1;
+	uint8_t length_bytes = packet_length_encode(length, NULL);
+	struct buf_ctx length_buf = {
+		.cur = length_pos,
+		.end = length_pos + length_bytes,
+	};
+
+	if (length_bytes > 1) {
+		if ((buf->end - buf->cur) < (length_bytes - 1)) {
+			return -ENOMEM;
+		}
+
+		memmove(length_pos + length_bytes, length_pos + 1, length);
+		buf->cur += length_bytes - 1;
+	}
+
+	(void)packet_length_encode(length, &length_buf);
+
+	return 0;
+}
+
+static int pack_property_uint8(uint8_t id, uint8_t val, struct buf_ctx *buf)
+{
+	int err_code;
+
+	err_code = pack_uint8(id, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	return pack_uint8(val, buf);
+}
+
+static int pack_property_uint16(uint8_t id, uint16_t val, struct buf_ctx *buf)
+{
+	int err_code;
+
+	err_code = pack_uint8(id, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	return pack_uint16(val, buf);
+}
+
+static int pack_property_uint32(uint8_t id, uint32_t val, struct buf_ctx *buf)
+{
+	int err_code;
+
+	err_code = pack_uint8(id, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	return pack_uint32(val, buf);
+}
+
+static int pack_property_utf8_str(uint8_t id, const struct mqtt_utf8 *str,
+				  struct buf_ctx *buf)
+{
+	int err_code;
+
+	err_code = pack_uint8(id, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	return pack_utf8_str(str, buf);
+}
+
+static int pack_property_utf8_pair(uint8_t id, const struct mqtt_utf8_pair *pair,
+				   struct buf_ctx *buf)
+{
+	int err_code;
+
+	err_code = pack_property_utf8_str(id, &pair->name, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	return pack_utf8_str(&pair->value, buf);
+}
+
+static int connect_properties_encode(const struct mqtt_client *client,
+				     struct buf_ctx *buf)
+{
+	uint8_t *length_pos;
+	int err_code;
+
+	err_code = properties_start(buf, &length_pos);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	if (client->prop.session_expiry_interval != 0U) {
+		err_code = pack_property_uint32(MQTT_PROP_SESSION_EXPIRY_INTERVAL,
+						client->prop.session_expiry_interval,
+						buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	err_code = pack_property_uint16(MQTT_PROP_TOPIC_ALIAS_MAXIMUM,
+					CONFIG_MQTT_TOPIC_ALIAS_MAX, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	return properties_finish(length_pos, buf);
+}
+
+static int publish_properties_encode(const struct mqtt_publish_param *param,
+				     struct buf_ctx *buf)
+{
+	uint8_t *length_pos;
+	int err_code;
+
+	err_code = properties_start(buf, &length_pos);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	if (param->prop.payload_format_indicator != 0U) {
+		err_code = pack_property_uint8(MQTT_PROP_PAYLOAD_FORMAT_INDICATOR,
+					       param->prop.payload_format_indicator,
+					       buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	if (param->prop.message_expiry_interval != 0U) {
+		err_code = pack_property_uint32(MQTT_PROP_MESSAGE_EXPIRY_INTERVAL,
+						param->prop.message_expiry_interval,
+						buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	if (param->prop.topic_alias != 0U) {
+		err_code = pack_property_uint16(MQTT_PROP_TOPIC_ALIAS,
+						param->prop.topic_alias, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	if (param->prop.content_type.size > 0) {
+		err_code = pack_property_utf8_str(MQTT_PROP_CONTENT_TYPE,
+						  &param->prop.content_type, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(param->prop.user_prop); i++) {
+		if (param->prop.user_prop[i].name.size == 0) {
+			break;
+		}
+
+		err_code = pack_property_utf8_pair(MQTT_PROP_USER_PROPERTY,
+						   &param->prop.user_prop[i], buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
+	return properties_finish(length_pos, buf);
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 /**
  * @brief Encodes fixed header for the MQTT message and provides pointer to
  *        start of the header.
@@ -238,13 +470,14 @@ static int zero_len_str_encode(struct buf_ctx *buf)
  *
  * @param[in] message_type Message type and reserved bit fields.
  * @param[in] message_id Message id to be encoded in the variable header.
+ * @param[in] reason_code MQTT 5.0 reason code, only encoded if not 0.
  * @param[inout] buf_ctx Pointer to the buffer context structure,
  *                       containing buffer for the encoded message.
  *
  * @retval 0 or an error code indicating a reason for failure.
  */
 static int mqtt_message_id_only_enc(uint8_t message_type, uint16_t message_id,
-				    struct buf_ctx *buf)
+				    uint8_t reason_code, struct buf_ctx *buf)
 {
 	int err_code;
 	uint8_t *start;
@@ -263,6 +496,14 @@ static int mqtt_message_id_only_enc(uint8_t message_type, uint16_t message_id,
 		return err_code;
 	}
 
+	/* MQTT 5.0 allows omitting the reason code on success. */
+	if (reason_code != 0U) {
+		err_code = pack_uint8(reason_code, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
 	return mqtt_encode_fixed_header(message_type, start, buf);
 }
 
@@ -277,10 +518,11 @@ int connect_request_encode(const struct mqtt_client *client,
 	int err_code;
 	uint8_t *start;
 
-	if (client->protocol_version == MQTT_VERSION_3_1_1) {
-		mqtt_proto_desc = &mqtt_3_1_1_proto_desc;
-	} else {
+	if (client->protocol_version == MQTT_VERSION_3_1_0) {
 		mqtt_proto_desc = &mqtt_3_1_0_proto_desc;
+	} else {
+		/* 3.1.1 and 5.0 share the protocol name. */
+		mqtt_proto_desc = &mqtt_3_1_1_proto_desc;
 	}
 
 	/* Reserve space for fixed header. */
@@ -317,6 +559,15 @@ int connect_request_encode(const struct mqtt_client *client,
 		return err_code;
 	}
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client)) {
+		err_code = connect_properties_encode(client, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+#endif
+
 	NET_HEXDUMP_DBG(client->client_id.utf8, client->client_id.size,
 			 "Encoding Client Id.");
 	err_code = pack_utf8_str(&client->client_id, buf);
@@ -331,6 +582,14 @@ int connect_request_encode(const struct mqtt_client *client,
 		connect_flags |= ((client->will_topic->qos & 0x03) << 3);
 		connect_flags |= client->will_retain << 5;
 
+		if (MQTT_IS_VERSION_5_0(client)) {
+			/* No will properties. */
+			err_code = pack_uint8(0, buf);
+			if (err_code != 0) {
+				return err_code;
+			}
+		}
+
 		NET_HEXDUMP_DBG(client->will_topic->topic.utf8,
 				 client->will_topic->topic.size,
 				 "Encoding Will Topic.");
@@ -388,7 +647,8 @@ int connect_request_encode(const struct mqtt_client *client,
 	return mqtt_encode_fixed_header(message_type, start, buf);
 }
 
-int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
+int publish_encode(const struct mqtt_client *client,
+		   const struct mqtt_publish_param *param, struct buf_ctx *buf)
 {
 	const uint8_t message_type = MQTT_MESSAGES_OPTIONS(
 			MQTT_PKT_TYPE_PUBLISH, param->dup_flag,
@@ -417,6 +677,15 @@ int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
 		}
 	}
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client)) {
+		err_code = publish_properties_encode(param, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+#endif
+
 	/* Do not copy payload. We move the buffer pointer to ensure that
 	 * message length in fixed header is encoded correctly.
 	 */
@@ -438,7 +707,8 @@ int publish_ack_encode(const struct mqtt_puback_param *param,
 	const uint8_t message_type =
 		MQTT_MESSAGES_OPTIONS(MQTT_PKT_TYPE_PUBACK, 0, 0, 0);
 
-	return mqtt_message_id_only_enc(message_type, param->message_id, buf);
+	return mqtt_message_id_only_enc(message_type, param->message_id,
+					ACK_REASON_CODE(param), buf);
 }
 
 int publish_receive_encode(const struct mqtt_pubrec_param *param,
@@ -447,7 +717,8 @@ int publish_receive_encode(const struct mqtt_pubrec_param *param,
 	const uint8_t message_type =
 		MQTT_MESSAGES_OPTIONS(MQTT_PKT_TYPE_PUBREC, 0, 0, 0);
 
-	return mqtt_message_id_only_enc(message_type, param->message_id, buf);
+	return mqtt_message_id_only_enc(message_type, param->message_id,
+					ACK_REASON_CODE(param), buf);
 }
 
 int publish_release_encode(const struct mqtt_pubrel_param *param,
@@ -456,7 +727,8 @@ int publish_release_encode(const struct mqtt_pubrel_param *param,
 	const uint8_t message_type =
 		MQTT_MESSAGES_OPTIONS(MQTT_PKT_TYPE_PUBREL, 0, 1, 0);
 
-	return mqtt_message_id_only_enc(message_type, param->message_id, buf);
+	return mqtt_message_id_only_enc(message_type, param->message_id,
+					ACK_REASON_CODE(param), buf);
 }
 
 int publish_complete_encode(const struct mqtt_pubcomp_param *param,
@@ -465,7 +737,8 @@ int publish_complete_encode(const struct mqtt_pubcomp_param *param,
 	const uint8_t message_type =
 		MQTT_MESSAGES_OPTIONS(MQTT_PKT_TYPE_PUBCOMP, 0, 0, 0);
 
-	return mqtt_message_id_only_enc(message_type, param->message_id, buf);
+	return mqtt_message_id_only_enc(message_type, param->message_id,
+					ACK_REASON_CODE(param), buf);
 }
 
 int disconnect_encode(struct buf_ctx *buf)
@@ -480,7 +753,8 @@ int disconnect_encode(struct buf_ctx *buf)
 	return 0;
 }
 
-int subscribe_encode(const struct mqtt_subscription_list *param,
+int subscribe_encode(const struct mqtt_client *client,
+		     const struct mqtt_subscription_list *param,
 		     struct buf_ctx *buf)
 {
 	const uint8_t message_type = MQTT_MESSAGES_OPTIONS(
@@ -502,6 +776,14 @@ int subscribe_encode(const struct mqtt_subscription_list *param,
 		return err_code;
 	}
 
+	if (MQTT_IS_VERSION_5_0(client)) {
+		/* No properties. */
+		err_code = pack_uint8(0, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
 	for (i = 0; i < param->list_count; i++) {
 		err_code = pack_utf8_str(&param->list[i].topic, buf);
 		if (err_code != 0) {
@@ -517,7 +799,8 @@ int subscribe_encode(const struct mqtt_subscription_list *param,
 	return mqtt_encode_fixed_header(message_type, start, buf);
 }
 
-int unsubscribe_encode(const struct mqtt_subscription_list *param,
+int unsubscribe_encode(const struct mqtt_client *client,
+		       const struct mqtt_subscription_list *param,
 		       struct buf_ctx *buf)
 {
 	const uint8_t message_type = MQTT_MESSAGES_OPTIONS(
@@ -534,6 +817,14 @@ int unsubscribe_encode(const struct mqtt_subscription_list *param,
 		return err_code;
 	}
 
+	if (MQTT_IS_VERSION_5_0(client)) {
+		/* No properties. */
+		err_code = pack_uint8(0, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
 	for (i = 0; i < param->list_count; i++) {
 		err_code = pack_utf8_str(&param->list[i].topic, buf);
 		if (err_code != 0) {
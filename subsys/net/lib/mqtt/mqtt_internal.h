@@ -69,6 +69,56 @@ extern "C" {
 
 #define MQTT_CONNACK_FLAG_SESSION_PRESENT 0x01
 
+/**@brief MQTT 5.0 property identifiers. */
+#define MQTT_PROP_PAYLOAD_FORMAT_INDICATOR          0x01
+#define MQTT_PROP_MESSAGE_EXPIRY_INTERVAL           0x02
+#define MQTT_PROP_CONTENT_TYPE                      0x03
+#define MQTT_PROP_RESPONSE_TOPIC                    0x08
+#define MQTT_PROP_CORRELATION_DATA                  0x09
+#define MQTT_PROP_SUBSCRIPTION_IDENTIFIER           0x0B
+#define MQTT_PROP_SESSION_EXPIRY_INTERVAL           0x11
+#define MQTT_PROP_ASSIGNED_CLIENT_IDENTIFIER        0x12
+#define MQTT_PROP_SERVER_KEEP_ALIVE                 0x13
+#define MQTT_PROP_AUTHENTICATION_METHOD             0x15
+#define MQTT_PROP_AUTHENTICATION_DATA               0x16
+#define MQTT_PROP_REQUEST_PROBLEM_INFORMATION       0x17
+#define MQTT_PROP_WILL_DELAY_INTERVAL               0x18
+#define MQTT_PROP_REQUEST_RESPONSE_INFORMATION      0x19
+#define MQTT_PROP_RESPONSE_INFORMATION              0x1A
+#define MQTT_PROP_SERVER_REFERENCE                  0x1C
+#define MQTT_PROP_REASON_STRING                     0x1F
+#define MQTT_PROP_RECEIVE_MAXIMUM                   0x21
+#define MQTT_PROP_TOPIC_ALIAS_MAXIMUM               0x22
+#define MQTT_PROP_TOPIC_ALIAS                       0x23
+#define MQTT_PROP_MAXIMUM_QOS                       0x24
+#define MQTT_PROP_RETAIN_AVAILABLE                  0x25
+#define MQTT_PROP_USER_PROPERTY                     0x26
+#define MQTT_PROP_MAXIMUM_PACKET_SIZE               0x27
+#define MQTT_PROP_WILDCARD_SUBSCRIPTION_AVAILABLE   0x28
+#define MQTT_PROP_SUBSCRIPTION_IDENTIFIER_AVAILABLE 0x29
+#define MQTT_PROP_SHARED_SUBSCRIPTION_AVAILABLE     0x2A
+
+/**@brief Default value of the Receive Maximum property. */
+#define MQTT_RECEIVE_MAXIMUM_DEFAULT 65535
+
+/**@brief Lowest MQTT 5.0 reason code indicating a failure. */
+#define MQTT_REASON_CODE_FAILURE 0x80
+
+/**@brief Verifies if the client uses MQTT 5.0. */
+#if defined(CONFIG_MQTT_VERSION_5_0)
+#define MQTT_IS_VERSION_5_0(CLIENT) \
+	((CLIENT)->protocol_version == MQTT_VERSION_5_0)
+#else
+#define MQTT_IS_VERSION_5_0(CLIENT) false
+#endif
+
+/**@brief Reason code of an acknowledgment, 0 (success) before MQTT 5.0. */
+#if defined(CONFIG_MQTT_VERSION_5_0)
+#define ACK_REASON_CODE(PARAM) ((PARAM)->reason_code)
+#else
+#define ACK_REASON_CODE(PARAM) 0U
+#endif
+
 /**@brief Maximum payload size of MQTT packet. */
 #define MQTT_MAX_PAYLOAD_SIZE 0x0FFFFFFF
 
@@ -181,7 +231,10 @@ int connect_request_encode(const struct mqtt_client *client,
 
 /**@brief Constructs/encodes Publish packet.
  *
- * @param[in] param Publish message parameters.
+ * @param[in] client MQTT client for which packet is encoded.
+ * @param[in] param Publish message parameters. With MQTT 5.0, a non-zero
+ *                  topic alias is sent along with the topic, which may then
+ *                  be empty.
  * @param[inout] buf_ctx Pointer to the buffer context structure,
  *                       containing buffer for the encoded message.
  *                       As output points to the beginning and end of
@@ -189,7 +242,8 @@ int connect_request_encode(const struct mqtt_client *client,
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf);
+int publish_encode(const struct mqtt_client *client,
+		   const struct mqtt_publish_param *param, struct buf_ctx *buf);
 
 /**@brief Constructs/encodes Publish Ack packet.
  *
@@ -256,6 +310,7 @@ int disconnect_encode(struct buf_ctx *buf);
 
 /**@brief Constructs/encodes Subscribe packet.
  *
+ * @param[in] client MQTT client for which packet is encoded.
  * @param[in] param Subscribe message parameters.
  * @param[inout] buf_ctx Pointer to the buffer context structure,
  *                       containing buffer for the encoded message.
@@ -264,11 +319,13 @@ int disconnect_encode(struct buf_ctx *buf);
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int subscribe_encode(const struct mqtt_subscription_list *param,
+int subscribe_encode(const struct mqtt_client *client,
+		     const struct mqtt_subscription_list *param,
 		     struct buf_ctx *buf);
 
 /**@brief Constructs/encodes Unsubscribe packet.
  *
+ * @param[in] client MQTT client for which packet is encoded.
  * @param[in] param Unsubscribe message parameters.
  * @param[inout] buf_ctx Pointer to the buffer context structure,
  *                       containing buffer for the encoded message.
@@ -277,7 +334,8 @@ int subscribe_encode(const struct mqtt_subscription_list *param,
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int unsubscribe_encode(const struct mqtt_subscription_list *param,
+int unsubscribe_encode(const struct mqtt_client *client,
+		       const struct mqtt_subscription_list *param,
 		       struct buf_ctx *buf);
 
 /**@brief Constructs/encodes Ping Request packet.
@@ -317,6 +375,7 @@ int connect_ack_decode(const struct mqtt_client *client, struct buf_ctx *buf,
 
 /**@brief Decode MQTT Publish packet.
  *
+ * @param[in] client MQTT client for which packet is decoded.
  * @param[in] flags Byte containing message type and flags.
  * @param[in] var_length Length of the variable part of the message.
  * @param[inout] buf A pointer to the buf_ctx structure containing current
@@ -325,7 +384,8 @@ int connect_ack_decode(const struct mqtt_client *client, struct buf_ctx *buf,
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int publish_decode(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
+int publish_decode(const struct mqtt_client *client, uint8_t flags,
+		   uint32_t var_length, struct buf_ctx *buf,
 		   struct mqtt_publish_param *param);
 
 /**@brief Decode MQTT Publish Ack packet.
@@ -373,26 +433,132 @@ int publish_complete_decode(struct buf_ctx *buf,
 
 /**@brief Decode MQTT Subscribe packet.
  *
+ * @param[in] client MQTT client for which packet is decoded.
  * @param[inout] buf A pointer to the buf_ctx structure containing current
  *                   buffer position.
  * @param[out] param Pointer to buffer for decoded Subscribe parameters.
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int subscribe_ack_decode(struct buf_ctx *buf,
-			 struct mqtt_suback_param *param);
+int subscribe_ack_decode(const struct mqtt_client *client,
+			 struct buf_ctx *buf, struct mqtt_suback_param *param);
 
 /**@brief Decode MQTT Unsubscribe packet.
  *
+ * @param[in] client MQTT client for which packet is decoded.
  * @param[inout] buf A pointer to the buf_ctx structure containing current
  *                   buffer position.
  * @param[out] param Pointer to buffer for decoded Unsubscribe parameters.
  *
  * @return 0 if the procedure is successful, an error code otherwise.
  */
-int unsubscribe_ack_decode(struct buf_ctx *buf,
+int unsubscribe_ack_decode(const struct mqtt_client *client,
+			   struct buf_ctx *buf,
 			   struct mqtt_unsuback_param *param);
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**@brief Decode MQTT 5.0 Disconnect packet sent by the server.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] reason_code Disconnect reason code.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int disconnect_decode(struct buf_ctx *buf, uint8_t *reason_code);
+
+/**@brief Verifies if a published message is in flight.
+ *
+ * @param[in] client MQTT client which published the message.
+ * @param[in] message_id Message id to verify.
+ *
+ * @return true if the message was sent and is not acknowledged yet.
+ */
+bool mqtt_inflight_has(const struct mqtt_client *client, uint16_t message_id);
+
+/**@brief Verifies if another QoS 1 or QoS 2 message can be sent, within the
+ *        Receive Maximum announced by the server.
+ *
+ * @param[in] client MQTT client to verify.
+ *
+ * @return true if the in-flight window is not full.
+ */
+bool mqtt_inflight_window_open(const struct mqtt_client *client);
+
+/**@brief Tracks a sent QoS 1 or QoS 2 message until it is acknowledged. A
+ *        message already in flight, sent again, keeps its slot.
+ *
+ * @param[in] client MQTT client which sent the message.
+ * @param[in] message_id Message id of the message.
+ */
+void mqtt_inflight_add(struct mqtt_client *client, uint16_t message_id);
+
+/**@brief Releases the slot of an acknowledged message. Acknowledgments of
+ *        messages not in flight are ignored.
+ *
+ * @param[in] client MQTT client which received the acknowledgment.
+ * @param[in] message_id Message id acknowledged.
+ */
+void mqtt_inflight_release(struct mqtt_client *client, uint16_t message_id);
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+/**@brief Adds a PUBLISH message to the outbound queue.
+ *
+ * @param[in] client MQTT client for which the message is queued.
+ * @param[in] param Publish message parameters. The message id is assigned by
+ *                  the queue.
+ *
+ * @return Message id assigned to the message, 0 with QoS 0, or an error code.
+ */
+int mqtt_queue_push(struct mqtt_client *client,
+		    const struct mqtt_publish_param *param);
+
+/**@brief Sends the queued messages the in-flight window allows, and the
+ *        pending PUBREL messages.
+ *
+ * @param[in] client MQTT client for which the queue is flushed.
+ * @param[in] batch Whether to hold messages back while more than half of the
+ *                  window is in flight.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int mqtt_queue_flush(struct mqtt_client *client, bool batch);
+
+/**@brief Updates the delivery state of a queued message on acknowledgment.
+ *
+ * @param[in] client MQTT client for which the acknowledgment was received.
+ * @param[in] type Acknowledgment packet type.
+ * @param[in] message_id Message id acknowledged.
+ * @param[in] reason_code Reason code of the acknowledgment.
+ */
+void mqtt_queue_ack(struct mqtt_client *client, uint8_t type,
+		    uint16_t message_id, uint8_t reason_code);
+
+/**@brief Verifies if the PUBREL of a message is sent by the queue.
+ *
+ * @param[in] client MQTT client for which the message was queued.
+ * @param[in] message_id Message id to verify.
+ *
+ * @return true for a queued QoS 2 message already received by the broker.
+ */
+bool mqtt_queue_released(struct mqtt_client *client, uint16_t message_id);
+
+/**@brief Prepares the queued messages to be sent again on a new connection.
+ *
+ * @param[in] client MQTT client whose connection was closed.
+ */
+void mqtt_queue_requeue(struct mqtt_client *client);
+
+/**@brief Returns the number of queued messages not delivered yet.
+ *
+ * @param[in] client MQTT client for which the messages were queued.
+ *
+ * @return Number of queued messages.
+ */
+int mqtt_queue_len(struct mqtt_client *client);
+#endif /* CONFIG_MQTT_OUTBOUND_QUEUE */
+
 #ifdef __cplusplus
 }
 #endif
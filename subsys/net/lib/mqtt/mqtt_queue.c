@@ -0,0 +1,524 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file mqtt_queue.c
+ *
+ * @brief MQTT outbound message queue.
+ *
+ * Queued PUBLISH messages are encoded, payload included, one after the other
+ * in the queue buffer of the client, and described by a ring of entries in the
+ * order they were queued. Messages queued in a row are thus contiguous, and
+ * are sent together with a single transport write. Space is reclaimed once the
+ * oldest messages are delivered, and a message that does not fit at the end
+ * of the buffer is stored at its beginning, like in a ring buffer.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_mqtt_queue, CONFIG_MQTT_LOG_LEVEL);
+
+#include "mqtt_internal.h"
+#include "mqtt_transport.h"
+#include "mqtt_os.h"
+
+/** Number of separate buffers written at once. */
+#define MQTT_QUEUE_IOV_MAX 4
+
+/** Delivery states of the queued messages. */
+enum mqtt_queue_state {
+	/** PUBLISH to be sent on this connection. */
+	MQTT_QUEUE_PENDING,
+
+	/** PUBLISH sent, waiting for PUBACK or PUBREC. */
+	MQTT_QUEUE_SENT,
+
+	/** PUBREC received, PUBREL to be sent on this connection. */
+	MQTT_QUEUE_RECEIVED,
+
+	/** PUBREL sent, waiting for PUBCOMP. */
+	MQTT_QUEUE_RELEASED,
+
+	/** Delivered, freed along with the older messages. */
+	MQTT_QUEUE_DONE,
+};
+
+static struct mqtt_queue_entry *queue_entry(struct mqtt_client *client,
+					    uint16_t index)
+{
+	index = (client->internal.queue_head + index) %
+		CONFIG_MQTT_OUTBOUND_QUEUE_LEN;
+
+	return &client->internal.queue[index];
+}
+
+static struct mqtt_queue_entry *queue_find(struct mqtt_client *client,
+					   uint16_t message_id)
+{
+	struct mqtt_queue_entry *entry;
+
+	for (uint16_t i = 0U; i < client->internal.queue_count; i++) {
+		entry = queue_entry(client, i);
+
+		if ((entry->message_id == message_id) &&
+		    (entry->state != MQTT_QUEUE_DONE)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static uint16_t queue_message_id_next(struct mqtt_client *client)
+{
+	uint16_t message_id = client->internal.queue_message_id;
+
+	do {
+		message_id++;
+		if (message_id == 0U) {
+			message_id = 1U;
+		}
+	} while (queue_find(client, message_id) != NULL);
+
+	client->internal.queue_message_id = message_id;
+
+	return message_id;
+}
+
+/* Frees the delivered messages at the head of the queue. Messages delivered
+ * out of order are freed along with the older ones.
+ */
+static void queue_free(struct mqtt_client *client)
+{
+	while ((client->internal.queue_count > 0U) &&
+	       (queue_entry(client, 0U)->state == MQTT_QUEUE_DONE)) {
+		client->internal.queue_head = (client->internal.queue_head + 1U) %
+					      CONFIG_MQTT_OUTBOUND_QUEUE_LEN;
+		client->internal.queue_count--;
+
+		if (client->internal.queue_unsent > 0U) {
+			client->internal.queue_unsent--;
+		}
+	}
+
+	if (client->internal.queue_count == 0U) {
+		client->internal.queue_tail = 0U;
+	}
+}
+
+static int queue_encode(struct mqtt_client *client,
+			const struct mqtt_publish_param *param,
+			uint32_t offset, uint32_t end, uint32_t *len)
+{
+	uint8_t *start = client->queue_buf + offset;
+	uint32_t payload_len = param->message.payload.len;
+	uint32_t header_len;
+	struct buf_ctx packet;
+	int err_code;
+
+	packet.cur = start;
+	packet.end = client->queue_buf + end;
+
+	err_code = publish_encode(client, param, &packet);
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	header_len = packet.end - packet.cur;
+
+	if (header_len + payload_len > end - offset) {
+		return -ENOMEM;
+	}
+
+	/* Drop the room reserved for the longest fixed header, to keep the
+	 * messages contiguous.
+	 */
+	memmove(start, packet.cur, header_len);
+
+	if (payload_len > 0U) {
+		memcpy(start + header_len, param->message.payload.data,
+		       payload_len);
+	}
+
+	*len = header_len + payload_len;
+
+	return 0;
+}
+
+static bool queue_window_open(const struct mqtt_client *client)
+{
+	if (client->internal.queue_inflight >=
+	    CONFIG_MQTT_OUTBOUND_QUEUE_INFLIGHT) {
+		return false;
+	}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client) && !mqtt_inflight_window_open(client)) {
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+static void queue_inflight_add(struct mqtt_client *client,
+			       const struct mqtt_queue_entry *entry)
+{
+	client->internal.queue_inflight++;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/* Shared with mqtt_publish(), the Receive Maximum covers both. */
+	if (MQTT_IS_VERSION_5_0(client)) {
+		mqtt_inflight_add(client, entry->message_id);
+	}
+#endif
+}
+
+static int queue_write(struct mqtt_client *client, struct iovec *io_vector,
+		       size_t count)
+{
+	struct msghdr msg;
+	int err_code;
+
+	memset(&msg, 0, sizeof(msg));
+
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = count;
+
+	NET_DBG("[%p]: Transport writing %zu queue buffers.", client, count);
+
+	err_code = mqtt_transport_write_msg(client, &msg);
+	if (err_code < 0) {
+		NET_ERR("Transport write failed, err_code = %d", err_code);
+		return err_code;
+	}
+
+	client->internal.last_activity = mqtt_sys_tick_in_ms_get();
+
+	return 0;
+}
+
+static int queue_release(struct mqtt_client *client)
+{
+	struct mqtt_queue_entry *entry;
+	struct mqtt_pubrel_param param;
+	struct buf_ctx packet;
+	int err_code;
+
+	for (uint16_t i = 0U; (i < client->internal.queue_count) &&
+			      (client->internal.queue_received > 0U); i++) {
+		entry = queue_entry(client, i);
+
+		if (entry->state != MQTT_QUEUE_RECEIVED) {
+			continue;
+		}
+
+		memset(&param, 0, sizeof(param));
+		param.message_id = entry->message_id;
+
+		packet.cur = client->tx_buf;
+		packet.end = client->tx_buf + client->tx_buf_size;
+
+		err_code = publish_release_encode(&param, &packet);
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		err_code = mqtt_transport_write(client, packet.cur,
+						packet.end - packet.cur);
+		if (err_code < 0) {
+			NET_ERR("Transport write failed, err_code = %d",
+				err_code);
+			return err_code;
+		}
+
+		entry->state = MQTT_QUEUE_RELEASED;
+		client->internal.queue_received--;
+	}
+
+	return 0;
+}
+
+int mqtt_queue_push(struct mqtt_client *client,
+		    const struct mqtt_publish_param *param)
+{
+	struct mqtt_publish_param publish = *param;
+	uint32_t offset = client->internal.queue_tail;
+	uint32_t end = client->queue_buf_size;
+	uint8_t qos = param->message.topic.qos;
+	struct mqtt_queue_entry *entry;
+	uint32_t oldest = 0U;
+	uint32_t len;
+	int err_code;
+
+	if (client->queue_buf == NULL) {
+		return -ENOMEM;
+	}
+
+	if (client->internal.queue_count >= CONFIG_MQTT_OUTBOUND_QUEUE_LEN) {
+		return -EAGAIN;
+	}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client) &&
+	    MQTT_HAS_STATE(client, MQTT_STATE_CONNECTED) &&
+	    (qos > client->internal.server_max_qos)) {
+		return -EINVAL;
+	}
+
+	/* The message may be sent again on a new connection, where the alias
+	 * would not be known.
+	 */
+	publish.prop.topic_alias = 0U;
+#endif
+
+	publish.dup_flag = 0U;
+	publish.message_id = 0U;
+
+	if (qos > MQTT_QOS_0_AT_MOST_ONCE) {
+		publish.message_id = queue_message_id_next(client);
+	}
+
+	if (client->internal.queue_count > 0U) {
+		oldest = queue_entry(client, 0U)->offset;
+
+		/* Already wrapped around, free space ends at the oldest
+		 * message.
+		 */
+		if (offset <= oldest) {
+			end = oldest;
+		}
+	}
+
+	err_code = queue_encode(client, &publish, offset, end, &len);
+	if ((err_code == -ENOMEM) && (end == client->queue_buf_size) &&
+	    (client->internal.queue_count > 0U)) {
+		/* Wrap around, leaving the end of the buffer unused. */
+		offset = 0U;
+		err_code = queue_encode(client, &publish, offset, oldest, &len);
+	}
+
+	if (err_code == -ENOMEM) {
+		/* Retrying is pointless when the queue is empty. */
+		return (client->internal.queue_count > 0U) ? -EAGAIN : -EMSGSIZE;
+	}
+
+	if (err_code < 0) {
+		return err_code;
+	}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (MQTT_IS_VERSION_5_0(client) &&
+	    MQTT_HAS_STATE(client, MQTT_STATE_CONNECTED) &&
+	    (client->internal.server_max_packet_size != 0U) &&
+	    (len > client->internal.server_max_packet_size)) {
+		return -EMSGSIZE;
+	}
+#endif
+
+	entry = queue_entry(client, client->internal.queue_count);
+	entry->offset = offset;
+	entry->len = len;
+	entry->message_id = publish.message_id;
+	entry->qos = qos;
+	entry->state = MQTT_QUEUE_PENDING;
+
+	client->internal.queue_tail = offset + len;
+	client->internal.queue_count++;
+
+	return publish.message_id;
+}
+
+int mqtt_queue_flush(struct mqtt_client *client, bool batch)
+{
+	struct iovec io_vector[MQTT_QUEUE_IOV_MAX];
+	struct mqtt_queue_entry *entry;
+	size_t count = 0;
+	uint8_t *data;
+	uint16_t i;
+	int err_code;
+
+	if (!MQTT_HAS_STATE(client, MQTT_STATE_CONNECTED)) {
+		return 0;
+	}
+
+	err_code = queue_release(client);
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	/* Hold new messages back while more than half of the window is in
+	 * flight, so that they are written together.
+	 */
+	if (batch && (client->internal.queue_inflight >
+		      CONFIG_MQTT_OUTBOUND_QUEUE_INFLIGHT / 2)) {
+		return 0;
+	}
+
+	for (i = client->internal.queue_unsent;
+	     i < client->internal.queue_count; i++) {
+		entry = queue_entry(client, i);
+
+		if (entry->state != MQTT_QUEUE_PENDING) {
+			continue;
+		}
+
+		/* Later messages, QoS 0 included, are kept in order. */
+		if (entry->qos > MQTT_QOS_0_AT_MOST_ONCE) {
+			if (!queue_window_open(client)) {
+				break;
+			}
+
+			entry->state = MQTT_QUEUE_SENT;
+			queue_inflight_add(client, entry);
+		} else {
+			entry->state = MQTT_QUEUE_DONE;
+		}
+
+		data = client->queue_buf + entry->offset;
+
+		if ((count > 0) &&
+		    ((uint8_t *)io_vector[count - 1].iov_base +
+		     io_vector[count - 1].iov_len == data)) {
+			io_vector[count - 1].iov_len += entry->len;
+			continue;
+		}
+
+		if (count == ARRAY_SIZE(io_vector)) {
+			err_code = queue_write(client, io_vector, count);
+			if (err_code < 0) {
+				return err_code;
+			}
+
+			count = 0;
+		}
+
+		io_vector[count].iov_base = data;
+		io_vector[count].iov_len = entry->len;
+		count++;
+	}
+
+	client->internal.queue_unsent = i;
+
+	if (count > 0) {
+		err_code = queue_write(client, io_vector, count);
+		if (err_code < 0) {
+			return err_code;
+		}
+	}
+
+	queue_free(client);
+
+	return 0;
+}
+
+void mqtt_queue_ack(struct mqtt_client *client, uint8_t type,
+		    uint16_t message_id, uint8_t reason_code)
+{
+	struct mqtt_queue_entry *entry;
+
+	entry = queue_find(client, message_id);
+	if ((entry == NULL) || (entry->qos == MQTT_QOS_0_AT_MOST_ONCE)) {
+		/* Not a queued message. */
+		return;
+	}
+
+	switch (type) {
+	case MQTT_PKT_TYPE_PUBACK:
+		if ((entry->qos != MQTT_QOS_1_AT_LEAST_ONCE) ||
+		    (entry->state != MQTT_QUEUE_SENT)) {
+			return;
+		}
+
+		break;
+
+	case MQTT_PKT_TYPE_PUBREC:
+		if ((entry->qos != MQTT_QOS_2_EXACTLY_ONCE) ||
+		    (entry->state != MQTT_QUEUE_SENT)) {
+			return;
+		}
+
+		/* A failed QoS 2 exchange ends here, with no PUBCOMP. */
+		if (reason_code < MQTT_REASON_CODE_FAILURE) {
+			entry->state = MQTT_QUEUE_RECEIVED;
+			client->internal.queue_received++;
+			return;
+		}
+
+		break;
+
+	case MQTT_PKT_TYPE_PUBCOMP:
+		if (entry->state != MQTT_QUEUE_RELEASED) {
+			return;
+		}
+
+		break;
+
+	default:
+		return;
+	}
+
+	entry->state = MQTT_QUEUE_DONE;
+	client->internal.queue_inflight--;
+
+	queue_free(client);
+}
+
+bool mqtt_queue_released(struct mqtt_client *client, uint16_t message_id)
+{
+	struct mqtt_queue_entry *entry = queue_find(client, message_id);
+
+	return (entry != NULL) &&
+	       (entry->qos == MQTT_QOS_2_EXACTLY_ONCE) &&
+	       ((entry->state == MQTT_QUEUE_RECEIVED) ||
+		(entry->state == MQTT_QUEUE_RELEASED));
+}
+
+void mqtt_queue_requeue(struct mqtt_client *client)
+{
+	struct mqtt_queue_entry *entry;
+
+	client->internal.queue_inflight = 0U;
+	client->internal.queue_unsent = 0U;
+
+	for (uint16_t i = 0U; i < client->internal.queue_count; i++) {
+		entry = queue_entry(client, i);
+
+		switch (entry->state) {
+		case MQTT_QUEUE_SENT:
+			client->queue_buf[entry->offset] |=
+						MQTT_HEADER_DUP_MASK;
+			entry->state = MQTT_QUEUE_PENDING;
+			break;
+
+		case MQTT_QUEUE_RELEASED:
+			entry->state = MQTT_QUEUE_RECEIVED;
+			client->internal.queue_received++;
+			__fallthrough;
+
+		case MQTT_QUEUE_RECEIVED:
+			/* Still held by the broker, the PUBREL is sent on
+			 * connection.
+			 */
+			queue_inflight_add(client, entry);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+int mqtt_queue_len(struct mqtt_client *client)
+{
+	int len = 0;
+
+	for (uint16_t i = 0U; i < client->internal.queue_count; i++) {
+		if (queue_entry(client, i)->state != MQTT_QUEUE_DONE) {
+			len++;
+		}
+	}
+
+	return len;
+}
@@ -16,6 +16,67 @@ LOG_MODULE_REGISTER(net_mqtt_rx, CONFIG_MQTT_LOG_LEVEL);
  * @brief MQTT Received data handling.
  */
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+static void connect_ack_apply(struct mqtt_client *client,
+			      const struct mqtt_connack_param *param)
+{
+	client->internal.server_receive_max = param->prop.receive_maximum;
+	client->internal.server_topic_alias_max =
+		MIN(param->prop.topic_alias_maximum, CONFIG_MQTT_TOPIC_ALIAS_MAX);
+	client->internal.server_max_qos = param->prop.maximum_qos;
+	client->internal.server_max_packet_size =
+		param->prop.maximum_packet_size;
+
+	if (param->prop.server_keep_alive != 0U) {
+		client->keepalive = param->prop.server_keep_alive;
+	}
+}
+
+static int publish_topic_alias_resolve(struct mqtt_client *client,
+				       struct mqtt_publish_param *param)
+{
+	struct mqtt_utf8 *topic = &param->message.topic.topic;
+	uint16_t alias = param->prop.topic_alias;
+	struct mqtt_topic_alias *entry;
+
+	if (alias == 0U) {
+		return 0;
+	}
+
+	if (alias > CONFIG_MQTT_TOPIC_ALIAS_MAX) {
+		NET_ERR("[CID %p]: Invalid topic alias %u", client, alias);
+		return -EINVAL;
+	}
+
+	entry = &client->internal.rx_alias[alias - 1];
+
+	/* A topic sent along with the alias (re)defines it. */
+	if (topic->size > 0) {
+		if (topic->size > sizeof(entry->topic)) {
+			NET_WARN("[CID %p]: Topic too long for alias %u",
+				 client, alias);
+			entry->topic_len = 0U;
+			return 0;
+		}
+
+		memcpy(entry->topic, topic->utf8, topic->size);
+		entry->topic_len = topic->size;
+
+		return 0;
+	}
+
+	if (entry->topic_len == 0U) {
+		NET_ERR("[CID %p]: Unknown topic alias %u", client, alias);
+		return -EINVAL;
+	}
+
+	topic->utf8 = entry->topic;
+	topic->size = entry->topic_len;
+
+	return 0;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 static int mqtt_handle_packet(struct mqtt_client *client,
 			      uint8_t type_and_flags,
 			      uint32_t var_length,
@@ -24,6 +85,10 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 	int err_code = 0;
 	bool notify_event = true;
 	struct mqtt_evt evt;
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+	bool queue_flush = false;
+	bool queue_batch = true;
+#endif
 
 	/* Success by default, overwritten in special cases. */
 	evt.result = 0;
@@ -42,6 +107,17 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 						MQTT_CONNECTION_ACCEPTED) {
 				/* Set state. */
 				MQTT_SET_STATE(client, MQTT_STATE_CONNECTED);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+				if (MQTT_IS_VERSION_5_0(client)) {
+					connect_ack_apply(client,
+							  &evt.param.connack);
+				}
+#endif
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+				/* Send what was queued while disconnected. */
+				queue_flush = true;
+				queue_batch = false;
+#endif
 			} else {
 				err_code = -ECONNREFUSED;
 			}
@@ -57,8 +133,14 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		NET_DBG("[CID %p]: Received MQTT_PKT_TYPE_PUBLISH", client);
 
 		evt.type = MQTT_EVT_PUBLISH;
-		err_code = publish_decode(type_and_flags, var_length, buf,
-					  &evt.param.publish);
+		err_code = publish_decode(client, type_and_flags, var_length,
+					  buf, &evt.param.publish);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		if (err_code == 0 && MQTT_IS_VERSION_5_0(client)) {
+			err_code = publish_topic_alias_resolve(
+					client, &evt.param.publish);
+		}
+#endif
 		evt.result = err_code;
 
 		client->internal.remaining_payload =
@@ -77,6 +159,20 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBACK;
 		err_code = publish_ack_decode(buf, &evt.param.puback);
 		evt.result = err_code;
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		if (err_code == 0) {
+			mqtt_inflight_release(client,
+					      evt.param.puback.message_id);
+		}
+#endif
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+		if (err_code == 0) {
+			mqtt_queue_ack(client, MQTT_PKT_TYPE_PUBACK,
+				       evt.param.puback.message_id,
+				       ACK_REASON_CODE(&evt.param.puback));
+			queue_flush = true;
+		}
+#endif
 		break;
 
 	case MQTT_PKT_TYPE_PUBREC:
@@ -85,6 +181,22 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBREC;
 		err_code = publish_receive_decode(buf, &evt.param.pubrec);
 		evt.result = err_code;
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		/* A failed QoS 2 exchange ends here, with no PUBCOMP. */
+		if (err_code == 0 && evt.param.pubrec.reason_code >=
+				     MQTT_REASON_CODE_FAILURE) {
+			mqtt_inflight_release(client,
+					      evt.param.pubrec.message_id);
+		}
+#endif
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+		if (err_code == 0) {
+			mqtt_queue_ack(client, MQTT_PKT_TYPE_PUBREC,
+				       evt.param.pubrec.message_id,
+				       ACK_REASON_CODE(&evt.param.pubrec));
+			queue_flush = true;
+		}
+#endif
 		break;
 
 	case MQTT_PKT_TYPE_PUBREL:
@@ -101,13 +213,27 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBCOMP;
 		err_code = publish_complete_decode(buf, &evt.param.pubcomp);
 		evt.result = err_code;
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		if (err_code == 0) {
+			mqtt_inflight_release(client,
+					      evt.param.pubcomp.message_id);
+		}
+#endif
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+		if (err_code == 0) {
+			mqtt_queue_ack(client, MQTT_PKT_TYPE_PUBCOMP,
+				       evt.param.pubcomp.message_id,
+				       ACK_REASON_CODE(&evt.param.pubcomp));
+			queue_flush = true;
+		}
+#endif
 		break;
 
 	case MQTT_PKT_TYPE_SUBACK:
 		NET_DBG("[CID %p]: Received MQTT_PKT_TYPE_SUBACK!", client);
 
 		evt.type = MQTT_EVT_SUBACK;
-		err_code = subscribe_ack_decode(buf, &evt.param.suback);
+		err_code = subscribe_ack_decode(client, buf, &evt.param.suback);
 		evt.result = err_code;
 		break;
 
@@ -115,7 +241,8 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		NET_DBG("[CID %p]: Received MQTT_PKT_TYPE_UNSUBACK!", client);
 
 		evt.type = MQTT_EVT_UNSUBACK;
-		err_code = unsubscribe_ack_decode(buf, &evt.param.unsuback);
+		err_code = unsubscribe_ack_decode(client, buf,
+						  &evt.param.unsuback);
 		evt.result = err_code;
 		break;
 
@@ -132,12 +259,42 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PINGRESP;
 		break;
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	case MQTT_PKT_TYPE_DISCONNECT:
+		NET_DBG("[CID %p]: Received MQTT_PKT_TYPE_DISCONNECT!", client);
+
+		/* Reported as a disconnect event by the caller. */
+		notify_event = false;
+
+		if (MQTT_IS_VERSION_5_0(client)) {
+			uint8_t reason_code;
+
+			err_code = disconnect_decode(buf, &reason_code);
+			if (err_code == 0) {
+				NET_INFO("[CID %p]: Disconnected by server, "
+					 "reason 0x%02x", client, reason_code);
+				err_code = -ECONNRESET;
+			}
+		}
+
+		break;
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 	default:
 		/* Nothing to notify. */
 		notify_event = false;
 		break;
 	}
 
+#if defined(CONFIG_MQTT_OUTBOUND_QUEUE)
+	/* Before notifying, so that queued QoS 2 messages are already
+	 * released when the application sees the PUBREC.
+	 */
+	if (queue_flush) {
+		err_code = mqtt_queue_flush(client, queue_batch);
+	}
+#endif
+
 	if (notify_event == true) {
 		event_notify(client, &evt);
 	}
@@ -193,6 +350,40 @@ static int mqtt_read_message_chunk(struct mqtt_client *client,
 	return 0;
 }
 
+/* Extends the header length with the property length field at the end of
+ * the header read so far, and the properties it announces.
+ */
+static int mqtt_read_properties_length(struct mqtt_client *client,
+				       struct buf_ctx *buf,
+				       uint32_t *header_length)
+{
+	uint32_t length = 0U;
+	uint8_t bytes = 0U;
+	uint8_t byte;
+	int err_code;
+
+	do {
+		if (bytes >= MQTT_MAX_LENGTH_BYTES) {
+			return -EINVAL;
+		}
+
+		err_code = mqtt_read_message_chunk(client, buf,
+						   *header_length + bytes + 1);
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		byte = buf->cur[*header_length + bytes];
+		length += (uint32_t)(byte & MQTT_LENGTH_VALUE_MASK)
+						<< (MQTT_LENGTH_SHIFT * bytes);
+		bytes++;
+	} while ((byte & MQTT_LENGTH_CONTINUATION_BIT) != 0U);
+
+	*header_length += bytes + length;
+
+	return 0;
+}
+
 static int mqtt_read_publish_var_header(struct mqtt_client *client,
 					uint8_t type_and_flags,
 					struct buf_ctx *buf)
@@ -218,6 +409,14 @@ static int mqtt_read_publish_var_header(struct mqtt_client *client,
 		variable_header_length += sizeof(uint16_t);
 	}
 
+	if (MQTT_IS_VERSION_5_0(client)) {
+		err_code = mqtt_read_properties_length(client, buf,
+						       &variable_header_length);
+		if (err_code < 0) {
+			return err_code;
+		}
+	}
+
 	/* Now we can read the whole header. */
 	err_code = mqtt_read_message_chunk(client, buf,
 					   variable_header_length);
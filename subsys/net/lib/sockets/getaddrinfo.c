@@ -44,20 +44,41 @@ LOG_MODULE_REGISTER(net_sock_addr, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #if defined(CONFIG_DNS_RESOLVER)
 
+struct getaddrinfo_state;
+
+enum getaddrinfo_query_state {
+	QUERY_WAITING,
+	QUERY_SENT,
+	QUERY_DONE,
+};
+
+/* One A or AAAA query. Both are sent at the same time and share the result
+ * array, which is filled in the order the answers arrive.
+ */
+struct getaddrinfo_query {
+	struct getaddrinfo_state *state;
+	k_timeout_t timeout;
+	k_timepoint_t guard;
+	enum dns_query_type qtype;
+	enum getaddrinfo_query_state query_state;
+	int status;
+	uint16_t dns_id;
+};
+
 struct getaddrinfo_state {
 	const struct zsock_addrinfo *hints;
 	struct k_sem sem;
-	int status;
 	uint16_t idx;
 	uint16_t port;
-	uint16_t dns_id;
 	struct zsock_addrinfo *ai_arr;
+	struct getaddrinfo_query queries[2];
 };
 
 static void dns_resolve_cb(enum dns_resolve_status status,
 			   struct dns_addrinfo *info, void *user_data)
 {
-	struct getaddrinfo_state *state = user_data;
+	struct getaddrinfo_query *query = user_data;
+	struct getaddrinfo_state *state = query->state;
 	struct zsock_addrinfo *ai;
 	int socktype = SOCK_STREAM;
 
@@ -67,7 +88,8 @@ static void dns_resolve_cb(enum dns_resolve_status status,
 		if (status == DNS_EAI_ALLDONE) {
 			status = 0;
 		}
-		state->status = status;
+		query->status = status;
+		query->query_state = QUERY_DONE;
 		k_sem_give(&state->sem);
 		return;
 	}
@@ -118,65 +140,128 @@ static k_timeout_t recalc_timeout(k_timepoint_t end, k_timeout_t timeout)
 	return timeout;
 }
 
-static int exec_query(const char *host, int family,
-		      struct getaddrinfo_state *ai_state)
+static void start_query(const char *host, struct getaddrinfo_query *query,
+			bool other_sent)
 {
-	enum dns_query_type qtype = DNS_QUERY_TYPE_A;
-	k_timepoint_t end = sys_timepoint_calc(K_MSEC(CONFIG_NET_SOCKETS_DNS_TIMEOUT));
-	k_timeout_t timeout = K_MSEC(MIN(CONFIG_NET_SOCKETS_DNS_TIMEOUT,
-					 CONFIG_NET_SOCKETS_DNS_BACKOFF_INTERVAL));
-	int timeout_ms;
-	int st, ret;
-
-	if (family == AF_INET6) {
-		qtype = DNS_QUERY_TYPE_AAAA;
-	}
-
-again:
-	timeout_ms = k_ticks_to_ms_ceil32(timeout.ticks);
+	int timeout_ms = k_ticks_to_ms_ceil32(query->timeout.ticks);
+	int ret;
 
 	NET_DBG("Timeout %d", timeout_ms);
 
-	ret = dns_get_addr_info(host, qtype, &ai_state->dns_id,
-				dns_resolve_cb, ai_state, timeout_ms);
+	/* If the DNS query for reason fails so that the dns_resolve_cb()
+	 * would not be called, then we want to stop waiting for it so that
+	 * we will not hang forever. So make the guard time longer than the
+	 * DNS timeout so that we do not need to start to cancel any pending
+	 * DNS queries.
+	 */
+	query->guard = sys_timepoint_calc(K_MSEC(timeout_ms + 100));
+	query->query_state = QUERY_SENT;
+
+	/* Answers found in the cache are reported before this returns */
+	ret = dns_get_addr_info(host, query->qtype, &query->dns_id,
+				dns_resolve_cb, query, timeout_ms);
 	if (ret == 0) {
-		/* If the DNS query for reason fails so that the
-		 * dns_resolve_cb() would not be called, then we want the
-		 * semaphore to timeout so that we will not hang forever.
-		 * So make the sem timeout longer than the DNS timeout so that
-		 * we do not need to start to cancel any pending DNS queries.
-		 */
-		ret = k_sem_take(&ai_state->sem, K_MSEC(timeout_ms + 100));
-		if (ret == -EAGAIN) {
-			if (!sys_timepoint_expired(end)) {
-				timeout = recalc_timeout(end, timeout);
-				goto again;
-			}
+		return;
+	}
 
-			(void)dns_cancel_addr_info(ai_state->dns_id);
-			st = DNS_EAI_AGAIN;
-		} else {
-			if (ai_state->status == DNS_EAI_CANCELED) {
-				if (!sys_timepoint_expired(end)) {
-					timeout = recalc_timeout(end, timeout);
-					goto again;
-				}
-			}
+	if (ret == -EAGAIN && other_sent) {
+		/* All resolver slots are in use, try again once the other
+		 * query is done.
+		 */
+		query->query_state = QUERY_WAITING;
+		return;
+	}
 
-			st = ai_state->status;
-		}
-	} else if (ret == -EPFNOSUPPORT) {
+	if (ret == -EPFNOSUPPORT) {
 		/* If we are returned -EPFNOSUPPORT then that will indicate
 		 * wrong address family type queried. Check that and return
 		 * DNS_EAI_ADDRFAMILY.
 		 */
-		st = DNS_EAI_ADDRFAMILY;
+		query->status = DNS_EAI_ADDRFAMILY;
 	} else {
 		errno = -ret;
-		st = DNS_EAI_SYSTEM;
+		query->status = DNS_EAI_SYSTEM;
 	}
 
-	return st;
+	query->query_state = QUERY_DONE;
+}
+
+static void exec_queries(const char *host, struct getaddrinfo_state *ai_state,
+			 size_t count)
+{
+	k_timepoint_t end = sys_timepoint_calc(K_MSEC(CONFIG_NET_SOCKETS_DNS_TIMEOUT));
+	struct getaddrinfo_query *query;
+	k_timepoint_t guard;
+	bool sent;
+
+	for (size_t i = 0; i < count; i++) {
+		query = &ai_state->queries[i];
+		query->timeout = K_MSEC(MIN(CONFIG_NET_SOCKETS_DNS_TIMEOUT,
+					    CONFIG_NET_SOCKETS_DNS_BACKOFF_INTERVAL));
+		query->query_state = QUERY_WAITING;
+	}
+
+	while (true) {
+		for (size_t i = 0; i < count; i++) {
+			query = &ai_state->queries[i];
+
+			if (query->query_state == QUERY_SENT &&
+			    sys_timepoint_expired(query->guard)) {
+				/* Cancelling reports DNS_EAI_CANCELED, so the
+				 * query is retried below if there is time left.
+				 */
+				if (dns_cancel_addr_info(query->dns_id) < 0) {
+					query->status = DNS_EAI_CANCELED;
+					query->query_state = QUERY_DONE;
+				}
+
+				if (sys_timepoint_expired(end)) {
+					query->status = DNS_EAI_AGAIN;
+				}
+			}
+
+			if (query->query_state == QUERY_DONE &&
+			    query->status == DNS_EAI_CANCELED &&
+			    !sys_timepoint_expired(end)) {
+				query->timeout = recalc_timeout(end, query->timeout);
+				query->query_state = QUERY_WAITING;
+			}
+		}
+
+		sent = false;
+
+		for (size_t i = 0; i < count; i++) {
+			if (ai_state->queries[i].query_state == QUERY_SENT) {
+				sent = true;
+			}
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			query = &ai_state->queries[i];
+
+			if (query->query_state == QUERY_WAITING) {
+				start_query(host, query, sent);
+				sent = sent || query->query_state == QUERY_SENT;
+			}
+		}
+
+		if (!sent) {
+			break;
+		}
+
+		guard = sys_timepoint_calc(K_FOREVER);
+
+		for (size_t i = 0; i < count; i++) {
+			query = &ai_state->queries[i];
+
+			if (query->query_state == QUERY_SENT &&
+			    sys_timepoint_cmp(query->guard, guard) < 0) {
+				guard = query->guard;
+			}
+		}
+
+		(void)k_sem_take(&ai_state->sem, sys_timepoint_timeout(guard));
+	}
 }
 
 static int getaddrinfo_null_host(int port, const struct zsock_addrinfo *hints,
@@ -225,6 +310,8 @@ int z_impl_z_zsock_getaddrinfo_internal(const char *host, const char *service,
 	int st1 = DNS_EAI_ADDRFAMILY, st2 = DNS_EAI_ADDRFAMILY;
 	struct sockaddr *ai_addr;
 	struct getaddrinfo_state ai_state;
+	enum dns_query_type queries[ARRAY_SIZE(ai_state.queries)];
+	size_t count = 0;
 
 	if (hints) {
 		family = hints->ai_family;
@@ -263,26 +350,37 @@ int z_impl_z_zsock_getaddrinfo_internal(const char *host, const char *service,
 	ai_state.idx = 0U;
 	ai_state.port = htons(port);
 	ai_state.ai_arr = res;
-	ai_state.dns_id = 0;
 	k_sem_init(&ai_state.sem, 0, K_SEM_MAX_LIMIT);
 
-	/* If family is AF_UNSPEC, then we query IPv4 address first
-	 * if IPv4 is enabled in the config.
+	/* If family is AF_UNSPEC, then we query IPv4 and IPv6 addresses at the
+	 * same time if both are enabled in the config.
 	 */
 	if ((family != AF_INET6) && IS_ENABLED(CONFIG_NET_IPV4)) {
-		st1 = exec_query(host, AF_INET, &ai_state);
-		if (st1 == DNS_EAI_AGAIN) {
-			return st1;
-		}
+		queries[count++] = DNS_QUERY_TYPE_A;
 	}
 
-	/* If family is AF_UNSPEC, the IPv4 query has been already done
-	 * so we can do IPv6 query next if IPv6 is enabled in the config.
-	 */
 	if ((family != AF_INET) && IS_ENABLED(CONFIG_NET_IPV6)) {
-		st2 = exec_query(host, AF_INET6, &ai_state);
-		if (st2 == DNS_EAI_AGAIN) {
-			return st2;
+		queries[count++] = DNS_QUERY_TYPE_AAAA;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		ai_state.queries[i] = (struct getaddrinfo_query) {
+			.state = &ai_state,
+			.qtype = queries[i],
+		};
+	}
+
+	exec_queries(host, &ai_state, count);
+
+	for (size_t i = 0; i < count; i++) {
+		if (ai_state.queries[i].status == DNS_EAI_AGAIN) {
+			return DNS_EAI_AGAIN;
+		}
+
+		if (queries[i] == DNS_QUERY_TYPE_A) {
+			st1 = ai_state.queries[i].status;
+		} else {
+			st2 = ai_state.queries[i].status;
 		}
 	}
 
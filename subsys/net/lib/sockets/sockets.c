@@ -25,6 +25,10 @@ LOG_MODULE_REGISTER(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include "socks.h"
 #endif
 
+#if defined(CONFIG_NET_SOCKETS_SENDFILE)
+#include <zephyr/fs/fs.h>
+#endif
+
 #include <zephyr/net/igmp.h>
 #include "../../ip/ipv6.h"
 
@@ -268,6 +272,8 @@ int zsock_close_ctx(struct net_context *ctx)
 	ctx->user_data = INT_TO_POINTER(EINTR);
 	sock_set_error(ctx);
 
+	zsock_epoll_detach(ctx);
+
 	zsock_flush_queue(ctx);
 
 	SET_ERRNO(net_context_put(ctx));
@@ -374,6 +380,8 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		net_context_ref(new_ctx);
 
 		(void)k_condvar_signal(&parent->cond.recv);
+
+		zsock_epoll_notify(parent);
 	}
 
 }
@@ -428,6 +436,8 @@ unlock:
 	/* Wake reader if it was sleeping */
 	(void)k_condvar_signal(&ctx->cond.recv);
 
+	zsock_epoll_notify(ctx);
+
 	if (ctx->cond.lock) {
 		(void)k_mutex_unlock(ctx->cond.lock);
 	}
@@ -445,6 +455,8 @@ int zsock_shutdown_ctx(struct net_context *ctx, int how)
 		sock_set_eof(ctx);
 
 		zsock_flush_queue(ctx);
+
+		zsock_epoll_notify(ctx);
 	} else if (how == ZSOCK_SHUT_WR || how == ZSOCK_SHUT_RDWR) {
 		SET_ERRNO(-ENOTSUP);
 	} else {
@@ -495,6 +507,7 @@ static void zsock_connected_cb(struct net_context *ctx, int status, void *user_d
 	if (status < 0) {
 		ctx->user_data = INT_TO_POINTER(-status);
 		sock_set_error(ctx);
+		zsock_epoll_notify(ctx);
 	}
 }
 
@@ -938,94 +951,386 @@ ssize_t z_impl_zsock_sendmsg(int sock, const struct msghdr *msg, int flags)
 	return bytes_sent;
 }
 
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	unsigned int i;
+	int bytes_sent = 0;
+	ssize_t ret = 0;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (vtable->sendmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (i = 0; i < vlen; i++) {
+		ret = vtable->sendmsg(obj, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+		bytes_sent += ret;
+	}
+
+	k_mutex_unlock(lock);
+
+	sock_obj_core_update_send_stats(sock, bytes_sent);
+
+	/* An error is only reported if nothing was sent, otherwise the
+	 * caller will get it when sending the rest of the vector.
+	 */
+	return (i > 0) ? (int)i : (int)ret;
+}
+
 #ifdef CONFIG_USERSPACE
-static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
-					   const struct msghdr *msg,
-					   int flags)
+static void sendmsg_user_copy_free(struct msghdr *msg_copy)
 {
-	struct msghdr msg_copy;
 	size_t i;
-	int ret;
 
-	K_OOPS(k_usermode_from_copy(&msg_copy, (void *)msg, sizeof(msg_copy)));
+	k_free(msg_copy->msg_name);
+	k_free(msg_copy->msg_control);
 
-	msg_copy.msg_name = NULL;
-	msg_copy.msg_control = NULL;
+	if (msg_copy->msg_iov) {
+		for (i = 0; i < msg_copy->msg_iovlen; i++) {
+			k_free(msg_copy->msg_iov[i].iov_base);
+		}
 
-	msg_copy.msg_iov = k_usermode_alloc_from_copy(msg->msg_iov,
-				       msg->msg_iovlen * sizeof(struct iovec));
-	if (!msg_copy.msg_iov) {
+		k_free(msg_copy->msg_iov);
+	}
+}
+
+/* Copy a user space message to be sent, including the data it points to.
+ * On failure everything allocated so far is freed and errno is set.
+ */
+static int sendmsg_user_copy(struct msghdr *msg_copy, const struct msghdr *msg)
+{
+	size_t i;
+
+	K_OOPS(k_usermode_from_copy(msg_copy, (void *)msg, sizeof(*msg_copy)));
+
+	msg_copy->msg_name = NULL;
+	msg_copy->msg_control = NULL;
+
+	msg_copy->msg_iov = k_usermode_alloc_from_copy(msg->msg_iov,
+				       msg_copy->msg_iovlen * sizeof(struct iovec));
+	if (!msg_copy->msg_iov) {
 		errno = ENOMEM;
 		goto fail;
 	}
 
-	for (i = 0; i < msg->msg_iovlen; i++) {
-		msg_copy.msg_iov[i].iov_base =
+	/* Clear the pointers in the copy so that if the allocation in the
+	 * next loop fails, we do not try to free non allocated memory.
+	 */
+	memset(msg_copy->msg_iov, 0, msg_copy->msg_iovlen * sizeof(struct iovec));
+
+	for (i = 0; i < msg_copy->msg_iovlen; i++) {
+		msg_copy->msg_iov[i].iov_base =
 			k_usermode_alloc_from_copy(msg->msg_iov[i].iov_base,
-					       msg->msg_iov[i].iov_len);
-		if (!msg_copy.msg_iov[i].iov_base) {
+						   msg->msg_iov[i].iov_len);
+		if (!msg_copy->msg_iov[i].iov_base) {
 			errno = ENOMEM;
 			goto fail;
 		}
 
-		msg_copy.msg_iov[i].iov_len = msg->msg_iov[i].iov_len;
+		msg_copy->msg_iov[i].iov_len = msg->msg_iov[i].iov_len;
 	}
 
 	if (msg->msg_namelen > 0) {
-		msg_copy.msg_name = k_usermode_alloc_from_copy(msg->msg_name,
-							   msg->msg_namelen);
-		if (!msg_copy.msg_name) {
+		msg_copy->msg_name = k_usermode_alloc_from_copy(msg->msg_name,
+							    msg->msg_namelen);
+		if (!msg_copy->msg_name) {
 			errno = ENOMEM;
 			goto fail;
 		}
 	}
 
 	if (msg->msg_controllen > 0) {
-		msg_copy.msg_control = k_usermode_alloc_from_copy(msg->msg_control,
-							  msg->msg_controllen);
-		if (!msg_copy.msg_control) {
+		msg_copy->msg_control = k_usermode_alloc_from_copy(msg->msg_control,
+							       msg->msg_controllen);
+		if (!msg_copy->msg_control) {
 			errno = ENOMEM;
 			goto fail;
 		}
 	}
 
+	return 0;
+
+fail:
+	sendmsg_user_copy_free(msg_copy);
+
+	return -1;
+}
+
+static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
+					   const struct msghdr *msg,
+					   int flags)
+{
+	struct msghdr msg_copy;
+	int ret;
+
+	if (sendmsg_user_copy(&msg_copy, msg) < 0) {
+		return -1;
+	}
+
 	ret = z_impl_zsock_sendmsg(sock, (const struct msghdr *)&msg_copy,
 				   flags);
 
-	k_free(msg_copy.msg_name);
-	k_free(msg_copy.msg_control);
+	sendmsg_user_copy_free(&msg_copy);
+
+	return ret;
+}
+#include <syscalls/zsock_sendmsg_mrsh.c>
 
-	for (i = 0; i < msg_copy.msg_iovlen; i++) {
-		k_free(msg_copy.msg_iov[i].iov_base);
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *vec_copy;
+	unsigned int i, copied;
+	size_t vec_size;
+	int ret = -1;
+
+	if (vlen == 0U) {
+		return 0;
 	}
 
-	k_free(msg_copy.msg_iov);
+	if (size_mul_overflow(vlen, sizeof(*msgvec), &vec_size)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	vec_copy = k_usermode_alloc_from_copy(msgvec, vec_size);
+	if (!vec_copy) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	for (copied = 0; copied < vlen; copied++) {
+		if (sendmsg_user_copy(&vec_copy[copied].msg_hdr,
+				      &msgvec[copied].msg_hdr) < 0) {
+			goto out;
+		}
+	}
+
+	ret = z_impl_zsock_sendmmsg(sock, vec_copy, vlen, flags);
+
+	for (i = 0; ret > 0 && i < (unsigned int)ret; i++) {
+		K_OOPS(k_usermode_to_copy(&msgvec[i].msg_len,
+					  &vec_copy[i].msg_len,
+					  sizeof(msgvec[i].msg_len)));
+	}
+
+out:
+	for (i = 0; i < copied; i++) {
+		sendmsg_user_copy_free(&vec_copy[i].msg_hdr);
+	}
+
+	k_free(vec_copy);
 
 	return ret;
+}
+#include <syscalls/zsock_sendmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
 
-fail:
-	if (msg_copy.msg_name) {
-		k_free(msg_copy.msg_name);
+#if defined(CONFIG_NET_SOCKETS_SENDFILE)
+/* Size of the stack buffer used when the data cannot be read directly
+ * into the network buffers.
+ */
+#define SENDFILE_BOUNCE_LEN 256
+
+struct sendfile_data {
+	struct net_context *ctx;
+	struct fs_file_t *file;
+};
+
+static int sendfile_fill(void *dst, size_t len, void *user_data)
+{
+	struct sendfile_data *data = user_data;
+	int ret;
+
+	/* Reading the file can be slow, so let the other users of the socket
+	 * run meanwhile, like send_check_and_wait() does when it waits.
+	 */
+	if (data->ctx->cond.lock) {
+		(void)k_mutex_unlock(data->ctx->cond.lock);
 	}
 
-	if (msg_copy.msg_control) {
-		k_free(msg_copy.msg_control);
+	ret = fs_read(data->file, dst, len);
+
+	if (data->ctx->cond.lock) {
+		(void)k_mutex_lock(data->ctx->cond.lock, K_FOREVER);
+	}
+
+	return ret;
+}
+
+static ssize_t sendfile_ctx(struct net_context *ctx, struct fs_file_t *file,
+			    size_t count)
+{
+	struct sendfile_data data = {
+		.ctx = ctx,
+		.file = file,
+	};
+	k_timeout_t timeout = K_FOREVER;
+	uint32_t retry_timeout = WAIT_BUFS_INITIAL_MS;
+	k_timepoint_t buf_timeout, end;
+	size_t sent = 0;
+	int status;
+
+	if (sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_SNDTIMEO, &timeout, NULL);
 	}
 
-	if (msg_copy.msg_iov) {
-		for (i = 0; i < msg_copy.msg_iovlen; i++) {
-			if (msg_copy.msg_iov[i].iov_base) {
-				k_free(msg_copy.msg_iov[i].iov_base);
+	buf_timeout = sys_timepoint_calc(K_TIMEOUT_EQ(timeout, K_NO_WAIT) ?
+					 K_NO_WAIT : MAX_WAIT_BUFS);
+	end = sys_timepoint_calc(timeout);
+
+	while (sent < count) {
+		/* The file is read straight into TCP send buffers, one MSS
+		 * at a time, without holding the connection lock.
+		 */
+		status = net_tcp_queue_fill(ctx, count - sent, sendfile_fill,
+					    &data);
+		if (status == 0) {
+			/* End of file */
+			break;
+		}
+
+		if (status < 0) {
+			if (sent > 0 && K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+				break;
 			}
+
+			status = send_check_and_wait(ctx, status, buf_timeout,
+						     timeout, &retry_timeout);
+			if (status < 0) {
+				return sent > 0 ? sent : status;
+			}
+
+			/* Update the timeout value in case loop is repeated. */
+			timeout = sys_timepoint_timeout(end);
+
+			continue;
 		}
 
-		k_free(msg_copy.msg_iov);
+		sent += status;
 	}
 
-	return -1;
+	return sent;
 }
-#include <syscalls/zsock_sendmsg_mrsh.c>
-#endif /* CONFIG_USERSPACE */
+
+static ssize_t sendfile_bounce(int sock, struct fs_file_t *file, size_t count)
+{
+	uint8_t buf[SENDFILE_BOUNCE_LEN];
+	size_t sent = 0;
+	ssize_t len, out;
+	size_t done;
+
+	while (sent < count) {
+		len = fs_read(file, buf, MIN(sizeof(buf), count - sent));
+		if (len <= 0) {
+			if (len < 0 && sent == 0) {
+				errno = -len;
+				return -1;
+			}
+
+			break;
+		}
+
+		for (done = 0; done < len; done += out) {
+			out = zsock_send(sock, buf + done, len - done, 0);
+			if (out < 0) {
+				/* Leave the file position after the last
+				 * byte that was actually sent.
+				 */
+				(void)fs_seek(file, (off_t)done - len,
+					      FS_SEEK_CUR);
+
+				return sent + done > 0 ? sent + done : -1;
+			}
+		}
+
+		sent += len;
+	}
+
+	return sent;
+}
+
+ssize_t zsock_sendfile(int sock, struct fs_file_t *file, off_t *offset,
+		       size_t count)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	off_t pos = 0;
+	ssize_t ret;
+	void *obj;
+	int err;
+
+	if (file == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (offset != NULL) {
+		pos = fs_tell(file);
+		if (pos < 0) {
+			errno = -pos;
+			return -1;
+		}
+
+		err = fs_seek(file, *offset, FS_SEEK_SET);
+		if (err < 0) {
+			errno = -err;
+			return -1;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_NET_NATIVE_TCP) &&
+	    vtable == &sock_fd_op_vtable &&
+	    net_context_get_type(obj) == SOCK_STREAM &&
+	    !net_if_is_ip_offloaded(net_context_get_iface(obj))) {
+		(void)k_mutex_lock(lock, K_FOREVER);
+
+		ret = sendfile_ctx(obj, file, count);
+
+		k_mutex_unlock(lock);
+
+		sock_obj_core_update_send_stats(sock, ret);
+	} else {
+		/* TLS and offloaded sockets need the data in a plain buffer */
+		ret = sendfile_bounce(sock, file, count);
+	}
+
+	if (offset != NULL) {
+		if (ret > 0) {
+			*offset += ret;
+		}
+
+		(void)fs_seek(file, pos, FS_SEEK_SET);
+	}
+
+	return ret;
+}
+#endif /* CONFIG_NET_SOCKETS_SENDFILE */
 
 static int sock_get_pkt_src_addr(struct net_pkt *pkt,
 				 enum net_ip_protocol proto,
@@ -1850,13 +2155,75 @@ ssize_t z_impl_zsock_recvmsg(int sock, struct msghdr *msg, int flags)
 	return bytes_received;
 }
 
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	int bytes_received = 0;
+	unsigned int i;
+	ssize_t ret = 0;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (vtable->recvmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	for (i = 0; i < vlen; i++) {
+		ret = vtable->recvmsg(obj, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+		bytes_received += ret;
+
+		/* Only wait for the first message, then take what is queued */
+		flags |= ZSOCK_MSG_DONTWAIT;
+	}
+
+	k_mutex_unlock(lock);
+
+	sock_obj_core_update_recv_stats(sock, bytes_received);
+
+	return (i > 0) ? (int)i : (int)ret;
+}
+
 #ifdef CONFIG_USERSPACE
-ssize_t z_vrfy_zsock_recvmsg(int sock, struct msghdr *msg, int flags)
+static void recvmsg_user_copy_free(struct msghdr *msg_copy, size_t iovlen)
+{
+	size_t i;
+
+	k_free(msg_copy->msg_name);
+	k_free(msg_copy->msg_control);
+
+	/* Note that we need to free according to original iovlen */
+	if (msg_copy->msg_iov) {
+		for (i = 0; i < iovlen; i++) {
+			k_free(msg_copy->msg_iov[i].iov_base);
+		}
+
+		k_free(msg_copy->msg_iov);
+	}
+}
+
+/* Prepare a kernel copy of a user space message to receive into. The
+ * original number of vectors is returned in iovlen. On failure everything
+ * allocated so far is freed and errno is set.
+ */
+static int recvmsg_user_copy(struct msghdr *msg_copy, struct msghdr *msg,
+			     size_t *iovlen)
 {
-	struct msghdr msg_copy;
-	size_t iovlen;
 	size_t i;
-	int ret;
 
 	if (msg == NULL) {
 		errno = EINVAL;
@@ -1868,16 +2235,16 @@ ssize_t z_vrfy_zsock_recvmsg(int sock, struct msghdr *msg, int flags)
 		return -1;
 	}
 
-	K_OOPS(k_usermode_from_copy(&msg_copy, (void *)msg, sizeof(msg_copy)));
+	K_OOPS(k_usermode_from_copy(msg_copy, (void *)msg, sizeof(*msg_copy)));
 
-	k_usermode_from_copy(&iovlen, &msg->msg_iovlen, sizeof(iovlen));
+	*iovlen = msg_copy->msg_iovlen;
 
-	msg_copy.msg_name = NULL;
-	msg_copy.msg_control = NULL;
+	msg_copy->msg_name = NULL;
+	msg_copy->msg_control = NULL;
 
-	msg_copy.msg_iov = k_usermode_alloc_from_copy(msg->msg_iov,
-				       msg->msg_iovlen * sizeof(struct iovec));
-	if (!msg_copy.msg_iov) {
+	msg_copy->msg_iov = k_usermode_alloc_from_copy(msg->msg_iov,
+				       *iovlen * sizeof(struct iovec));
+	if (!msg_copy->msg_iov) {
 		errno = ENOMEM;
 		goto fail;
 	}
@@ -1886,24 +2253,24 @@ ssize_t z_vrfy_zsock_recvmsg(int sock, struct msghdr *msg, int flags)
 	 * next loop fails, we do not try to free non allocated memory
 	 * in fail branch.
 	 */
-	memset(msg_copy.msg_iov, 0, msg->msg_iovlen * sizeof(struct iovec));
+	memset(msg_copy->msg_iov, 0, *iovlen * sizeof(struct iovec));
 
-	for (i = 0; i < iovlen; i++) {
+	for (i = 0; i < *iovlen; i++) {
 		/* TODO: In practice we do not need to copy the actual data
 		 * in msghdr when receiving data but currently there is no
 		 * ready made function to do just that (unless we want to call
 		 * relevant malloc function here ourselves). So just use
 		 * the copying variant for now.
 		 */
-		msg_copy.msg_iov[i].iov_base =
+		msg_copy->msg_iov[i].iov_base =
 			k_usermode_alloc_from_copy(msg->msg_iov[i].iov_base,
 						   msg->msg_iov[i].iov_len);
-		if (!msg_copy.msg_iov[i].iov_base) {
+		if (!msg_copy->msg_iov[i].iov_base) {
 			errno = ENOMEM;
 			goto fail;
 		}
 
-		msg_copy.msg_iov[i].iov_len = msg->msg_iov[i].iov_len;
+		msg_copy->msg_iov[i].iov_len = msg->msg_iov[i].iov_len;
 	}
 
 	if (msg->msg_namelen > 0) {
@@ -1912,9 +2279,9 @@ ssize_t z_vrfy_zsock_recvmsg(int sock, struct msghdr *msg, int flags)
 			goto fail;
 		}
 
-		msg_copy.msg_name = k_usermode_alloc_from_copy(msg->msg_name,
-							   msg->msg_namelen);
-		if (msg_copy.msg_name == NULL) {
+		msg_copy->msg_name = k_usermode_alloc_from_copy(msg->msg_name,
+							    msg->msg_namelen);
+		if (msg_copy->msg_name == NULL) {
 			errno = ENOMEM;
 			goto fail;
 		}
@@ -1926,99 +2293,342 @@ ssize_t z_vrfy_zsock_recvmsg(int sock, struct msghdr *msg, int flags)
 			goto fail;
 		}
 
-		msg_copy.msg_control =
+		msg_copy->msg_control =
 			k_usermode_alloc_from_copy(msg->msg_control,
 						   msg->msg_controllen);
-		if (msg_copy.msg_control == NULL) {
+		if (msg_copy->msg_control == NULL) {
 			errno = ENOMEM;
 			goto fail;
 		}
 	}
 
+	return 0;
+
+fail:
+	recvmsg_user_copy_free(msg_copy, *iovlen);
+
+	return -1;
+}
+
+/* Copy a received message back to user space */
+static void recvmsg_user_copy_back(struct msghdr *msg,
+				   struct msghdr *msg_copy, size_t iovlen)
+{
+	size_t i;
+
+	if (msg->msg_namelen > 0 && msg->msg_name != NULL) {
+		K_OOPS(k_usermode_to_copy(msg->msg_name,
+					  msg_copy->msg_name,
+					  msg_copy->msg_namelen));
+	}
+
+	if (msg->msg_controllen > 0 &&
+	    msg->msg_control != NULL) {
+		K_OOPS(k_usermode_to_copy(msg->msg_control,
+					  msg_copy->msg_control,
+					  msg_copy->msg_controllen));
+
+		msg->msg_controllen = msg_copy->msg_controllen;
+	} else {
+		msg->msg_controllen = 0U;
+	}
+
+	k_usermode_to_copy(&msg->msg_iovlen,
+			   &msg_copy->msg_iovlen,
+			   sizeof(msg->msg_iovlen));
+
+	/* The new iovlen cannot be bigger than the original one */
+	NET_ASSERT(msg_copy->msg_iovlen <= iovlen);
+
+	for (i = 0; i < iovlen; i++) {
+		if (i < msg_copy->msg_iovlen) {
+			K_OOPS(k_usermode_to_copy(msg->msg_iov[i].iov_base,
+						  msg_copy->msg_iov[i].iov_base,
+						  msg_copy->msg_iov[i].iov_len));
+			K_OOPS(k_usermode_to_copy(&msg->msg_iov[i].iov_len,
+						  &msg_copy->msg_iov[i].iov_len,
+						  sizeof(msg->msg_iov[i].iov_len)));
+		} else {
+			/* Clear out those vectors that we could not populate */
+			msg->msg_iov[i].iov_len = 0;
+		}
+	}
+
+	k_usermode_to_copy(&msg->msg_flags,
+			   &msg_copy->msg_flags,
+			   sizeof(msg->msg_flags));
+}
+
+ssize_t z_vrfy_zsock_recvmsg(int sock, struct msghdr *msg, int flags)
+{
+	struct msghdr msg_copy;
+	size_t iovlen;
+	int ret;
+
+	if (recvmsg_user_copy(&msg_copy, msg, &iovlen) < 0) {
+		return -1;
+	}
+
 	ret = z_impl_zsock_recvmsg(sock, &msg_copy, flags);
 
 	/* Do not copy anything back if there was an error or nothing was
 	 * received.
 	 */
 	if (ret > 0) {
-		if (msg->msg_namelen > 0 && msg->msg_name != NULL) {
-			K_OOPS(k_usermode_to_copy(msg->msg_name,
-						  msg_copy.msg_name,
-						  msg_copy.msg_namelen));
+		recvmsg_user_copy_back(msg, &msg_copy, iovlen);
+	}
+
+	recvmsg_user_copy_free(&msg_copy, iovlen);
+
+	return ret;
+}
+#include <syscalls/zsock_recvmsg_mrsh.c>
+
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *vec_copy;
+	unsigned int i, copied;
+	size_t *iovlens;
+	size_t vec_size;
+	int ret = -1;
+
+	if (vlen == 0U) {
+		return 0;
+	}
+
+	if (size_mul_overflow(vlen, sizeof(*msgvec), &vec_size)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	vec_copy = k_usermode_alloc_from_copy(msgvec, vec_size);
+	if (!vec_copy) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	/* The received messages may use less vectors than given, so the
+	 * original counts are needed for copying back and freeing.
+	 */
+	iovlens = k_malloc(vlen * sizeof(size_t));
+	if (!iovlens) {
+		k_free(vec_copy);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	for (copied = 0; copied < vlen; copied++) {
+		if (recvmsg_user_copy(&vec_copy[copied].msg_hdr,
+				      &msgvec[copied].msg_hdr,
+				      &iovlens[copied]) < 0) {
+			goto out;
+		}
+	}
+
+	ret = z_impl_zsock_recvmmsg(sock, vec_copy, vlen, flags);
+
+	for (i = 0; ret > 0 && i < (unsigned int)ret; i++) {
+		if (vec_copy[i].msg_len > 0) {
+			recvmsg_user_copy_back(&msgvec[i].msg_hdr,
+					       &vec_copy[i].msg_hdr,
+					       iovlens[i]);
+		}
+
+		K_OOPS(k_usermode_to_copy(&msgvec[i].msg_len,
+					  &vec_copy[i].msg_len,
+					  sizeof(msgvec[i].msg_len)));
+	}
+
+out:
+	for (i = 0; i < copied; i++) {
+		recvmsg_user_copy_free(&vec_copy[i].msg_hdr, iovlens[i]);
+	}
+
+	k_free(iovlens);
+	k_free(vec_copy);
+
+	return ret;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+#if defined(CONFIG_NET_SOCKETS_RECV_ZEROCOPY)
+static ssize_t zsock_recv_dgram_zc(struct net_context *ctx,
+				   struct msghdr *msg,
+				   void **token,
+				   int flags)
+{
+	k_timeout_t timeout = K_FOREVER;
+	size_t recv_len, remaining, offset, len;
+	struct net_buf *frag;
+	struct net_pkt *pkt;
+	size_t iovec = 0;
+	int ret;
+
+	if (msg->msg_iovlen < 1 || msg->msg_iov == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+
+		ret = zsock_wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
 		}
+	}
 
-		if (msg->msg_controllen > 0 &&
-		    msg->msg_control != NULL) {
-			K_OOPS(k_usermode_to_copy(msg->msg_control,
-						  msg_copy.msg_control,
-						  msg_copy.msg_controllen));
+	pkt = k_fifo_get(&ctx->recv_q, timeout);
+	if (!pkt) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (msg->msg_name != NULL && msg->msg_namelen > 0) {
+		struct sockaddr *src_addr = msg->msg_name;
 
-			msg->msg_controllen = msg_copy.msg_controllen;
+		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+			ret = sock_get_offload_pkt_src_addr(pkt, ctx, src_addr,
+							    msg->msg_namelen);
 		} else {
-			msg->msg_controllen = 0U;
+			ret = sock_get_pkt_src_addr(pkt, net_context_get_proto(ctx),
+						    src_addr, msg->msg_namelen);
 		}
 
-		k_usermode_to_copy(&msg->msg_iovlen,
-				   &msg_copy.msg_iovlen,
-				   sizeof(msg->msg_iovlen));
+		if (ret < 0) {
+			errno = -ret;
+			net_pkt_unref(pkt);
+			return -1;
+		}
 
-		/* The new iovlen cannot be bigger than the original one */
-		NET_ASSERT(msg_copy.msg_iovlen <= iovlen);
+		if (src_addr->sa_family == AF_INET) {
+			msg->msg_namelen = sizeof(struct sockaddr_in);
+		} else if (src_addr->sa_family == AF_INET6) {
+			msg->msg_namelen = sizeof(struct sockaddr_in6);
+		} else {
+			errno = ENOTSUP;
+			net_pkt_unref(pkt);
+			return -1;
+		}
+	}
 
-		for (i = 0; i < iovlen; i++) {
-			if (i < msg_copy.msg_iovlen) {
-				K_OOPS(k_usermode_to_copy(msg->msg_iov[i].iov_base,
-							  msg_copy.msg_iov[i].iov_base,
-							  msg_copy.msg_iov[i].iov_len));
-				K_OOPS(k_usermode_to_copy(&msg->msg_iov[i].iov_len,
-							  &msg_copy.msg_iov[i].iov_len,
-							  sizeof(msg->msg_iov[i].iov_len)));
-			} else {
-				/* Clear out those vectors that we could not populate */
-				msg->msg_iov[i].iov_len = 0;
-			}
+	if (msg->msg_control != NULL && msg->msg_controllen > 0 &&
+	    IS_ENABLED(CONFIG_NET_CONTEXT_RECV_PKTINFO) &&
+	    net_context_is_recv_pktinfo_set(ctx)) {
+		if (add_pktinfo(ctx, pkt, msg) < 0) {
+			msg->msg_flags |= ZSOCK_MSG_CTRUNC;
+		}
+	} else {
+		msg->msg_controllen = 0U;
+	}
+
+	/* Describe the payload after the cursor, one vector per fragment */
+	recv_len = net_pkt_remaining_data(pkt);
+	remaining = recv_len;
+	frag = pkt->cursor.buf;
+	offset = frag ? pkt->cursor.pos - frag->data : 0;
+
+	while (frag && remaining > 0 && iovec < msg->msg_iovlen) {
+		len = MIN(remaining, frag->len - offset);
+		if (len > 0) {
+			msg->msg_iov[iovec].iov_base = frag->data + offset;
+			msg->msg_iov[iovec].iov_len = len;
+			remaining -= len;
+			iovec++;
 		}
 
-		k_usermode_to_copy(&msg->msg_flags,
-				   &msg_copy.msg_flags,
-				   sizeof(msg->msg_flags));
+		frag = frag->frags;
+		offset = 0;
 	}
 
-	k_free(msg_copy.msg_name);
-	k_free(msg_copy.msg_control);
+	msg->msg_iovlen = iovec;
 
-	/* Note that we need to free according to original iovlen */
-	for (i = 0; i < iovlen; i++) {
-		k_free(msg_copy.msg_iov[i].iov_base);
+	if (remaining > 0) {
+		msg->msg_flags |= ZSOCK_MSG_TRUNC;
 	}
 
-	k_free(msg_copy.msg_iov);
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
 
-	return ret;
+	*token = pkt;
 
-fail:
-	if (msg_copy.msg_name) {
-		k_free(msg_copy.msg_name);
+	return (flags & ZSOCK_MSG_TRUNC) ? recv_len : recv_len - remaining;
+}
+
+ssize_t z_impl_zsock_recvmsg_zc(int sock, struct msghdr *msg, void **token,
+				int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	ssize_t ret;
+	void *obj;
+
+	if (msg == NULL || token == NULL || (flags & ZSOCK_MSG_PEEK)) {
+		errno = EINVAL;
+		return -1;
 	}
 
-	if (msg_copy.msg_control) {
-		k_free(msg_copy.msg_control);
+	*token = NULL;
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
 	}
 
-	if (msg_copy.msg_iov) {
-		for (i = 0; i < msg_copy.msg_iovlen; i++) {
-			if (msg_copy.msg_iov[i].iov_base) {
-				k_free(msg_copy.msg_iov[i].iov_base);
-			}
-		}
+	/* Only native datagram sockets can lend their packets */
+	if (vtable != &sock_fd_op_vtable ||
+	    net_context_get_type(obj) != SOCK_DGRAM) {
+		return z_impl_zsock_recvmsg(sock, msg, flags);
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	ret = zsock_recv_dgram_zc(obj, msg, token, flags);
+
+	k_mutex_unlock(lock);
+
+	sock_obj_core_update_recv_stats(sock, ret);
+
+	return ret;
+}
 
-		k_free(msg_copy.msg_iov);
+void z_impl_zsock_recvmsg_zc_release(void *token)
+{
+	if (token != NULL) {
+		net_pkt_unref(token);
 	}
+}
 
-	return -1;
+#ifdef CONFIG_USERSPACE
+static inline ssize_t z_vrfy_zsock_recvmsg_zc(int sock, struct msghdr *msg,
+					      void **token, int flags)
+{
+	void *no_token = NULL;
+
+	/* The network buffers are not accessible from user mode, so copy
+	 * the data instead and never hand out a token.
+	 */
+	K_OOPS(k_usermode_to_copy(token, &no_token, sizeof(no_token)));
+
+	return z_vrfy_zsock_recvmsg(sock, msg, flags);
 }
-#include <syscalls/zsock_recvmsg_mrsh.c>
+#include <syscalls/zsock_recvmsg_zc_mrsh.c>
+
+static inline void z_vrfy_zsock_recvmsg_zc_release(void *token)
+{
+	K_OOPS(K_SYSCALL_VERIFY_MSG(token == NULL, "invalid token"));
+}
+#include <syscalls/zsock_recvmsg_zc_release_mrsh.c>
 #endif /* CONFIG_USERSPACE */
+#endif /* CONFIG_NET_SOCKETS_RECV_ZEROCOPY */
 
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
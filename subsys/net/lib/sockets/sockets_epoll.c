@@ -0,0 +1,846 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/fdtable.h>
+
+#include "sockets_internal.h"
+
+#define EPOLL_EVENTS (ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT | ZSOCK_EPOLLERR | \
+		      ZSOCK_EPOLLHUP)
+
+struct epoll;
+
+struct epoll_item {
+	/** Node in the list of items watching a native socket */
+	sys_snode_t watch_node;
+	/** Node in the ready list of the instance */
+	sys_dnode_t ready_node;
+	/** Node in the interest list of the instance */
+	sys_dnode_t node;
+	/** Node in the list of items that have to be polled */
+	sys_dnode_t poll_node;
+	/** Node in the list of disarmed items without callbacks */
+	sys_dnode_t idle_node;
+	/** Instance the item belongs to */
+	struct epoll *ep;
+	/** Watched object, NULL once a native socket has been closed */
+	void *obj;
+	/** First poll event used by the item while waiting */
+	struct k_poll_event *pev;
+	/** Poll entry used with ZFD_IOCTL_POLL_PREPARE/UPDATE */
+	struct zsock_pollfd pfd;
+	uint32_t events;
+	zsock_epoll_data_t data;
+	int fd;
+	/** Readiness is reported by the socket callbacks */
+	bool native;
+	/** Cleared after a ZSOCK_EPOLLONESHOT event was reported */
+	bool armed;
+};
+
+struct epoll {
+	struct k_mutex lock;
+	/** All the items of the instance */
+	sys_dlist_t items;
+	/** Items that might be ready, checked in zsock_epoll_wait() */
+	sys_dlist_t ready;
+	/** Items without callbacks, these are polled while waiting */
+	sys_dlist_t polled;
+	/** Disarmed items without callbacks, only checked for close */
+	sys_dlist_t idle;
+	/** Raised when an item is put on the ready list */
+	struct k_poll_signal signal;
+	/** Changed every time the polled list is modified */
+	uint32_t gen;
+	/** Held by the file descriptor and by each thread inside an epoll
+	 * call, the slot is only reused once all of them are gone.
+	 */
+	int refs;
+	/** Set when the file descriptor is closed */
+	bool closed;
+};
+
+static struct epoll epolls[CONFIG_NET_SOCKETS_EPOLL_MAX];
+
+K_MEM_SLAB_DEFINE_STATIC(epoll_item_slab, sizeof(struct epoll_item),
+			 CONFIG_NET_SOCKETS_EPOLL_MAX_ITEMS, 4);
+
+/* Protects the ready lists, the socket watch lists and item->obj, these
+ * are accessed from the network stack callbacks.
+ */
+static struct k_spinlock epoll_lock;
+
+static const struct fd_op_vtable epoll_fd_vtable;
+
+static bool is_native_sock(const struct fd_op_vtable *vtable)
+{
+	return vtable == (const struct fd_op_vtable *)&sock_fd_op_vtable;
+}
+
+/* Must be called with epoll_lock held */
+static void item_set_ready(struct epoll_item *item)
+{
+	if (!sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_append(&item->ep->ready, &item->ready_node);
+	}
+
+	k_poll_signal_raise(&item->ep->signal, 0);
+}
+
+void zsock_epoll_notify(struct net_context *ctx)
+{
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&epoll_lock);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, watch_node) {
+		if (item->armed) {
+			item_set_ready(item);
+		}
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+}
+
+void zsock_epoll_detach(struct net_context *ctx)
+{
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+	sys_snode_t *node;
+
+	key = k_spin_lock(&epoll_lock);
+
+	while ((node = sys_slist_get(&ctx->epoll_items)) != NULL) {
+		item = CONTAINER_OF(node, struct epoll_item, watch_node);
+		item->obj = NULL;
+
+		/* The instance frees the item when it finds it on the
+		 * ready list, its lock cannot be taken here.
+		 */
+		item_set_ready(item);
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+}
+
+static struct epoll *get_epoll(int epfd)
+{
+	const struct fd_op_vtable *vtable;
+	struct epoll *ep;
+
+	ep = z_get_fd_obj_and_vtable(epfd, &vtable, NULL);
+	if (ep == NULL) {
+		errno = EBADF;
+		return NULL;
+	}
+
+	if (vtable != &epoll_fd_vtable) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	return ep;
+}
+
+/* Take a reference on the instance so that its slot, and the mutex in it,
+ * are not reinitialized by zsock_epoll_create() while it is used.
+ */
+static struct epoll *epoll_get(int epfd)
+{
+	k_spinlock_key_t key;
+	struct epoll *ep;
+
+	ep = get_epoll(epfd);
+	if (ep == NULL) {
+		return NULL;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+
+	if (ep->refs == 0 || ep->closed) {
+		ep = NULL;
+	} else {
+		ep->refs++;
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	if (ep == NULL) {
+		errno = EBADF;
+	}
+
+	return ep;
+}
+
+static void epoll_put(struct epoll *ep)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&epoll_lock);
+	ep->refs--;
+	k_spin_unlock(&epoll_lock, key);
+}
+
+static bool item_is_polled(struct epoll_item *item)
+{
+	/* Native sockets have callbacks for received data, but write space
+	 * on TCP sockets is only visible through the TX semaphore.
+	 */
+	return item->armed &&
+	       (!item->native || (item->events & ZSOCK_EPOLLOUT));
+}
+
+static void item_update_polled(struct epoll *ep, struct epoll_item *item)
+{
+	bool idle = !item->native && !item->armed;
+	bool linked;
+
+	/* Nothing tells when a file descriptor without callbacks is closed,
+	 * so a disarmed one is kept on a list of its own to be able to free
+	 * it anyway.
+	 */
+	linked = sys_dnode_is_linked(&item->idle_node);
+	if (idle && !linked) {
+		sys_dlist_append(&ep->idle, &item->idle_node);
+	} else if (!idle && linked) {
+		sys_dlist_remove(&item->idle_node);
+	}
+
+	linked = sys_dnode_is_linked(&item->poll_node);
+
+	if (item_is_polled(item) && !linked) {
+		sys_dlist_append(&ep->polled, &item->poll_node);
+	} else if (!item_is_polled(item) && linked) {
+		sys_dlist_remove(&item->poll_node);
+	} else {
+		return;
+	}
+
+	ep->gen++;
+}
+
+static struct epoll_item *item_find(struct epoll *ep, int fd, void *obj)
+{
+	struct epoll_item *item;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&ep->items, item, node) {
+		if (item->obj != NULL && item->fd == fd && item->obj == obj) {
+			return item;
+		}
+	}
+
+	return NULL;
+}
+
+/* Must be called with the instance lock held */
+static void item_free(struct epoll *ep, struct epoll_item *item)
+{
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&epoll_lock);
+
+	if (item->native && item->obj != NULL) {
+		struct net_context *ctx = item->obj;
+
+		(void)sys_slist_find_and_remove(&ctx->epoll_items,
+						&item->watch_node);
+	}
+
+	if (sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_remove(&item->ready_node);
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	if (sys_dnode_is_linked(&item->poll_node)) {
+		sys_dlist_remove(&item->poll_node);
+		ep->gen++;
+	}
+
+	if (sys_dnode_is_linked(&item->idle_node)) {
+		sys_dlist_remove(&item->idle_node);
+	}
+
+	sys_dlist_remove(&item->node);
+
+	k_mem_slab_free(&epoll_item_slab, item);
+}
+
+/* Return false if the file descriptor of the item was closed */
+static bool item_is_valid(struct epoll_item *item,
+			  const struct fd_op_vtable **vtable,
+			  struct k_mutex **lock)
+{
+	const struct fd_op_vtable *ignored;
+	void *obj = item->obj;
+
+	if (obj == NULL) {
+		return false;
+	}
+
+	return z_get_fd_obj_and_vtable(item->fd,
+				       vtable ? vtable : &ignored,
+				       lock) == obj;
+}
+
+/* Free the disarmed items whose file descriptor was closed. Armed ones are
+ * found while preparing the wait and native sockets detach themselves.
+ */
+static void epoll_reap_idle(struct epoll *ep)
+{
+	struct epoll_item *item, *next;
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ep->idle, item, next, idle_node) {
+		if (!item_is_valid(item, NULL, NULL)) {
+			item_free(ep, item);
+		}
+	}
+}
+
+static uint32_t item_revents(struct epoll_item *item)
+{
+	struct zsock_pollfd pfd = {
+		.fd = item->fd,
+		.events = item->events & (ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT),
+	};
+
+	if (zsock_poll_internal(&pfd, 1, K_NO_WAIT) <= 0) {
+		return 0;
+	}
+
+	return pfd.revents & ((item->events & EPOLL_EVENTS) |
+			      ZSOCK_EPOLLERR | ZSOCK_EPOLLHUP);
+}
+
+static int epoll_ctl_add(struct epoll *ep, int fd,
+			 struct zsock_epoll_event *event)
+{
+	struct k_poll_event probe[2];
+	struct k_poll_event *pev = probe;
+	const struct fd_op_vtable *vtable;
+	struct epoll_item *item;
+	struct k_mutex *lock;
+	k_spinlock_key_t key;
+	void *obj;
+	int ret;
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable, &lock);
+	if (obj == NULL) {
+		return -EBADF;
+	}
+
+	if (vtable == &epoll_fd_vtable) {
+		return -EINVAL;
+	}
+
+	if (item_find(ep, fd, obj) != NULL) {
+		return -EEXIST;
+	}
+
+	/* Serialize against close() so a native socket cannot go away
+	 * before the item is on its watch list.
+	 */
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	if (z_get_fd_obj_and_vtable(fd, &vtable, NULL) != obj) {
+		ret = -EBADF;
+		goto out;
+	}
+
+	/* Offloaded sockets can only be polled by the offload driver */
+	ret = z_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_POLL_PREPARE,
+				   &(struct zsock_pollfd){ .fd = fd },
+				   &pev, probe + ARRAY_SIZE(probe));
+	if (ret == -EXDEV) {
+		ret = -EPERM;
+		goto out;
+	}
+
+	if (k_mem_slab_alloc(&epoll_item_slab, (void **)&item, K_NO_WAIT) < 0) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	memset(item, 0, sizeof(*item));
+
+	item->ep = ep;
+	item->obj = obj;
+	item->fd = fd;
+	item->events = event->events;
+	item->data = event->data;
+	item->native = is_native_sock(vtable);
+	item->armed = true;
+
+	sys_dlist_append(&ep->items, &item->node);
+	item_update_polled(ep, item);
+
+	key = k_spin_lock(&epoll_lock);
+
+	if (item->native) {
+		sys_slist_append(&((struct net_context *)obj)->epoll_items,
+				 &item->watch_node);
+	}
+
+	/* Report what is already pending */
+	item_set_ready(item);
+
+	k_spin_unlock(&epoll_lock, key);
+
+	ret = 0;
+
+out:
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
+int zsock_epoll_ctl(int epfd, int op, int fd, struct zsock_epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+	struct epoll *ep;
+	void *obj;
+	int ret = 0;
+
+	if (op != ZSOCK_EPOLL_CTL_DEL && event == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	ep = epoll_get(epfd);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(&ep->lock, K_FOREVER);
+
+	if (ep->closed) {
+		ret = -EBADF;
+		goto out;
+	}
+
+	epoll_reap_idle(ep);
+
+	if (op == ZSOCK_EPOLL_CTL_ADD) {
+		ret = epoll_ctl_add(ep, fd, event);
+		goto out;
+	}
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable, NULL);
+	if (obj == NULL) {
+		ret = -EBADF;
+		goto out;
+	}
+
+	item = item_find(ep, fd, obj);
+	if (item == NULL) {
+		ret = -ENOENT;
+		goto out;
+	}
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_MOD:
+		item->events = event->events;
+		item->data = event->data;
+		item->armed = true;
+		item_update_polled(ep, item);
+
+		key = k_spin_lock(&epoll_lock);
+		item_set_ready(item);
+		k_spin_unlock(&epoll_lock, key);
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		item_free(ep, item);
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+out:
+	k_mutex_unlock(&ep->lock);
+
+	epoll_put(ep);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Check the items on the ready list and report the ones that really are
+ * ready. Level triggered items stay on the list so they are checked again
+ * on the next call.
+ */
+static int epoll_harvest(struct epoll *ep, struct zsock_epoll_event *events,
+			 int maxevents)
+{
+	struct epoll_item *item;
+	k_spinlock_key_t key;
+	sys_dlist_t again;
+	sys_dnode_t *node;
+	uint32_t revents;
+	int count = 0;
+
+	sys_dlist_init(&again);
+
+	while (count < maxevents) {
+		key = k_spin_lock(&epoll_lock);
+		node = sys_dlist_get(&ep->ready);
+		k_spin_unlock(&epoll_lock, key);
+
+		if (node == NULL) {
+			break;
+		}
+
+		item = CONTAINER_OF(node, struct epoll_item, ready_node);
+
+		if (!item_is_valid(item, NULL, NULL)) {
+			item_free(ep, item);
+			continue;
+		}
+
+		if (!item->armed) {
+			continue;
+		}
+
+		revents = item_revents(item);
+		if (revents == 0) {
+			continue;
+		}
+
+		events[count].events = revents;
+		events[count].data = item->data;
+		count++;
+
+		if (item->events & ZSOCK_EPOLLONESHOT) {
+			item->armed = false;
+			item_update_polled(ep, item);
+			continue;
+		}
+
+		if (item->events & ZSOCK_EPOLLET) {
+			continue;
+		}
+
+		key = k_spin_lock(&epoll_lock);
+
+		/* A callback might have queued it again meanwhile */
+		if (!sys_dnode_is_linked(&item->ready_node)) {
+			sys_dlist_append(&again, &item->ready_node);
+		}
+
+		k_spin_unlock(&epoll_lock, key);
+	}
+
+	key = k_spin_lock(&epoll_lock);
+
+	while ((node = sys_dlist_get(&again)) != NULL) {
+		sys_dlist_append(&ep->ready, node);
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	return count;
+}
+
+/* Add the poll events of the items without callbacks. Returns 1 if some
+ * item is known to be ready already.
+ */
+static int epoll_prepare(struct epoll *ep, struct k_poll_event **pev,
+			 struct k_poll_event *pev_end)
+{
+	const struct fd_op_vtable *vtable;
+	struct epoll_item *item, *next;
+	struct k_mutex *lock;
+	k_spinlock_key_t key;
+	int ready = 0;
+	int ret;
+
+	epoll_reap_idle(ep);
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ep->polled, item, next, poll_node) {
+		item->pev = NULL;
+
+		if (!item_is_valid(item, &vtable, &lock)) {
+			item_free(ep, item);
+			continue;
+		}
+
+		item->pfd.fd = item->fd;
+		item->pfd.revents = 0;
+		item->pfd.events = item->events &
+				   (item->native ? ZSOCK_EPOLLOUT :
+				    (ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT));
+		item->pev = *pev;
+
+		(void)k_mutex_lock(lock, K_FOREVER);
+		ret = z_fdtable_call_ioctl(vtable, item->obj,
+					   ZFD_IOCTL_POLL_PREPARE,
+					   &item->pfd, pev, pev_end);
+		k_mutex_unlock(lock);
+
+		if (ret == -EALREADY) {
+			key = k_spin_lock(&epoll_lock);
+			item_set_ready(item);
+			k_spin_unlock(&epoll_lock, key);
+
+			ready = 1;
+		} else if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return ready;
+}
+
+static void epoll_update(struct epoll *ep)
+{
+	const struct fd_op_vtable *vtable;
+	struct k_poll_event *pev;
+	struct epoll_item *item;
+	struct k_mutex *lock;
+	k_spinlock_key_t key;
+	int ret;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&ep->polled, item, poll_node) {
+		if (item->pev == NULL ||
+		    !item_is_valid(item, &vtable, &lock)) {
+			continue;
+		}
+
+		pev = item->pev;
+
+		(void)k_mutex_lock(lock, K_FOREVER);
+		ret = z_fdtable_call_ioctl(vtable, item->obj,
+					   ZFD_IOCTL_POLL_UPDATE,
+					   &item->pfd, &pev);
+		k_mutex_unlock(lock);
+
+		if (ret == 0 && item->pfd.revents != 0) {
+			key = k_spin_lock(&epoll_lock);
+			item_set_ready(item);
+			k_spin_unlock(&epoll_lock, key);
+		}
+	}
+}
+
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout)
+{
+	/* The first event is the signal of the instance */
+	struct k_poll_event poll_events[CONFIG_NET_SOCKETS_POLL_MAX + 1];
+	struct k_poll_event *pev_end = poll_events + ARRAY_SIZE(poll_events);
+	struct k_poll_event *pev;
+	k_timeout_t wait;
+	k_timepoint_t end;
+	struct epoll *ep;
+	uint32_t gen;
+	bool last;
+	int ret;
+
+	if (events == NULL || maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ep = epoll_get(epfd);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	end = sys_timepoint_calc(timeout < 0 ? K_FOREVER : K_MSEC(timeout));
+
+	(void)k_mutex_lock(&ep->lock, K_FOREVER);
+
+	while (true) {
+		if (ep->closed) {
+			ret = -EBADF;
+			break;
+		}
+
+		k_poll_signal_reset(&ep->signal);
+
+		ret = epoll_harvest(ep, events, maxevents);
+		if (ret > 0) {
+			break;
+		}
+
+		pev = poll_events;
+		k_poll_event_init(pev++, K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY, &ep->signal);
+
+		ret = epoll_prepare(ep, &pev, pev_end);
+		if (ret < 0) {
+			break;
+		}
+
+		wait = sys_timepoint_timeout(end);
+		last = K_TIMEOUT_EQ(wait, K_NO_WAIT);
+		gen = ep->gen;
+
+		if (ret > 0) {
+			/* Something is ready, just pick up the other events */
+			wait = K_NO_WAIT;
+		}
+
+		/* Let other threads modify the interest list while waiting */
+		k_mutex_unlock(&ep->lock);
+
+		ret = k_poll(poll_events, pev - poll_events, wait);
+
+		(void)k_mutex_lock(&ep->lock, K_FOREVER);
+
+		/* EAGAIN when timeout expired, EINTR when cancelled (i.e. EOF) */
+		if (ret != 0 && ret != -EAGAIN && ret != -EINTR) {
+			break;
+		}
+
+		if (ep->gen == gen) {
+			epoll_update(ep);
+		}
+
+		if (last) {
+			ret = epoll_harvest(ep, events, maxevents);
+			break;
+		}
+	}
+
+	k_mutex_unlock(&ep->lock);
+
+	epoll_put(ep);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return ret;
+}
+
+int zsock_epoll_create(int flags)
+{
+	struct epoll *ep = NULL;
+	k_spinlock_key_t key;
+	int fd;
+
+	if (flags != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+
+	/* A closed slot still referenced by a waiter is not free yet */
+	ARRAY_FOR_EACH_PTR(epolls, candidate) {
+		if (candidate->refs == 0) {
+			candidate->refs = 1;
+			candidate->closed = false;
+			ep = candidate;
+			break;
+		}
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	if (ep == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		epoll_put(ep);
+		return -1;
+	}
+
+	k_mutex_init(&ep->lock);
+	sys_dlist_init(&ep->items);
+	sys_dlist_init(&ep->ready);
+	sys_dlist_init(&ep->polled);
+	sys_dlist_init(&ep->idle);
+	k_poll_signal_init(&ep->signal);
+	ep->gen = 0;
+
+	z_finalize_fd(fd, ep, &epoll_fd_vtable);
+
+	return fd;
+}
+
+static ssize_t epoll_read_op(void *obj, void *buf, size_t sz)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buf);
+	ARG_UNUSED(sz);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_op(void *obj, const void *buf, size_t sz)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(buf);
+	ARG_UNUSED(sz);
+
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_ioctl_op(void *obj, unsigned int request, va_list args)
+{
+	ARG_UNUSED(obj);
+	ARG_UNUSED(request);
+	ARG_UNUSED(args);
+
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+static int epoll_close_op(void *obj)
+{
+	struct epoll *ep = obj;
+	sys_dnode_t *node;
+
+	(void)k_mutex_lock(&ep->lock, K_FOREVER);
+
+	while ((node = sys_dlist_peek_head(&ep->items)) != NULL) {
+		item_free(ep, CONTAINER_OF(node, struct epoll_item, node));
+	}
+
+	ep->closed = true;
+
+	/* Wake up the threads still waiting on the instance, the slot is
+	 * freed when the last of them drops its reference.
+	 */
+	k_poll_signal_raise(&ep->signal, 0);
+
+	k_mutex_unlock(&ep->lock);
+
+	epoll_put(ep);
+
+	return 0;
+}
+
+static const struct fd_op_vtable epoll_fd_vtable = {
+	.read = epoll_read_op,
+	.write = epoll_write_op,
+	.close = epoll_close_op,
+	.ioctl = epoll_ioctl_op,
+};
@@ -0,0 +1,248 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *
+ * @brief Connection attempts as described by Happy Eyeballs (RFC 8305).
+ *
+ * Addresses are tried alternating between IPv6 and IPv4, IPv6 first. Each
+ * attempt is given CONFIG_NET_SOCKETS_HAPPY_EYEBALLS_DELAY milliseconds
+ * before the next one is started, without giving up on it, and the next one
+ * is started right away when an attempt fails. The first socket to connect
+ * wins and the other attempts are abandoned.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket.h>
+
+#define MAX_ATTEMPTS CONFIG_NET_SOCKETS_HAPPY_EYEBALLS_MAX_ATTEMPTS
+
+BUILD_ASSERT(MAX_ATTEMPTS <= CONFIG_NET_SOCKETS_POLL_MAX,
+	     "Not enough poll() entries for the connection attempts");
+
+struct happy_eyeballs {
+	/* Next address to try for IPv6 and IPv4 */
+	const struct zsock_addrinfo *next[2];
+	/* Family to try next, index into next[] */
+	int turn;
+	/* When to start the next attempt */
+	k_timepoint_t next_attempt;
+	struct zsock_pollfd fds[MAX_ATTEMPTS];
+	int count;
+	int error;
+};
+
+static const struct zsock_addrinfo *next_of_family(const struct zsock_addrinfo *ai,
+						   int family)
+{
+	while (ai != NULL && ai->ai_family != family) {
+		ai = ai->ai_next;
+	}
+
+	return ai;
+}
+
+static const struct zsock_addrinfo *next_addr(struct happy_eyeballs *he)
+{
+	static const int families[] = { AF_INET6, AF_INET };
+	const struct zsock_addrinfo *ai;
+
+	if (he->next[he->turn] == NULL) {
+		he->turn ^= 1;
+	}
+
+	ai = he->next[he->turn];
+	if (ai != NULL) {
+		he->next[he->turn] = next_of_family(ai->ai_next, families[he->turn]);
+		he->turn ^= 1;
+	}
+
+	return ai;
+}
+
+static bool more_addrs(struct happy_eyeballs *he)
+{
+	return he->next[0] != NULL || he->next[1] != NULL;
+}
+
+static void start_attempt(struct happy_eyeballs *he, const struct zsock_addrinfo *ai)
+{
+	int sock;
+	int flags;
+
+	/* If this one fails, the next address is tried right away */
+	he->next_attempt = sys_timepoint_calc(K_NO_WAIT);
+
+	sock = zsock_socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+	if (sock < 0) {
+		he->error = errno;
+		return;
+	}
+
+	flags = zsock_fcntl(sock, F_GETFL, 0);
+	if (flags < 0 || zsock_fcntl(sock, F_SETFL, flags | O_NONBLOCK) < 0) {
+		goto fail;
+	}
+
+	/* A socket connected right away is reported by poll() as well */
+	if (zsock_connect(sock, ai->ai_addr, ai->ai_addrlen) < 0 && errno != EINPROGRESS) {
+		goto fail;
+	}
+
+	NET_DBG("Connecting socket %d, family %d", sock, ai->ai_family);
+
+	he->fds[he->count].fd = sock;
+	he->fds[he->count].events = ZSOCK_POLLOUT;
+	he->fds[he->count].revents = 0;
+	he->count++;
+
+	he->next_attempt = sys_timepoint_calc(K_MSEC(CONFIG_NET_SOCKETS_HAPPY_EYEBALLS_DELAY));
+
+	return;
+
+fail:
+	he->error = errno;
+	(void)zsock_close(sock);
+}
+
+static void drop_attempt(struct happy_eyeballs *he, int idx)
+{
+	(void)zsock_close(he->fds[idx].fd);
+
+	he->count--;
+	he->fds[idx] = he->fds[he->count];
+}
+
+static int poll_timeout(k_timepoint_t end)
+{
+	k_timeout_t timeout = sys_timepoint_timeout(end);
+
+	if (K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+		return -1;
+	}
+
+	return k_ticks_to_ms_ceil32(timeout.ticks);
+}
+
+/* Returns the connected socket, or -1 if the attempt is still in progress or
+ * failed.
+ */
+static int check_attempt(struct happy_eyeballs *he, int idx)
+{
+	struct zsock_pollfd *pfd = &he->fds[idx];
+	socklen_t optlen = sizeof(int);
+	int sock = pfd->fd;
+	int error = 0;
+	int flags;
+
+	if (pfd->revents == 0) {
+		return -1;
+	}
+
+	if (zsock_getsockopt(sock, SOL_SOCKET, SO_ERROR, &error, &optlen) < 0) {
+		error = errno;
+	}
+
+	if (error == 0 && (pfd->revents & (ZSOCK_POLLERR | ZSOCK_POLLHUP))) {
+		error = ECONNREFUSED;
+	}
+
+	if (error != 0) {
+		NET_DBG("Socket %d failed to connect (%d)", sock, error);
+		he->error = error;
+		he->next_attempt = sys_timepoint_calc(K_NO_WAIT);
+		drop_attempt(he, idx);
+		return -1;
+	}
+
+	if ((pfd->revents & ZSOCK_POLLOUT) == 0) {
+		return -1;
+	}
+
+	flags = zsock_fcntl(sock, F_GETFL, 0);
+	if (flags < 0 || zsock_fcntl(sock, F_SETFL, flags & ~O_NONBLOCK) < 0) {
+		he->error = errno;
+		drop_attempt(he, idx);
+		return -1;
+	}
+
+	/* Keep the winner out of the way of drop_attempt() */
+	he->count--;
+	he->fds[idx] = he->fds[he->count];
+
+	return sock;
+}
+
+int zsock_connect_happy_eyeballs(const struct zsock_addrinfo *res, int32_t timeout)
+{
+	struct happy_eyeballs he = {
+		.next = {
+			next_of_family(res, AF_INET6),
+			next_of_family(res, AF_INET),
+		},
+		.error = EHOSTUNREACH,
+	};
+	k_timepoint_t end = sys_timepoint_calc(SYS_TIMEOUT_MS(timeout));
+	k_timepoint_t wake;
+	int sock = -1;
+	int ret;
+
+	while (true) {
+		/* Start a new attempt when the delay is over, or as soon as the
+		 * previous attempts are all done.
+		 */
+		while (he.count < MAX_ATTEMPTS && more_addrs(&he) &&
+		       (he.count == 0 || sys_timepoint_expired(he.next_attempt))) {
+			start_attempt(&he, next_addr(&he));
+		}
+
+		if (he.count == 0) {
+			errno = he.error;
+			return -1;
+		}
+
+		if (sys_timepoint_expired(end)) {
+			he.error = ETIMEDOUT;
+			break;
+		}
+
+		wake = end;
+		if (he.count < MAX_ATTEMPTS && more_addrs(&he) &&
+		    sys_timepoint_cmp(he.next_attempt, wake) < 0) {
+			wake = he.next_attempt;
+		}
+
+		ret = zsock_poll(he.fds, he.count, poll_timeout(wake));
+		if (ret < 0) {
+			he.error = errno;
+			break;
+		}
+
+		for (int i = he.count - 1; i >= 0; i--) {
+			sock = check_attempt(&he, i);
+			if (sock >= 0) {
+				break;
+			}
+		}
+
+		if (sock >= 0) {
+			break;
+		}
+	}
+
+	while (he.count > 0) {
+		drop_attempt(&he, he.count - 1);
+	}
+
+	if (sock < 0) {
+		errno = he.error;
+	}
+
+	return sock;
+}
@@ -9,7 +9,6 @@ LOG_MODULE_REGISTER(net_sock_svc, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include <zephyr/kernel.h>
 #include <zephyr/net/socket_service.h>
-#include <zephyr/posix/sys/eventfd.h>
 
 static int init_socket_service(void);
 static bool init_done;
@@ -20,12 +19,14 @@ static K_CONDVAR_DEFINE(wait_start);
 STRUCT_SECTION_START_EXTERN(net_socket_service_desc);
 STRUCT_SECTION_END_EXTERN(net_socket_service_desc);
 
-static struct service {
-	struct zsock_pollfd events[CONFIG_NET_SOCKETS_POLL_MAX];
-	int count;
-} ctx;
+/* Number of events handled per zsock_epoll_wait() call */
+#define SERVICE_EPOLL_EVENTS 4
 
-#define get_idx(svc) (*(svc->idx))
+/* All the registered sockets are in this epoll instance. They are added
+ * with ZSOCK_EPOLLONESHOT so a socket is not reported again while its
+ * callback is pending, and re-armed once the callback has been run.
+ */
+static int epfd = -1;
 
 void net_socket_service_foreach(net_socket_service_cb_t cb, void *user_data)
 {
@@ -34,13 +35,31 @@ void net_socket_service_foreach(net_socket_service_cb_t cb, void *user_data)
 	}
 }
 
-static void cleanup_svc_events(const struct net_socket_service_desc *svc)
+static int svc_event_ctl(struct net_socket_service_event *pev, int op)
+{
+	struct zsock_epoll_event event = {
+		.events = pev->event.events | ZSOCK_EPOLLONESHOT,
+		.data.ptr = pev,
+	};
+
+	if (zsock_epoll_ctl(epfd, op, pev->event.fd, &event) < 0) {
+		return -errno;
+	}
+
+	return 0;
+}
+
+static void cleanup_svc_event(struct net_socket_service_event *pev)
 {
-	for (int i = 0; i < svc->pev_len; i++) {
-		ctx.events[get_idx(svc) + i].fd = -1;
-		svc->pev[i].event.fd = -1;
-		svc->pev[i].event.events = 0;
+	if (pev->event.fd >= 0) {
+		/* Fails if the socket was closed already, in which case
+		 * it has left the epoll instance by itself.
+		 */
+		(void)svc_event_ctl(pev, ZSOCK_EPOLL_CTL_DEL);
 	}
+
+	pev->event.fd = -1;
+	pev->event.events = 0;
 }
 
 int z_impl_net_socket_service_register(const struct net_socket_service_desc *svc,
@@ -61,7 +80,9 @@ int z_impl_net_socket_service_register(const struct net_socket_service_desc *svc
 	}
 
 	if (fds == NULL) {
-		cleanup_svc_events(svc);
+		for (i = 0; i < svc->pev_len; i++) {
+			cleanup_svc_event(&svc->pev[i]);
+		}
 	} else {
 		if (len > svc->pev_len) {
 			NET_DBG("Too many file descriptors, "
@@ -72,17 +93,26 @@ int z_impl_net_socket_service_register(const struct net_socket_service_desc *svc
 		}
 
 		for (i = 0; i < len; i++) {
+			cleanup_svc_event(&svc->pev[i]);
+
 			svc->pev[i].event = fds[i];
 			svc->pev[i].user_data = user_data;
-		}
+			svc->pev[i].svc = (struct net_socket_service_desc *)svc;
 
-		for (i = 0; i < svc->pev_len; i++) {
-			ctx.events[get_idx(svc) + i] = svc->pev[i].event;
+			if (fds[i].fd < 0) {
+				continue;
+			}
+
+			ret = svc_event_ctl(&svc->pev[i], ZSOCK_EPOLL_CTL_ADD);
+			if (ret < 0) {
+				NET_DBG("Cannot watch socket %d (%d)",
+					fds[i].fd, ret);
+				svc->pev[i].event.fd = -1;
+				goto out;
+			}
 		}
 	}
 
-	/* Tell the thread to re-read the variables */
-	eventfd_write(ctx.events[0].fd, 1);
 	ret = 0;
 
 out:
@@ -91,54 +121,31 @@ out:
 	return ret;
 }
 
-static struct net_socket_service_desc *find_svc_and_event(
-	struct zsock_pollfd *pev,
-	struct net_socket_service_event **event)
-{
-	STRUCT_SECTION_FOREACH(net_socket_service_desc, svc) {
-		for (int i = 0; i < svc->pev_len; i++) {
-			if (svc->pev[i].event.fd == pev->fd) {
-				*event = &svc->pev[i];
-				return svc;
-			}
-		}
-	}
-
-	return NULL;
-}
-
 /* We do not set the user callback to our work struct because we need to
- * hook into the flow and restore the global poll array so that the next poll
- * round will not notice it and call the callback again while we are
- * servicing the callback.
+ * hook into the flow and re-arm the socket in the epoll instance after
+ * the callback so that the next wait round will not report it and call
+ * the callback again while we are servicing the callback.
  */
 void net_socket_service_callback(struct k_work *work)
 {
 	struct net_socket_service_event *pev =
 		CONTAINER_OF(work, struct net_socket_service_event, work);
-	struct net_socket_service_desc *svc = pev->svc;
 	struct net_socket_service_event ev = *pev;
 
 	ev.callback(&ev.work);
 
-	/* Copy back the socket fd to the global array because we marked
-	 * it as -1 when triggering the work.
+	/* The callback may have unregistered or replaced the socket, in
+	 * which case it is not armed anymore or was armed when added.
 	 */
-	for (int i = 0; i < svc->pev_len; i++) {
-		ctx.events[get_idx(svc) + i] = svc->pev[i].event;
+	if (pev->event.fd >= 0) {
+		(void)svc_event_ctl(pev, ZSOCK_EPOLL_CTL_MOD);
 	}
 }
 
-static int call_work(struct zsock_pollfd *pev, struct k_work_q *work_q,
-		     struct k_work *work)
+static int call_work(struct k_work_q *work_q, struct k_work *work)
 {
 	int ret = 0;
 
-	/* Mark the global fd non pollable so that we do not
-	 * call the callback second time.
-	 */
-	pev->fd = -1;
-
 	if (work->handler == NULL) {
 		/* Synchronous call */
 		net_socket_service_callback(work);
@@ -156,30 +163,26 @@ static int call_work(struct zsock_pollfd *pev, struct k_work_q *work_q,
 
 }
 
-static int trigger_work(struct zsock_pollfd *pev)
+static int trigger_work(struct zsock_epoll_event *epev)
 {
-	struct net_socket_service_event *event;
-	struct net_socket_service_desc *svc;
+	struct net_socket_service_event *event = epev->data.ptr;
 
-	svc = find_svc_and_event(pev, &event);
-	if (svc == NULL) {
+	if (event == NULL || event->svc == NULL) {
 		return -ENOENT;
 	}
 
-	event->svc = svc;
-
-	/* Copy the triggered event to our event so that we know what
+	/* Store the triggered events to our event so that we know what
 	 * was actually causing the event.
 	 */
-	event->event = *pev;
+	event->event.revents = epev->events & 0xffff;
 
-	return call_work(pev, svc->work_q, &event->work);
+	return call_work(event->svc->work_q, &event->work);
 }
 
 static void socket_service_thread(void)
 {
-	int ret, i, fd, count = 0;
-	eventfd_t value;
+	struct zsock_epoll_event events[SERVICE_EPOLL_EVENTS];
+	int ret, i, count = 0;
 
 	STRUCT_SECTION_COUNT(net_socket_service_desc, &ret);
 	if (ret == 0) {
@@ -187,62 +190,41 @@ static void socket_service_thread(void)
 		goto fail;
 	}
 
-	/* Create contiguous poll event array to enable socket polling */
 	STRUCT_SECTION_FOREACH(net_socket_service_desc, svc) {
 		NET_DBG("Service %s has %d pollable sockets",
 			COND_CODE_1(CONFIG_NET_SOCKETS_LOG_LEVEL_DBG,
 				    (svc->owner), ("")),
 			svc->pev_len);
-		get_idx(svc) = count + 1;
+		*svc->idx = count;
 		count += svc->pev_len;
 	}
 
-	if ((count + 1) > ARRAY_SIZE(ctx.events)) {
+	if (count > CONFIG_NET_SOCKETS_EPOLL_MAX_ITEMS) {
 		NET_ERR("You have %d services to monitor but "
-			"%zd poll entries configured.",
-			count + 1, ARRAY_SIZE(ctx.events));
+			"%d epoll entries configured.",
+			count, CONFIG_NET_SOCKETS_EPOLL_MAX_ITEMS);
 		NET_ERR("Please increase value of %s to at least %d",
-			"CONFIG_NET_SOCKETS_POLL_MAX", count + 1);
+			"CONFIG_NET_SOCKETS_EPOLL_MAX_ITEMS", count);
 		goto fail;
 	}
 
 	NET_DBG("Monitoring %d socket entries", count);
 
-	ctx.count = count + 1;
-
-	/* Create an eventfd that can be used to trigger events during polling */
-	fd = eventfd(0, 0);
-	if (fd < 0) {
-		fd = -errno;
-		NET_ERR("eventfd failed (%d)", fd);
-		goto out;
+	epfd = zsock_epoll_create(0);
+	if (epfd < 0) {
+		ret = -errno;
+		NET_ERR("epoll_create failed (%d)", ret);
+		goto fail;
 	}
 
 	init_done = true;
 	k_condvar_broadcast(&wait_start);
 
-	ctx.events[0].fd = fd;
-	ctx.events[0].events = ZSOCK_POLLIN;
-
-restart:
-	i = 1;
-
-	k_mutex_lock(&lock, K_FOREVER);
-
-	/* Copy individual events to the big array */
-	STRUCT_SECTION_FOREACH(net_socket_service_desc, svc) {
-		for (int j = 0; j < svc->pev_len; j++) {
-			ctx.events[get_idx(svc) + j] = svc->pev[j].event;
-		}
-	}
-
-	k_mutex_unlock(&lock);
-
 	while (true) {
-		ret = zsock_poll(ctx.events, count + 1, -1);
+		ret = zsock_epoll_wait(epfd, events, ARRAY_SIZE(events), -1);
 		if (ret < 0) {
 			ret = -errno;
-			NET_ERR("poll failed (%d)", ret);
+			NET_ERR("epoll_wait failed (%d)", ret);
 			goto out;
 		}
 
@@ -251,22 +233,11 @@ restart:
 			break;
 		}
 
-		if (ret > 0 && ctx.events[0].revents) {
-			eventfd_read(ctx.events[0].fd, &value);
-			NET_DBG("Received restart event.");
-			goto restart;
-		}
-
-		for (i = 1; i < (count + 1); i++) {
-			if (ctx.events[i].fd < 0) {
-				continue;
-			}
+		for (i = 0; i < ret; i++) {
+			int err = trigger_work(&events[i]);
 
-			if (ctx.events[i].revents > 0) {
-				ret = trigger_work(&ctx.events[i]);
-				if (ret < 0) {
-					NET_DBG("Triggering work failed (%d)", ret);
-				}
+			if (err < 0) {
+				NET_DBG("Triggering work failed (%d)", err);
 			}
 		}
 	}
@@ -627,15 +627,47 @@ static int websocket_prepare_and_send(struct websocket_context *ctx,
 #endif /* CONFIG_NET_TEST */
 }
 
-int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
-		       enum websocket_opcode opcode, bool mask, bool final,
-		       int32_t timeout)
+void websocket_mask(uint8_t *data, size_t len, uint32_t masking_key, size_t offset)
 {
-	struct websocket_context *ctx;
-	uint8_t header[MAX_HEADER_LEN], hdr_len = 2;
-	uint8_t *data_to_send = (uint8_t *)payload;
-	int ret;
+	uint8_t key[sizeof(unsigned long)];
+	unsigned long word_key;
+	unsigned long word;
+	size_t i = 0;
+
+	/* The first key byte on the wire is the most significant one */
+	for (size_t j = 0; j < sizeof(key); j++) {
+		key[j] = masking_key >> (8 * (3 - (offset + j) % 4));
+	}
 
+	/* Bytes until the data is aligned for word access */
+	while (i < len && !IS_ALIGNED(&data[i], sizeof(unsigned long))) {
+		data[i] ^= key[i % 4];
+		i++;
+	}
+
+	/* The word size is a multiple of the key size, so the key keeps the same
+	 * phase for all the words. Copying the key bytes keeps them in memory
+	 * order, whatever the byte order of the CPU is.
+	 */
+	for (size_t j = 0; j < sizeof(key); j++) {
+		key[j] = masking_key >> (8 * (3 - (offset + i + j) % 4));
+	}
+
+	memcpy(&word_key, key, sizeof(word_key));
+
+	for (; len - i >= sizeof(unsigned long); i += sizeof(unsigned long)) {
+		memcpy(&word, &data[i], sizeof(word));
+		word ^= word_key;
+		memcpy(&data[i], &word, sizeof(word));
+	}
+
+	for (size_t j = 0; i < len; i++, j++) {
+		data[i] ^= key[j];
+	}
+}
+
+static int websocket_check_opcode(enum websocket_opcode opcode)
+{
 	if (opcode != WEBSOCKET_OPCODE_DATA_TEXT &&
 	    opcode != WEBSOCKET_OPCODE_DATA_BINARY &&
 	    opcode != WEBSOCKET_OPCODE_CONTINUE &&
@@ -645,25 +677,17 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		return -EINVAL;
 	}
 
-	ctx = z_get_fd_obj(ws_sock, NULL, 0);
-	if (ctx == NULL) {
-		return -EBADF;
-	}
-
-#if !defined(CONFIG_NET_TEST)
-	/* Websocket unit test does not use context from pool but allocates
-	 * its own, hence skip the check.
-	 */
-
-	if (!PART_OF_ARRAY(contexts, ctx)) {
-		return -ENOENT;
-	}
-#endif /* !defined(CONFIG_NET_TEST) */
+	return 0;
+}
 
-	NET_DBG("[%p] Len %zd %s/%d/%s", ctx, payload_len, opcode2str(opcode),
-		mask, final ? "final" : "more");
+/* Returns the length of the header */
+static uint8_t websocket_build_header(uint8_t *header, size_t payload_len,
+				      enum websocket_opcode opcode, bool mask,
+				      uint32_t masking_key, bool final)
+{
+	uint8_t hdr_len = 2;
 
-	memset(header, 0, sizeof(header));
+	memset(header, 0, MAX_HEADER_LEN);
 
 	/* Is this the last packet? */
 	header[0] = final ? BIT(7) : 0;
@@ -696,27 +720,61 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 
 	/* Add masking value if needed */
 	if (mask) {
-		int i;
+		header[hdr_len++] |= masking_key >> 24;
+		header[hdr_len++] |= masking_key >> 16;
+		header[hdr_len++] |= masking_key >> 8;
+		header[hdr_len++] |= masking_key;
+	}
 
-		ctx->masking_value = sys_rand32_get();
+	return hdr_len;
+}
+
+int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
+		       enum websocket_opcode opcode, bool mask, bool final,
+		       int32_t timeout)
+{
+	struct websocket_context *ctx;
+	uint8_t header[MAX_HEADER_LEN], hdr_len;
+	uint8_t *data_to_send = (uint8_t *)payload;
+	int ret;
 
-		header[hdr_len++] |= ctx->masking_value >> 24;
-		header[hdr_len++] |= ctx->masking_value >> 16;
-		header[hdr_len++] |= ctx->masking_value >> 8;
-		header[hdr_len++] |= ctx->masking_value;
+	if (websocket_check_opcode(opcode) < 0) {
+		return -EINVAL;
+	}
 
-		if ((payload != NULL) && (payload_len > 0)) {
-			data_to_send = k_malloc(payload_len);
-			if (!data_to_send) {
-				return -ENOMEM;
-			}
+	ctx = z_get_fd_obj(ws_sock, NULL, 0);
+	if (ctx == NULL) {
+		return -EBADF;
+	}
 
-			memcpy(data_to_send, payload, payload_len);
+#if !defined(CONFIG_NET_TEST)
+	/* Websocket unit test does not use context from pool but allocates
+	 * its own, hence skip the check.
+	 */
 
-			for (i = 0; i < payload_len; i++) {
-				data_to_send[i] ^= ctx->masking_value >> (8 * (3 - i % 4));
-			}
+	if (!PART_OF_ARRAY(contexts, ctx)) {
+		return -ENOENT;
+	}
+#endif /* !defined(CONFIG_NET_TEST) */
+
+	NET_DBG("[%p] Len %zd %s/%d/%s", ctx, payload_len, opcode2str(opcode),
+		mask, final ? "final" : "more");
+
+	if (mask) {
+		ctx->masking_value = sys_rand32_get();
+	}
+
+	hdr_len = websocket_build_header(header, payload_len, opcode, mask,
+					 ctx->masking_value, final);
+
+	if (mask && (payload != NULL) && (payload_len > 0)) {
+		data_to_send = k_malloc(payload_len);
+		if (!data_to_send) {
+			return -ENOMEM;
 		}
+
+		memcpy(data_to_send, payload, payload_len);
+		websocket_mask(data_to_send, payload_len, ctx->masking_value, 0);
 	}
 
 	ret = websocket_prepare_and_send(ctx, header, hdr_len,
@@ -739,6 +797,52 @@ quit:
 	return ret - hdr_len;
 }
 
+int websocket_send_msg_masked(int ws_sock, const uint8_t *payload, size_t payload_len,
+			      enum websocket_opcode opcode, uint32_t masking_key,
+			      bool final, int32_t timeout)
+{
+	struct websocket_context *ctx;
+	uint8_t header[MAX_HEADER_LEN], hdr_len;
+	int ret;
+
+	if (websocket_check_opcode(opcode) < 0) {
+		return -EINVAL;
+	}
+
+	ctx = z_get_fd_obj(ws_sock, NULL, 0);
+	if (ctx == NULL) {
+		return -EBADF;
+	}
+
+#if !defined(CONFIG_NET_TEST)
+	/* See websocket_send_msg() */
+	if (!PART_OF_ARRAY(contexts, ctx)) {
+		return -ENOENT;
+	}
+#endif /* !defined(CONFIG_NET_TEST) */
+
+	NET_DBG("[%p] Len %zd %s/masked/%s", ctx, payload_len, opcode2str(opcode),
+		final ? "final" : "more");
+
+	hdr_len = websocket_build_header(header, payload_len, opcode, true,
+					 masking_key, final);
+
+	/* The payload was masked by the caller, send it as is */
+	ret = websocket_prepare_and_send(ctx, header, hdr_len,
+					 (uint8_t *)payload, payload_len, timeout);
+	if (ret < 0) {
+		NET_DBG("Cannot send ws msg (%d)", -errno);
+		return ret;
+	}
+
+	/* Do no math with 0 and error codes */
+	if (ret == 0) {
+		return ret;
+	}
+
+	return ret - hdr_len;
+}
+
 static uint32_t websocket_opcode2flag(uint8_t data)
 {
 	switch (data & 0x0f) {
@@ -1028,15 +1132,8 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 
 	/* Unmask the data */
 	if (ctx->masked) {
-		uint8_t *mask_as_bytes = (uint8_t *)&ctx->masking_value;
-		size_t data_buf_offset = ctx->message_len - ctx->parser_remaining - payload.count;
-
-		for (size_t i = 0; i < payload.count; i++) {
-			size_t m = data_buf_offset % 4;
-
-			payload.buf[i] ^= mask_as_bytes[3 - m];
-			data_buf_offset++;
-		}
+		websocket_mask(payload.buf, payload.count, ctx->masking_value,
+			       ctx->message_len - ctx->parser_remaining - payload.count);
 	}
 
 	return payload.count;
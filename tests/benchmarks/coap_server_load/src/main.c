@@ -0,0 +1,260 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Load a CoAP service with as many observers and unacknowledged confirmable
+ * messages as it can hold, and time the requests of a client over loopback.
+ * Every packet received by the service looks up the pending messages, and
+ * every turn of the server loop checks for retransmissions, so without the
+ * lookup tables the cost of a request grows with the number of observers and
+ * messages in flight.
+ *
+ * No reference numbers are recorded for this benchmark yet, run the variants
+ * with and without the lookup tables on the target of interest to compare
+ * them.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/coap_service.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/ztest.h>
+
+#include "net_bench.h"
+
+#define SERVICE_PORT 5683
+#define DEAD_PORT 9
+#define PINGS 500
+#define OBSERVERS CONFIG_COAP_SERVICE_OBSERVERS
+#define PENDINGS CONFIG_COAP_SERVICE_PENDING_MESSAGES
+/* Message ids of the server, apart from the ones of the client */
+#define PENDING_ID_BASE 0x8000
+#define ACK_BATCH 16
+
+static int client_sock = -1;
+static uint16_t client_id;
+
+static int ping_get(struct coap_resource *resource, struct coap_packet *request,
+		    struct sockaddr *addr, socklen_t addr_len)
+{
+	ARG_UNUSED(resource);
+	ARG_UNUSED(request);
+	ARG_UNUSED(addr);
+	ARG_UNUSED(addr_len);
+
+	return COAP_RESPONSE_CODE_CONTENT;
+}
+
+static int obs_get(struct coap_resource *resource, struct coap_packet *request,
+		   struct sockaddr *addr, socklen_t addr_len)
+{
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t buf[32];
+	struct coap_packet response;
+	uint8_t code = COAP_RESPONSE_CODE_CONTENT;
+	uint8_t tkl;
+	int ret;
+
+	if (coap_resource_parse_observe(resource, request, addr) < 0) {
+		code = COAP_RESPONSE_CODE_SERVICE_UNAVAILABLE;
+	}
+
+	tkl = coap_header_get_token(request, token);
+
+	ret = coap_packet_init(&response, buf, sizeof(buf), COAP_VERSION_1, COAP_TYPE_NON_CON,
+			       tkl, token, code, coap_header_get_id(request));
+	if (ret < 0) {
+		return ret;
+	}
+
+	return coap_resource_send(resource, &response, addr, addr_len, NULL);
+}
+
+static const uint16_t service_port = SERVICE_PORT;
+COAP_SERVICE_DEFINE(bench, "127.0.0.1", &service_port, COAP_SERVICE_AUTOSTART);
+
+static const char * const ping_path[] = { "ping", NULL };
+COAP_RESOURCE_DEFINE(ping, bench, {
+	.path = ping_path,
+	.get = ping_get,
+});
+
+static const char * const obs_path[] = { "obs", NULL };
+COAP_RESOURCE_DEFINE(obs, bench, {
+	.path = obs_path,
+	.get = obs_get,
+});
+
+static void client_send(const struct coap_packet *cpkt)
+{
+	zassert_equal(zsock_send(client_sock, cpkt->data, cpkt->offset, 0), cpkt->offset,
+		      "Failed to send (%d)", errno);
+}
+
+static uint8_t client_recv(void)
+{
+	uint8_t buf[64];
+	struct coap_packet reply;
+	ssize_t len;
+
+	len = zsock_recv(client_sock, buf, sizeof(buf), 0);
+	zassert_true(len > 0, "No reply (%d)", errno);
+	zassert_ok(coap_packet_parse(&reply, buf, len, NULL, 0));
+
+	return coap_header_get_code(&reply);
+}
+
+static void client_ping(void)
+{
+	uint8_t buf[32];
+	struct coap_packet request;
+
+	zassert_ok(coap_packet_init(&request, buf, sizeof(buf), COAP_VERSION_1, COAP_TYPE_CON,
+				    0, NULL, COAP_METHOD_GET, client_id++));
+	zassert_ok(coap_packet_append_option(&request, COAP_OPTION_URI_PATH, "ping", 4));
+
+	client_send(&request);
+	zassert_equal(client_recv(), COAP_RESPONSE_CODE_CONTENT);
+}
+
+static void client_observe(uint32_t token, int observe)
+{
+	uint8_t buf[32];
+	struct coap_packet request;
+
+	zassert_ok(coap_packet_init(&request, buf, sizeof(buf), COAP_VERSION_1,
+				    COAP_TYPE_NON_CON, sizeof(token), (uint8_t *)&token,
+				    COAP_METHOD_GET, client_id++));
+	zassert_ok(coap_append_option_int(&request, COAP_OPTION_OBSERVE, observe));
+	zassert_ok(coap_packet_append_option(&request, COAP_OPTION_URI_PATH, "obs", 3));
+
+	client_send(&request);
+	zassert_equal(client_recv(), COAP_RESPONSE_CODE_CONTENT);
+}
+
+static void client_ack_all(int count)
+{
+	uint8_t buf[8];
+	struct coap_packet ack;
+
+	for (int i = 0; i < count; i++) {
+		zassert_ok(coap_packet_init(&ack, buf, sizeof(buf), COAP_VERSION_1,
+					    COAP_TYPE_ACK, 0, NULL, COAP_CODE_EMPTY,
+					    PENDING_ID_BASE + i));
+		client_send(&ack);
+
+		/* Wait for the service to catch up, before its queue is full */
+		if (i % ACK_BATCH == ACK_BATCH - 1) {
+			client_ping();
+		}
+	}
+}
+
+/* Confirmable messages to a port nobody listens on stay pending */
+static void server_send_pendings(int count)
+{
+	static const struct coap_transmission_parameters params = {
+		.ack_timeout = 60000,
+		.coap_backoff_percent = 200,
+		.max_retransmission = 1,
+	};
+	struct sockaddr_in dead = {
+		.sin_family = AF_INET,
+		.sin_port = htons(DEAD_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	uint8_t buf[16];
+	struct coap_packet cpkt;
+
+	for (int i = 0; i < count; i++) {
+		zassert_ok(coap_packet_init(&cpkt, buf, sizeof(buf), COAP_VERSION_1,
+					    COAP_TYPE_CON, 0, NULL, COAP_RESPONSE_CODE_CONTENT,
+					    PENDING_ID_BASE + i));
+		zassert_ok(coap_service_send(&bench, &cpkt, (struct sockaddr *)&dead,
+					     sizeof(dead), &params));
+
+		/* Let the loopback interface drop them */
+		if (i % 16 == 15) {
+			k_msleep(1);
+		}
+	}
+}
+
+static uint32_t time_pings(void)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (int i = 0; i < PINGS; i++) {
+		client_ping();
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+ZTEST(coap_server_load, test_idle)
+{
+	net_bench_report("request, idle", PINGS, "packet", time_pings());
+}
+
+ZTEST(coap_server_load, test_observers)
+{
+	uint32_t start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < OBSERVERS; i++) {
+		client_observe(i + 1, 0);
+	}
+	net_bench_report("register observer", OBSERVERS, "packet", k_cycle_get_32() - start);
+
+	net_bench_report("request, all observing", PINGS, "packet", time_pings());
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < OBSERVERS; i++) {
+		client_observe(i + 1, 1);
+	}
+	net_bench_report("deregister observer", OBSERVERS, "packet", k_cycle_get_32() - start);
+}
+
+ZTEST(coap_server_load, test_pending)
+{
+	uint32_t start;
+
+	server_send_pendings(PENDINGS);
+
+	net_bench_report("request, all pending", PINGS, "packet", time_pings());
+
+	start = k_cycle_get_32();
+	client_ack_all(PENDINGS);
+	net_bench_report("acknowledge pending", PENDINGS + PENDINGS / ACK_BATCH, "packet",
+			 k_cycle_get_32() - start);
+}
+
+static void *setup(void)
+{
+	struct sockaddr_in server = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVICE_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	struct timeval timeout = {
+		.tv_sec = 2,
+	};
+
+	/* Wait for the service to be started by the server thread */
+	while (coap_service_is_running(&bench) != 1) {
+		k_msleep(10);
+	}
+
+	client_sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(client_sock >= 0, "Failed to create socket (%d)", errno);
+	zassert_ok(zsock_setsockopt(client_sock, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+				    sizeof(timeout)));
+	zassert_ok(zsock_connect(client_sock, (struct sockaddr *)&server, sizeof(server)));
+
+	client_id = 1;
+
+	return NULL;
+}
+
+ZTEST_SUITE(coap_server_load, NULL, setup, NULL, NULL, NULL);
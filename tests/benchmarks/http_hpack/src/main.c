@@ -0,0 +1,302 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the HPACK response header encoding of the HTTP server, with and
+ * without the dynamic table, and the Huffman coder on its own. The header
+ * corpus is what a small device serving static resources typically sends,
+ * several responses on one connection sharing most of their headers.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/http/hpack.h>
+
+#include "net_bench.h"
+
+#define ROUNDS 2000
+
+struct header {
+	const char *name;
+	const char *value;
+};
+
+#define RESPONSE_LEN 6
+
+static const struct header corpus[][RESPONSE_LEN] = {
+	{
+		{ ":status", "200" },
+		{ "content-type", "text/html" },
+		{ "content-encoding", "gzip" },
+		{ "cache-control", "max-age=3600" },
+		{ "etag", "\"5f3a-1c2b\"" },
+		{ "server", "Zephyr" },
+	},
+	{
+		{ ":status", "200" },
+		{ "content-type", "text/css" },
+		{ "content-encoding", "gzip" },
+		{ "cache-control", "max-age=3600" },
+		{ "etag", "\"5f3a-08d1\"" },
+		{ "server", "Zephyr" },
+	},
+	{
+		{ ":status", "200" },
+		{ "content-type", "application/javascript" },
+		{ "content-encoding", "gzip" },
+		{ "cache-control", "max-age=3600" },
+		{ "etag", "\"5f3a-3e07\"" },
+		{ "server", "Zephyr" },
+	},
+	{
+		{ ":status", "304" },
+		{ "content-type", "text/html" },
+		{ "content-encoding", "gzip" },
+		{ "cache-control", "max-age=3600" },
+		{ "etag", "\"5f3a-1c2b\"" },
+		{ "server", "Zephyr" },
+	},
+};
+
+static struct http_hpack_header_buf header_buf;
+static struct http_hpack_encoder encoder;
+static uint8_t out[256];
+
+static void set_header(const char *name, const char *value)
+{
+	header_buf.name = name;
+	header_buf.name_len = strlen(name);
+	header_buf.value = value;
+	header_buf.value_len = strlen(value);
+}
+
+static int encode_block(const struct header *headers, size_t count,
+			bool dynamic, uint8_t *buf, size_t buflen)
+{
+	int ret, len = 0;
+
+	for (int i = 0; i < count; i++) {
+		set_header(headers[i].name, headers[i].value);
+
+		if (dynamic) {
+			ret = http_hpack_encoder_encode(&encoder, buf + len,
+							buflen - len, &header_buf);
+		} else {
+			ret = http_hpack_encode_header(buf + len, buflen - len,
+						       &header_buf);
+		}
+
+		zassert_true(ret > 0, "Failed to encode %s (%d)",
+			     headers[i].name, ret);
+		len += ret;
+	}
+
+	return len;
+}
+
+static void assert_block(const struct header *headers, size_t count,
+			 const uint8_t *expected, size_t expected_len)
+{
+	int len;
+
+	len = encode_block(headers, count, true, out, sizeof(out));
+	zassert_equal(len, expected_len, "Unexpected block length %d", len);
+	zassert_mem_equal(out, expected, expected_len, "Unexpected block");
+}
+
+/* RFC 7541, C.4 */
+ZTEST(http_hpack, test_huffman_vectors)
+{
+	static const struct {
+		const char *str;
+		const uint8_t *encoded;
+		size_t encoded_len;
+	} vectors[] = {
+		{ "www.example.com",
+		  "\xf1\xe3\xc2\xe5\xf2\x3a\x6b\xa0\xab\x90\xf4\xff", 12 },
+		{ "no-cache", "\xa8\xeb\x10\x64\x9c\xbf", 6 },
+		{ "custom-key", "\x25\xa8\x49\xe9\x5b\xa9\x7d\x7f", 8 },
+		{ "custom-value", "\x25\xa8\x49\xe9\x5b\xb8\xe8\xb4\xbf", 9 },
+	};
+	uint8_t decoded[32];
+	int ret;
+
+	ARRAY_FOR_EACH(vectors, i) {
+		ret = http_hpack_huffman_encode(vectors[i].str,
+						strlen(vectors[i].str), out,
+						sizeof(out));
+		zassert_equal(ret, vectors[i].encoded_len,
+			      "Unexpected length %d for %s", ret, vectors[i].str);
+		zassert_mem_equal(out, vectors[i].encoded, ret,
+				  "Unexpected encoding of %s", vectors[i].str);
+
+		ret = http_hpack_huffman_decode(vectors[i].encoded,
+						vectors[i].encoded_len, decoded,
+						sizeof(decoded));
+		zassert_equal(ret, strlen(vectors[i].str),
+			      "Unexpected length %d for %s", ret, vectors[i].str);
+		zassert_mem_equal(decoded, vectors[i].str, ret,
+				  "Unexpected decoding of %s", vectors[i].str);
+	}
+
+	/* Padding longer than 7 bits */
+	ret = http_hpack_huffman_decode("\x1f\xff", 2, decoded, sizeof(decoded));
+	zassert_equal(ret, -EBADMSG, "Invalid padding accepted");
+}
+
+/* RFC 7541, C.6, with a 256 byte table. Huffman coding is only used when it
+ * is shorter, so "307" is sent as is.
+ */
+ZTEST(http_hpack, test_encoder_vectors)
+{
+	static const struct header first[] = {
+		{ ":status", "302" },
+		{ "cache-control", "private" },
+		{ "date", "Mon, 21 Oct 2013 20:13:21 GMT" },
+		{ "location", "https://www.example.com" },
+	};
+	static const struct header second[] = {
+		{ ":status", "307" },
+		{ "cache-control", "private" },
+		{ "date", "Mon, 21 Oct 2013 20:13:21 GMT" },
+		{ "location", "https://www.example.com" },
+	};
+	static const struct header third[] = {
+		{ ":status", "200" },
+		{ "cache-control", "private" },
+		{ "date", "Mon, 21 Oct 2013 20:13:22 GMT" },
+		{ "location", "https://www.example.com" },
+		{ "content-encoding", "gzip" },
+		{ "set-cookie",
+		  "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1" },
+	};
+	static const uint8_t first_block[] = {
+		/* Table size update to 256 */
+		0x3f, 0xe1, 0x01,
+		0x48, 0x82, 0x64, 0x02, 0x58, 0x85, 0xae, 0xc3, 0x77, 0x1a,
+		0x4b, 0x61, 0x96, 0xd0, 0x7a, 0xbe, 0x94, 0x10, 0x54, 0xd4,
+		0x44, 0xa8, 0x20, 0x05, 0x95, 0x04, 0x0b, 0x81, 0x66, 0xe0,
+		0x82, 0xa6, 0x2d, 0x1b, 0xff, 0x6e, 0x91, 0x9d, 0x29, 0xad,
+		0x17, 0x18, 0x63, 0xc7, 0x8f, 0x0b, 0x97, 0xc8, 0xe9, 0xae,
+		0x82, 0xae, 0x43, 0xd3,
+	};
+	static const uint8_t second_block[] = {
+		0x48, 0x03, 0x33, 0x30, 0x37, 0xc1, 0xc0, 0xbf,
+	};
+	static const uint8_t third_block[] = {
+		0x88, 0xc1, 0x61, 0x96, 0xd0, 0x7a, 0xbe, 0x94, 0x10, 0x54,
+		0xd4, 0x44, 0xa8, 0x20, 0x05, 0x95, 0x04, 0x0b, 0x81, 0x66,
+		0xe0, 0x84, 0xa6, 0x2d, 0x1b, 0xff, 0xc0, 0x5a, 0x83, 0x9b,
+		0xd9, 0xab, 0x77, 0xad, 0x94, 0xe7, 0x82, 0x1d, 0xd7, 0xf2,
+		0xe6, 0xc7, 0xb3, 0x35, 0xdf, 0xdf, 0xcd, 0x5b, 0x39, 0x60,
+		0xd5, 0xaf, 0x27, 0x08, 0x7f, 0x36, 0x72, 0xc1, 0xab, 0x27,
+		0x0f, 0xb5, 0x29, 0x1f, 0x95, 0x87, 0x31, 0x60, 0x65, 0xc0,
+		0x03, 0xed, 0x4e, 0xe5, 0xb1, 0x06, 0x3d, 0x50, 0x07,
+	};
+
+	http_hpack_encoder_init(&encoder);
+
+	assert_block(first, ARRAY_SIZE(first), first_block, sizeof(first_block));
+	zassert_equal(encoder.size, 222, "Unexpected table size %d", encoder.size);
+
+	assert_block(second, ARRAY_SIZE(second), second_block,
+		     sizeof(second_block));
+	zassert_equal(encoder.size, 222, "Unexpected table size %d", encoder.size);
+
+	assert_block(third, ARRAY_SIZE(third), third_block, sizeof(third_block));
+	zassert_equal(encoder.size, 215, "Unexpected table size %d", encoder.size);
+
+	/* A smaller table announced by the peer empties ours */
+	http_hpack_encoder_set_max_size(&encoder, 0);
+	zassert_equal(encoder.count, 0, "Table not emptied");
+
+	set_header("cache-control", "private");
+	zassert_equal(http_hpack_encoder_encode(&encoder, out, sizeof(out),
+						&header_buf),
+		      9, "Unexpected length");
+	zassert_equal(out[0], 0x20, "Table size update not sent");
+}
+
+static uint64_t run_encoder(bool dynamic, uint32_t *bytes)
+{
+	uint32_t start;
+
+	*bytes = 0;
+	http_hpack_encoder_init(&encoder);
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < ROUNDS; i++) {
+		*bytes += encode_block(corpus[i % ARRAY_SIZE(corpus)],
+				       RESPONSE_LEN, dynamic, out, sizeof(out));
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+ZTEST(http_hpack, test_encode_rate)
+{
+	uint32_t stateless_bytes, dynamic_bytes;
+	uint64_t stateless, dynamic;
+
+	stateless = run_encoder(false, &stateless_bytes);
+	dynamic = run_encoder(true, &dynamic_bytes);
+
+	zassert_true(dynamic_bytes < stateless_bytes,
+		     "Dynamic table did not reduce the header size");
+
+	TC_PRINT("%-20s %8u bytes/block\n", "literal headers",
+		 stateless_bytes / ROUNDS);
+	TC_PRINT("%-20s %8u bytes/block\n", "dynamic table",
+		 dynamic_bytes / ROUNDS);
+	net_bench_report("literal headers", ROUNDS, "block", stateless);
+	net_bench_report("dynamic table", ROUNDS, "block", dynamic);
+}
+
+ZTEST(http_hpack, test_huffman_rate)
+{
+	uint32_t encoded_bytes = 0, decoded_bytes = 0;
+	uint8_t encoded[RESPONSE_LEN][64];
+	int encoded_len[RESPONSE_LEN];
+	const struct header *header;
+	uint8_t decoded[64];
+	uint32_t start;
+	uint64_t encode, decode;
+	int ret;
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < ROUNDS; i++) {
+		header = &corpus[0][i % RESPONSE_LEN];
+
+		ret = http_hpack_huffman_encode(header->value,
+						strlen(header->value),
+						encoded[i % RESPONSE_LEN],
+						sizeof(encoded[0]));
+		zassert_true(ret > 0, "Failed to encode %s", header->value);
+		encoded_len[i % RESPONSE_LEN] = ret;
+		encoded_bytes += strlen(header->value);
+	}
+
+	encode = k_cycle_get_32() - start;
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < ROUNDS; i++) {
+		ret = http_hpack_huffman_decode(encoded[i % RESPONSE_LEN],
+						encoded_len[i % RESPONSE_LEN],
+						decoded, sizeof(decoded));
+		zassert_true(ret > 0, "Failed to decode");
+		decoded_bytes += ret;
+	}
+
+	decode = k_cycle_get_32() - start;
+
+	zassert_equal(encoded_bytes, decoded_bytes, "Round trip mismatch");
+
+	net_bench_throughput("huffman encode", encoded_bytes, encode);
+	net_bench_throughput("huffman decode", decoded_bytes, decode);
+}
+
+ZTEST_SUITE(http_hpack, NULL, NULL, NULL, NULL, NULL);
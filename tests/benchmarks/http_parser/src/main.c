@@ -0,0 +1,100 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the HTTP/1 parsing rate for a typical browser request and server
+ * response. Run the byte_scan variant of this benchmark, built without
+ * CONFIG_HTTP_PARSER_FAST_SCAN, for the plain state machine numbers.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/http/parser.h>
+
+#include "net_bench.h"
+
+#define ROUNDS 5000
+
+static const char request[] =
+	"GET /static/js/app.min.js?v=1.4.2 HTTP/1.1\r\n"
+	"Host: device.local:8080\r\n"
+	"Connection: keep-alive\r\n"
+	"User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+	"(KHTML, like Gecko) Chrome/124.0.0.0 Safari/537.36\r\n"
+	"Accept: text/html,application/xhtml+xml,application/xml;q=0.9,"
+	"image/avif,image/webp,*/*;q=0.8\r\n"
+	"Accept-Encoding: gzip, deflate, br\r\n"
+	"Accept-Language: en-US,en;q=0.9,fi;q=0.8\r\n"
+	"Cache-Control: max-age=0\r\n"
+	"Referer: http://device.local:8080/index.html\r\n"
+	"Cookie: session=7f3c9a1e5b2d4c6f8e0a1b3c5d7e9f1a; theme=dark\r\n"
+	"If-None-Match: \"5f3a-1c2b\"\r\n"
+	"\r\n";
+
+static const char response[] =
+	"HTTP/1.1 200 OK\r\n"
+	"Server: Zephyr\r\n"
+	"Date: Mon, 21 Oct 2024 20:13:21 GMT\r\n"
+	"Content-Type: application/javascript\r\n"
+	"Content-Encoding: gzip\r\n"
+	"Cache-Control: public, max-age=31536000, immutable\r\n"
+	"ETag: \"5f3a-1c2b\"\r\n"
+	"Vary: Accept-Encoding\r\n"
+	"Content-Length: 4\r\n"
+	"\r\n"
+	"body";
+
+static struct http_parser_settings settings;
+static struct http_parser parser;
+static int header_count;
+
+static int on_header_field(struct http_parser *p, const char *at, size_t length)
+{
+	header_count++;
+
+	return 0;
+}
+
+static uint64_t run(enum http_parser_type type, const char *msg, size_t len,
+		    int headers)
+{
+	uint32_t start;
+	size_t parsed;
+
+	http_parser_settings_init(&settings);
+	settings.on_header_field = on_header_field;
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < ROUNDS; i++) {
+		header_count = 0;
+		http_parser_init(&parser, type);
+
+		parsed = http_parser_execute(&parser, &settings, msg, len);
+		zassert_equal(parsed, len, "Parse error %s",
+			      http_errno_name(parser.http_errno));
+		zassert_equal(header_count, headers, "Got %d headers",
+			      header_count);
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+ZTEST(http_parser, test_parse_rate)
+{
+	uint64_t req, resp;
+
+	req = run(HTTP_REQUEST, request, sizeof(request) - 1, 10);
+	resp = run(HTTP_RESPONSE, response, sizeof(response) - 1, 8);
+
+	TC_PRINT("Fast scan %s\n",
+		 IS_ENABLED(CONFIG_HTTP_PARSER_FAST_SCAN) ? "enabled" : "disabled");
+	net_bench_report("request", ROUNDS, "message", req);
+	net_bench_throughput("request", ROUNDS * (sizeof(request) - 1), req);
+	net_bench_report("response", ROUNDS, "message", resp);
+	net_bench_throughput("response", ROUNDS * (sizeof(response) - 1), resp);
+}
+
+ZTEST_SUITE(http_parser, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,89 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Compare the request dispatch rate of the HTTP server with the linear
+ * resource scan used before the resource tree is built, and with the
+ * resource tree. Only get_resource_detail() is measured, the server itself
+ * is never started, so the numbers are not skewed by the network stack.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/http/server.h>
+#include <zephyr/net/http/service.h>
+
+#include "net_bench.h"
+#include "server_internal.h"
+
+#define NUM_RESOURCES 64
+#define ROUNDS 10000
+
+static uint16_t bench_service_port = 8080;
+HTTP_SERVICE_DEFINE(bench_service, "127.0.0.1", &bench_service_port, 1, 1, NULL);
+
+static const char payload[] = "bench";
+static struct http_resource_detail_static bench_detail = {
+	.common = {
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+	},
+	.static_data = payload,
+	.static_data_len = sizeof(payload),
+};
+
+#define BENCH_RESOURCE(n, _)                                                 \
+	HTTP_RESOURCE_DEFINE(bench_resource_##n, bench_service,              \
+			     "/api/v1/items/" STRINGIFY(n), &bench_detail)
+
+LISTIFY(NUM_RESOURCES, BENCH_RESOURCE, (;));
+
+static const char *const paths[] = {
+	/* First, middle and last registered resource */
+	"/api/v1/items/0",
+	"/api/v1/items/31",
+	"/api/v1/items/63?verbose=1",
+	/* Miss, worst case for the linear scan */
+	"/api/v1/items/64",
+};
+
+static uint64_t run(void)
+{
+	struct http_resource_detail *detail;
+	uint32_t start;
+	int path_len;
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < ROUNDS; i++) {
+		detail = get_resource_detail(paths[i % ARRAY_SIZE(paths)],
+					     &path_len, false);
+		if ((i % ARRAY_SIZE(paths)) < ARRAY_SIZE(paths) - 1) {
+			zassert_not_null(detail, "No match");
+		} else {
+			zassert_is_null(detail, "Unexpected match");
+		}
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+ZTEST(http_server_dispatch, test_dispatch_rate)
+{
+	uint64_t linear, tree;
+
+	zassert_false(http_server_route_ready(), "Resource tree already built");
+
+	linear = run();
+
+	zassert_ok(http_server_route_init(), "Failed to build resource tree");
+
+	tree = run();
+
+	net_bench_report("linear scan", ROUNDS, "request", linear);
+	net_bench_report("resource tree", ROUNDS, "request", tree);
+}
+
+ZTEST_SUITE(http_server_dispatch, NULL, NULL, NULL, NULL, NULL);
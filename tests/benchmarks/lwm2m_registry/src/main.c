@@ -0,0 +1,187 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the registry lookups behind composite reads, SenML reads and
+ * notifications, which resolve every path they carry to its object instance,
+ * object field and resource. A custom object with many instances and
+ * resources is registered next to the objects of the engine, and its
+ * resources are read by path. Build with
+ * CONFIG_LWM2M_ENGINE_REGISTRY_INDEX_SIZE=0 to compare with plain list
+ * walks.
+ *
+ * No reference numbers are recorded for this benchmark yet, neither for
+ * the plain list walks nor for the index. Run both variants on native_sim
+ * or the target of interest to compare them.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/lwm2m.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+#include "lwm2m_observation.h"
+#include "lwm2m_rw_senml_json.h"
+#include "net_bench.h"
+
+#define ROUNDS 20
+
+#define BENCH_OBJ_ID 32769
+#define INSTANCE_COUNT 16
+#define RESOURCE_COUNT 64
+
+static struct lwm2m_engine_obj bench_obj;
+static struct lwm2m_engine_obj_field fields[RESOURCE_COUNT];
+
+static struct lwm2m_engine_obj_inst inst[INSTANCE_COUNT];
+static struct lwm2m_engine_res res[INSTANCE_COUNT][RESOURCE_COUNT];
+static struct lwm2m_engine_res_inst res_inst[INSTANCE_COUNT][RESOURCE_COUNT];
+static uint32_t data[INSTANCE_COUNT][RESOURCE_COUNT];
+
+static struct lwm2m_message msg;
+static struct lwm2m_obj_path_list path_buf[INSTANCE_COUNT];
+
+static struct lwm2m_engine_obj_inst *bench_obj_create(uint16_t obj_inst_id)
+{
+	int i = 0, j = 0;
+
+	if (obj_inst_id >= INSTANCE_COUNT || inst[obj_inst_id].resources != NULL) {
+		return NULL;
+	}
+
+	init_res_instance(res_inst[obj_inst_id], RESOURCE_COUNT);
+
+	for (int id = 0; id < RESOURCE_COUNT; id++) {
+		data[obj_inst_id][id] = obj_inst_id * RESOURCE_COUNT + id;
+		INIT_OBJ_RES_DATA(id, res[obj_inst_id], i, res_inst[obj_inst_id], j,
+				  &data[obj_inst_id][id], sizeof(uint32_t));
+	}
+
+	inst[obj_inst_id].resources = res[obj_inst_id];
+	inst[obj_inst_id].resource_count = i;
+
+	return &inst[obj_inst_id];
+}
+
+static void *setup(void)
+{
+	struct lwm2m_engine_obj_inst *obj_inst;
+
+	for (int id = 0; id < RESOURCE_COUNT; id++) {
+		fields[id] = (struct lwm2m_engine_obj_field)OBJ_FIELD_DATA(id, R, U32);
+	}
+
+	bench_obj.obj_id = BENCH_OBJ_ID;
+	bench_obj.version_major = 1;
+	bench_obj.version_minor = 0;
+	bench_obj.fields = fields;
+	bench_obj.field_count = RESOURCE_COUNT;
+	bench_obj.max_instance_count = INSTANCE_COUNT;
+	bench_obj.create_cb = bench_obj_create;
+	lwm2m_register_obj(&bench_obj);
+
+	for (int i = 0; i < INSTANCE_COUNT; i++) {
+		zassert_ok(lwm2m_create_obj_inst(BENCH_OBJ_ID, i, &obj_inst));
+	}
+
+	return NULL;
+}
+
+/* Read every resource of every instance, as a composite read of the whole
+ * object would, one path at a time.
+ */
+ZTEST(lwm2m_registry_bench, test_read_all)
+{
+	uint32_t start, cycles;
+	uint32_t value;
+
+	start = k_cycle_get_32();
+
+	for (int round = 0; round < ROUNDS; round++) {
+		for (int i = 0; i < INSTANCE_COUNT; i++) {
+			for (int id = 0; id < RESOURCE_COUNT; id++) {
+				zassert_ok(lwm2m_get_u32(&LWM2M_OBJ(BENCH_OBJ_ID, i, id), &value));
+				zassert_equal(value, data[i][id]);
+			}
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+	net_bench_report("all resources", ROUNDS * INSTANCE_COUNT * RESOURCE_COUNT, "read",
+			 cycles);
+}
+
+/* Read the last resource of every instance, the worst case for list walks */
+ZTEST(lwm2m_registry_bench, test_read_last)
+{
+	uint32_t start, cycles;
+	uint32_t value;
+
+	start = k_cycle_get_32();
+
+	for (int round = 0; round < ROUNDS * RESOURCE_COUNT; round++) {
+		for (int i = 0; i < INSTANCE_COUNT; i++) {
+			zassert_ok(lwm2m_get_u32(
+				&LWM2M_OBJ(BENCH_OBJ_ID, i, RESOURCE_COUNT - 1), &value));
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+	net_bench_report("last resource", ROUNDS * RESOURCE_COUNT * INSTANCE_COUNT, "read",
+			 cycles);
+}
+
+/* Core objects are registered first, so their paths are the best case for
+ * list walks.
+ */
+ZTEST(lwm2m_registry_bench, test_read_core)
+{
+	uint32_t start, cycles;
+
+	start = k_cycle_get_32();
+
+	for (int round = 0; round < ROUNDS * RESOURCE_COUNT * INSTANCE_COUNT; round++) {
+		zassert_not_null(lwm2m_engine_get_res(&LWM2M_OBJ(LWM2M_OBJECT_DEVICE_ID, 0, 0)));
+	}
+
+	cycles = k_cycle_get_32() - start;
+	net_bench_report("core resource", ROUNDS * RESOURCE_COUNT * INSTANCE_COUNT, "read",
+			 cycles);
+}
+
+/* Encode a SenML JSON composite read of the last resource of every
+ * instance, as a Read-Composite request or a Send of those paths would.
+ */
+ZTEST(lwm2m_registry_bench, test_composite_read_senml)
+{
+	uint32_t start, cycles;
+	sys_slist_t path_list;
+	sys_slist_t free_list;
+
+	lwm2m_engine_path_list_init(&path_list, &free_list, path_buf, ARRAY_SIZE(path_buf));
+
+	for (int i = 0; i < INSTANCE_COUNT; i++) {
+		zassert_ok(lwm2m_engine_add_path_to_list(
+			&path_list, &free_list, &LWM2M_OBJ(BENCH_OBJ_ID, i, RESOURCE_COUNT - 1)));
+	}
+
+	msg.out.writer = &senml_json_writer;
+	msg.out.out_cpkt = &msg.cpkt;
+
+	start = k_cycle_get_32();
+
+	for (int round = 0; round < ROUNDS * INSTANCE_COUNT; round++) {
+		zassert_ok(coap_packet_init(&msg.cpkt, msg.msg_data, sizeof(msg.msg_data),
+					    COAP_VERSION_1, COAP_TYPE_ACK, 0, NULL,
+					    COAP_RESPONSE_CODE_CONTENT, 0));
+		zassert_ok(do_send_op_senml_json(&msg, &path_list));
+	}
+
+	cycles = k_cycle_get_32() - start;
+	net_bench_report("senml composite read", ROUNDS * INSTANCE_COUNT, "msg", cycles);
+}
+
+ZTEST_SUITE(lwm2m_registry_bench, NULL, setup, NULL, NULL, NULL);
@@ -0,0 +1,324 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Compare publishing QoS 1 messages one at a time, waiting for each PUBACK,
+ * with the outbound queue, against a loopback broker plugged in as the
+ * custom transport. The broker acknowledges messages as soon as they are
+ * written, so the numbers show the cost of the client alone, and the number
+ * of transport writes. Over a real link, each message published one at a
+ * time also costs a round trip, which the queue overlaps. The behaviour of
+ * the queue is covered by tests/net/lib/mqtt_queue.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/mqtt.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/ztest.h>
+
+#include "net_bench.h"
+
+#define ROUNDS 2000
+#define BUFFER_SIZE 256
+#define QUEUE_BUFFER_SIZE 2048
+#define PAYLOAD_SIZE 32
+
+#define TOPIC "sensors/kitchen/temperature"
+
+static uint8_t rx_buffer[BUFFER_SIZE];
+static uint8_t tx_buffer[BUFFER_SIZE];
+static uint8_t queue_buffer[QUEUE_BUFFER_SIZE];
+static uint8_t payload[PAYLOAD_SIZE];
+static struct mqtt_client client;
+
+static struct broker {
+	/* Packets queued for the client */
+	uint8_t out[BUFFER_SIZE * 2];
+	size_t out_len;
+	size_t out_pos;
+
+	/* Packets written by the client */
+	uint8_t in[QUEUE_BUFFER_SIZE];
+	size_t in_len;
+
+	int writes;
+} broker;
+
+static struct {
+	int puback;
+} events;
+
+static size_t varint_decode(const uint8_t *p, uint32_t *value)
+{
+	size_t n = 0;
+
+	*value = 0U;
+
+	do {
+		*value |= (uint32_t)(p[n] & 0x7F) << (7 * n);
+	} while (p[n++] & 0x80);
+
+	return n;
+}
+
+static void broker_send(const uint8_t *data, size_t len)
+{
+	memmove(broker.out, &broker.out[broker.out_pos],
+		broker.out_len - broker.out_pos);
+	broker.out_len -= broker.out_pos;
+	broker.out_pos = 0;
+
+	zassert_true(broker.out_len + len <= sizeof(broker.out), "Broker full");
+	memcpy(&broker.out[broker.out_len], data, len);
+	broker.out_len += len;
+}
+
+/* Every message is QoS 1, acknowledged as soon as it is written */
+static void broker_publish(const uint8_t *body)
+{
+	uint16_t topic_len = sys_get_be16(body);
+	uint8_t puback[4] = { 0x40, 0x02 };
+
+	memcpy(&puback[2], body + 2 + topic_len, sizeof(uint16_t));
+	broker_send(puback, sizeof(puback));
+}
+
+static void broker_handle(const uint8_t *pkt)
+{
+	static const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+	uint32_t remaining;
+	const uint8_t *body = pkt + 1 + varint_decode(pkt + 1, &remaining);
+
+	switch (pkt[0] & 0xF0) {
+	case 0x10:
+		broker_send(connack, sizeof(connack));
+		break;
+	case 0x30:
+		broker_publish(body);
+		break;
+	case 0xE0:
+		break;
+	default:
+		zassert_unreachable("Unexpected packet 0x%02x", pkt[0]);
+	}
+}
+
+static void broker_write(const uint8_t *data, size_t len)
+{
+	uint32_t remaining;
+	size_t pkt_len;
+	size_t pos = 0;
+
+	zassert_true(broker.in_len + len <= sizeof(broker.in), "Write too big");
+	memcpy(&broker.in[broker.in_len], data, len);
+	broker.in_len += len;
+
+	while (broker.in_len - pos >= 2) {
+		pkt_len = 1 + varint_decode(&broker.in[pos + 1], &remaining) +
+			  remaining;
+		if (broker.in_len - pos < pkt_len) {
+			break;
+		}
+
+		broker_handle(&broker.in[pos]);
+		pos += pkt_len;
+	}
+
+	memmove(broker.in, &broker.in[pos], broker.in_len - pos);
+	broker.in_len -= pos;
+}
+
+int mqtt_client_custom_transport_connect(struct mqtt_client *client)
+{
+	return 0;
+}
+
+int mqtt_client_custom_transport_write(struct mqtt_client *client,
+				       const uint8_t *data, uint32_t datalen)
+{
+	broker.writes++;
+	broker_write(data, datalen);
+
+	return 0;
+}
+
+int mqtt_client_custom_transport_write_msg(struct mqtt_client *client,
+					   const struct msghdr *message)
+{
+	broker.writes++;
+
+	for (int i = 0; i < message->msg_iovlen; i++) {
+		if (message->msg_iov[i].iov_len == 0) {
+			continue;
+		}
+
+		broker_write(message->msg_iov[i].iov_base,
+			     message->msg_iov[i].iov_len);
+	}
+
+	return 0;
+}
+
+int mqtt_client_custom_transport_read(struct mqtt_client *client,
+				      uint8_t *data, uint32_t buflen,
+				      bool shall_block)
+{
+	size_t len = MIN(buflen, broker.out_len - broker.out_pos);
+
+	if (len == 0) {
+		return -EAGAIN;
+	}
+
+	memcpy(data, &broker.out[broker.out_pos], len);
+	broker.out_pos += len;
+
+	return len;
+}
+
+int mqtt_client_custom_transport_disconnect(struct mqtt_client *client)
+{
+	broker.out_len = 0;
+	broker.out_pos = 0;
+	broker.in_len = 0;
+
+	return 0;
+}
+
+static void evt_handler(struct mqtt_client *const c, const struct mqtt_evt *evt)
+{
+	if (evt->type == MQTT_EVT_PUBACK) {
+		events.puback++;
+	}
+}
+
+static void mqtt_connect_and_wait(void)
+{
+	zassert_ok(mqtt_connect(&client), "Failed to connect");
+	zassert_ok(mqtt_input(&client), "Failed to read CONNACK");
+}
+
+static struct mqtt_publish_param message(uint8_t qos, uint16_t message_id)
+{
+	struct mqtt_publish_param param = {
+		.message.topic.topic = MQTT_UTF8_LITERAL(TOPIC),
+		.message.topic.qos = qos,
+		.message.payload.data = payload,
+		.message.payload.len = sizeof(payload),
+		.message_id = message_id,
+	};
+
+	return param;
+}
+
+static int publish_queued(uint8_t qos)
+{
+	struct mqtt_publish_param param = message(qos, 0);
+
+	return mqtt_publish_queued(&client, &param);
+}
+
+static void input_until(int *counter, int value)
+{
+	while (*counter < value) {
+		zassert_ok(mqtt_input(&client), "Input failed");
+	}
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(&broker, 0, sizeof(broker));
+	memset(&events, 0, sizeof(events));
+
+	mqtt_client_init(&client);
+	client.client_id = MQTT_UTF8_LITERAL("bench");
+	client.transport.type = MQTT_TRANSPORT_CUSTOM;
+	client.evt_cb = evt_handler;
+	client.rx_buf = rx_buffer;
+	client.rx_buf_size = sizeof(rx_buffer);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+	client.queue_buf = queue_buffer;
+	client.queue_buf_size = sizeof(queue_buffer);
+
+	mqtt_connect_and_wait();
+
+	broker.writes = 0;
+}
+
+static void after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	mqtt_abort(&client);
+}
+
+static uint64_t run_blocking(void)
+{
+	struct mqtt_publish_param param;
+	uint32_t start;
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < ROUNDS; i++) {
+		param = message(MQTT_QOS_1_AT_LEAST_ONCE, (i % UINT16_MAX) + 1);
+
+		zassert_ok(mqtt_publish(&client, &param), "Publish failed");
+		input_until(&events.puback, i + 1);
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static uint64_t run_queued(void)
+{
+	uint32_t start;
+	int ret;
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < ROUNDS; i++) {
+		do {
+			ret = publish_queued(MQTT_QOS_1_AT_LEAST_ONCE);
+			if (ret == -EAGAIN) {
+				zassert_ok(mqtt_input(&client), "Input failed");
+			}
+		} while (ret == -EAGAIN);
+
+		zassert_true(ret > 0, "Failed to queue (%d)", ret);
+	}
+
+	input_until(&events.puback, ROUNDS);
+
+	return k_cycle_get_32() - start;
+}
+
+ZTEST(mqtt_publish_queue, test_publish_rate)
+{
+	int blocking_writes, queued_writes;
+	uint64_t blocking, queued;
+
+	blocking = run_blocking();
+	blocking_writes = broker.writes;
+
+	broker.writes = 0;
+	events.puback = 0;
+
+	queued = run_queued();
+	queued_writes = broker.writes;
+
+	zassert_equal(mqtt_publish_queue_len(&client), 0, "Queue not empty");
+	zassert_true(queued_writes < blocking_writes,
+		     "Messages not coalesced");
+
+	net_bench_report("one at a time", ROUNDS, "message", blocking);
+	TC_PRINT("%-28s %8d socket writes\n", "one at a time", blocking_writes);
+	net_bench_report("outbound queue", ROUNDS, "message", queued);
+	TC_PRINT("%-28s %8d socket writes\n", "outbound queue", queued_writes);
+}
+
+ZTEST_SUITE(mqtt_publish_queue, NULL, NULL, before, after, NULL);
@@ -0,0 +1,84 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Time calc_chksum() against the 16-bit at a time loop it replaced, for
+ * common packet sizes.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "net_bench.h"
+#include "net_private.h"
+
+#define CHECKSUM_LENGTH 1500
+#define ROUNDS 2000
+
+static uint8_t data[CHECKSUM_LENGTH];
+
+static uint16_t calc_chksum_ref(uint16_t sum, const uint8_t *buf, size_t len)
+{
+	const uint8_t *end = buf + len - 1;
+	uint16_t tmp;
+
+	while (buf < end) {
+		tmp = (buf[0] << 8) + buf[1];
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+
+		buf += 2;
+	}
+
+	if (buf == end) {
+		tmp = buf[0] << 8;
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+	}
+
+	return sum;
+}
+
+ZTEST(net_checksum, test_sizes)
+{
+	static const size_t sizes[] = { 20, 64, 256, 576, 1280, 1500 };
+	volatile uint16_t sink = 0U;
+
+	for (int i = 0; i < CHECKSUM_LENGTH; i++) {
+		data[i] = (uint8_t)(i * 7);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		uint32_t start, ref_cycles, opt_cycles;
+		char name[32];
+
+		zassert_equal(calc_chksum_ref(0, data, sizes[i]), calc_chksum(0, data, sizes[i]));
+
+		start = k_cycle_get_32();
+		for (int j = 0; j < ROUNDS; j++) {
+			sink += calc_chksum_ref(j, data, sizes[i]);
+		}
+		ref_cycles = k_cycle_get_32() - start;
+
+		start = k_cycle_get_32();
+		for (int j = 0; j < ROUNDS; j++) {
+			sink += calc_chksum(j, data, sizes[i]);
+		}
+		opt_cycles = k_cycle_get_32() - start;
+
+		snprintk(name, sizeof(name), "16-bit loop, %zu bytes", sizes[i]);
+		net_bench_report(name, ROUNDS, "sum", ref_cycles);
+		snprintk(name, sizeof(name), "calc_chksum, %zu bytes", sizes[i]);
+		net_bench_report(name, ROUNDS, "sum", opt_cycles);
+	}
+
+	ARG_UNUSED(sink);
+}
+
+ZTEST_SUITE(net_checksum, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,53 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Result lines printed by the networking benchmarks */
+
+#ifndef NET_BENCH_H_
+#define NET_BENCH_H_
+
+#include <inttypes.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+/**
+ * @brief Print the time spent on @a count items
+ *
+ * Prints the total time, the time per item and the items per second.
+ *
+ * @param name Name of the measured case.
+ * @param count Number of items processed.
+ * @param unit Name of one item, e.g. "pkt".
+ * @param cycles Cycles spent on all items.
+ */
+static inline void net_bench_report(const char *name, uint64_t count, const char *unit,
+				    uint64_t cycles)
+{
+	uint64_t ns = k_cyc_to_ns_floor64(cycles);
+
+	TC_PRINT("%-28s %8" PRIu64 " %-8s %12" PRIu64 " ns %8" PRIu64 " ns/%-8s %10" PRIu64
+		 " %s/s\n",
+		 name, count, unit, ns, count > 0 ? ns / count : 0, unit,
+		 ns > 0 ? count * NSEC_PER_SEC / ns : 0, unit);
+}
+
+/**
+ * @brief Print the throughput of processing @a bytes
+ *
+ * @param name Name of the measured case.
+ * @param bytes Number of bytes processed.
+ * @param cycles Cycles spent on all bytes.
+ */
+static inline void net_bench_throughput(const char *name, uint64_t bytes, uint64_t cycles)
+{
+	uint64_t ns = k_cyc_to_ns_floor64(cycles);
+
+	TC_PRINT("%-28s %8" PRIu64 " bytes    %12" PRIu64 " ns %8" PRIu64 " MB/s\n", name, bytes,
+		 ns, ns > 0 ? bytes * 1000U / ns : 0);
+}
+
+#endif /* NET_BENCH_H_ */
@@ -0,0 +1,107 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Compare the packets per second delivered to the RX traffic class thread
+ * with net_recv_data() and net_recv_data_burst(). The packets are not
+ * valid IPv6, so the stack drops them right after the L2 and the
+ * measurement is dominated by the queueing and thread wake up cost.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/dummy.h>
+
+#include "net_bench.h"
+
+#define BURST_SIZE 16
+#define ROUNDS 64
+#define PKT_LEN 64
+
+static struct k_mem_slab *rx_slab;
+
+static void dummy_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+}
+
+static int dummy_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static struct dummy_api dummy_api_funcs = {
+	.iface_api.init = dummy_iface_init,
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT(rx_burst_test, "rx_burst_test", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &dummy_api_funcs,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+static void alloc_burst(struct net_if *iface, struct net_pkt **pkts)
+{
+	static const uint8_t payload[PKT_LEN] = { 0xff };
+
+	for (int i = 0; i < BURST_SIZE; i++) {
+		pkts[i] = net_pkt_rx_alloc_with_buffer(iface, PKT_LEN, AF_UNSPEC,
+						       0, K_FOREVER);
+		zassert_not_null(pkts[i], "Cannot allocate pkt");
+		zassert_ok(net_pkt_write(pkts[i], payload, sizeof(payload)));
+	}
+}
+
+static void wait_rx_done(uint32_t free_count)
+{
+	while (k_mem_slab_num_free_get(rx_slab) != free_count) {
+		k_yield();
+	}
+}
+
+ZTEST(net_rx_burst, test_rx_pps)
+{
+	struct net_if *iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	struct net_pkt *pkts[BURST_SIZE];
+	uint64_t single = 0, burst = 0;
+	uint32_t free_count;
+	uint32_t start;
+
+	zassert_not_null(iface, "No dummy interface");
+
+	net_pkt_get_info(&rx_slab, NULL, NULL, NULL);
+	free_count = k_mem_slab_num_free_get(rx_slab);
+
+	for (int round = 0; round < ROUNDS; round++) {
+		alloc_burst(iface, pkts);
+
+		start = k_cycle_get_32();
+		for (int i = 0; i < BURST_SIZE; i++) {
+			zassert_ok(net_recv_data(iface, pkts[i]));
+		}
+		wait_rx_done(free_count);
+		single += k_cycle_get_32() - start;
+
+		alloc_burst(iface, pkts);
+
+		start = k_cycle_get_32();
+		zassert_equal(net_recv_data_burst(iface, pkts, BURST_SIZE),
+			      BURST_SIZE);
+		wait_rx_done(free_count);
+		burst += k_cycle_get_32() - start;
+	}
+
+	net_bench_report("net_recv_data", ROUNDS * BURST_SIZE, "pkt", single);
+	net_bench_report("net_recv_data_burst", ROUNDS * BURST_SIZE, "pkt", burst);
+}
+
+ZTEST_SUITE(net_rx_burst, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,151 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Compare the UDP packets per second over the loopback interface when
+ * moving one datagram per call with sendto()/recvfrom() and a vector of
+ * datagrams per call with sendmmsg()/recvmmsg().
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+
+#include "net_bench.h"
+
+#define BATCH 16
+#define ROUNDS 128
+#define DGRAM_LEN 64
+#define PORT 4242
+
+/* The tests run as user threads in the userspace variant, so everything
+ * they touch lives in the ztest memory partition.
+ */
+static ZTEST_BMEM uint8_t tx_data[BATCH][DGRAM_LEN];
+static ZTEST_BMEM uint8_t rx_data[BATCH][DGRAM_LEN];
+static ZTEST_BMEM struct iovec tx_iov[BATCH];
+static ZTEST_BMEM struct iovec rx_iov[BATCH];
+static ZTEST_BMEM struct mmsghdr tx_msgs[BATCH];
+static ZTEST_BMEM struct mmsghdr rx_msgs[BATCH];
+
+static ZTEST_BMEM int sock_tx = -1;
+static ZTEST_BMEM int sock_rx = -1;
+static ZTEST_BMEM struct sockaddr_in addr;
+
+/* The sockets are opened from the test thread itself, so that the user
+ * thread is granted access to them.
+ */
+static void open_sockets(void)
+{
+	struct zsock_timeval tv = { .tv_sec = 1 };
+
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(PORT);
+	zassert_equal(zsock_inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr), 1);
+
+	sock_rx = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(sock_rx >= 0, "socket failed (%d)", errno);
+
+	sock_tx = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(sock_tx >= 0, "socket failed (%d)", errno);
+
+	zassert_ok(zsock_bind(sock_rx, (struct sockaddr *)&addr, sizeof(addr)));
+	zassert_ok(zsock_setsockopt(sock_rx, SOL_SOCKET, SO_RCVTIMEO,
+				    &tv, sizeof(tv)));
+
+	for (int i = 0; i < BATCH; i++) {
+		tx_iov[i].iov_base = tx_data[i];
+		tx_iov[i].iov_len = DGRAM_LEN;
+		tx_msgs[i].msg_hdr.msg_name = &addr;
+		tx_msgs[i].msg_hdr.msg_namelen = sizeof(addr);
+		tx_msgs[i].msg_hdr.msg_iov = &tx_iov[i];
+		tx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+static void close_sockets(void)
+{
+	zassert_ok(zsock_close(sock_tx));
+	zassert_ok(zsock_close(sock_rx));
+}
+
+static void reset_rx_msgs(void)
+{
+	for (int i = 0; i < BATCH; i++) {
+		rx_iov[i].iov_base = rx_data[i];
+		rx_iov[i].iov_len = DGRAM_LEN;
+		memset(&rx_msgs[i].msg_hdr, 0, sizeof(rx_msgs[i].msg_hdr));
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+ZTEST_USER(sockets_udp_pps, test_single)
+{
+	uint64_t cycles = 0;
+	uint32_t start;
+
+	open_sockets();
+
+	for (int round = 0; round < ROUNDS; round++) {
+		start = k_cycle_get_32();
+
+		for (int i = 0; i < BATCH; i++) {
+			zassert_equal(zsock_sendto(sock_tx, tx_data[i], DGRAM_LEN, 0,
+						   (struct sockaddr *)&addr,
+						   sizeof(addr)),
+				      DGRAM_LEN);
+		}
+
+		for (int i = 0; i < BATCH; i++) {
+			zassert_equal(zsock_recvfrom(sock_rx, rx_data[i], DGRAM_LEN,
+						     0, NULL, NULL),
+				      DGRAM_LEN);
+		}
+
+		cycles += k_cycle_get_32() - start;
+	}
+
+	close_sockets();
+
+	net_bench_report("sendto/recvfrom", ROUNDS * BATCH, "pkt", cycles);
+}
+
+ZTEST_USER(sockets_udp_pps, test_batch)
+{
+	uint64_t cycles = 0;
+	uint32_t start;
+	int received;
+	int ret;
+
+	open_sockets();
+
+	for (int round = 0; round < ROUNDS; round++) {
+		reset_rx_msgs();
+
+		start = k_cycle_get_32();
+
+		zassert_equal(zsock_sendmmsg(sock_tx, tx_msgs, BATCH, 0), BATCH);
+
+		for (received = 0; received < BATCH; received += ret) {
+			ret = zsock_recvmmsg(sock_rx, &rx_msgs[received],
+					     BATCH - received, 0);
+			zassert_true(ret > 0, "recvmmsg failed (%d)", errno);
+		}
+
+		cycles += k_cycle_get_32() - start;
+
+		for (int i = 0; i < BATCH; i++) {
+			zassert_equal(tx_msgs[i].msg_len, DGRAM_LEN);
+			zassert_equal(rx_msgs[i].msg_len, DGRAM_LEN);
+		}
+	}
+
+	close_sockets();
+
+	net_bench_report("sendmmsg/recvmmsg", ROUNDS * BATCH, "pkt", cycles);
+}
+
+ZTEST_SUITE(sockets_udp_pps, NULL, NULL, NULL, NULL, NULL);
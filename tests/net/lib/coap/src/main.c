@@ -16,6 +16,7 @@ LOG_MODULE_REGISTER(net_test, LOG_LEVEL_DBG);
 #include <zephyr/sys/printk.h>
 #include <zephyr/kernel.h>
 #include <zephyr/sys/util.h>
+#include <zephyr/net/buf.h>
 #include <zephyr/net/coap.h>
 
 #include <zephyr/tc_util.h>
@@ -1368,6 +1369,109 @@ static void init_basic_test_msg(struct coap_packet *cpkt, uint8_t *data)
 	zassert_equal((*cpkt).offset, 57, "Wrong data size");
 }
 
+ZTEST(coap, test_build_options_out_of_order_ext)
+{
+	struct coap_packet cpkt;
+	static const char token[] = "token";
+	static const uint8_t payload[] = {0xde, 0xad};
+	uint8_t *data = data_buf[0];
+	int r;
+
+	r = coap_packet_init(&cpkt, data, COAP_BUF_SIZE, COAP_VERSION_1, COAP_TYPE_CON,
+			     strlen(token), token, COAP_METHOD_POST, 0x1234);
+	zassert_equal(r, 0, "Could not initialize packet");
+
+	/* Option number and length encoded with 16 bit extensions */
+	static const uint8_t long_value[300] = {0xab};
+
+	r = coap_packet_append_option(&cpkt, 300, long_value, sizeof(long_value));
+	zassert_equal(r, -EINVAL, "Option larger than the packet was added");
+
+	r = coap_packet_append_option(&cpkt, 300, "abc", 3);
+	zassert_equal(r, 0, "Could not append option");
+
+	r = coap_packet_append_payload_marker(&cpkt);
+	zassert_equal(r, 0, "Could not append payload marker");
+
+	r = coap_packet_append_payload(&cpkt, payload, sizeof(payload));
+	zassert_equal(r, 0, "Could not append payload");
+
+	/* Option out of order, the delta of the next one shrinks */
+	r = coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH, "p", 1);
+	zassert_equal(r, 0, "Could not append option");
+
+	static const uint8_t expected_0[] = {
+		0x45, 0x02, 0x12, 0x34, 't', 'o', 'k', 'e', 'n',
+		0xb1, 'p',				/* uri path */
+		0xe3, 0x00, 0x14, 'a', 'b', 'c',	/* 300 */
+		0xff, 0xde, 0xad,
+	};
+
+	zassert_equal(cpkt.opt_len, 8, "Wrong options size");
+	zassert_equal(cpkt.offset, sizeof(expected_0), "Wrong data size");
+	zassert_mem_equal(expected_0, cpkt.data, sizeof(expected_0), "Wrong data");
+
+	/* The delta of the next option grows back */
+	r = coap_packet_remove_option(&cpkt, COAP_OPTION_URI_PATH);
+	zassert_equal(r, 0, "Could not remove option");
+
+	static const uint8_t expected_1[] = {
+		0x45, 0x02, 0x12, 0x34, 't', 'o', 'k', 'e', 'n',
+		0xe3, 0x00, 0x1f, 'a', 'b', 'c',	/* 300 */
+		0xff, 0xde, 0xad,
+	};
+
+	zassert_equal(cpkt.opt_len, 6, "Wrong options size");
+	zassert_equal(cpkt.offset, sizeof(expected_1), "Wrong data size");
+	zassert_mem_equal(expected_1, cpkt.data, sizeof(expected_1), "Wrong data");
+}
+
+NET_BUF_POOL_DEFINE(coap_test_pool, 1, COAP_BUF_SIZE, 0, NULL);
+
+ZTEST(coap, test_build_pdu_in_net_buf)
+{
+	uint8_t result_pdu[] = { 0x55, 0xA5, 0x12, 0x34, 't', 'o', 'k',
+				 'e', 'n', 0xC0, 0xFF, 'p', 'a', 'y',
+				 'l', 'o', 'a', 'd', 0x00 };
+	struct coap_packet cpkt;
+	struct net_buf *buf;
+	const char token[] = "token";
+	static const uint8_t payload[] = "payload";
+	int r;
+
+	buf = net_buf_alloc(&coap_test_pool, K_NO_WAIT);
+	zassert_not_null(buf, "Could not allocate buffer");
+
+	r = coap_packet_init_net_buf(&cpkt, buf, COAP_VERSION_1, COAP_TYPE_NON_CON,
+				     strlen(token), token, COAP_RESPONSE_CODE_PROXYING_NOT_SUPPORTED,
+				     0x1234);
+	zassert_equal(r, 0, "Could not initialize packet");
+	zassert_equal_ptr(cpkt.data, buf->data, "Packet not built in the buffer");
+	zassert_equal(cpkt.max_len, COAP_BUF_SIZE, "Wrong max length");
+
+	r = coap_append_option_int(&cpkt, COAP_OPTION_CONTENT_FORMAT,
+				   COAP_CONTENT_FORMAT_TEXT_PLAIN);
+	zassert_equal(r, 0, "Could not append option");
+
+	r = coap_packet_append_payload_marker(&cpkt);
+	zassert_equal(r, 0, "Failed to set the payload marker");
+
+	r = coap_packet_append_payload(&cpkt, payload, sizeof(payload));
+	zassert_equal(r, 0, "Failed to set the payload");
+
+	zassert_equal(cpkt.offset, sizeof(result_pdu), "Different size from the reference packet");
+	zassert_mem_equal(result_pdu, buf->data, cpkt.offset,
+			  "Built packet doesn't match reference packet");
+
+	/* Only an empty buffer can be used */
+	net_buf_add(buf, cpkt.offset);
+	r = coap_packet_init_net_buf(&cpkt, buf, COAP_VERSION_1, COAP_TYPE_NON_CON, 0, NULL,
+				     COAP_RESPONSE_CODE_CONTENT, 0x1234);
+	zassert_equal(r, -EINVAL, "Initialized packet in a used buffer");
+
+	net_buf_unref(buf);
+}
+
 ZTEST(coap, test_remove_first_coap_option)
 {
 	int r;
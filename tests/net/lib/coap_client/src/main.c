@@ -329,6 +329,108 @@ static ssize_t z_impl_zsock_recvfrom_custom_fake_echo_next_req(int sock, void *b
 	return sizeof(ack_data);
 }
 
+#define BLOCK2_TEST_SZX 2
+#define BLOCK2_TEST_BLOCK_SIZE 64
+
+struct block2_test_request {
+	uint16_t id;
+	uint32_t num;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t tkl;
+};
+
+static struct block2_test_request block2_requests[CONFIG_COAP_CLIENT_BLOCK2_WINDOW];
+static int block2_queued;
+static int block2_max_queued;
+static size_t block2_received;
+static int block2_last_blocks;
+static bool block2_mismatch;
+static bool block2_shared_token;
+
+static ssize_t z_impl_zsock_sendto_custom_fake_block2(int sock, void *buf, size_t len,
+						      int flags, const struct sockaddr *dest_addr,
+						      socklen_t addrlen)
+{
+	struct block2_test_request *req;
+	struct coap_packet request;
+	int block;
+
+	if (coap_packet_parse(&request, buf, len, NULL, 0) < 0 ||
+	    block2_queued >= ARRAY_SIZE(block2_requests)) {
+		block2_mismatch = true;
+		return -1;
+	}
+
+	block = coap_get_option_int(&request, COAP_OPTION_BLOCK2);
+
+	req = &block2_requests[block2_queued];
+	req->id = coap_header_get_id(&request);
+	req->num = block < 0 ? 0 : GET_BLOCK_NUM(block);
+	req->tkl = coap_header_get_token(&request, req->token);
+
+	/* Each block in flight must be told apart by its token */
+	for (int i = 0; i < block2_queued; i++) {
+		if (block2_requests[i].tkl == req->tkl &&
+		    memcmp(block2_requests[i].token, req->token, req->tkl) == 0) {
+			block2_shared_token = true;
+		}
+	}
+
+	block2_queued++;
+	block2_max_queued = MAX(block2_max_queued, block2_queued);
+
+	return len;
+}
+
+/* Answers the latest request first, so blocks arrive out of order */
+static ssize_t z_impl_zsock_recvfrom_custom_fake_block2(int sock, void *buf, size_t max_len,
+							int flags, struct sockaddr *src_addr,
+							socklen_t *addrlen)
+{
+	struct block2_test_request *req;
+	struct coap_packet response;
+	size_t total = strlen(long_payload);
+	size_t offset;
+	size_t len;
+	bool more;
+
+	if (block2_queued == 0) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	req = &block2_requests[--block2_queued];
+	offset = req->num * BLOCK2_TEST_BLOCK_SIZE;
+	len = MIN(BLOCK2_TEST_BLOCK_SIZE, total - offset);
+	more = offset + len < total;
+
+	coap_packet_init(&response, buf, max_len, COAP_VERSION_1, COAP_TYPE_ACK, req->tkl,
+			 req->token, COAP_RESPONSE_CODE_CONTENT, req->id);
+	coap_append_option_int(&response, COAP_OPTION_BLOCK2,
+			       (req->num << 4) | (more << 3) | BLOCK2_TEST_SZX);
+	if (req->num == 0) {
+		coap_append_option_int(&response, COAP_OPTION_SIZE2, total);
+	}
+	coap_packet_append_payload_marker(&response);
+	coap_packet_append_payload(&response, long_payload + offset, len);
+
+	return response.offset;
+}
+
+static void coap_callback_block2(int16_t code, size_t offset, const uint8_t *payload, size_t len,
+				 bool last_block, void *user_data)
+{
+	if (code != COAP_RESPONSE_CODE_CONTENT || offset != block2_received ||
+	    memcmp(payload, long_payload + offset, len) != 0) {
+		block2_mismatch = true;
+	}
+
+	block2_received += len;
+	if (last_block) {
+		block2_last_blocks++;
+	}
+}
+
 static void *suite_setup(void)
 {
 	coap_client_init(&client, NULL);
@@ -687,3 +789,44 @@ ZTEST(coap_client, test_unmatching_tokens)
 	k_sleep(K_MSEC(500));
 	zassert_equal(last_response_code, -ETIMEDOUT, "Unexpected response");
 }
+
+ZTEST(coap_client, test_block2_window)
+{
+	int ret = 0;
+	struct sockaddr address = {0};
+	struct coap_client_request client_request = {
+		.method = COAP_METHOD_GET,
+		.confirmable = true,
+		.path = test_path,
+		.fmt = COAP_CONTENT_FORMAT_TEXT_PLAIN,
+		.cb = coap_callback_block2,
+		.payload = NULL,
+		.len = 0
+	};
+
+	block2_queued = 0;
+	block2_max_queued = 0;
+	block2_received = 0;
+	block2_last_blocks = 0;
+	block2_mismatch = false;
+	block2_shared_token = false;
+
+	z_impl_zsock_sendto_fake.custom_fake = z_impl_zsock_sendto_custom_fake_block2;
+	z_impl_zsock_recvfrom_fake.custom_fake = z_impl_zsock_recvfrom_custom_fake_block2;
+
+	k_sleep(K_MSEC(1));
+
+	LOG_INF("Send request");
+	ret = coap_client_req(&client, 0, &address, &client_request, NULL);
+	zassert_true(ret >= 0, "Sending request failed, %d", ret);
+	set_socket_events(ZSOCK_POLLIN);
+
+	k_sleep(K_MSEC(200));
+	clear_socket_events();
+
+	zassert_false(block2_shared_token, "Blocks in flight share a token");
+	zassert_false(block2_mismatch, "Blocks not delivered in order");
+	zassert_equal(block2_received, strlen(long_payload), "Transfer not complete");
+	zassert_equal(block2_last_blocks, 1, "Last block reported %d times", block2_last_blocks);
+	zassert_true(block2_max_queued > 1, "Blocks were not requested ahead");
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* A confirmable message sent from a network buffer keeps a reference to the
+ * buffer while it is pending. Check that the service drops it when the
+ * message is acknowledged, reset or given up on.
+ */
+
+#include <errno.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/coap_service.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/ztest.h>
+
+#define SERVICE_PORT 5683
+#define CLIENT_PORT 5684
+#define BUF_SIZE 64
+#define RELEASE_TIMEOUT K_SECONDS(2)
+
+static const uint16_t service_port = SERVICE_PORT;
+COAP_SERVICE_DEFINE(buf_service, "127.0.0.1", &service_port, COAP_SERVICE_AUTOSTART);
+
+/* A single buffer, so one that is not released fails the next test */
+NET_BUF_POOL_DEFINE(test_pool, 1, BUF_SIZE, 0, NULL);
+
+static const struct coap_transmission_parameters wait_params = {
+	.ack_timeout = 60000,
+	.coap_backoff_percent = 200,
+	.max_retransmission = 1,
+};
+
+static const struct coap_transmission_parameters give_up_params = {
+	.ack_timeout = 100,
+	.coap_backoff_percent = 200,
+	.max_retransmission = 0,
+};
+
+static int client_sock = -1;
+static struct sockaddr_in client_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(CLIENT_PORT),
+	.sin_addr = INADDR_LOOPBACK_INIT,
+};
+
+static void client_recv(uint16_t id)
+{
+	uint8_t data[BUF_SIZE];
+	struct coap_packet msg;
+	ssize_t len;
+
+	do {
+		len = zsock_recv(client_sock, data, sizeof(data), 0);
+		zassert_true(len > 0, "No message (%d)", errno);
+		zassert_ok(coap_packet_parse(&msg, data, len, NULL, 0));
+	} while (coap_header_get_id(&msg) != id);
+}
+
+static void client_reply(uint8_t type, uint16_t id)
+{
+	uint8_t data[8];
+	struct coap_packet reply;
+
+	zassert_ok(coap_packet_init(&reply, data, sizeof(data), COAP_VERSION_1, type, 0, NULL,
+				    COAP_CODE_EMPTY, id));
+	zassert_equal(zsock_send(client_sock, reply.data, reply.offset, 0), reply.offset,
+		      "Failed to send (%d)", errno);
+}
+
+static struct net_buf *server_send(uint16_t id, const struct coap_transmission_parameters *params)
+{
+	static const uint8_t payload[] = "data";
+	struct coap_packet cpkt;
+	struct net_buf *buf;
+
+	buf = net_buf_alloc(&test_pool, K_NO_WAIT);
+	zassert_not_null(buf, "Buffer of an earlier message not released");
+
+	zassert_ok(coap_packet_init_net_buf(&cpkt, buf, COAP_VERSION_1, COAP_TYPE_CON, 0, NULL,
+					    COAP_RESPONSE_CODE_CONTENT, id));
+	zassert_ok(coap_packet_append_payload_marker(&cpkt));
+	zassert_ok(coap_packet_append_payload(&cpkt, payload, sizeof(payload) - 1));
+
+	zassert_ok(coap_service_send_buf(&buf_service, &cpkt, buf,
+					 (struct sockaddr *)&client_addr, sizeof(client_addr),
+					 params));
+	zassert_equal(buf->ref, 2, "Buffer not kept for retransmissions");
+
+	client_recv(id);
+
+	return buf;
+}
+
+static void wait_released(struct net_buf *buf)
+{
+	k_timepoint_t end = sys_timepoint_calc(RELEASE_TIMEOUT);
+
+	while (buf->ref > 1 && !sys_timepoint_expired(end)) {
+		k_msleep(10);
+	}
+
+	zassert_equal(buf->ref, 1, "Buffer still referenced by the service");
+
+	net_buf_unref(buf);
+}
+
+ZTEST(coap_server_send_buf, test_release_on_ack)
+{
+	struct net_buf *buf = server_send(0x100, &wait_params);
+
+	client_reply(COAP_TYPE_ACK, 0x100);
+	wait_released(buf);
+}
+
+ZTEST(coap_server_send_buf, test_release_on_reset)
+{
+	struct net_buf *buf = server_send(0x200, &wait_params);
+
+	client_reply(COAP_TYPE_RESET, 0x200);
+	wait_released(buf);
+}
+
+ZTEST(coap_server_send_buf, test_release_on_give_up)
+{
+	struct net_buf *buf = server_send(0x300, &give_up_params);
+
+	/* Not acknowledged, the service gives up after the timeout */
+	wait_released(buf);
+}
+
+static void *setup(void)
+{
+	struct sockaddr_in server = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVICE_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	struct timeval timeout = {
+		.tv_sec = 2,
+	};
+
+	/* Wait for the service to be started by the server thread */
+	while (coap_service_is_running(&buf_service) != 1) {
+		k_msleep(10);
+	}
+
+	client_sock = zsock_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(client_sock >= 0, "Failed to create socket (%d)", errno);
+	zassert_ok(zsock_setsockopt(client_sock, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+				    sizeof(timeout)));
+	zassert_ok(zsock_bind(client_sock, (struct sockaddr *)&client_addr, sizeof(client_addr)));
+	zassert_ok(zsock_connect(client_sock, (struct sockaddr *)&server, sizeof(server)));
+
+	return NULL;
+}
+
+ZTEST_SUITE(coap_server_send_buf, NULL, setup, NULL, NULL, NULL);
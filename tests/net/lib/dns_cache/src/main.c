@@ -133,3 +133,111 @@ ZTEST(net_dns_cache_test, test_expired_entries_removed)
 	zassert_equal(1, dns_cache_find(&test_dns_cache, query, info_read, 3));
 	zassert_equal(AF_INET, info_read[0].ai_family);
 }
+
+ZTEST(net_dns_cache_test, test_least_recently_used_removed)
+{
+	struct dns_addrinfo info_write = {.ai_family = AF_INET};
+	struct dns_addrinfo info_read = {0};
+	char query[sizeof("example00.com")];
+
+	for (size_t i = 0; i < TEST_DNS_CACHE_SIZE; i++) {
+		snprintk(query, sizeof(query), "example%02zu.com", i);
+		zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write,
+					 TEST_DNS_CACHE_DEFAULT_TTL),
+			   "Cache entry adding should work.");
+	}
+
+	/* Using the oldest entry keeps it while the next oldest one is replaced */
+	zassert_equal(1, dns_cache_find(&test_dns_cache, "example00.com", &info_read, 1));
+	zassert_ok(dns_cache_add(&test_dns_cache, "example.com", &info_write,
+				 TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_equal(1, dns_cache_find(&test_dns_cache, "example00.com", &info_read, 1));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, "example01.com", &info_read, 1));
+	zassert_equal(1, dns_cache_find(&test_dns_cache, "example.com", &info_read, 1));
+}
+
+ZTEST(net_dns_cache_test, test_expired_entry_replaced_first)
+{
+	struct dns_addrinfo info_write = {.ai_family = AF_INET};
+	struct dns_addrinfo info_read = {0};
+	char query[sizeof("example00.com")];
+
+	zassert_ok(dns_cache_add(&test_dns_cache, "expired.com", &info_write,
+				 TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	k_sleep(K_MSEC(TEST_DNS_CACHE_DEFAULT_TTL * 1000 + 1));
+
+	for (size_t i = 0; i < TEST_DNS_CACHE_SIZE; i++) {
+		snprintk(query, sizeof(query), "example%02zu.com", i);
+		zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write,
+					 TEST_DNS_CACHE_DEFAULT_TTL * 2),
+			   "Cache entry adding should work.");
+	}
+
+	zassert_equal(1, dns_cache_find(&test_dns_cache, "example00.com", &info_read, 1));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, "expired.com", &info_read, 1));
+}
+
+ZTEST(net_dns_cache_test, test_remove)
+{
+	struct dns_addrinfo info_write = {.ai_family = AF_INET};
+	struct dns_addrinfo info_read[2] = {0};
+
+	zassert_ok(dns_cache_add(&test_dns_cache, "example.com", &info_write,
+				 TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_ok(dns_cache_add(&test_dns_cache, "example.com", &info_write,
+				 TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_ok(dns_cache_add(&test_dns_cache, "example2.com", &info_write,
+				 TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_ok(dns_cache_remove(&test_dns_cache, "example.com"));
+	zassert_equal(0, dns_cache_find(&test_dns_cache, "example.com", info_read, 2));
+	zassert_equal(1, dns_cache_find(&test_dns_cache, "example2.com", info_read, 2));
+}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE_PREFETCH)
+ZTEST(net_dns_cache_test, test_prefetch)
+{
+	struct dns_addrinfo info_write = {.ai_family = AF_INET, .ai_addrlen = 1};
+	struct dns_addrinfo info_write6 = {.ai_family = AF_INET6};
+	struct dns_addrinfo info_read[2] = {0};
+	const char *query = "example.com";
+	bool prefetch;
+
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write, TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write6, TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+
+	/* Not close enough to expiry yet */
+	for (int i = 0; i < CONFIG_DNS_RESOLVER_CACHE_PREFETCH_HITS; i++) {
+		zassert_equal(2, dns_cache_find_prefetch(&test_dns_cache, query, AF_INET,
+							 info_read, 2, &prefetch));
+		zassert_false(prefetch);
+	}
+
+	k_sleep(K_MSEC(TEST_DNS_CACHE_DEFAULT_TTL * 10 *
+		       (100 - CONFIG_DNS_RESOLVER_CACHE_PREFETCH_PERCENT) + 1));
+
+	zassert_equal(2, dns_cache_find_prefetch(&test_dns_cache, query, AF_INET, info_read, 2,
+						 &prefetch));
+	zassert_true(prefetch);
+
+	/* Only one refresh is requested */
+	zassert_equal(2, dns_cache_find_prefetch(&test_dns_cache, query, AF_INET, info_read, 2,
+						 &prefetch));
+	zassert_false(prefetch);
+
+	/* The answer replaces the IPv4 entry only */
+	info_write.ai_addrlen = 2;
+	zassert_ok(dns_cache_add(&test_dns_cache, query, &info_write, TEST_DNS_CACHE_DEFAULT_TTL),
+		   "Cache entry adding should work.");
+	zassert_equal(2, dns_cache_find(&test_dns_cache, query, info_read, 2));
+	zassert_equal(AF_INET6, info_read[0].ai_family);
+	zassert_equal(AF_INET, info_read[1].ai_family);
+	zassert_equal(2, info_read[1].ai_addrlen);
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE_PREFETCH */
@@ -0,0 +1,331 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Differential test of the HTTP/1 header scanning. Generated requests are
+ * parsed in one go and in random chunks, at random buffer alignments. The
+ * reported header fields and values must be the generated ones, and a
+ * corrupted request must fail with the same error at the same offset
+ * however it is split. The testcase runs with and without
+ * CONFIG_HTTP_PARSER_FAST_SCAN, so both ways of finding the end of a line
+ * are held against the same expectations.
+ *
+ * The parser checks the bytes of a header value one by one only at the start
+ * of a buffer, so corrupted requests are split at line starts only.
+ */
+
+#include <string.h>
+
+#include <zephyr/net/http/parser.h>
+#include <zephyr/ztest.h>
+
+#define ROUNDS      300
+#define MAX_HEADERS 12
+#define MAX_NAME    24
+#define MAX_VALUE   120
+
+struct trace {
+	char buf[2304];
+	size_t len;
+	char last;
+	bool overflow;
+};
+
+static struct http_parser parser;
+static struct http_parser_settings settings;
+static struct trace expected;
+static struct trace actual;
+static char request[2048];
+static size_t line_starts[MAX_HEADERS + 2];
+static int line_count;
+static char aligned[sizeof(request) + 16];
+static uint32_t rand_state;
+
+static uint32_t next_rand(void)
+{
+	/* xorshift32, the sequence must not depend on the platform */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static uint32_t rand_range(uint32_t min, uint32_t max)
+{
+	return min + next_rand() % (max - min + 1);
+}
+
+/* Data of consecutive callbacks of the same kind is joined, so that the
+ * trace does not depend on where the input was split.
+ */
+static void trace_add(struct trace *t, char kind, const char *at, size_t length)
+{
+	if (t->last != kind || at == NULL) {
+		if (t->len + 2 > sizeof(t->buf)) {
+			t->overflow = true;
+			return;
+		}
+
+		t->buf[t->len++] = '\n';
+		t->buf[t->len++] = kind;
+		t->last = kind;
+	}
+
+	if (length > sizeof(t->buf) - t->len) {
+		t->overflow = true;
+		return;
+	}
+
+	memcpy(&t->buf[t->len], at, length);
+	t->len += length;
+}
+
+static int on_url(struct http_parser *p, const char *at, size_t length)
+{
+	trace_add(&actual, 'U', at, length);
+
+	return 0;
+}
+
+static int on_header_field(struct http_parser *p, const char *at, size_t length)
+{
+	trace_add(&actual, 'F', at, length);
+
+	return 0;
+}
+
+static int on_header_value(struct http_parser *p, const char *at, size_t length)
+{
+	trace_add(&actual, 'V', at, length);
+
+	return 0;
+}
+
+static int on_headers_complete(struct http_parser *p)
+{
+	trace_add(&actual, 'H', NULL, 0);
+
+	return 0;
+}
+
+static int on_message_complete(struct http_parser *p)
+{
+	trace_add(&actual, 'M', NULL, 0);
+
+	return 0;
+}
+
+static char rand_token_char(void)
+{
+	static const char token[] = "abcdefghijklmnopqrstuvwxyz"
+				    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+				    "0123456789!#$%&'*+-.^_`|~";
+
+	return token[rand_range(0, sizeof(token) - 2)];
+}
+
+/* Printable characters, tabs and obs-text, so that the word at a time scan
+ * sees bytes on both sides of CR and LF.
+ */
+static char rand_value_char(bool edge)
+{
+	uint32_t r = rand_range(0, 99);
+
+	if (edge) {
+		return (char)rand_range('!', '~');
+	} else if (r < 5) {
+		return '\t';
+	} else if (r < 10) {
+		return (char)rand_range(0x80, 0xff);
+	}
+
+	return (char)rand_range(' ', '~');
+}
+
+static size_t generate_request(void)
+{
+	size_t len = 0;
+	int headers = rand_range(0, MAX_HEADERS);
+	char *value;
+	int n;
+
+	memset(&expected, 0, sizeof(expected));
+	line_count = 0;
+
+	len += sprintf(&request[len], "GET /");
+	n = rand_range(0, 40);
+	for (int i = 0; i < n; i++) {
+		request[len++] = rand_token_char();
+	}
+
+	trace_add(&expected, 'U', &request[4], len - 4);
+	len += sprintf(&request[len], " HTTP/1.1\r\n");
+
+	for (int h = 0; h < headers; h++) {
+		line_starts[line_count++] = len;
+
+		/* Keep clear of the headers the parser interprets */
+		request[len++] = 'X';
+		request[len++] = '-';
+		n = rand_range(1, MAX_NAME);
+		for (int i = 0; i < n; i++) {
+			request[len++] = rand_token_char();
+		}
+
+		trace_add(&expected, 'F', &request[len - n - 2], n + 2);
+		request[len++] = ':';
+
+		/* Leading whitespace is not part of the value */
+		n = rand_range(0, 3);
+		for (int i = 0; i < n; i++) {
+			request[len++] = ' ';
+		}
+
+		value = &request[len];
+		n = rand_range(0, MAX_VALUE);
+		for (int i = 0; i < n; i++) {
+			request[len++] = rand_value_char(i == 0 || i == n - 1);
+		}
+
+		trace_add(&expected, 'V', value, n);
+		request[len++] = '\r';
+		request[len++] = '\n';
+	}
+
+	line_starts[line_count++] = len;
+	request[len++] = '\r';
+	request[len++] = '\n';
+
+	trace_add(&expected, 'H', NULL, 0);
+	trace_add(&expected, 'M', NULL, 0);
+
+	zassert_false(expected.overflow, "Expected trace too long");
+
+	return len;
+}
+
+/* Parse the request from a buffer at the given alignment, in chunks of at
+ * most max_chunk bytes, or if max_chunk is 0 in chunks ending at randomly
+ * picked line starts. Returns the number of bytes parsed.
+ */
+static size_t parse(size_t len, size_t offset, size_t max_chunk)
+{
+	const char *data = &aligned[offset];
+	size_t parsed = 0;
+	int line = 0;
+	size_t chunk;
+	size_t ret;
+
+	memcpy(&aligned[offset], request, len);
+	memset(&actual, 0, sizeof(actual));
+	http_parser_init(&parser, HTTP_REQUEST);
+
+	while (parsed < len) {
+		if (max_chunk > 0) {
+			chunk = rand_range(1, max_chunk);
+			chunk = MIN(chunk, len - parsed);
+		} else {
+			while (line < line_count &&
+			       (line_starts[line] <= parsed || rand_range(0, 1) == 0)) {
+				line++;
+			}
+
+			chunk = (line < line_count ? line_starts[line] : len) - parsed;
+		}
+
+		ret = http_parser_execute(&parser, &settings, &data[parsed], chunk);
+		parsed += ret;
+
+		if (ret != chunk || parser.http_errno != HPE_OK) {
+			break;
+		}
+	}
+
+	zassert_false(actual.overflow, "Trace too long");
+
+	return parsed;
+}
+
+ZTEST(http_parser, test_header_scan)
+{
+	size_t len, parsed;
+
+	rand_state = 0x2545f491;
+
+	for (int round = 0; round < ROUNDS; round++) {
+		len = generate_request();
+
+		/* In one go, then in small and in large chunks */
+		for (int i = 0; i < 3; i++) {
+			parsed = parse(len, rand_range(0, 15),
+				       i == 0 ? len : (i == 1 ? 7 : 200));
+
+			zassert_equal(parser.http_errno, HPE_OK,
+				      "Round %d: error %d at %zu", round,
+				      parser.http_errno, parsed);
+			zassert_equal(parsed, len, "Round %d: request not parsed",
+				      round);
+			zassert_equal(actual.len, expected.len,
+				      "Round %d: trace differs in length", round);
+			zassert_mem_equal(actual.buf, expected.buf, expected.len,
+					  "Round %d: trace differs", round);
+		}
+	}
+}
+
+ZTEST(http_parser, test_corrupted_header_scan)
+{
+	enum http_errno whole_errno;
+	size_t len, whole_parsed, parsed;
+	size_t pos;
+
+	rand_state = 0x9e3779b9;
+
+	for (int round = 0; round < ROUNDS; round++) {
+		len = generate_request();
+
+		/* Overwrite a byte, often with one that ends or breaks a line */
+		pos = rand_range(0, len - 1);
+		switch (rand_range(0, 3)) {
+		case 0:
+			request[pos] = '\r';
+			break;
+		case 1:
+			request[pos] = '\n';
+			break;
+		default:
+			request[pos] = (char)rand_range(0, 0xff);
+			break;
+		}
+
+		whole_parsed = parse(len, rand_range(0, 15), len);
+		whole_errno = parser.http_errno;
+
+		for (int i = 0; i < 2; i++) {
+			parsed = parse(len, rand_range(0, 15), 0);
+
+			zassert_equal(parser.http_errno, whole_errno,
+				      "Round %d: error %d, expected %d", round,
+				      parser.http_errno, whole_errno);
+			zassert_equal(parsed, whole_parsed,
+				      "Round %d: stopped at %zu, expected %zu",
+				      round, parsed, whole_parsed);
+		}
+	}
+}
+
+static void *http_parser_setup(void)
+{
+	settings.on_url = on_url;
+	settings.on_header_field = on_header_field;
+	settings.on_header_value = on_header_value;
+	settings.on_headers_complete = on_headers_complete;
+	settings.on_message_complete = on_message_complete;
+
+	return NULL;
+}
+
+ZTEST_SUITE(http_parser, NULL, http_parser_setup, NULL, NULL, NULL);
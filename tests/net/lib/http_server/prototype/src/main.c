@@ -63,6 +63,127 @@ struct http_resource_detail_static index_html_gz_resource_detail = {
 HTTP_RESOURCE_DEFINE(index_html_gz_resource, test_http_service, "/",
 		     &index_html_gz_resource_detail);
 
+HTTP_RESOURCE_DEFINE(user_resource, test_http_service, "/users/{id}",
+		     &index_html_gz_resource_detail);
+HTTP_RESOURCE_DEFINE(user_posts_resource, test_http_service, "/users/{id}/posts",
+		     &index_html_gz_resource_detail);
+HTTP_RESOURCE_DEFINE(user_me_resource, test_http_service, "/users/me",
+		     &index_html_gz_resource_detail);
+HTTP_RESOURCE_DEFINE(static_resource, test_http_service, "/static/*",
+		     &index_html_gz_resource_detail);
+
+static const char big_data[32768];
+struct http_resource_detail_static big_resource_detail = {
+	.common = {
+			.type = HTTP_RESOURCE_TYPE_STATIC,
+			.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		},
+	.static_data = big_data,
+	.static_data_len = sizeof(big_data),
+};
+
+HTTP_RESOURCE_DEFINE(big_resource, test_http_service, "/big",
+		     &big_resource_detail);
+
+/* A dynamic resource whose handler blocks on its first call, so that a
+ * second client can be served by another worker in the meantime.
+ */
+static K_SEM_DEFINE(slow_entered, 0, 1);
+static K_SEM_DEFINE(slow_release, 0, 1);
+static uint8_t slow_buffer[4];
+static char slow_received[32];
+static size_t slow_received_len;
+static bool slow_blocked;
+
+static int slow_cb(struct http_client_ctx *client, enum http_data_status status,
+		   uint8_t *buffer, size_t len, void *user_data)
+{
+	if (!slow_blocked) {
+		slow_blocked = true;
+		k_sem_give(&slow_entered);
+		(void)k_sem_take(&slow_release, K_SECONDS(2));
+	}
+
+	len = MIN(len, sizeof(slow_received) - 1 - slow_received_len);
+	memcpy(&slow_received[slow_received_len], buffer, len);
+	slow_received_len += len;
+
+	/* Echo the query back */
+	return len;
+}
+
+struct http_resource_detail_dynamic slow_resource_detail = {
+	.common = {
+			.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+			.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		},
+	.cb = slow_cb,
+	.data_buffer = slow_buffer,
+	.data_buffer_len = sizeof(slow_buffer),
+};
+
+HTTP_RESOURCE_DEFINE(slow_resource, test_http_service, "/slow/{id}",
+		     &slow_resource_detail);
+
+/* Magic, SETTINGS[0] with a 16 kB initial window, HEADERS[1]: GET /big with
+ * priority fields, HEADERS[3]: GET /
+ */
+static const unsigned char interleave_frames[] = {
+	/* Magic */
+	0x50, 0x52, 0x49, 0x20, 0x2a, 0x20, 0x48, 0x54, 0x54, 0x50, 0x2f, 0x32,
+	0x2e, 0x30, 0x0d, 0x0a, 0x0d, 0x0a, 0x53, 0x4d, 0x0d, 0x0a, 0x0d, 0x0a,
+	/* SETTINGS[0]: SETTINGS_INITIAL_WINDOW_SIZE 16384 */
+	0x00, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x04, 0x00, 0x00, 0x40, 0x00,
+	/* HEADERS[1]: GET /big, depends on 0, weight 16 */
+	0x00, 0x00, 0x0d, 0x01, 0x25, 0x00, 0x00, 0x00, 0x01,
+	0x00, 0x00, 0x00, 0x00, 0x0f,
+	0x82, 0x86, 0x04, 0x04, 0x2f, 0x62, 0x69, 0x67,
+	/* HEADERS[3]: GET / */
+	0x00, 0x00, 0x03, 0x01, 0x05, 0x00, 0x00, 0x00, 0x03,
+	0x82, 0x86, 0x84,
+};
+
+/* Magic, SETTINGS[0] with an initial window above the maximum */
+static const unsigned char large_window_frames[] = {
+	/* Magic */
+	0x50, 0x52, 0x49, 0x20, 0x2a, 0x20, 0x48, 0x54, 0x54, 0x50, 0x2f, 0x32,
+	0x2e, 0x30, 0x0d, 0x0a, 0x0d, 0x0a, 0x53, 0x4d, 0x0d, 0x0a, 0x0d, 0x0a,
+	/* SETTINGS[0]: SETTINGS_INITIAL_WINDOW_SIZE 2^31 */
+	0x00, 0x00, 0x06, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x04, 0x80, 0x00, 0x00, 0x00,
+};
+
+/* Magic, SETTINGS[0], HEADERS[1]: GET / with one byte of padding */
+static const unsigned char padded_frames[] = {
+	/* Magic */
+	0x50, 0x52, 0x49, 0x20, 0x2a, 0x20, 0x48, 0x54, 0x54, 0x50, 0x2f, 0x32,
+	0x2e, 0x30, 0x0d, 0x0a, 0x0d, 0x0a, 0x53, 0x4d, 0x0d, 0x0a, 0x0d, 0x0a,
+	/* SETTINGS[0] */
+	0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+	/* HEADERS[1]: GET /, padded */
+	0x00, 0x00, 0x05, 0x01, 0x0d, 0x00, 0x00, 0x00, 0x01,
+	0x01, 0x82, 0x86, 0x84, 0x00,
+};
+
+/* Magic, SETTINGS[0], HEADERS[1]: padding as long as the frame */
+static const unsigned char bad_padding_frames[] = {
+	/* Magic */
+	0x50, 0x52, 0x49, 0x20, 0x2a, 0x20, 0x48, 0x54, 0x54, 0x50, 0x2f, 0x32,
+	0x2e, 0x30, 0x0d, 0x0a, 0x0d, 0x0a, 0x53, 0x4d, 0x0d, 0x0a, 0x0d, 0x0a,
+	/* SETTINGS[0] */
+	0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+	/* HEADERS[1]: 4 bytes of padding in a 4 byte frame */
+	0x00, 0x00, 0x04, 0x01, 0x0d, 0x00, 0x00, 0x00, 0x01,
+	0x04, 0x82, 0x86, 0x84,
+};
+
+/* WINDOW_UPDATE[1]: 16384 */
+static const unsigned char window_update_frame[] = {
+	0x00, 0x00, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00, 0x01,
+	0x00, 0x00, 0x40, 0x00,
+};
+
 static void test_streams(void)
 {
 	int ret;
@@ -196,6 +317,125 @@ ZTEST(server_function_tests, test_http_concurrent_streams)
 	test_streams();
 }
 
+struct frame_info {
+	uint32_t length;
+	uint32_t stream_id;
+	uint8_t type;
+	uint8_t flags;
+	uint8_t head[8];
+};
+
+static void recv_frame(int fd, struct frame_info *info)
+{
+	static uint8_t payload[256];
+	uint8_t hdr[9];
+	size_t left;
+	int ret;
+
+	ret = zsock_recv(fd, hdr, sizeof(hdr), ZSOCK_MSG_WAITALL);
+	zassert_equal(ret, sizeof(hdr), "recv() failed (%d)", errno);
+
+	info->length = (hdr[0] << 16) | (hdr[1] << 8) | hdr[2];
+	info->type = hdr[3];
+	info->flags = hdr[4];
+	info->stream_id = ((hdr[5] << 24) | (hdr[6] << 16) | (hdr[7] << 8) | hdr[8]) &
+			  0x7fffffff;
+
+	memset(info->head, 0, sizeof(info->head));
+
+	for (left = info->length; left > 0; left -= ret) {
+		ret = zsock_recv(fd, payload, MIN(left, sizeof(payload)),
+				 ZSOCK_MSG_WAITALL);
+		zassert_true(ret > 0, "recv() failed (%d)", errno);
+
+		if (left == info->length) {
+			memcpy(info->head, payload, MIN(ret, sizeof(info->head)));
+		}
+	}
+}
+
+ZTEST(server_function_tests, test_http2_interleaved_streams)
+{
+	struct zsock_pollfd pfd;
+	struct sockaddr_in sa = { 0 };
+	struct frame_info info;
+	size_t big_received = 0;
+	bool small_done = false;
+	bool big_done = false;
+	int client_fd;
+	int ret;
+
+	zassert_ok(http_server_start(), "Failed to start the server");
+
+	client_fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_not_equal(client_fd, -1, "failed to create client socket (%d)", errno);
+
+	sa.sin_family = AF_INET;
+	sa.sin_port = htons(SERVER_PORT);
+	ret = zsock_inet_pton(AF_INET, MY_IPV4_ADDR, &sa.sin_addr.s_addr);
+	zassert_equal(1, ret, "inet_pton() failed to convert %s", MY_IPV4_ADDR);
+
+	ret = zsock_connect(client_fd, (struct sockaddr *)&sa, sizeof(sa));
+	zassert_not_equal(ret, -1, "failed to connect (%d)", errno);
+
+	ret = zsock_send(client_fd, interleave_frames, sizeof(interleave_frames), 0);
+	zassert_equal(ret, sizeof(interleave_frames), "send() failed (%d)", errno);
+
+	/* The small response overtakes the large one, which stops once the
+	 * 16 kB stream window is used up.
+	 */
+	while (!small_done || big_received < 16384) {
+		recv_frame(client_fd, &info);
+
+		if (info.type != HTTP_SERVER_DATA_FRAME) {
+			continue;
+		}
+
+		zassert_true(info.length <= CONFIG_HTTP_SERVER_HTTP2_DATA_CHUNK_SIZE,
+			     "DATA frame too large (%u)", info.length);
+
+		if (info.stream_id == 3) {
+			zassert_true(info.flags & HTTP_SERVER_FLAG_END_STREAM,
+				     "Small response not in a single frame");
+			zassert_true(big_received < sizeof(big_data),
+				     "Small response sent after the large one");
+			small_done = true;
+		} else {
+			zassert_equal(info.stream_id, 1, "Unexpected stream");
+			big_received += info.length;
+		}
+	}
+
+	zassert_equal(big_received, 16384, "Stream window exceeded");
+
+	pfd.fd = client_fd;
+	pfd.events = ZSOCK_POLLIN;
+	ret = zsock_poll(&pfd, 1, 100);
+	zassert_equal(ret, 0, "Data sent without flow control window");
+
+	ret = zsock_send(client_fd, window_update_frame, sizeof(window_update_frame), 0);
+	zassert_equal(ret, sizeof(window_update_frame), "send() failed (%d)", errno);
+
+	while (!big_done) {
+		recv_frame(client_fd, &info);
+
+		if (info.type != HTTP_SERVER_DATA_FRAME) {
+			continue;
+		}
+
+		zassert_equal(info.stream_id, 1, "Unexpected stream");
+		big_received += info.length;
+		big_done = info.flags & HTTP_SERVER_FLAG_END_STREAM;
+	}
+
+	zassert_equal(big_received, sizeof(big_data), "Wrong response length");
+
+	ret = zsock_close(client_fd);
+	zassert_not_equal(-1, ret, "close() failed on the client fd (%d)", errno);
+
+	zassert_ok(http_server_stop(), "Failed to stop the server");
+}
+
 static void test_common(int test_support)
 {
 	int ret;
@@ -281,6 +521,190 @@ ZTEST(server_function_tests, test_backward_compatibility)
 	test_common(SUPPORT_BACKWARD_COMPATIBILITY);
 }
 
+static int connect_client(void)
+{
+	struct sockaddr_in sa = { 0 };
+	int client_fd;
+	int ret;
+
+	sa.sin_family = AF_INET;
+	sa.sin_port = htons(SERVER_PORT);
+
+	ret = zsock_inet_pton(AF_INET, MY_IPV4_ADDR, &sa.sin_addr.s_addr);
+	zassert_equal(1, ret, "inet_pton() failed to convert %s", MY_IPV4_ADDR);
+
+	client_fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_not_equal(client_fd, -1, "failed to create client socket (%d)", errno);
+
+	ret = zsock_connect(client_fd, (struct sockaddr *)&sa, sizeof(sa));
+	zassert_not_equal(ret, -1, "failed to connect (%d)", errno);
+
+	return client_fd;
+}
+
+static void recv_until(int client_fd, char *buf, size_t size, const char *end)
+{
+	struct zsock_pollfd pfd = {
+		.fd = client_fd,
+		.events = ZSOCK_POLLIN,
+	};
+	size_t len = 0;
+	int ret;
+
+	memset(buf, 0, size);
+
+	while (strstr(buf, end) == NULL) {
+		ret = zsock_poll(&pfd, 1, TIMEOUT);
+		zassert_equal(ret, 1, "No response received");
+
+		ret = zsock_recv(client_fd, buf + len, size - 1 - len, 0);
+		zassert_true(ret > 0, "recv() failed (%d)", errno);
+		len += ret;
+	}
+}
+
+ZTEST(server_function_tests, test_http_concurrent_clients)
+{
+	static const char slow_request[] = "GET /slow/1?q=abcdefgh HTTP/1.1\r\n"
+					   "Host: 127.0.0.1:8080\r\n"
+					   "\r\n";
+	static const char other_request[] = "GET /slow/123456?other HTTP/1.1\r\n"
+					    "Host: 127.0.0.1:8080\r\n"
+					    "\r\n";
+	static char buf[256];
+	int slow_fd, other_fd;
+	int ret;
+
+	if (CONFIG_HTTP_SERVER_NUM_WORKERS < 2) {
+		ztest_test_skip();
+	}
+
+	slow_blocked = false;
+	slow_received_len = 0;
+	k_sem_reset(&slow_entered);
+	k_sem_reset(&slow_release);
+
+	zassert_ok(http_server_start(), "Failed to start the server");
+
+	/* Consecutive connections are handed to different workers */
+	slow_fd = connect_client();
+	other_fd = connect_client();
+
+	ret = zsock_send(slow_fd, slow_request, strlen(slow_request), 0);
+	zassert_not_equal(ret, -1, "send() failed (%d)", errno);
+
+	zassert_ok(k_sem_take(&slow_entered, K_SECONDS(1)),
+		   "Handler not called");
+
+	/* The first worker is blocked in the handler. The other one looks up
+	 * the same resource with another path length and reports it busy.
+	 */
+	ret = zsock_send(other_fd, other_request, strlen(other_request), 0);
+	zassert_not_equal(ret, -1, "send() failed (%d)", errno);
+
+	recv_until(other_fd, buf, sizeof(buf), "\r\n\r\n");
+	zassert_mem_equal(buf, "HTTP/1.1 409 Conflict\r\n", 23,
+			  "Unexpected response");
+
+	k_sem_give(&slow_release);
+
+	recv_until(slow_fd, buf, sizeof(buf), "\r\n0\r\n\r\n");
+	zassert_mem_equal(buf, "HTTP/1.1 200 OK\r\n", 17, "Unexpected response");
+
+	/* The handler got the query of its own request */
+	zassert_equal(slow_received_len, strlen("?q=abcdefgh"),
+		      "Wrong query length");
+	zassert_mem_equal(slow_received, "?q=abcdefgh", slow_received_len,
+			  "Wrong query");
+
+	/* The path length is kept per client, the shared resource detail
+	 * is left untouched.
+	 */
+	zassert_equal(slow_resource_detail.common.path_len, 0,
+		      "Resource detail modified");
+
+	ret = zsock_close(other_fd);
+	zassert_not_equal(-1, ret, "close() failed on the client fd (%d)", errno);
+	ret = zsock_close(slow_fd);
+	zassert_not_equal(-1, ret, "close() failed on the client fd (%d)", errno);
+
+	zassert_ok(http_server_stop(), "Failed to stop the server");
+}
+
+static void test_goaway(const unsigned char *frames, size_t len,
+			uint32_t error_code)
+{
+	struct frame_info info;
+	uint8_t byte;
+	int client_fd;
+	int ret;
+
+	zassert_ok(http_server_start(), "Failed to start the server");
+
+	client_fd = connect_client();
+
+	ret = zsock_send(client_fd, frames, len, 0);
+	zassert_equal(ret, len, "send() failed (%d)", errno);
+
+	do {
+		recv_frame(client_fd, &info);
+	} while (info.type != HTTP_SERVER_GOAWAY_FRAME);
+
+	zassert_equal(info.length, 8, "Wrong GOAWAY length");
+	zassert_equal((info.head[4] << 24) | (info.head[5] << 16) |
+		      (info.head[6] << 8) | info.head[7], error_code,
+		      "Wrong error code");
+
+	/* The server closes the connection after GOAWAY */
+	ret = zsock_recv(client_fd, &byte, sizeof(byte), 0);
+	zassert_true(ret <= 0, "Connection not closed");
+
+	ret = zsock_close(client_fd);
+	zassert_not_equal(-1, ret, "close() failed on the client fd (%d)", errno);
+
+	zassert_ok(http_server_stop(), "Failed to stop the server");
+}
+
+ZTEST(server_function_tests, test_http2_large_initial_window)
+{
+	test_goaway(large_window_frames, sizeof(large_window_frames),
+		    HTTP_SERVER_FLOW_CONTROL_ERROR);
+}
+
+ZTEST(server_function_tests, test_http2_padded_headers)
+{
+	struct frame_info info;
+	int client_fd;
+	int ret;
+
+	zassert_ok(http_server_start(), "Failed to start the server");
+
+	client_fd = connect_client();
+
+	ret = zsock_send(client_fd, padded_frames, sizeof(padded_frames), 0);
+	zassert_equal(ret, sizeof(padded_frames), "send() failed (%d)", errno);
+
+	/* The padding is skipped and the request is served */
+	do {
+		recv_frame(client_fd, &info);
+		zassert_not_equal(info.type, HTTP_SERVER_GOAWAY_FRAME,
+				  "Padded frame rejected");
+	} while (info.type != HTTP_SERVER_HEADERS_FRAME);
+
+	zassert_equal(info.stream_id, 1, "Wrong stream");
+
+	ret = zsock_close(client_fd);
+	zassert_not_equal(-1, ret, "close() failed on the client fd (%d)", errno);
+
+	zassert_ok(http_server_stop(), "Failed to stop the server");
+}
+
+ZTEST(server_function_tests, test_http2_bad_padding)
+{
+	test_goaway(bad_padding_frames, sizeof(bad_padding_frames),
+		    HTTP_SERVER_PROTOCOL_ERROR);
+}
+
 ZTEST(server_function_tests, test_http_server_start_stop)
 {
 	struct sockaddr_in sa = { 0 };
@@ -317,6 +741,126 @@ ZTEST(server_function_tests, test_http_server_start_stop)
 	zassert_ok(http_server_stop(), "Failed to stop the server");
 }
 
+static void check_route(const char *path, bool found, int expected_len)
+{
+	struct http_resource_detail *detail;
+	int path_len = -1;
+
+	detail = get_resource_detail(path, &path_len, false);
+	if (!found) {
+		zassert_is_null(detail, "Unexpected match for %s", path);
+		return;
+	}
+
+	zassert_not_null(detail, "No match for %s", path);
+	zassert_equal(path_len, expected_len, "Wrong path length for %s", path);
+
+	/* Still updated for the applications using it with a single thread */
+	if (CONFIG_HTTP_SERVER_NUM_WORKERS == 1) {
+		zassert_equal(detail->path_len, expected_len,
+			      "Resource detail not updated for %s", path);
+	}
+}
+
+ZTEST(server_function_tests, test_get_resource_detail)
+{
+	int path_len;
+
+	zassert_ok(http_server_route_init(), "Failed to build resource tree");
+
+	check_route("/", true, 1);
+	check_route("/?param=value", true, 1);
+	check_route("/index.html", false, 0);
+	check_route("/users/me", true, 9);
+	check_route("/users/42", true, 9);
+	check_route("/users/42?param=value", true, 9);
+	check_route("/users/42/posts", true, 15);
+	check_route("/users/42/other", false, 0);
+	check_route("/users/", false, 0);
+	check_route("/static/", true, 8);
+	check_route("/static/js/app.js", true, 8);
+	check_route("/static", false, 0);
+
+	zassert_is_null(get_resource_detail("/", &path_len, true),
+			"Websocket lookup matched a static resource");
+}
+
+static bool accepts_gzip(const char *value)
+{
+	struct http_client_ctx client = { 0 };
+
+	http_server_parse_accept_encoding(&client, value, strlen(value));
+
+	return client.accept_gzip;
+}
+
+static bool not_modified(struct http_client_ctx *client, const char *value,
+			 const char *etag)
+{
+	http_server_set_if_none_match(client, value, strlen(value));
+
+	return http_server_static_not_modified(client, etag);
+}
+
+ZTEST(server_function_tests, test_static_negotiation)
+{
+	static const char data[] = "data";
+	struct http_resource_detail_static detail = {
+		.common = {
+			.type = HTTP_RESOURCE_TYPE_STATIC,
+			.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		},
+		.static_data = data,
+		.static_data_len = sizeof(data),
+		.static_gzip_data = data,
+		.static_gzip_data_len = sizeof(data),
+		.etag = "\"0123456789abcdef\"",
+	};
+	char etag_buf[HTTP_SERVER_MAX_ETAG_LEN];
+	struct http_client_ctx client = { 0 };
+	const char *etag;
+
+	zassert_true(accepts_gzip("gzip"), "");
+	zassert_true(accepts_gzip("deflate, GZIP;q=0.5, br"), "");
+	zassert_true(accepts_gzip("*"), "");
+	zassert_false(accepts_gzip("gzip;q=0"), "");
+	zassert_false(accepts_gzip("gzip;q=0.000, *"), "");
+	zassert_false(accepts_gzip("deflate, br"), "");
+	zassert_false(accepts_gzip("gzipped"), "");
+	zassert_false(accepts_gzip(""), "");
+
+	zassert_false(http_server_static_use_gzip(&client, &detail), "");
+	etag = http_server_static_etag(&client, &detail, etag_buf, sizeof(etag_buf));
+	zassert_equal(etag, detail.etag, "Wrong plain variant tag");
+	client.accept_gzip = true;
+	zassert_true(http_server_static_use_gzip(&client, &detail), "");
+
+	/* Each variant has its own entity tag */
+	etag = http_server_static_etag(&client, &detail, etag_buf, sizeof(etag_buf));
+	zassert_not_null(etag, "No gzip variant tag");
+	zassert_equal(strcmp(etag, "\"0123456789abcdef-gz\""), 0,
+		      "Wrong gzip variant tag %s", etag);
+	zassert_is_null(http_server_static_etag(&client, &detail, etag_buf, 20), "");
+
+	zassert_false(not_modified(&client, "", etag), "");
+	zassert_true(not_modified(&client, "\"0123456789abcdef-gz\"", etag), "");
+	zassert_true(not_modified(&client, "\"other\", W/\"0123456789abcdef-gz\"", etag),
+		     "");
+	zassert_true(not_modified(&client, "*", etag), "");
+
+	/* The plain variant tag does not match the gzip variant */
+	zassert_false(not_modified(&client, "\"0123456789abcdef\"", etag), "");
+
+	/* Entity tags are compared exactly, not as substrings */
+	zassert_false(not_modified(&client, "\"x\"0123456789abcdef-gz\"", etag), "");
+	zassert_false(not_modified(&client, "\"0123456789abcdef-gz\"x", etag), "");
+	zassert_false(not_modified(&client, "\"0123456789abcdef-gz", etag), "");
+	zassert_false(not_modified(&client, "\"0123456789abcdee-gz\"", etag), "");
+	zassert_false(not_modified(&client, "w/\"0123456789abcdef-gz\"", etag), "");
+
+	zassert_false(not_modified(&client, "*", NULL), "");
+}
+
 ZTEST(server_function_tests, test_get_frame_type_name)
 {
 	zassert_equal(strcmp(get_frame_type_name(HTTP_SERVER_DATA_FRAME), "DATA"), 0,
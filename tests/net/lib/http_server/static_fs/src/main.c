@@ -0,0 +1,194 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "server_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <ff.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/net/http/service.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/ztest.h>
+
+#define MY_IPV4_ADDR "127.0.0.1"
+#define SERVER_PORT  8080
+
+#define FATFS_MNTP "/RAM:"
+#define TEST_FILE  FATFS_MNTP "/index.htm"
+
+/* Larger than the loopback MTU so that the body spans several segments */
+#define TEST_FILE_LEN 3000
+
+static FATFS fat_fs;
+
+static struct fs_mount_t fatfs_mnt = {
+	.type = FS_FATFS,
+	.mnt_point = FATFS_MNTP,
+	.fs_data = &fat_fs,
+};
+
+static uint8_t file_data[TEST_FILE_LEN];
+static uint8_t buf[TEST_FILE_LEN + 256];
+
+static uint16_t test_http_service_port = SERVER_PORT;
+HTTP_SERVICE_DEFINE(test_http_service, MY_IPV4_ADDR,
+		    &test_http_service_port, 1,
+		    10, NULL);
+
+static struct http_resource_detail_static_fs index_resource_detail = {
+	.common = {
+			.type = HTTP_RESOURCE_TYPE_STATIC_FS,
+			.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		},
+	.fs_path = TEST_FILE,
+};
+
+HTTP_RESOURCE_DEFINE(index_resource, test_http_service, "/index.html",
+		     &index_resource_detail);
+
+static struct http_resource_detail_static_fs missing_resource_detail = {
+	.common = {
+			.type = HTTP_RESOURCE_TYPE_STATIC_FS,
+			.bitmask_of_supported_http_methods = BIT(HTTP_GET),
+		},
+	.fs_path = FATFS_MNTP "/missing.htm",
+};
+
+HTTP_RESOURCE_DEFINE(missing_resource, test_http_service, "/missing.html",
+		     &missing_resource_detail);
+
+static int client_fd = -1;
+
+/* Send the request and read until the server closes the connection */
+static size_t get(const char *request)
+{
+	size_t recv_len = 0;
+	int ret;
+
+	ret = zsock_send(client_fd, request, strlen(request), 0);
+	zassert_not_equal(ret, -1, "send() failed (%d)", errno);
+
+	do {
+		ret = zsock_recv(client_fd, buf + recv_len,
+				 sizeof(buf) - 1 - recv_len, 0);
+		zassert_not_equal(ret, -1, "recv() failed (%d)", errno);
+
+		recv_len += ret;
+	} while (ret > 0 && recv_len < sizeof(buf) - 1);
+
+	buf[recv_len] = '\0';
+
+	return recv_len;
+}
+
+ZTEST(server_static_fs, test_get_file)
+{
+	const char *request = "GET /index.html HTTP/1.1\r\n"
+			      "Host: 127.0.0.1:8080\r\n"
+			      "Connection: close\r\n"
+			      "\r\n";
+	const char *length;
+	const char *body;
+	size_t recv_len;
+
+	recv_len = get(request);
+
+	zassert_mem_equal(buf, "HTTP/1.1 200 OK\r\n", 17, "Wrong status");
+
+	length = strstr(buf, "Content-Length: ");
+	zassert_not_null(length, "No Content-Length");
+	zassert_equal(strtoul(length + 16, NULL, 10), TEST_FILE_LEN,
+		      "Wrong Content-Length");
+
+	body = strstr(buf, "\r\n\r\n");
+	zassert_not_null(body, "Header not found");
+	body += 4;
+
+	zassert_equal(recv_len - (body - (const char *)buf), TEST_FILE_LEN,
+		      "Wrong body length");
+	zassert_mem_equal(body, file_data, TEST_FILE_LEN, "Wrong body");
+}
+
+ZTEST(server_static_fs, test_missing_file)
+{
+	const char *request = "GET /missing.html HTTP/1.1\r\n"
+			      "Host: 127.0.0.1:8080\r\n"
+			      "Connection: close\r\n"
+			      "\r\n";
+
+	(void)get(request);
+
+	zassert_mem_equal(buf, "HTTP/1.1 404 Not Found\r\n", 24, "Wrong status");
+}
+
+static void *setup(void)
+{
+	struct fs_file_t file;
+	ssize_t written;
+
+	zassert_ok(fs_mount(&fatfs_mnt), "mount failed");
+
+	for (size_t i = 0; i < sizeof(file_data); i++) {
+		file_data[i] = 'a' + i % 26;
+	}
+
+	fs_file_t_init(&file);
+	zassert_ok(fs_open(&file, TEST_FILE, FS_O_CREATE | FS_O_WRITE),
+		   "open for writing failed");
+	written = fs_write(&file, file_data, sizeof(file_data));
+	zassert_equal(written, sizeof(file_data), "write failed (%d)", written);
+	zassert_ok(fs_close(&file), "close failed");
+
+	zassert_ok(http_server_start(), "Failed to start the server");
+
+	return NULL;
+}
+
+static void teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(http_server_stop(), "Failed to stop the server");
+
+	(void)fs_unlink(TEST_FILE);
+	(void)fs_unmount(&fatfs_mnt);
+}
+
+static void before(void *fixture)
+{
+	struct zsock_timeval tv = { .tv_sec = 1 };
+	struct sockaddr_in sa;
+	int ret;
+
+	ARG_UNUSED(fixture);
+
+	client_fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_not_equal(client_fd, -1, "failed to create client socket (%d)", errno);
+
+	zassert_ok(zsock_setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO,
+				    &tv, sizeof(tv)));
+
+	sa.sin_family = AF_INET;
+	sa.sin_port = htons(SERVER_PORT);
+
+	ret = zsock_inet_pton(AF_INET, MY_IPV4_ADDR, &sa.sin_addr.s_addr);
+	zassert_equal(1, ret, "inet_pton() failed to convert %s", MY_IPV4_ADDR);
+
+	ret = zsock_connect(client_fd, (struct sockaddr *)&sa, sizeof(sa));
+	zassert_not_equal(ret, -1, "failed to connect (%d)", errno);
+}
+
+static void after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)zsock_close(client_fd);
+	client_fd = -1;
+}
+
+ZTEST_SUITE(server_static_fs, NULL, setup, before, after, teardown);
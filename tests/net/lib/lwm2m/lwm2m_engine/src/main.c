@@ -255,6 +255,96 @@ ZTEST(lwm2m_engine, test_check_notifications)
 		      "Next observe event not scheduled");
 }
 
+ZTEST(lwm2m_engine, test_check_notifications_batch)
+{
+	int ret;
+	int64_t now;
+	struct lwm2m_ctx ctx;
+	struct observe_node obs[3];
+
+	(void)memset(&ctx, 0x0, sizeof(ctx));
+	(void)memset(obs, 0x0, sizeof(obs));
+
+	ctx.sock_fd = -1;
+	ctx.load_credentials = NULL;
+	ctx.remote_addr.sa_family = AF_INET;
+	sys_slist_init(&ctx.observer);
+
+	now = k_uptime_get();
+
+	/* Due first, opens the batch */
+	obs[0].last_timestamp = now;
+	obs[0].event_timestamp = now + 1000;
+
+	/* Due within the coalescing window, sent with the first one */
+	obs[1].last_timestamp = now;
+	obs[1].min_timestamp = now;
+	obs[1].event_timestamp = now + 1200;
+
+	/* Within the window as well, but held back by pmin */
+	obs[2].last_timestamp = now;
+	obs[2].min_timestamp = now + 1400;
+	obs[2].event_timestamp = now + 1300;
+
+	for (int i = 0; i < ARRAY_SIZE(obs); i++) {
+		sys_slist_append(&ctx.observer, &obs[i].node);
+	}
+
+	lwm2m_rd_client_is_registred_fake.return_val = true;
+	ret = lwm2m_engine_start(&ctx);
+	zassert_equal(ret, 0);
+	k_sleep(K_MSEC(1100));
+	ret = lwm2m_engine_stop(&ctx);
+	zassert_equal(ret, 0);
+	zassert_equal(generate_notify_message_fake.call_count, 2, "Notifications not batched");
+	zassert_equal(generate_notify_message_fake.arg1_history[0], &obs[0]);
+	zassert_equal(generate_notify_message_fake.arg1_history[1], &obs[1]);
+}
+
+ZTEST(lwm2m_engine, test_check_notifications_batch_per_ctx)
+{
+	int ret;
+	int64_t now;
+	struct lwm2m_ctx ctx[2];
+	struct observe_node obs[2];
+
+	(void)memset(ctx, 0x0, sizeof(ctx));
+	(void)memset(obs, 0x0, sizeof(obs));
+
+	now = k_uptime_get();
+
+	for (int i = 0; i < ARRAY_SIZE(ctx); i++) {
+		ctx[i].sock_fd = -1;
+		ctx[i].load_credentials = NULL;
+		ctx[i].remote_addr.sa_family = AF_INET;
+		sys_slist_init(&ctx[i].observer);
+
+		obs[i].last_timestamp = now;
+		obs[i].min_timestamp = now;
+		sys_slist_append(&ctx[i].observer, &obs[i].node);
+	}
+
+	/* Due first, opens a batch for its own context only */
+	obs[0].event_timestamp = now + 1000;
+
+	/* Within the window, but belongs to the other context */
+	obs[1].event_timestamp = now + 1200;
+
+	lwm2m_rd_client_is_registred_fake.return_val = true;
+	for (int i = 0; i < ARRAY_SIZE(ctx); i++) {
+		ret = lwm2m_engine_start(&ctx[i]);
+		zassert_equal(ret, 0);
+	}
+	k_sleep(K_MSEC(1100));
+	for (int i = 0; i < ARRAY_SIZE(ctx); i++) {
+		ret = lwm2m_engine_stop(&ctx[i]);
+		zassert_equal(ret, 0);
+	}
+	zassert_equal(generate_notify_message_fake.call_count, 1, "Batch shared by contexts");
+	zassert_equal(generate_notify_message_fake.arg0_history[0], &ctx[0]);
+	zassert_equal(generate_notify_message_fake.arg1_history[0], &obs[0]);
+}
+
 ZTEST(lwm2m_engine, test_push_queued_buffers)
 {
 	int ret;
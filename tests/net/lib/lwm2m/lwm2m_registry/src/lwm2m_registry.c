@@ -563,6 +563,62 @@ ZTEST(lwm2m_registry, test_next_engine_obj_inst)
 	zassert_is_null(lwm2m_engine_get_obj_inst(&LWM2M_OBJ(3303, 1)));
 }
 
+static void check_lookups(struct lwm2m_engine_obj_inst *oi)
+{
+	struct lwm2m_engine_obj *obj = oi->obj;
+
+	for (int i = 0; i < obj->field_count; i++) {
+		zassert_equal(lwm2m_get_engine_obj_field(obj, obj->fields[i].res_id),
+			      &obj->fields[i]);
+	}
+
+	for (int i = 0; i < oi->resource_count; i++) {
+		zassert_equal(lwm2m_get_engine_res(oi, oi->resources[i].res_id),
+			      &oi->resources[i]);
+	}
+
+	zassert_is_null(lwm2m_get_engine_obj_field(obj, 49999));
+	zassert_is_null(lwm2m_get_engine_res(oi, 49999));
+}
+
+ZTEST(lwm2m_registry, test_engine_lookups)
+{
+	struct lwm2m_engine_obj_inst *oi;
+
+	for (int i = 0; i < 4; i++) {
+		zassert_equal(lwm2m_create_object_inst(&LWM2M_OBJ(3303, i)), 0);
+	}
+
+	zassert_equal(lwm2m_delete_object_inst(&LWM2M_OBJ(3303, 1)), 0);
+	zassert_is_null(get_engine_obj_inst(3303, 1));
+
+	for (int i = 0; i < 4; i++) {
+		if (i == 1) {
+			continue;
+		}
+
+		oi = get_engine_obj_inst(3303, i);
+		zassert_not_null(oi);
+		zassert_equal(oi->obj->obj_id, 3303);
+		zassert_equal(oi->obj_inst_id, i);
+		check_lookups(oi);
+	}
+
+	oi = get_engine_obj_inst(TEST_OBJ_ID, 0);
+	zassert_not_null(oi);
+	check_lookups(oi);
+
+	zassert_equal(get_engine_obj(3303), get_engine_obj_inst(3303, 0)->obj);
+	zassert_is_null(get_engine_obj(49999));
+	zassert_is_null(get_engine_obj_inst(49999, 0));
+
+	for (int i = 0; i < 4; i++) {
+		if (i != 1) {
+			zassert_equal(lwm2m_delete_object_inst(&LWM2M_OBJ(3303, i)), 0);
+		}
+	}
+}
+
 ZTEST(lwm2m_registry, test_null_strings)
 {
 	int ret;
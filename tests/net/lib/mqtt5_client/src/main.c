@@ -0,0 +1,589 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* MQTT 5.0 client tests against a broker stand-in, plugged in as the custom
+ * transport. The broker parses what the client writes, records the PUBLISH
+ * messages and answers with canned packets.
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/mqtt.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/ztest.h>
+
+#define BUFFER_SIZE 256
+#define TOPIC_SIZE 32
+#define MAX_PUBLISHED 8
+
+#define TOPIC_TEMPERATURE "sensors/kitchen/temperature"
+#define TOPIC_HUMIDITY "sensors/kitchen/humidity"
+
+static uint8_t rx_buffer[BUFFER_SIZE];
+static uint8_t tx_buffer[BUFFER_SIZE];
+static struct mqtt_client client;
+
+/* Receive Maximum 2, Topic Alias Maximum 1, Maximum Packet Size 128 and an
+ * assigned client identifier.
+ */
+static const uint8_t connack[] = {
+	0x20, 21, 0x00, 0x00, 18,
+	0x21, 0x00, 0x02,
+	0x22, 0x00, 0x01,
+	0x27, 0x00, 0x00, 0x00, 0x80,
+	0x12, 0x00, 0x04, 'a', 'b', 'c', 'd',
+};
+
+struct published {
+	char topic[TOPIC_SIZE];
+	char user_prop[TOPIC_SIZE];
+	uint16_t topic_alias;
+	uint16_t message_id;
+	uint8_t qos;
+	bool topic_sent;
+	size_t len;
+};
+
+static struct broker {
+	/* Packets queued for the client */
+	uint8_t out[BUFFER_SIZE];
+	size_t out_len;
+	size_t out_pos;
+
+	/* Packets written by the client */
+	uint8_t in[BUFFER_SIZE];
+	size_t in_len;
+
+	bool auto_ack;
+	uint8_t protocol_level;
+	uint16_t client_topic_alias_max;
+	char topic_alias[CONFIG_MQTT_TOPIC_ALIAS_MAX][TOPIC_SIZE];
+	struct published published[MAX_PUBLISHED];
+	int published_count;
+	bool disconnected;
+} broker;
+
+static struct {
+	struct mqtt_evt last;
+	char topic[TOPIC_SIZE];
+	char user_prop[TOPIC_SIZE];
+	char payload[8];
+	int count;
+} events;
+
+static size_t varint_decode(const uint8_t *p, uint32_t *value)
+{
+	size_t n = 0;
+
+	*value = 0U;
+
+	do {
+		*value |= (uint32_t)(p[n] & 0x7F) << (7 * n);
+	} while (p[n++] & 0x80);
+
+	return n;
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+	return (p[0] << 8) | p[1];
+}
+
+static void copy_str(char *dst, const uint8_t *src, size_t len)
+{
+	zassert_true(len < TOPIC_SIZE, "String too long");
+	if (len > 0) {
+		memcpy(dst, src, len);
+	}
+	dst[len] = '\0';
+}
+
+static void broker_queue(const uint8_t *data, size_t len)
+{
+	zassert_true(broker.out_len + len <= sizeof(broker.out), "Broker full");
+	memcpy(&broker.out[broker.out_len], data, len);
+	broker.out_len += len;
+}
+
+/* Walks the properties the client may send. */
+static void broker_properties(const uint8_t *p, struct published *pub)
+{
+	const uint8_t *end;
+	uint32_t len;
+
+	p += varint_decode(p, &len);
+	end = p + len;
+
+	while (p < end) {
+		uint8_t id = *p++;
+
+		switch (id) {
+		case 0x01:
+			p += 1;
+			break;
+		case 0x02:
+		case 0x11:
+			p += 4;
+			break;
+		case 0x22:
+			broker.client_topic_alias_max = get_u16(p);
+			p += 2;
+			break;
+		case 0x23:
+			pub->topic_alias = get_u16(p);
+			p += 2;
+			break;
+		case 0x03:
+			p += 2 + get_u16(p);
+			break;
+		case 0x26:
+			/* Only the first name is recorded */
+			if (pub->user_prop[0] == '\0') {
+				copy_str(pub->user_prop, p + 2, get_u16(p));
+			}
+			p += 2 + get_u16(p);
+			p += 2 + get_u16(p);
+			break;
+		default:
+			zassert_unreachable("Unexpected property 0x%02x", id);
+		}
+	}
+}
+
+static void broker_publish(const uint8_t *pkt, const uint8_t *body, size_t len)
+{
+	struct published *pub = &broker.published[broker.published_count++];
+	uint16_t topic_len = get_u16(body);
+	const uint8_t *p = body + 2 + topic_len;
+	uint8_t puback[4] = { 0x40, 0x02 };
+
+	zassert_true(broker.published_count <= MAX_PUBLISHED, "Too many");
+
+	memset(pub, 0, sizeof(*pub));
+	pub->qos = (pkt[0] >> 1) & 0x03;
+	pub->len = len;
+	pub->topic_sent = topic_len > 0;
+
+	if (pub->qos > 0) {
+		pub->message_id = get_u16(p);
+		p += 2;
+	}
+
+	broker_properties(p, pub);
+
+	if (pub->topic_alias != 0) {
+		zassert_true(pub->topic_alias <= 1, "Alias above maximum");
+
+		if (topic_len > 0) {
+			copy_str(broker.topic_alias[pub->topic_alias - 1],
+				 body + 2, topic_len);
+		}
+
+		strcpy(pub->topic, broker.topic_alias[pub->topic_alias - 1]);
+	} else {
+		copy_str(pub->topic, body + 2, topic_len);
+	}
+
+	if (pub->qos == 1 && broker.auto_ack) {
+		sys_put_be16(pub->message_id, &puback[2]);
+		broker_queue(puback, sizeof(puback));
+	}
+}
+
+static void broker_handle(const uint8_t *pkt, size_t len)
+{
+	uint32_t remaining;
+	const uint8_t *body = pkt + 1 + varint_decode(pkt + 1, &remaining);
+
+	switch (pkt[0] & 0xF0) {
+	case 0x10:
+		zassert_mem_equal(body, "\x00\x04MQTT", 6, "Bad protocol name");
+		broker.protocol_level = body[6];
+		broker_properties(&body[10], &broker.published[0]);
+		broker_queue(connack, sizeof(connack));
+		break;
+	case 0x30:
+		broker_publish(pkt, body, len);
+		break;
+	case 0xE0:
+		broker.disconnected = true;
+		break;
+	default:
+		zassert_unreachable("Unexpected packet 0x%02x", pkt[0]);
+	}
+}
+
+static void broker_write(const uint8_t *data, size_t len)
+{
+	uint32_t remaining;
+	size_t pkt_len;
+
+	zassert_true(broker.in_len + len <= sizeof(broker.in), "Packet too big");
+	memcpy(&broker.in[broker.in_len], data, len);
+	broker.in_len += len;
+
+	/* Packets are written whole, possibly in several parts. */
+	while (broker.in_len >= 2) {
+		pkt_len = 1 + varint_decode(&broker.in[1], &remaining) + remaining;
+		if (broker.in_len < pkt_len) {
+			break;
+		}
+
+		broker_handle(broker.in, pkt_len);
+
+		memmove(broker.in, &broker.in[pkt_len], broker.in_len - pkt_len);
+		broker.in_len -= pkt_len;
+	}
+}
+
+int mqtt_client_custom_transport_connect(struct mqtt_client *client)
+{
+	return 0;
+}
+
+int mqtt_client_custom_transport_write(struct mqtt_client *client,
+				       const uint8_t *data, uint32_t datalen)
+{
+	broker_write(data, datalen);
+
+	return 0;
+}
+
+int mqtt_client_custom_transport_write_msg(struct mqtt_client *client,
+					   const struct msghdr *message)
+{
+	for (int i = 0; i < message->msg_iovlen; i++) {
+		if (message->msg_iov[i].iov_len == 0) {
+			continue;
+		}
+
+		broker_write(message->msg_iov[i].iov_base,
+			     message->msg_iov[i].iov_len);
+	}
+
+	return 0;
+}
+
+int mqtt_client_custom_transport_read(struct mqtt_client *client,
+				      uint8_t *data, uint32_t buflen,
+				      bool shall_block)
+{
+	size_t len = MIN(buflen, broker.out_len - broker.out_pos);
+
+	if (len == 0) {
+		return -EAGAIN;
+	}
+
+	memcpy(data, &broker.out[broker.out_pos], len);
+	broker.out_pos += len;
+
+	return len;
+}
+
+int mqtt_client_custom_transport_disconnect(struct mqtt_client *client)
+{
+	return 0;
+}
+
+static void evt_handler(struct mqtt_client *const c, const struct mqtt_evt *evt)
+{
+	const struct mqtt_publish_param *pub = &evt->param.publish;
+	int ret;
+
+	events.last = *evt;
+	events.count++;
+
+	if (evt->type != MQTT_EVT_PUBLISH || evt->result != 0) {
+		return;
+	}
+
+	copy_str(events.topic, pub->message.topic.topic.utf8,
+		 pub->message.topic.topic.size);
+	copy_str(events.user_prop, pub->prop.user_prop[0].value.utf8,
+		 pub->prop.user_prop[0].value.size);
+
+	memset(events.payload, 0, sizeof(events.payload));
+	ret = mqtt_readall_publish_payload(c, events.payload,
+					   pub->message.payload.len);
+	zassert_ok(ret, "Failed to read payload");
+}
+
+static int publish(const char *topic, uint8_t qos, uint16_t message_id,
+		   size_t payload_len)
+{
+	static uint8_t payload[BUFFER_SIZE];
+	struct mqtt_publish_param param = {
+		.message.topic.topic.utf8 = (const uint8_t *)topic,
+		.message.topic.topic.size = strlen(topic),
+		.message.topic.qos = qos,
+		.message.payload.data = payload,
+		.message.payload.len = payload_len,
+		.message_id = message_id,
+	};
+
+	return mqtt_publish(&client, &param);
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(&broker, 0, sizeof(broker));
+	memset(&events, 0, sizeof(events));
+	broker.auto_ack = true;
+
+	mqtt_client_init(&client);
+	client.protocol_version = MQTT_VERSION_5_0;
+	client.client_id.utf8 = (const uint8_t *)"";
+	client.client_id.size = 0;
+	client.transport.type = MQTT_TRANSPORT_CUSTOM;
+	client.evt_cb = evt_handler;
+	client.rx_buf = rx_buffer;
+	client.rx_buf_size = sizeof(rx_buffer);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+
+	zassert_ok(mqtt_connect(&client), "Failed to connect");
+	zassert_ok(mqtt_input(&client), "Failed to read CONNACK");
+	zassert_equal(events.last.type, MQTT_EVT_CONNACK, "No CONNACK");
+	zassert_equal(events.last.result, 0, "Connection refused");
+
+	broker.published_count = 0;
+	memset(&broker.published[0], 0, sizeof(broker.published[0]));
+}
+
+static void after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	mqtt_abort(&client);
+}
+
+ZTEST(mqtt5_client, test_connect)
+{
+	const struct mqtt_connack_param *param = &events.last.param.connack;
+
+	zassert_equal(broker.protocol_level, 5, "Wrong protocol level");
+	zassert_equal(broker.client_topic_alias_max, CONFIG_MQTT_TOPIC_ALIAS_MAX,
+		      "Topic Alias Maximum not announced");
+
+	zassert_equal(param->prop.receive_maximum, 2, "Wrong Receive Maximum");
+	zassert_equal(param->prop.topic_alias_maximum, 1,
+		      "Wrong Topic Alias Maximum");
+	zassert_equal(param->prop.maximum_packet_size, 128,
+		      "Wrong Maximum Packet Size");
+	zassert_equal(param->prop.maximum_qos, MQTT_QOS_2_EXACTLY_ONCE,
+		      "Wrong default Maximum QoS");
+	zassert_equal(param->prop.assigned_client_id.size, 4,
+		      "No assigned client identifier");
+
+	zassert_ok(mqtt_disconnect(&client), "Failed to disconnect");
+	zassert_true(broker.disconnected, "No DISCONNECT");
+}
+
+ZTEST(mqtt5_client, test_topic_alias)
+{
+	struct published *pub = broker.published;
+
+	for (int i = 0; i < 3; i++) {
+		zassert_ok(publish(TOPIC_TEMPERATURE, 0, 0, 4), "Publish failed");
+	}
+
+	/* The topic is only sent to set up the alias */
+	zassert_equal(broker.published_count, 3, "Missing messages");
+	zassert_true(pub[0].topic_sent, "Alias not set up");
+	zassert_equal(pub[0].topic_alias, 1, "No alias");
+
+	for (int i = 1; i < 3; i++) {
+		zassert_false(pub[i].topic_sent, "Topic not replaced");
+		zassert_equal(pub[i].topic_alias, 1, "No alias");
+		zassert_equal(strcmp(pub[i].topic, TOPIC_TEMPERATURE), 0,
+			      "Wrong topic");
+		zassert_equal(pub[0].len - pub[i].len, strlen(TOPIC_TEMPERATURE),
+			      "Unexpected length");
+	}
+
+	/* The broker allows a single alias, which is reassigned */
+	zassert_ok(publish(TOPIC_HUMIDITY, 0, 0, 4), "Publish failed");
+	zassert_ok(publish(TOPIC_TEMPERATURE, 0, 0, 4), "Publish failed");
+
+	zassert_true(pub[3].topic_sent, "Alias not reassigned");
+	zassert_equal(strcmp(pub[3].topic, TOPIC_HUMIDITY), 0, "Wrong topic");
+	zassert_true(pub[4].topic_sent, "Alias not reassigned");
+	zassert_equal(strcmp(pub[4].topic, TOPIC_TEMPERATURE), 0, "Wrong topic");
+}
+
+ZTEST(mqtt5_client, test_flow_control)
+{
+	static const uint8_t puback[] = { 0x40, 0x02, 0x00, 0x01 };
+	struct mqtt_publish_param param = {
+		.message.topic.topic = MQTT_UTF8_LITERAL(TOPIC_TEMPERATURE),
+		.message.topic.qos = MQTT_QOS_1_AT_LEAST_ONCE,
+		.message_id = 1,
+		.dup_flag = 1,
+	};
+
+	broker.auto_ack = false;
+
+	zassert_ok(publish(TOPIC_TEMPERATURE, 1, 1, 4), "Publish failed");
+	zassert_ok(publish(TOPIC_TEMPERATURE, 1, 2, 4), "Publish failed");
+
+	/* Receive Maximum reached */
+	zassert_equal(publish(TOPIC_TEMPERATURE, 1, 3, 4), -EAGAIN,
+		      "Window not enforced");
+	zassert_ok(publish(TOPIC_TEMPERATURE, 0, 0, 4), "QoS 0 limited");
+
+	/* Retransmissions do not take a new slot */
+	zassert_ok(mqtt_publish(&client, &param), "Retransmission failed");
+
+	broker_queue(puback, sizeof(puback));
+	zassert_ok(mqtt_input(&client), "Failed to read PUBACK");
+	zassert_equal(events.last.type, MQTT_EVT_PUBACK, "No PUBACK");
+	zassert_equal(events.last.param.puback.message_id, 1, "Wrong id");
+	zassert_equal(events.last.param.puback.reason_code, 0, "Wrong reason");
+
+	zassert_ok(publish(TOPIC_TEMPERATURE, 1, 3, 4), "Window not released");
+	zassert_equal(broker.published_count, 5, "Missing messages");
+}
+
+static int publish_dup(uint16_t message_id)
+{
+	struct mqtt_publish_param param = {
+		.message.topic.topic = MQTT_UTF8_LITERAL(TOPIC_TEMPERATURE),
+		.message.topic.qos = MQTT_QOS_1_AT_LEAST_ONCE,
+		.message_id = message_id,
+		.dup_flag = 1,
+	};
+
+	return mqtt_publish(&client, &param);
+}
+
+static void puback_receive(uint16_t message_id)
+{
+	uint8_t puback[4] = { 0x40, 0x02 };
+
+	sys_put_be16(message_id, &puback[2]);
+	broker_queue(puback, sizeof(puback));
+
+	zassert_ok(mqtt_input(&client), "Failed to read PUBACK");
+	zassert_equal(events.last.type, MQTT_EVT_PUBACK, "No PUBACK");
+	zassert_equal(events.last.param.puback.message_id, message_id,
+		      "Wrong id");
+}
+
+ZTEST(mqtt5_client, test_reconnect_resend)
+{
+	broker.auto_ack = false;
+
+	zassert_ok(publish(TOPIC_TEMPERATURE, 1, 1, 4), "Publish failed");
+	zassert_ok(publish(TOPIC_TEMPERATURE, 1, 2, 4), "Publish failed");
+
+	/* Acknowledgments of messages not in flight release nothing */
+	puback_receive(7);
+	zassert_equal(publish(TOPIC_TEMPERATURE, 1, 3, 4), -EAGAIN,
+		      "Window released by an unknown id");
+
+	/* Reconnect with the two messages unacknowledged */
+	mqtt_abort(&client);
+	broker.out_len = 0;
+	broker.out_pos = 0;
+
+	zassert_ok(mqtt_connect(&client), "Failed to reconnect");
+	zassert_ok(mqtt_input(&client), "Failed to read CONNACK");
+	zassert_equal(events.last.type, MQTT_EVT_CONNACK, "No CONNACK");
+
+	/* The resent messages take the window of the new connection */
+	zassert_ok(publish_dup(1), "Resend failed");
+	zassert_ok(publish_dup(2), "Resend failed");
+	zassert_equal(publish(TOPIC_TEMPERATURE, 1, 3, 4), -EAGAIN,
+		      "Resent messages not counted");
+
+	/* Each acknowledgment releases its own message, once */
+	puback_receive(2);
+	zassert_ok(publish(TOPIC_TEMPERATURE, 1, 3, 4), "Window not released");
+
+	puback_receive(2);
+	zassert_equal(publish(TOPIC_TEMPERATURE, 1, 4, 4), -EAGAIN,
+		      "Window released twice");
+
+	puback_receive(1);
+	zassert_ok(publish(TOPIC_TEMPERATURE, 1, 4, 4), "Window not released");
+
+	zassert_equal(broker.published_count, 6, "Missing messages");
+}
+
+ZTEST(mqtt5_client, test_properties)
+{
+	struct mqtt_publish_param param = {
+		.message.topic.topic = MQTT_UTF8_LITERAL(TOPIC_TEMPERATURE),
+		.prop.user_prop = {
+			{ MQTT_UTF8_LITERAL("unit"), MQTT_UTF8_LITERAL("C") },
+			{ MQTT_UTF8_LITERAL("room"), MQTT_UTF8_LITERAL("kitchen") },
+		},
+		.prop.content_type = MQTT_UTF8_LITERAL("text/plain"),
+		.prop.payload_format_indicator = 1,
+	};
+
+	zassert_ok(mqtt_publish(&client, &param), "Publish failed");
+	zassert_equal(strcmp(broker.published[0].user_prop, "unit"), 0,
+		      "User property not sent");
+
+	/* Larger than the Maximum Packet Size of the broker */
+	zassert_equal(publish(TOPIC_TEMPERATURE, 0, 0, 128), -EMSGSIZE,
+		      "Maximum Packet Size not enforced");
+	zassert_equal(broker.published_count, 1, "Oversized message sent");
+}
+
+ZTEST(mqtt5_client, test_incoming_alias)
+{
+	static const uint8_t with_topic[] = {
+		0x30, 26, 0x00, 0x07, 'c', 'm', 'd', '/', 'l', 'e', 'd',
+		14, 0x23, 0x00, 0x02,
+		0x26, 0x00, 0x03, 's', 'r', 'c', 0x00, 0x03, 'a', 'p', 'p',
+		'o', 'n',
+	};
+	static const uint8_t alias_only[] = {
+		0x30, 9, 0x00, 0x00, 3, 0x23, 0x00, 0x02, 'o', 'f', 'f',
+	};
+	static const uint8_t unknown_alias[] = {
+		0x30, 9, 0x00, 0x00, 3, 0x23, 0x00, 0x01, 'o', 'f', 'f',
+	};
+
+	broker_queue(with_topic, sizeof(with_topic));
+	zassert_ok(mqtt_input(&client), "Failed to read PUBLISH");
+	zassert_equal(events.last.type, MQTT_EVT_PUBLISH, "No PUBLISH");
+	zassert_equal(strcmp(events.topic, "cmd/led"), 0, "Wrong topic");
+	zassert_equal(strcmp(events.user_prop, "app"), 0,
+		      "Wrong user property");
+	zassert_equal(strcmp(events.payload, "on"), 0, "Wrong payload");
+
+	broker_queue(alias_only, sizeof(alias_only));
+	zassert_ok(mqtt_input(&client), "Failed to read PUBLISH");
+	zassert_equal(events.last.param.publish.prop.topic_alias, 2,
+		      "Wrong alias");
+	zassert_equal(strcmp(events.topic, "cmd/led"), 0, "Alias not resolved");
+	zassert_equal(strcmp(events.payload, "off"), 0, "Wrong payload");
+
+	/* Protocol error, the client disconnects */
+	broker_queue(unknown_alias, sizeof(unknown_alias));
+	zassert_equal(mqtt_input(&client), -EINVAL, "Unknown alias accepted");
+	zassert_equal(events.last.type, MQTT_EVT_DISCONNECT, "Not disconnected");
+}
+
+ZTEST(mqtt5_client, test_server_disconnect)
+{
+	/* Message rate too high */
+	static const uint8_t disconnect[] = { 0xE0, 0x01, 0x96 };
+
+	broker_queue(disconnect, sizeof(disconnect));
+	zassert_equal(mqtt_input(&client), -ECONNRESET, "DISCONNECT ignored");
+	zassert_equal(events.last.type, MQTT_EVT_DISCONNECT, "No event");
+	zassert_equal(events.last.result, -ECONNRESET, "Wrong result");
+}
+
+ZTEST_SUITE(mqtt5_client, NULL, NULL, before, after, NULL);
@@ -773,7 +773,7 @@ static int eval_msg_publish(struct mqtt_test *mqtt_test)
 	buf.cur = client.tx_buf;
 	buf.end = client.tx_buf + client.tx_buf_size;
 
-	rc = publish_encode(param, &buf);
+	rc = publish_encode(&client, param, &buf);
 
 	/* Payload is not copied, copy it manually just after the header.*/
 	memcpy(buf.end, param->message.payload.data,
@@ -791,7 +791,8 @@ static int eval_msg_publish(struct mqtt_test *mqtt_test)
 
 	zassert_false(rc, "fixed_header_decode failed");
 
-	rc = publish_decode(type_and_flags, length, &buf, &dec_param);
+	rc = publish_decode(&client, type_and_flags, length, &buf,
+			    &dec_param);
 
 	/**TESTPOINT: Check publish_decode function*/
 	zassert_false(rc, "publish_decode failed");
@@ -830,7 +831,7 @@ static int eval_msg_corrupted_publish(struct mqtt_test *mqtt_test)
 	rc = fixed_header_decode(buf, &type_and_flags, &length);
 	zassert_equal(rc, 0, "fixed_header_decode failed");
 
-	rc = publish_decode(type_and_flags, length, buf, &dec_param);
+	rc = publish_decode(&client, type_and_flags, length, buf, &dec_param);
 	zassert_equal(rc, -EINVAL, "publish_decode should fail");
 
 	return TC_PASS;
@@ -846,7 +847,7 @@ static int eval_msg_subscribe(struct mqtt_test *mqtt_test)
 	buf.cur = client.tx_buf;
 	buf.end = client.tx_buf + client.tx_buf_size;
 
-	rc = subscribe_encode(param, &buf);
+	rc = subscribe_encode(&client, param, &buf);
 
 	/**TESTPOINT: Check subscribe_encode function*/
 	zassert_false(rc, "subscribe_encode failed");
@@ -874,7 +875,7 @@ static int eval_msg_suback(struct mqtt_test *mqtt_test)
 
 	zassert_false(rc, "fixed_header_decode failed");
 
-	rc = subscribe_ack_decode(&buf, &dec_param);
+	rc = subscribe_ack_decode(&client, &buf, &dec_param);
 
 	/**TESTPOINT: Check subscribe_ack_decode function*/
 	zassert_false(rc, "subscribe_ack_decode failed");
@@ -1083,7 +1084,7 @@ static int eval_msg_unsuback(struct mqtt_test *mqtt_test)
 
 	zassert_false(rc, "fixed_header_decode failed");
 
-	rc = unsubscribe_ack_decode(&buf, &dec_param);
+	rc = unsubscribe_ack_decode(&client, &buf, &dec_param);
 
 	zassert_false(rc, "unsubscribe_ack_decode failed");
 
@@ -0,0 +1,407 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Outbound queue tests against a broker stand-in, plugged in as the custom
+ * transport. The broker parses what the client writes, counts the PUBLISH
+ * and PUBREL packets and answers with acknowledgments, right away or when
+ * the test queues them.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/mqtt.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/ztest.h>
+
+#define BUFFER_SIZE 256
+#define QUEUE_BUFFER_SIZE 2048
+#define PAYLOAD_SIZE 32
+
+#define TOPIC "sensors/kitchen/temperature"
+
+static uint8_t rx_buffer[BUFFER_SIZE];
+static uint8_t tx_buffer[BUFFER_SIZE];
+static uint8_t queue_buffer[QUEUE_BUFFER_SIZE];
+static uint8_t payload[PAYLOAD_SIZE];
+static struct mqtt_client client;
+
+static struct broker {
+	/* Packets queued for the client */
+	uint8_t out[BUFFER_SIZE * 2];
+	size_t out_len;
+	size_t out_pos;
+
+	/* Packets written by the client */
+	uint8_t in[QUEUE_BUFFER_SIZE];
+	size_t in_len;
+
+	bool auto_ack;
+	int writes;
+	int published;
+	int duplicates;
+	int released;
+	uint16_t last_message_id;
+} broker;
+
+static struct {
+	int puback;
+	int pubcomp;
+	int disconnect;
+} events;
+
+static size_t varint_decode(const uint8_t *p, uint32_t *value)
+{
+	size_t n = 0;
+
+	*value = 0U;
+
+	do {
+		*value |= (uint32_t)(p[n] & 0x7F) << (7 * n);
+	} while (p[n++] & 0x80);
+
+	return n;
+}
+
+static void broker_send(const uint8_t *data, size_t len)
+{
+	memmove(broker.out, &broker.out[broker.out_pos],
+		broker.out_len - broker.out_pos);
+	broker.out_len -= broker.out_pos;
+	broker.out_pos = 0;
+
+	zassert_true(broker.out_len + len <= sizeof(broker.out), "Broker full");
+	memcpy(&broker.out[broker.out_len], data, len);
+	broker.out_len += len;
+}
+
+static void broker_queue(uint8_t type, uint16_t message_id)
+{
+	uint8_t ack[4] = { type, 0x02 };
+
+	sys_put_be16(message_id, &ack[2]);
+	broker_send(ack, sizeof(ack));
+}
+
+static void broker_ack(uint16_t message_id)
+{
+	broker_queue(0x40, message_id);
+}
+
+static void broker_publish(const uint8_t *pkt, const uint8_t *body)
+{
+	uint8_t qos = (pkt[0] >> 1) & 0x03;
+	uint16_t topic_len = sys_get_be16(body);
+
+	broker.published++;
+
+	if (pkt[0] & 0x08) {
+		broker.duplicates++;
+	}
+
+	if (qos == 0) {
+		return;
+	}
+
+	broker.last_message_id = sys_get_be16(body + 2 + topic_len);
+
+	if (broker.auto_ack) {
+		broker_queue(qos == 1 ? 0x40 : 0x50, broker.last_message_id);
+	}
+}
+
+static void broker_handle(const uint8_t *pkt)
+{
+	static const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+	uint32_t remaining;
+	const uint8_t *body = pkt + 1 + varint_decode(pkt + 1, &remaining);
+
+	switch (pkt[0] & 0xF0) {
+	case 0x10:
+		broker_send(connack, sizeof(connack));
+		break;
+	case 0x30:
+		broker_publish(pkt, body);
+		break;
+	case 0x60:
+		broker.released++;
+		broker_queue(0x70, sys_get_be16(body));
+		break;
+	case 0xE0:
+		break;
+	default:
+		zassert_unreachable("Unexpected packet 0x%02x", pkt[0]);
+	}
+}
+
+static void broker_write(const uint8_t *data, size_t len)
+{
+	uint32_t remaining;
+	size_t pkt_len;
+	size_t pos = 0;
+
+	zassert_true(broker.in_len + len <= sizeof(broker.in), "Write too big");
+	memcpy(&broker.in[broker.in_len], data, len);
+	broker.in_len += len;
+
+	while (broker.in_len - pos >= 2) {
+		pkt_len = 1 + varint_decode(&broker.in[pos + 1], &remaining) +
+			  remaining;
+		if (broker.in_len - pos < pkt_len) {
+			break;
+		}
+
+		broker_handle(&broker.in[pos]);
+		pos += pkt_len;
+	}
+
+	memmove(broker.in, &broker.in[pos], broker.in_len - pos);
+	broker.in_len -= pos;
+}
+
+int mqtt_client_custom_transport_connect(struct mqtt_client *client)
+{
+	return 0;
+}
+
+int mqtt_client_custom_transport_write(struct mqtt_client *client,
+				       const uint8_t *data, uint32_t datalen)
+{
+	broker.writes++;
+	broker_write(data, datalen);
+
+	return 0;
+}
+
+int mqtt_client_custom_transport_write_msg(struct mqtt_client *client,
+					   const struct msghdr *message)
+{
+	broker.writes++;
+
+	for (int i = 0; i < message->msg_iovlen; i++) {
+		if (message->msg_iov[i].iov_len == 0) {
+			continue;
+		}
+
+		broker_write(message->msg_iov[i].iov_base,
+			     message->msg_iov[i].iov_len);
+	}
+
+	return 0;
+}
+
+int mqtt_client_custom_transport_read(struct mqtt_client *client,
+				      uint8_t *data, uint32_t buflen,
+				      bool shall_block)
+{
+	size_t len = MIN(buflen, broker.out_len - broker.out_pos);
+
+	if (len == 0) {
+		return -EAGAIN;
+	}
+
+	memcpy(data, &broker.out[broker.out_pos], len);
+	broker.out_pos += len;
+
+	return len;
+}
+
+int mqtt_client_custom_transport_disconnect(struct mqtt_client *client)
+{
+	broker.out_len = 0;
+	broker.out_pos = 0;
+	broker.in_len = 0;
+
+	return 0;
+}
+
+static void evt_handler(struct mqtt_client *const c, const struct mqtt_evt *evt)
+{
+	switch (evt->type) {
+	case MQTT_EVT_PUBACK:
+		events.puback++;
+		break;
+	case MQTT_EVT_PUBREC: {
+		/* What an application not aware of the queue does */
+		const struct mqtt_pubrel_param param = {
+			.message_id = evt->param.pubrec.message_id,
+		};
+
+		zassert_ok(mqtt_publish_qos2_release(c, &param),
+			   "Failed to release");
+		break;
+	}
+	case MQTT_EVT_PUBCOMP:
+		events.pubcomp++;
+		break;
+	case MQTT_EVT_DISCONNECT:
+		events.disconnect++;
+		break;
+	default:
+		break;
+	}
+}
+
+static void mqtt_connect_and_wait(void)
+{
+	zassert_ok(mqtt_connect(&client), "Failed to connect");
+	zassert_ok(mqtt_input(&client), "Failed to read CONNACK");
+}
+
+static struct mqtt_publish_param message(uint8_t qos, uint16_t message_id)
+{
+	struct mqtt_publish_param param = {
+		.message.topic.topic = MQTT_UTF8_LITERAL(TOPIC),
+		.message.topic.qos = qos,
+		.message.payload.data = payload,
+		.message.payload.len = sizeof(payload),
+		.message_id = message_id,
+	};
+
+	return param;
+}
+
+static int publish_queued(uint8_t qos)
+{
+	struct mqtt_publish_param param = message(qos, 0);
+
+	return mqtt_publish_queued(&client, &param);
+}
+
+static void input_until(int *counter, int value)
+{
+	while (*counter < value) {
+		zassert_ok(mqtt_input(&client), "Input failed");
+	}
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(&broker, 0, sizeof(broker));
+	memset(&events, 0, sizeof(events));
+	broker.auto_ack = true;
+
+	mqtt_client_init(&client);
+	client.client_id = MQTT_UTF8_LITERAL("test");
+	client.transport.type = MQTT_TRANSPORT_CUSTOM;
+	client.evt_cb = evt_handler;
+	client.rx_buf = rx_buffer;
+	client.rx_buf_size = sizeof(rx_buffer);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+	client.queue_buf = queue_buffer;
+	client.queue_buf_size = sizeof(queue_buffer);
+
+	mqtt_connect_and_wait();
+
+	broker.writes = 0;
+}
+
+static void after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	mqtt_abort(&client);
+}
+
+ZTEST(mqtt_queue, test_window)
+{
+	const int window = CONFIG_MQTT_OUTBOUND_QUEUE_INFLIGHT;
+	int writes;
+
+	broker.auto_ack = false;
+
+	/* Sent right away until half of the window is in flight */
+	for (int i = 0; i < window + 4; i++) {
+		zassert_equal(publish_queued(MQTT_QOS_1_AT_LEAST_ONCE), i + 1,
+			      "Unexpected message id");
+	}
+
+	zassert_equal(broker.published, window / 2 + 1, "Messages not held");
+	zassert_equal(broker.writes, window / 2 + 1, "Unexpected writes");
+	zassert_equal(mqtt_publish_queue_len(&client), window + 4,
+		      "Wrong queue length");
+
+	/* The held back messages fill the window in a single write */
+	broker_ack(1);
+	input_until(&events.puback, 1);
+
+	zassert_equal(broker.published, window + 1, "Window not filled");
+	zassert_equal(broker.writes, window / 2 + 2, "Messages not coalesced");
+
+	/* The rest goes once half of the window is acknowledged */
+	for (int i = 2; i <= window / 2; i++) {
+		broker_ack(i);
+		input_until(&events.puback, i);
+	}
+
+	zassert_equal(broker.published, window + 1, "Messages not held");
+
+	writes = broker.writes;
+	broker_ack(window / 2 + 1);
+	input_until(&events.puback, window / 2 + 1);
+
+	zassert_equal(broker.published, window + 4, "Messages not sent");
+	zassert_equal(broker.writes, writes + 1, "Messages not coalesced");
+
+	/* Out of order acknowledgments */
+	for (int i = window + 4; i > window / 2 + 1; i--) {
+		broker_ack(i);
+	}
+
+	input_until(&events.puback, window + 4);
+	zassert_equal(mqtt_publish_queue_len(&client), 0, "Queue not empty");
+
+	zassert_equal(publish_queued(MQTT_QOS_0_AT_MOST_ONCE), 0,
+		      "Message id assigned with QoS 0");
+	zassert_equal(publish_queued(MQTT_QOS_1_AT_LEAST_ONCE), window + 5,
+		      "Unexpected message id");
+}
+
+ZTEST(mqtt_queue, test_retransmit)
+{
+	broker.auto_ack = false;
+
+	for (int i = 0; i < 3; i++) {
+		zassert_true(publish_queued(MQTT_QOS_1_AT_LEAST_ONCE) > 0,
+			     "Failed to queue");
+	}
+
+	broker_ack(2);
+	input_until(&events.puback, 1);
+
+	zassert_ok(mqtt_abort(&client), "Failed to abort");
+	zassert_equal(events.disconnect, 1, "Not disconnected");
+
+	/* Queued while disconnected */
+	zassert_equal(publish_queued(MQTT_QOS_1_AT_LEAST_ONCE), 4,
+		      "Failed to queue");
+	zassert_equal(mqtt_publish_queue_len(&client), 3, "Wrong queue length");
+
+	broker.published = 0;
+	mqtt_connect_and_wait();
+
+	zassert_equal(broker.published, 3, "Messages not sent again");
+	zassert_equal(broker.duplicates, 2, "DUP flag not set");
+	zassert_equal(broker.last_message_id, 4, "Messages reordered");
+}
+
+ZTEST(mqtt_queue, test_qos2)
+{
+	zassert_equal(publish_queued(MQTT_QOS_2_EXACTLY_ONCE), 1,
+		      "Failed to queue");
+
+	/* PUBREC, PUBREL sent before the application releases it too */
+	zassert_ok(mqtt_input(&client), "Failed to read PUBREC");
+	zassert_equal(broker.released, 1, "Message not released");
+
+	input_until(&events.pubcomp, 1);
+	zassert_equal(broker.released, 1, "Message released twice");
+	zassert_equal(mqtt_publish_queue_len(&client), 0, "Queue not empty");
+}
+
+ZTEST_SUITE(mqtt_queue, NULL, NULL, before, after, NULL);
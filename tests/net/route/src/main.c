@@ -544,6 +544,43 @@ static void test_route_preference(void)
 	net_route_del(route_entry);
 }
 
+static void test_route_longest_prefix(void)
+{
+	struct in6_addr prefix = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0 } } };
+	struct in6_addr other = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				      0, 0, 0, 0, 0xd, 0xe, 0x5, 0x8 } } };
+	struct net_route_entry *host_route, *net_route, *entry;
+
+	host_route = net_route_add(my_iface, &dest_addr, 128, &peer_addr_alt,
+				   NET_IPV6_ND_INFINITE_LIFETIME,
+				   NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(host_route, "Host route add failed");
+
+	net_route = net_route_add(my_iface, &prefix, 64, &peer_addr,
+				  NET_IPV6_ND_INFINITE_LIFETIME,
+				  NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(net_route, "Prefix route add failed");
+
+	entry = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(entry, host_route, "Longest prefix not selected");
+
+	entry = net_route_lookup(NULL, &other);
+	zassert_equal_ptr(entry, net_route, "Prefix route not found");
+
+	entry = net_route_lookup(peer_iface, &dest_addr);
+	zassert_is_null(entry, "Route found on wrong interface");
+
+	zassert_ok(net_route_del(host_route), "Host route del failed");
+
+	entry = net_route_lookup(my_iface, &dest_addr);
+	zassert_equal_ptr(entry, net_route, "Prefix route not used");
+
+	zassert_ok(net_route_del(net_route), "Prefix route del failed");
+
+	entry = net_route_lookup(my_iface, &dest_addr);
+	zassert_is_null(entry, "Route found after delete");
+}
 
 /*test case main entry*/
 ZTEST(route_test_suite, test_route)
@@ -566,6 +603,106 @@ ZTEST(route_test_suite, test_route)
 	test_route_del_many();
 	test_route_lifetime();
 	test_route_preference();
+	test_route_longest_prefix();
+}
+
+#if defined(CONFIG_NET_ROUTE_IPV4)
+static void route_ipv4_count_cb(struct net_route_entry_ipv4 *entry, void *user_data)
+{
+	int *count = user_data;
+
+	ARG_UNUSED(entry);
+
+	(*count)++;
+}
+
+ZTEST(route_test_suite, test_route_ipv4)
+{
+	struct net_if *iface1 = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	struct net_if *iface2 = iface1 + 1;
+	struct in_addr net8 = { { { 10, 0, 0, 0 } } };
+	struct in_addr net16 = { { { 10, 1, 0, 0 } } };
+	struct in_addr host = { { { 10, 1, 2, 3 } } };
+	struct in_addr any = { { { 0, 0, 0, 0 } } };
+	struct in_addr gw8 = { { { 192, 0, 2, 1 } } };
+	struct in_addr gw16 = { { { 192, 0, 2, 2 } } };
+	struct in_addr gw16_alt = { { { 192, 0, 2, 20 } } };
+	struct in_addr gw_host = { { { 192, 0, 2, 3 } } };
+	struct in_addr gw_default = { { { 192, 0, 2, 254 } } };
+	struct in_addr in16 = { { { 10, 1, 9, 9 } } };
+	struct in_addr in8 = { { { 10, 200, 0, 1 } } };
+	struct in_addr outside = { { { 198, 51, 100, 1 } } };
+	struct net_route_entry_ipv4 *r8, *r16, *r16_2, *rhost, *rdefault;
+	struct net_route_entry_ipv4 *extra[CONFIG_NET_MAX_ROUTES_IPV4];
+	struct in_addr nexthop;
+	int count = 0;
+	int added;
+
+	zassert_is_null(net_route_ipv4_add(iface1, &net8, 33, &gw8), "Invalid prefix added");
+
+	r8 = net_route_ipv4_add(iface1, &net8, 8, &gw8);
+	r16 = net_route_ipv4_add(iface1, &net16, 16, &gw16);
+	rhost = net_route_ipv4_add(iface1, &host, 32, &gw_host);
+	rdefault = net_route_ipv4_add(iface2, &any, 0, &gw_default);
+	zassert_true(r8 && r16 && rhost && rdefault, "Route add failed");
+
+	/* Longest prefix wins */
+	zassert_equal_ptr(net_route_ipv4_lookup(iface1, &host), rhost);
+	zassert_equal_ptr(net_route_ipv4_lookup(iface1, &in16), r16);
+	zassert_equal_ptr(net_route_ipv4_lookup(iface1, &in8), r8);
+	zassert_equal_ptr(net_route_ipv4_lookup(NULL, &outside), rdefault);
+	zassert_is_null(net_route_ipv4_lookup(iface1, &outside), "Route on wrong interface");
+
+	zassert_true(net_route_ipv4_get_nexthop(iface1, &in16, &nexthop));
+	zassert_true(net_ipv4_addr_cmp(&nexthop, &gw16), "Wrong next hop");
+	zassert_false(net_route_ipv4_get_nexthop(iface1, &outside, &nexthop));
+
+	/* The same prefix on another interface shares the trie node */
+	r16_2 = net_route_ipv4_add(iface2, &net16, 16, &gw16_alt);
+	zassert_not_null(r16_2, "Route add failed");
+	zassert_equal_ptr(net_route_ipv4_lookup(iface2, &in16), r16_2);
+	zassert_equal_ptr(net_route_ipv4_lookup(iface1, &in16), r16);
+
+	/* Adding it again updates the next hop */
+	zassert_equal_ptr(net_route_ipv4_add(iface2, &net16, 16, &gw16), r16_2);
+	zassert_true(net_ipv4_addr_cmp(&r16_2->nexthop, &gw16), "Next hop not updated");
+
+	zassert_equal(net_route_ipv4_foreach(route_ipv4_count_cb, &count), 5);
+	zassert_equal(count, 5);
+
+	/* Removing one route of a shared prefix keeps the other one */
+	zassert_ok(net_route_ipv4_del(r16));
+	zassert_equal_ptr(net_route_ipv4_lookup(iface1, &in16), r8);
+	zassert_equal_ptr(net_route_ipv4_lookup(iface2, &in16), r16_2);
+	zassert_equal(net_route_ipv4_del(r16), -ENOENT);
+
+	zassert_ok(net_route_ipv4_del(rhost));
+	zassert_equal_ptr(net_route_ipv4_lookup(iface1, &host), r8);
+
+	/* Fill the table */
+	for (added = 0; added < ARRAY_SIZE(extra); added++) {
+		struct in_addr prefix = { { { 172, 16, added, 0 } } };
+
+		extra[added] = net_route_ipv4_add(iface1, &prefix, 24, &gw8);
+		if (extra[added] == NULL) {
+			break;
+		}
+	}
+
+	zassert_equal(added, CONFIG_NET_MAX_ROUTES_IPV4 - 3, "Table of %d routes took %d more",
+		      CONFIG_NET_MAX_ROUTES_IPV4, added);
+
+	while (added-- > 0) {
+		zassert_ok(net_route_ipv4_del(extra[added]));
+	}
+
+	zassert_ok(net_route_ipv4_del(r16_2));
+	zassert_ok(net_route_ipv4_del(r8));
+	zassert_ok(net_route_ipv4_del(rdefault));
+
+	zassert_is_null(net_route_ipv4_lookup(NULL, &in16), "Route found after delete");
+	zassert_equal(net_route_ipv4_foreach(route_ipv4_count_cb, &count), 0);
 }
+#endif /* CONFIG_NET_ROUTE_IPV4 */
 
 ZTEST_SUITE(route_test_suite, NULL, NULL, NULL, NULL, NULL);
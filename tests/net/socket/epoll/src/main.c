@@ -0,0 +1,465 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <zephyr/ztest_assert.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/posix/sys/eventfd.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define MY_IPV6_ADDR "::1"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* On QEMU, a wait takes +10ms from the requested time. */
+#define FUZZ 10
+
+#define TCP_TEARDOWN_TIMEOUT K_SECONDS(3)
+
+static int c_sock;
+static int s_sock;
+static int epfd;
+
+static void *setup(void)
+{
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	int res;
+
+	prepare_sock_udp_v6(MY_IPV6_ADDR, CLIENT_PORT, &c_sock, &c_addr);
+	prepare_sock_udp_v6(MY_IPV6_ADDR, SERVER_PORT, &s_sock, &s_addr);
+
+	res = zsock_bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = zsock_connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	return NULL;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	epfd = zsock_epoll_create(0);
+	zassert_true(epfd >= 0, "epoll_create failed (%d)", errno);
+}
+
+static void after(void *fixture)
+{
+	char buf[10];
+
+	ARG_UNUSED(fixture);
+
+	zassert_equal(zsock_close(epfd), 0, "close failed");
+
+	/* Drain whatever a failed test left behind */
+	while (zsock_recv(s_sock, buf, sizeof(buf), ZSOCK_MSG_DONTWAIT) > 0) {
+	}
+}
+
+static void add_fd(int fd, uint32_t events)
+{
+	struct zsock_epoll_event ev = {
+		.events = events,
+		.data.fd = fd,
+	};
+
+	zassert_equal(zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_ADD, fd, &ev), 0,
+		      "epoll_ctl failed (%d)", errno);
+}
+
+static void send_small(void)
+{
+	ssize_t len;
+
+	len = zsock_send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+}
+
+static void recv_small(void)
+{
+	char buf[10];
+	ssize_t len;
+
+	len = zsock_recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+}
+
+ZTEST(net_socket_epoll, test_level_triggered)
+{
+	struct zsock_epoll_event ev[2];
+	uint32_t tstamp;
+	int res;
+
+	add_fd(s_sock, ZSOCK_EPOLLIN);
+
+	/* Nothing to read, wait with a timeout */
+	tstamp = k_uptime_get_32();
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_equal(res, 0, "");
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+
+	send_small();
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].events, ZSOCK_EPOLLIN, "");
+	zassert_equal(ev[0].data.fd, s_sock, "");
+
+	/* Level triggered, reported again until the data is read */
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 1, "");
+
+	recv_small();
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 0, "");
+}
+
+ZTEST(net_socket_epoll, test_edge_triggered)
+{
+	struct zsock_epoll_event ev[2];
+	int res;
+
+	add_fd(s_sock, ZSOCK_EPOLLIN | ZSOCK_EPOLLET);
+
+	send_small();
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].events, ZSOCK_EPOLLIN, "");
+
+	/* Data still pending, but nothing new arrived */
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 0, "");
+
+	send_small();
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+
+	recv_small();
+	recv_small();
+}
+
+ZTEST(net_socket_epoll, test_oneshot)
+{
+	struct zsock_epoll_event ev[2];
+	struct zsock_epoll_event mod = {
+		.events = ZSOCK_EPOLLIN | ZSOCK_EPOLLONESHOT,
+		.data.u32 = 42,
+	};
+	int res;
+
+	add_fd(s_sock, ZSOCK_EPOLLIN | ZSOCK_EPOLLONESHOT);
+
+	send_small();
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+
+	/* Disabled until re-armed */
+	send_small();
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 30);
+	zassert_equal(res, 0, "");
+
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_MOD, s_sock, &mod);
+	zassert_equal(res, 0, "epoll_ctl failed (%d)", errno);
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].data.u32, 42, "");
+
+	recv_small();
+	recv_small();
+}
+
+ZTEST(net_socket_epoll, test_ctl)
+{
+	struct zsock_epoll_event ev = { .events = ZSOCK_EPOLLIN };
+	int res;
+
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_MOD, s_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	add_fd(s_sock, ZSOCK_EPOLLIN);
+
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EEXIST, "");
+
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_ADD, epfd, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_DEL, s_sock, NULL);
+	zassert_equal(res, 0, "epoll_ctl failed (%d)", errno);
+
+	send_small();
+
+	res = zsock_epoll_wait(epfd, &ev, 1, 30);
+	zassert_equal(res, 0, "");
+
+	recv_small();
+}
+
+ZTEST(net_socket_epoll, test_tcp_accept_and_close)
+{
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	struct zsock_epoll_event ev[2];
+	int c_sock_tcp;
+	int s_sock_tcp;
+	int new_sock;
+	int res;
+
+	prepare_sock_tcp_v6(MY_IPV6_ADDR, CLIENT_PORT, &c_sock_tcp, &c_addr);
+	prepare_sock_tcp_v6(MY_IPV6_ADDR, SERVER_PORT, &s_sock_tcp, &s_addr);
+
+	res = zsock_bind(s_sock_tcp, (struct sockaddr *)&s_addr,
+			 sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = zsock_listen(s_sock_tcp, 0);
+	zassert_equal(res, 0, "listen failed");
+
+	add_fd(s_sock_tcp, ZSOCK_EPOLLIN);
+
+	res = zsock_connect(c_sock_tcp, (struct sockaddr *)&s_addr,
+			    sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].data.fd, s_sock_tcp, "");
+
+	new_sock = zsock_accept(s_sock_tcp, NULL, NULL);
+	zassert_true(new_sock >= 0, "accept failed");
+
+	add_fd(new_sock, ZSOCK_EPOLLIN);
+
+	/* Peer closing the connection is reported as EOF */
+	res = zsock_close(c_sock_tcp);
+	zassert_equal(res, 0, "close failed");
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].data.fd, new_sock, "");
+	zassert_true(ev[0].events & (ZSOCK_EPOLLIN | ZSOCK_EPOLLHUP), "");
+
+	/* A closed socket leaves the instance by itself */
+	res = zsock_close(new_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = zsock_close(s_sock_tcp);
+	zassert_equal(res, 0, "close failed");
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 0, "");
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+ZTEST(net_socket_epoll, test_udp_writable)
+{
+	struct zsock_epoll_event ev[2];
+	int res;
+
+	add_fd(c_sock, ZSOCK_EPOLLOUT);
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].events, ZSOCK_EPOLLOUT, "");
+	zassert_equal(ev[0].data.fd, c_sock, "");
+
+	/* Level triggered, stays writable */
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 1, "");
+}
+
+ZTEST(net_socket_epoll, test_tcp_writable)
+{
+	struct sockaddr_in6 c_addr;
+	struct sockaddr_in6 s_addr;
+	struct zsock_epoll_event ev[2];
+	int c_sock_tcp;
+	int s_sock_tcp;
+	int new_sock;
+	int res;
+
+	prepare_sock_tcp_v6(MY_IPV6_ADDR, CLIENT_PORT, &c_sock_tcp, &c_addr);
+	prepare_sock_tcp_v6(MY_IPV6_ADDR, SERVER_PORT, &s_sock_tcp, &s_addr);
+
+	res = zsock_bind(s_sock_tcp, (struct sockaddr *)&s_addr,
+			 sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = zsock_listen(s_sock_tcp, 0);
+	zassert_equal(res, 0, "listen failed");
+
+	res = zsock_connect(c_sock_tcp, (struct sockaddr *)&s_addr,
+			    sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	new_sock = zsock_accept(s_sock_tcp, NULL, NULL);
+	zassert_true(new_sock >= 0, "accept failed");
+
+	/* Write space on a native TCP socket is polled, read readiness is
+	 * still reported by the callbacks.
+	 */
+	add_fd(c_sock_tcp, ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT);
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].events, ZSOCK_EPOLLOUT, "");
+	zassert_equal(ev[0].data.fd, c_sock_tcp, "");
+
+	res = zsock_send(new_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(res, STRLEN(TEST_STR_SMALL), "send failed");
+
+	/* The socket is reported writable right away, so let the data
+	 * arrive first.
+	 */
+	k_msleep(50);
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].events, ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT, "");
+
+	res = zsock_close(c_sock_tcp);
+	zassert_equal(res, 0, "close failed");
+	res = zsock_close(new_sock);
+	zassert_equal(res, 0, "close failed");
+	res = zsock_close(s_sock_tcp);
+	zassert_equal(res, 0, "close failed");
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+ZTEST(net_socket_epoll, test_eventfd)
+{
+	struct zsock_epoll_event ev[2];
+	eventfd_t val;
+	int efd;
+	int res;
+
+	efd = eventfd(0, EFD_NONBLOCK);
+	zassert_true(efd >= 0, "eventfd failed (%d)", errno);
+
+	add_fd(efd, ZSOCK_EPOLLIN);
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 30);
+	zassert_equal(res, 0, "");
+
+	zassert_equal(eventfd_write(efd, 1), 0, "eventfd_write failed");
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 100);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev[0].events, ZSOCK_EPOLLIN, "");
+	zassert_equal(ev[0].data.fd, efd, "");
+
+	zassert_equal(eventfd_read(efd, &val), 0, "eventfd_read failed");
+	zassert_equal(val, 1, "");
+
+	res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+	zassert_equal(res, 0, "");
+
+	res = zsock_epoll_ctl(epfd, ZSOCK_EPOLL_CTL_DEL, efd, NULL);
+	zassert_equal(res, 0, "epoll_ctl failed (%d)", errno);
+
+	zassert_equal(zsock_close(efd), 0, "close failed");
+}
+
+ZTEST(net_socket_epoll, test_eventfd_oneshot_close)
+{
+	struct zsock_epoll_event ev[2];
+	int efd;
+	int res;
+
+	/* A disarmed item of a closed eventfd must give back its slot, so
+	 * this would run out of items without that.
+	 */
+	for (int i = 0; i < CONFIG_NET_SOCKETS_EPOLL_MAX_ITEMS + 2; i++) {
+		efd = eventfd(1, EFD_NONBLOCK);
+		zassert_true(efd >= 0, "eventfd failed (%d)", errno);
+
+		add_fd(efd, ZSOCK_EPOLLIN | ZSOCK_EPOLLONESHOT);
+
+		res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+		zassert_equal(res, 1, "");
+		zassert_equal(ev[0].data.fd, efd, "");
+
+		zassert_equal(zsock_close(efd), 0, "close failed");
+
+		res = zsock_epoll_wait(epfd, ev, ARRAY_SIZE(ev), 0);
+		zassert_equal(res, 0, "");
+	}
+}
+
+static K_THREAD_STACK_DEFINE(waiter_stack, 1024);
+static struct k_thread waiter_thread;
+static int waiter_res;
+static int waiter_errno;
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	struct zsock_epoll_event ev;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	waiter_res = zsock_epoll_wait(POINTER_TO_INT(p1), &ev, 1, -1);
+	waiter_errno = errno;
+}
+
+ZTEST(net_socket_epoll, test_close_while_waiting)
+{
+	struct zsock_epoll_event ev;
+	int wait_fd;
+	int new_fd;
+
+	wait_fd = zsock_epoll_create(0);
+	zassert_true(wait_fd >= 0, "epoll_create failed (%d)", errno);
+
+	k_thread_create(&waiter_thread, waiter_stack, K_THREAD_STACK_SIZEOF(waiter_stack),
+			waiter, INT_TO_POINTER(wait_fd), NULL, NULL, K_PRIO_PREEMPT(8), 0,
+			K_NO_WAIT);
+
+	/* Let the waiter block in epoll_wait() */
+	k_msleep(50);
+
+	zassert_equal(zsock_close(wait_fd), 0, "close failed");
+
+	/* The new instance must not reuse the slot while the waiter is in it */
+	new_fd = zsock_epoll_create(0);
+	zassert_true(new_fd >= 0, "epoll_create failed (%d)", errno);
+
+	zassert_ok(k_thread_join(&waiter_thread, K_SECONDS(1)), "Waiter not woken up");
+	zassert_equal(waiter_res, -1, "");
+	zassert_equal(waiter_errno, EBADF, "");
+
+	zassert_equal(zsock_epoll_wait(new_fd, &ev, 1, 0), 0, "");
+	zassert_equal(zsock_close(new_fd), 0, "close failed");
+}
+
+ZTEST_SUITE(net_socket_epoll, NULL, setup, before, after, NULL);
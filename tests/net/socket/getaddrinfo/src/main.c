@@ -11,6 +11,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <zephyr/ztest_assert.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/sem.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/net/socket.h>
 #include <zephyr/net/dns_resolve.h>
 #include <zephyr/net/buf.h>
@@ -26,6 +27,12 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
 #define THREAD_PRIORITY K_PRIO_COOP(2)
 #define WAIT_TIME K_MSEC(250)
+#define ANSWER_TTL 60
+
+/* Queries sent before the first answer, A and AAAA at once given two
+ * resolver slots.
+ */
+#define PARALLEL_QUERIES MIN(CONFIG_DNS_NUM_CONCUR_QUERIES, 2)
 
 static uint8_t recv_buf[MAX_BUF_SIZE];
 
@@ -43,6 +50,25 @@ static int expected_query_count =
 	2 * (LOG2CEIL(DIV_ROUND_UP(CONFIG_NET_SOCKETS_DNS_TIMEOUT,
 				   CONFIG_NET_SOCKETS_DNS_BACKOFF_INTERVAL) + 1));
 
+/* When set, process_dns() answers the queries once PARALLEL_QUERIES of them
+ * are pending, the last one received first.
+ */
+static bool answer_queries;
+static int max_pending;
+static int pending_count;
+
+static struct pending_query {
+	uint8_t buf[MAX_BUF_SIZE];
+	int len;
+	int sock;
+	struct sockaddr_in6 addr;
+	socklen_t addr_len;
+} pending[2];
+
+static const uint8_t answer_v4[] = { 192, 0, 2, 1 };
+static const uint8_t answer_v6[] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				     0, 0, 0, 0, 0, 0, 0, 0x01 };
+
 /* The semaphore is there to wait the data to be received. */
 static ZTEST_BMEM struct sys_sem wait_data;
 
@@ -108,6 +134,83 @@ static bool check_dns_query(uint8_t *buf, int buf_len)
 	return true;
 }
 
+static void send_answer(struct pending_query *query)
+{
+	uint8_t *buf = query->buf;
+	int pos = DNS_MSG_HEADER_SIZE;
+	const uint8_t *rdata;
+	uint16_t rdlength;
+	uint16_t qtype;
+
+	/* Skip the question name */
+	while (pos < query->len && buf[pos] != 0) {
+		pos += buf[pos] + 1;
+	}
+
+	pos++;
+	if (pos + 4 > query->len) {
+		NET_ERR("Invalid query");
+		return;
+	}
+
+	qtype = sys_get_be16(&buf[pos]);
+	pos += 4;
+
+	if (qtype == DNS_RR_TYPE_A) {
+		rdata = answer_v4;
+		rdlength = sizeof(answer_v4);
+	} else {
+		rdata = answer_v6;
+		rdlength = sizeof(answer_v6);
+	}
+
+	/* The question is kept, one answer pointing to its name follows */
+	buf[2] = 0x81;
+	buf[3] = 0x80;
+	sys_put_be16(1, &buf[6]);
+	memset(&buf[8], 0, 4);
+
+	buf[pos++] = 0xc0;
+	buf[pos++] = DNS_MSG_HEADER_SIZE;
+	sys_put_be16(qtype, &buf[pos]);
+	sys_put_be16(DNS_CLASS_IN, &buf[pos + 2]);
+	sys_put_be32(ANSWER_TTL, &buf[pos + 4]);
+	sys_put_be16(rdlength, &buf[pos + 8]);
+	pos += 10;
+
+	memcpy(&buf[pos], rdata, rdlength);
+	pos += rdlength;
+
+	(void)zsock_sendto(query->sock, buf, pos, 0,
+			   (struct sockaddr *)&query->addr, query->addr_len);
+}
+
+static void answer_query(int sock)
+{
+	struct pending_query *query = &pending[pending_count];
+
+	query->addr_len = sizeof(query->addr);
+	query->len = zsock_recvfrom(sock, query->buf, sizeof(query->buf), 0,
+				    (struct sockaddr *)&query->addr,
+				    &query->addr_len);
+	if (query->len < DNS_MSG_HEADER_SIZE) {
+		NET_ERR("DNS: Invalid query (%d)", query->len);
+		return;
+	}
+
+	query->sock = sock;
+	pending_count++;
+	max_pending = MAX(max_pending, pending_count);
+
+	if (pending_count < PARALLEL_QUERIES) {
+		return;
+	}
+
+	while (pending_count > 0) {
+		send_answer(&pending[--pending_count]);
+	}
+}
+
 static int process_dns(void)
 {
 	struct zsock_pollfd pollfds[2];
@@ -136,6 +239,11 @@ static int process_dns(void)
 
 		for (idx = 0; idx < ARRAY_SIZE(pollfds); idx++) {
 			if (pollfds[idx].revents & ZSOCK_POLLIN) {
+				if (answer_queries) {
+					answer_query(pollfds[idx].fd);
+					continue;
+				}
+
 				if (pollfds[idx].fd == sock_v4) {
 					addr_len = sizeof(addr_v4);
 					addr = (struct sockaddr *)&addr_v4;
@@ -227,6 +335,13 @@ ZTEST(net_socket_getaddrinfo, test_getaddrinfo_ok)
 {
 	struct zsock_addrinfo *res = NULL;
 
+	/* With a single resolver slot the AAAA query is only sent once
+	 * the A query has given up, so the count differs.
+	 */
+	if (PARALLEL_QUERIES < 2) {
+		ztest_test_skip();
+	}
+
 	queries_received = 0;
 
 	/* This check simulates a local query that we will catch
@@ -252,6 +367,13 @@ ZTEST(net_socket_getaddrinfo, test_getaddrinfo_cancelled)
 	struct zsock_addrinfo *res = NULL;
 	int ret;
 
+	/* With a single resolver slot the AAAA query is only sent once
+	 * the A query has given up, so the count differs.
+	 */
+	if (PARALLEL_QUERIES < 2) {
+		ztest_test_skip();
+	}
+
 	ret = zsock_getaddrinfo(QUERY_HOST, NULL, NULL, &res);
 
 	(void)sys_sem_take(&wait_data, K_NO_WAIT);
@@ -267,6 +389,56 @@ ZTEST(net_socket_getaddrinfo, test_getaddrinfo_cancelled)
 	zsock_freeaddrinfo(res);
 }
 
+ZTEST(net_socket_getaddrinfo, test_getaddrinfo_a_and_aaaa)
+{
+	struct zsock_addrinfo hints = {
+		.ai_socktype = SOCK_STREAM,
+	};
+	struct zsock_addrinfo *res = NULL;
+	struct zsock_addrinfo *ai;
+	int ret;
+
+	max_pending = 0;
+	answer_queries = true;
+
+	ret = zsock_getaddrinfo(QUERY_HOST, "80", &hints, &res);
+
+	answer_queries = false;
+
+	zassert_equal(ret, 0, "Invalid result (%d)", ret);
+
+	/* Both queries are sent before either is answered, or with a single
+	 * resolver slot the AAAA query once the A query is done.
+	 */
+	zassert_equal(max_pending, PARALLEL_QUERIES,
+		      "Unexpected queries in parallel (%d)", max_pending);
+
+	/* Addresses are listed in the order the answers arrive */
+	zassert_not_null(res, "");
+	zassert_not_null(res->ai_next, "");
+	zassert_is_null(res->ai_next->ai_next, "");
+	zassert_equal(res->ai_family, PARALLEL_QUERIES > 1 ? AF_INET6 : AF_INET,
+		      "Addresses not in the order of the answers");
+
+	for (ai = res; ai != NULL; ai = ai->ai_next) {
+		zassert_equal(ai->ai_socktype, SOCK_STREAM, "");
+		zassert_equal(ai->ai_protocol, IPPROTO_TCP, "");
+
+		if (ai->ai_family == AF_INET) {
+			zassert_equal(net_sin(ai->ai_addr)->sin_port, htons(80), "");
+			zassert_mem_equal(&net_sin(ai->ai_addr)->sin_addr, answer_v4,
+					  sizeof(answer_v4), "Wrong IPv4 address");
+		} else {
+			zassert_equal(ai->ai_family, AF_INET6, "");
+			zassert_equal(net_sin6(ai->ai_addr)->sin6_port, htons(80), "");
+			zassert_mem_equal(&net_sin6(ai->ai_addr)->sin6_addr, answer_v6,
+					  sizeof(answer_v6), "Wrong IPv6 address");
+		}
+	}
+
+	zsock_freeaddrinfo(res);
+}
+
 ZTEST(net_socket_getaddrinfo, test_getaddrinfo_no_host)
 {
 	struct zsock_addrinfo *res = NULL;
@@ -0,0 +1,263 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <inttypes.h>
+
+#include <zephyr/ztest_assert.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/dummy.h>
+
+#include "ipv6.h"
+
+#define MY_IPV4_ADDR "127.0.0.1"
+#define MY_IPV6_ADDR "::1"
+
+/* Network of the black hole interface, which drops whatever it is given */
+#define BLACKHOLE_IPV6_ADDR "2001:db8::1"
+#define BLACKHOLE_PEER_ADDR "2001:db8::2"
+
+#define SERVER_PORT 4242
+#define CLOSED_PORT 4243
+
+#define CONNECT_TIMEOUT_MS 2000
+
+#define TCP_TEARDOWN_TIMEOUT K_SECONDS(3)
+
+static struct sockaddr_in addr_v4;
+static struct sockaddr_in6 addr_v6;
+static struct sockaddr_in6 addr_blackhole;
+
+static struct zsock_addrinfo ai_v4 = {
+	.ai_family = AF_INET,
+	.ai_socktype = SOCK_STREAM,
+	.ai_protocol = IPPROTO_TCP,
+	.ai_addr = (struct sockaddr *)&addr_v4,
+	.ai_addrlen = sizeof(addr_v4),
+};
+
+static struct zsock_addrinfo ai_v6 = {
+	.ai_family = AF_INET6,
+	.ai_socktype = SOCK_STREAM,
+	.ai_protocol = IPPROTO_TCP,
+	.ai_addr = (struct sockaddr *)&addr_v6,
+	.ai_addrlen = sizeof(addr_v6),
+};
+
+static struct zsock_addrinfo ai_blackhole = {
+	.ai_family = AF_INET6,
+	.ai_socktype = SOCK_STREAM,
+	.ai_protocol = IPPROTO_TCP,
+	.ai_addr = (struct sockaddr *)&addr_blackhole,
+	.ai_addrlen = sizeof(addr_blackhole),
+};
+
+static atomic_t blackhole_sent;
+
+static int blackhole_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	atomic_inc(&blackhole_sent);
+
+	return 0;
+}
+
+static void blackhole_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+	struct in6_addr addr;
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+
+	zassert_equal(zsock_inet_pton(AF_INET6, BLACKHOLE_IPV6_ADDR, &addr), 1,
+		      "inet_pton failed");
+	zassert_not_null(net_if_ipv6_addr_add(iface, &addr, NET_ADDR_MANUAL, 0),
+			 "ipv6 addr");
+	zassert_not_null(net_if_ipv6_prefix_add(iface, &addr, 64,
+						NET_IPV6_ND_INFINITE_LIFETIME),
+			 "ipv6 prefix");
+}
+
+static struct dummy_api blackhole_api = {
+	.iface_api.init = blackhole_iface_init,
+	.send = blackhole_send,
+};
+
+NET_DEVICE_INIT(blackhole, "blackhole", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &blackhole_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static int listen_v4 = -1;
+static int listen_v6 = -1;
+
+static void set_port(uint16_t port)
+{
+	addr_v4.sin_port = htons(port);
+	addr_v6.sin6_port = htons(port);
+	addr_blackhole.sin6_port = htons(port);
+}
+
+static int start_listen(struct sockaddr *addr, socklen_t addrlen)
+{
+	int sock;
+	int ret;
+
+	sock = zsock_socket(addr->sa_family, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "socket open failed");
+
+	ret = zsock_bind(sock, addr, addrlen);
+	zassert_equal(ret, 0, "bind failed (%d)", errno);
+
+	ret = zsock_listen(sock, 1);
+	zassert_equal(ret, 0, "listen failed (%d)", errno);
+
+	return sock;
+}
+
+static void check_connected(int sock, int family, int listener)
+{
+	struct sockaddr_storage peer;
+	socklen_t peerlen = sizeof(peer);
+	int accepted;
+	int ret;
+
+	zassert_true(sock >= 0, "connect failed (%d)", errno);
+
+	ret = zsock_getpeername(sock, (struct sockaddr *)&peer, &peerlen);
+	zassert_equal(ret, 0, "getpeername failed (%d)", errno);
+	zassert_equal(peer.ss_family, family, "connected to the wrong family");
+
+	accepted = zsock_accept(listener, NULL, NULL);
+	zassert_true(accepted >= 0, "accept failed (%d)", errno);
+
+	(void)zsock_close(accepted);
+	(void)zsock_close(sock);
+}
+
+static void *setup(void)
+{
+	addr_v4.sin_family = AF_INET;
+	zassert_equal(zsock_inet_pton(AF_INET, MY_IPV4_ADDR, &addr_v4.sin_addr), 1,
+		      "inet_pton failed");
+
+	addr_v6.sin6_family = AF_INET6;
+	zassert_equal(zsock_inet_pton(AF_INET6, MY_IPV6_ADDR, &addr_v6.sin6_addr), 1,
+		      "inet_pton failed");
+
+	addr_blackhole.sin6_family = AF_INET6;
+	zassert_equal(zsock_inet_pton(AF_INET6, BLACKHOLE_PEER_ADDR,
+				      &addr_blackhole.sin6_addr), 1,
+		      "inet_pton failed");
+
+	return NULL;
+}
+
+static void after(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	if (listen_v4 >= 0) {
+		(void)zsock_close(listen_v4);
+		listen_v4 = -1;
+	}
+
+	if (listen_v6 >= 0) {
+		(void)zsock_close(listen_v6);
+		listen_v6 = -1;
+	}
+
+	ai_v4.ai_next = NULL;
+	ai_v6.ai_next = NULL;
+	ai_blackhole.ai_next = NULL;
+
+	/* Let the closed connections go away before the next test */
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+ZTEST(net_socket_happy_eyeballs, test_ipv6_first)
+{
+	int sock;
+
+	set_port(SERVER_PORT);
+	listen_v4 = start_listen((struct sockaddr *)&addr_v4, sizeof(addr_v4));
+	listen_v6 = start_listen((struct sockaddr *)&addr_v6, sizeof(addr_v6));
+
+	/* IPv6 is tried first whatever the order of the list */
+	ai_v4.ai_next = &ai_v6;
+
+	sock = zsock_connect_happy_eyeballs(&ai_v4, CONNECT_TIMEOUT_MS);
+	check_connected(sock, AF_INET6, listen_v6);
+}
+
+ZTEST(net_socket_happy_eyeballs, test_fallback_to_ipv4)
+{
+	int sock;
+
+	set_port(SERVER_PORT);
+	listen_v4 = start_listen((struct sockaddr *)&addr_v4, sizeof(addr_v4));
+
+	ai_v6.ai_next = &ai_v4;
+
+	sock = zsock_connect_happy_eyeballs(&ai_v6, CONNECT_TIMEOUT_MS);
+	check_connected(sock, AF_INET, listen_v4);
+}
+
+ZTEST(net_socket_happy_eyeballs, test_ipv6_blackhole)
+{
+	int64_t start;
+	int64_t elapsed;
+	int sock;
+
+	set_port(SERVER_PORT);
+	listen_v4 = start_listen((struct sockaddr *)&addr_v4, sizeof(addr_v4));
+
+	/* The IPv6 attempt is never answered, IPv4 is tried once the delay is
+	 * over without waiting for the IPv6 connect to time out.
+	 */
+	ai_blackhole.ai_next = &ai_v4;
+	atomic_clear(&blackhole_sent);
+
+	start = k_uptime_get();
+	sock = zsock_connect_happy_eyeballs(&ai_blackhole, CONNECT_TIMEOUT_MS);
+	elapsed = k_uptime_delta(&start);
+
+	zassert_true(atomic_get(&blackhole_sent) > 0, "IPv6 not tried");
+	zassert_true(elapsed >= CONFIG_NET_SOCKETS_HAPPY_EYEBALLS_DELAY,
+		     "IPv4 tried too early (%" PRId64 " ms)", elapsed);
+	zassert_true(elapsed < CONNECT_TIMEOUT_MS, "No fallback (%" PRId64 " ms)", elapsed);
+
+	check_connected(sock, AF_INET, listen_v4);
+}
+
+ZTEST(net_socket_happy_eyeballs, test_single_address)
+{
+	int sock;
+
+	set_port(SERVER_PORT);
+	listen_v4 = start_listen((struct sockaddr *)&addr_v4, sizeof(addr_v4));
+
+	sock = zsock_connect_happy_eyeballs(&ai_v4, CONNECT_TIMEOUT_MS);
+	check_connected(sock, AF_INET, listen_v4);
+}
+
+ZTEST(net_socket_happy_eyeballs, test_all_refused)
+{
+	int sock;
+
+	set_port(CLOSED_PORT);
+	ai_v6.ai_next = &ai_v4;
+
+	sock = zsock_connect_happy_eyeballs(&ai_v6, CONNECT_TIMEOUT_MS);
+	zassert_equal(sock, -1, "connect should fail");
+	zassert_equal(errno, ECONNREFUSED, "unexpected errno (%d)", errno);
+}
+
+ZTEST_SUITE(net_socket_happy_eyeballs, NULL, setup, NULL, after, NULL);
@@ -0,0 +1,208 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <ff.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+
+#include "../../socket_helpers.h"
+
+#define MY_IPV4_ADDR "127.0.0.1"
+#define SERVER_PORT 4242
+
+#define FATFS_MNTP "/RAM:"
+#define TEST_FILE FATFS_MNTP "/sendfile.bin"
+
+/* Larger than the loopback MTU so that the data spans several segments */
+#define TEST_FILE_LEN 2000
+
+/* Stays within CONFIG_NET_SOCKETPAIR_BUFFER_SIZE as nobody reads
+ * concurrently from the other end of the pair.
+ */
+#define BOUNCE_LEN 200
+
+static FATFS fat_fs;
+
+static struct fs_mount_t fatfs_mnt = {
+	.type = FS_FATFS,
+	.mnt_point = FATFS_MNTP,
+	.fs_data = &fat_fs,
+};
+
+static uint8_t file_data[TEST_FILE_LEN];
+static uint8_t rx_buf[TEST_FILE_LEN];
+
+static struct fs_file_t file;
+static int c_sock = -1;
+static int s_sock = -1;
+static int new_sock = -1;
+
+/* Each test listens on its own port, so that the connections of the
+ * previous test do not need to be fully closed.
+ */
+static uint16_t server_port = SERVER_PORT;
+
+static void recv_all(int sock, uint8_t *buf, size_t len)
+{
+	size_t received = 0;
+	ssize_t ret;
+
+	while (received < len) {
+		ret = zsock_recv(sock, buf + received, len - received, 0);
+		zassert_true(ret > 0, "recv failed (%d)", errno);
+		received += ret;
+	}
+}
+
+static void *setup(void)
+{
+	ssize_t written;
+
+	zassert_ok(fs_mount(&fatfs_mnt), "mount failed");
+
+	for (size_t i = 0; i < sizeof(file_data); i++) {
+		file_data[i] = (uint8_t)(i * 7);
+	}
+
+	fs_file_t_init(&file);
+	zassert_ok(fs_open(&file, TEST_FILE, FS_O_CREATE | FS_O_WRITE),
+		   "open for writing failed");
+	written = fs_write(&file, file_data, sizeof(file_data));
+	zassert_equal(written, sizeof(file_data), "write failed (%d)", written);
+	zassert_ok(fs_close(&file), "close failed");
+
+	return NULL;
+}
+
+static void teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)fs_unlink(TEST_FILE);
+	(void)fs_unmount(&fatfs_mnt);
+}
+
+static void before(void *fixture)
+{
+	struct zsock_timeval tv = { .tv_sec = 1 };
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+
+	ARG_UNUSED(fixture);
+
+	fs_file_t_init(&file);
+	zassert_ok(fs_open(&file, TEST_FILE, FS_O_READ), "open failed");
+
+	prepare_sock_tcp_v4(MY_IPV4_ADDR, 0, &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(MY_IPV4_ADDR, server_port++, &s_sock, &s_saddr);
+
+	zassert_ok(zsock_bind(s_sock, (struct sockaddr *)&s_saddr,
+			      sizeof(s_saddr)), "bind failed (%d)", errno);
+	zassert_ok(zsock_listen(s_sock, 1), "listen failed (%d)", errno);
+	zassert_ok(zsock_connect(c_sock, (struct sockaddr *)&s_saddr,
+				 sizeof(s_saddr)), "connect failed (%d)", errno);
+
+	new_sock = zsock_accept(s_sock, NULL, NULL);
+	zassert_true(new_sock >= 0, "accept failed (%d)", errno);
+
+	zassert_ok(zsock_setsockopt(new_sock, SOL_SOCKET, SO_RCVTIMEO,
+				    &tv, sizeof(tv)));
+}
+
+static void after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)fs_close(&file);
+
+	(void)zsock_close(c_sock);
+	(void)zsock_close(new_sock);
+	(void)zsock_close(s_sock);
+}
+
+ZTEST(net_socket_sendfile, test_file_position)
+{
+	ssize_t sent;
+
+	sent = zsock_sendfile(c_sock, &file, NULL, TEST_FILE_LEN);
+	zassert_equal(sent, TEST_FILE_LEN, "sendfile failed (%d)", errno);
+	zassert_equal(fs_tell(&file), TEST_FILE_LEN, "file position not advanced");
+
+	recv_all(new_sock, rx_buf, TEST_FILE_LEN);
+	zassert_mem_equal(rx_buf, file_data, TEST_FILE_LEN, "wrong data");
+
+	/* At the end of the file nothing more is sent */
+	sent = zsock_sendfile(c_sock, &file, NULL, TEST_FILE_LEN);
+	zassert_equal(sent, 0, "data sent past the end of file");
+}
+
+ZTEST(net_socket_sendfile, test_offset)
+{
+	off_t offset = 100;
+	ssize_t sent;
+
+	zassert_ok(fs_seek(&file, 10, FS_SEEK_SET));
+
+	sent = zsock_sendfile(c_sock, &file, &offset, 500);
+	zassert_equal(sent, 500, "sendfile failed (%d)", errno);
+	zassert_equal(offset, 600, "offset not updated");
+	zassert_equal(fs_tell(&file), 10, "file position changed");
+
+	recv_all(new_sock, rx_buf, 500);
+	zassert_mem_equal(rx_buf, file_data + 100, 500, "wrong data");
+
+	/* A count past the end of the file is cut short */
+	sent = zsock_sendfile(c_sock, &file, &offset, TEST_FILE_LEN);
+	zassert_equal(sent, TEST_FILE_LEN - 600, "sendfile failed (%d)", errno);
+	zassert_equal(offset, TEST_FILE_LEN, "offset not updated");
+
+	recv_all(new_sock, rx_buf, TEST_FILE_LEN - 600);
+	zassert_mem_equal(rx_buf, file_data + 600, TEST_FILE_LEN - 600,
+			  "wrong data");
+}
+
+ZTEST(net_socket_sendfile, test_bounce)
+{
+	off_t offset = 1000;
+	ssize_t sent;
+	int sv[2];
+
+	/* A socket pair is not a native TCP socket, so the data goes through
+	 * the bounce buffer.
+	 */
+	zassert_ok(zsock_socketpair(AF_UNIX, SOCK_STREAM, 0, sv),
+		   "socketpair failed (%d)", errno);
+
+	sent = zsock_sendfile(sv[0], &file, &offset, BOUNCE_LEN);
+	zassert_equal(sent, BOUNCE_LEN, "sendfile failed (%d)", errno);
+	zassert_equal(offset, 1000 + BOUNCE_LEN, "offset not updated");
+	zassert_equal(fs_tell(&file), 0, "file position changed");
+
+	recv_all(sv[1], rx_buf, BOUNCE_LEN);
+	zassert_mem_equal(rx_buf, file_data + 1000, BOUNCE_LEN, "wrong data");
+
+	zassert_ok(zsock_close(sv[0]));
+	zassert_ok(zsock_close(sv[1]));
+}
+
+ZTEST(net_socket_sendfile, test_invalid)
+{
+	ssize_t sent;
+
+	sent = zsock_sendfile(c_sock, NULL, NULL, TEST_FILE_LEN);
+	zassert_equal(sent, -1, "sendfile succeeded");
+	zassert_equal(errno, EINVAL, "wrong errno (%d)", errno);
+
+	sent = zsock_sendfile(-1, &file, NULL, TEST_FILE_LEN);
+	zassert_equal(sent, -1, "sendfile succeeded");
+	zassert_equal(errno, EBADF, "wrong errno (%d)", errno);
+}
+
+ZTEST_SUITE(net_socket_sendfile, NULL, setup, before, after, teardown);
@@ -2528,6 +2528,274 @@ ZTEST(net_socket_udp, test_37_ipv6_src_addr_select)
 				       &my_addr3, &dest);
 }
 
+ZTEST(net_socket_udp, test_38_v4_recvmsg_zc)
+{
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in src_addr;
+	struct iovec io_vector[8];
+	struct msghdr msg = { 0 };
+	int client_sock;
+	int server_sock;
+	void *token;
+	size_t copied = 0;
+	ssize_t recved;
+	int rv;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = zsock_bind(server_sock, (struct sockaddr *)&server_addr,
+			sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	rv = zsock_sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+			  (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR2), "sendto failed");
+
+	io_vector[0].iov_base = rx_buf;
+	io_vector[0].iov_len = sizeof(rx_buf);
+
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	msg.msg_name = &src_addr;
+	msg.msg_namelen = sizeof(src_addr);
+
+	recved = zsock_recvmsg_zc(server_sock, &msg, &token, 0);
+	zassert_equal(recved, STRLEN(TEST_STR2), "recvmsg_zc failed");
+	zassert_not_null(token, "Data was copied");
+	zassert_false(msg.msg_flags & ZSOCK_MSG_TRUNC, "Data truncated");
+	zassert_equal(src_addr.sin_family, AF_INET, "wrong source");
+
+	for (size_t i = 0; i < msg.msg_iovlen; i++) {
+		zassert_not_equal(io_vector[i].iov_base, rx_buf,
+				  "Vector points to the user buffer");
+		zassert_mem_equal(io_vector[i].iov_base, TEST_STR2 + copied,
+				  io_vector[i].iov_len, "wrong data");
+		copied += io_vector[i].iov_len;
+	}
+
+	zassert_equal(copied, STRLEN(TEST_STR2), "wrong vector length");
+
+	zsock_recvmsg_zc_release(token);
+
+	rv = zsock_close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = zsock_close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+ZTEST_USER(net_socket_udp, test_39_v4_sendmmsg_recvmmsg)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	int received;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	char rx_bufs[2][sizeof(TEST_STR_SMALL)];
+	struct iovec tx_iov[2];
+	struct iovec rx_iov[2];
+	struct mmsghdr tx_msgs[2];
+	struct mmsghdr rx_msgs[2];
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = zsock_bind(server_sock,
+			(struct sockaddr *)&server_addr,
+			sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	memset(tx_msgs, 0, sizeof(tx_msgs));
+	memset(rx_msgs, 0, sizeof(rx_msgs));
+
+	for (int i = 0; i < ARRAY_SIZE(tx_msgs); i++) {
+		tx_iov[i].iov_base = TEST_STR_SMALL;
+		tx_iov[i].iov_len = STRLEN(TEST_STR_SMALL) - i;
+		tx_msgs[i].msg_hdr.msg_name = &server_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+		tx_msgs[i].msg_hdr.msg_iov = &tx_iov[i];
+		tx_msgs[i].msg_hdr.msg_iovlen = 1;
+
+		rx_iov[i].iov_base = rx_bufs[i];
+		rx_iov[i].iov_len = sizeof(rx_bufs[i]);
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	rv = zsock_sendmmsg(client_sock, tx_msgs, ARRAY_SIZE(tx_msgs), 0);
+	zassert_equal(rv, ARRAY_SIZE(tx_msgs), "sendmmsg failed (%d)", errno);
+
+	for (int i = 0; i < ARRAY_SIZE(tx_msgs); i++) {
+		zassert_equal(tx_msgs[i].msg_len, tx_iov[i].iov_len,
+			      "wrong sent length");
+	}
+
+	for (received = 0; received < ARRAY_SIZE(rx_msgs); received += rv) {
+		rv = zsock_recvmmsg(server_sock, &rx_msgs[received],
+				    ARRAY_SIZE(rx_msgs) - received, 0);
+		zassert_true(rv > 0, "recvmmsg failed (%d)", errno);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(rx_msgs); i++) {
+		zassert_equal(rx_msgs[i].msg_len, tx_iov[i].iov_len,
+			      "wrong received length");
+		zassert_mem_equal(rx_bufs[i], TEST_STR_SMALL, tx_iov[i].iov_len,
+				  "wrong data");
+	}
+
+	rv = zsock_close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = zsock_close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+ZTEST_USER(net_socket_udp, test_40_mmsg_invalid)
+{
+	int rv;
+	int sock;
+	struct sockaddr_in addr;
+	struct iovec io_vector[1];
+	struct mmsghdr msgs[1];
+
+	/* Userspace is needed for this test */
+	Z_TEST_SKIP_IFNDEF(CONFIG_USERSPACE);
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &sock, &addr);
+
+	rv = zsock_bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	/* The message vector itself is not accessible */
+	rv = zsock_sendmmsg(sock, (struct mmsghdr *)1, 1, 0);
+	zassert_true(rv < 0, "sendmmsg() succeeded");
+
+	rv = zsock_recvmmsg(sock, (struct mmsghdr *)1, 1, 0);
+	zassert_true(rv < 0, "recvmmsg() succeeded");
+
+	/* The vector length goes past the end of the user buffer */
+	rv = zsock_sendmmsg(sock, msgs, UINT_MAX, 0);
+	zassert_true(rv < 0, "sendmmsg() succeeded");
+
+	rv = zsock_recvmmsg(sock, msgs, UINT_MAX, 0);
+	zassert_true(rv < 0, "recvmmsg() succeeded");
+
+	/* The vector is fine but the buffer it points to is not */
+	io_vector[0].iov_base = (void *)1;
+	io_vector[0].iov_len = STRLEN(TEST_STR_SMALL);
+
+	memset(msgs, 0, sizeof(msgs));
+	msgs[0].msg_hdr.msg_name = &addr;
+	msgs[0].msg_hdr.msg_namelen = sizeof(addr);
+	msgs[0].msg_hdr.msg_iov = io_vector;
+	msgs[0].msg_hdr.msg_iovlen = 1;
+
+	rv = zsock_sendmmsg(sock, msgs, 1, 0);
+	zassert_true(rv < 0 && errno == ENOMEM, "Wrong errno (%d)", errno);
+
+	rv = zsock_recvmmsg(sock, msgs, 1, ZSOCK_MSG_DONTWAIT);
+	zassert_true(rv < 0 && errno == ENOMEM, "Wrong errno (%d)", errno);
+
+	/* A missing I/O vector is rejected as well */
+	msgs[0].msg_hdr.msg_iov = NULL;
+
+	rv = zsock_recvmmsg(sock, msgs, 1, ZSOCK_MSG_DONTWAIT);
+	zassert_true(rv < 0 && errno == ENOMEM, "Wrong errno (%d)", errno);
+
+	rv = zsock_close(sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+ZTEST(net_socket_udp, test_41_v4_recvmsg_zc_pktinfo)
+{
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct in_pktinfo *info = NULL;
+	struct iovec io_vector[1];
+	struct msghdr msg = { 0 };
+	struct cmsghdr *cmsg;
+	union {
+		struct cmsghdr hdr;
+		unsigned char  buf[CMSG_SPACE(sizeof(struct in_pktinfo))];
+	} cmsgbuf;
+	int client_sock;
+	int server_sock;
+	void *token;
+	ssize_t recved;
+	int opt = 1;
+	int rv;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_NET_CONTEXT_RECV_PKTINFO);
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = zsock_bind(server_sock, (struct sockaddr *)&server_addr,
+			sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	rv = zsock_setsockopt(server_sock, IPPROTO_IP, IP_PKTINFO, &opt,
+			      sizeof(opt));
+	zassert_equal(rv, 0, "setsockopt failed (%d)", -errno);
+
+	rv = zsock_sendto(client_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0,
+			  (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR_SMALL), "sendto failed");
+
+	io_vector[0].iov_base = rx_buf;
+	io_vector[0].iov_len = sizeof(rx_buf);
+
+	memset(&cmsgbuf, 0, sizeof(cmsgbuf));
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	msg.msg_control = &cmsgbuf.buf;
+	msg.msg_controllen = sizeof(cmsgbuf.buf);
+
+	recved = zsock_recvmsg_zc(server_sock, &msg, &token, 0);
+	zassert_equal(recved, STRLEN(TEST_STR_SMALL), "recvmsg_zc failed");
+	zassert_false(msg.msg_flags & ZSOCK_MSG_CTRUNC, "Control data truncated");
+
+	for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+	     cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		if (cmsg->cmsg_level == IPPROTO_IP &&
+		    cmsg->cmsg_type == IP_PKTINFO) {
+			info = (struct in_pktinfo *)CMSG_DATA(cmsg);
+			break;
+		}
+	}
+
+	zassert_not_null(info, "No IP_PKTINFO");
+	zassert_equal(info->ipi_addr.s_addr, server_addr.sin_addr.s_addr,
+		      "Destination address not set properly");
+
+	zsock_recvmsg_zc_release(token);
+
+	/* Without room for the control data the datagram is still received */
+	rv = zsock_sendto(client_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0,
+			  (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR_SMALL), "sendto failed");
+
+	memset(&msg, 0, sizeof(msg));
+	io_vector[0].iov_base = rx_buf;
+	io_vector[0].iov_len = sizeof(rx_buf);
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	msg.msg_control = &cmsgbuf.buf;
+	msg.msg_controllen = 1;
+
+	recved = zsock_recvmsg_zc(server_sock, &msg, &token, 0);
+	zassert_equal(recved, STRLEN(TEST_STR_SMALL), "recvmsg_zc failed");
+	zassert_true(msg.msg_flags & ZSOCK_MSG_CTRUNC, "Control data not truncated");
+
+	zsock_recvmsg_zc_release(token);
+
+	rv = zsock_close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = zsock_close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 static void after(void *arg)
 {
 	ARG_UNUSED(arg);
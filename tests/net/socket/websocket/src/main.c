@@ -398,6 +398,49 @@ ZTEST(net_websocket, test_send_and_recv_lorem_ipsum)
 	z_free_fd(fd);
 }
 
+ZTEST(net_websocket, test_send_masked_lorem_ipsum)
+{
+	static struct websocket_context ctx;
+	static uint8_t masked[sizeof(lorem_ipsum)];
+	const uint32_t masking_key = 0xe17e8eb9;
+	int fd, ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.recv_buf.buf = temp_recv_buf;
+	ctx.recv_buf.size = sizeof(temp_recv_buf);
+
+	test_msg_len = sizeof(lorem_ipsum) - 1;
+
+	/* Mask in unaligned pieces, the receiver unmasks in its own ones */
+	memcpy(masked, lorem_ipsum, test_msg_len);
+	websocket_mask(&masked[0], 3, masking_key, 0);
+	websocket_mask(&masked[3], 101, masking_key, 3);
+	websocket_mask(&masked[104], test_msg_len - 104, masking_key, 104);
+
+	fd = test_fd_alloc(&ctx);
+	ret = websocket_send_msg_masked(fd, masked, test_msg_len,
+					WEBSOCKET_OPCODE_DATA_TEXT, masking_key, true,
+					SYS_FOREVER_MS);
+	zassert_equal(ret, test_msg_len,
+		      "Should have sent %zd bytes but sent %d instead",
+		      test_msg_len, ret);
+
+	z_free_fd(fd);
+}
+
+ZTEST(net_websocket, test_mask)
+{
+	uint8_t data[sizeof(frame1_msg) - 1];
+
+	memcpy(data, frame1_msg, sizeof(data));
+	websocket_mask(data, sizeof(data), 0xe17e8eb9, 0);
+	zassert_mem_equal(data, &frame1[FRAME1_HDR_SIZE], sizeof(data), "Invalid masked data");
+
+	websocket_mask(data, sizeof(data), 0xe17e8eb9, 0);
+	zassert_mem_equal(data, frame1_msg, sizeof(data), "Invalid unmasked data");
+}
+
 ZTEST(net_websocket, test_recv_two_large_split_msg)
 {
 	static struct websocket_context ctx;
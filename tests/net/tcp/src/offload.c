@@ -0,0 +1,540 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Segmentation and receive coalescing of TCP segments on an Ethernet
+ * interface. The packets are built by hand and handed to the offload
+ * functions directly, nothing is sent.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_test, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_pkt.h>
+
+#include "ipv4.h"
+#include "ipv6.h"
+#include "net_private.h"
+#include "tcp_internal.h"
+#include "tcp_private.h"
+
+#include <zephyr/ztest.h>
+
+#if defined(CONFIG_NET_TCP_GSO) || defined(CONFIG_NET_TCP_GRO)
+
+#define OFFLOAD_PORT 4243
+
+static struct in_addr local_addr = { { { 192, 0, 2, 11 } } };
+static struct in_addr remote_addr = { { { 192, 0, 2, 12 } } };
+
+static uint8_t payload[700];
+static struct net_if *eth_iface;
+
+struct eth_offload_context {
+	uint8_t mac_addr[sizeof(struct net_eth_addr)];
+};
+
+static struct eth_offload_context eth_offload_context_data;
+
+static void eth_offload_iface_init(struct net_if *iface)
+{
+	const struct device *dev = net_if_get_device(iface);
+	struct eth_offload_context *context = dev->data;
+
+	net_if_set_link_addr(iface, context->mac_addr, sizeof(context->mac_addr),
+			     NET_LINK_ETHERNET);
+
+	ethernet_init(iface);
+}
+
+static int eth_offload_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static enum ethernet_hw_caps eth_offload_capabilities(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static struct ethernet_api eth_offload_api = {
+	.iface_api.init = eth_offload_iface_init,
+	.get_capabilities = eth_offload_capabilities,
+	.send = eth_offload_send,
+};
+
+static int eth_offload_init(const struct device *dev)
+{
+	struct eth_offload_context *context = dev->data;
+
+	/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+	context->mac_addr[0] = 0x00;
+	context->mac_addr[1] = 0x00;
+	context->mac_addr[2] = 0x5E;
+	context->mac_addr[3] = 0x00;
+	context->mac_addr[4] = 0x53;
+	context->mac_addr[5] = 0x11;
+
+	return 0;
+}
+
+ETH_NET_DEVICE_INIT(eth_offload_test, "eth_offload_test", eth_offload_init, NULL,
+		    &eth_offload_context_data, NULL, CONFIG_ETH_INIT_PRIORITY,
+		    &eth_offload_api, NET_ETH_MTU);
+
+#if defined(CONFIG_NET_TCP_GSO)
+static struct in6_addr local_addr_v6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					     0, 0, 0, 0, 0, 0, 0, 0x11 } } };
+static struct in6_addr remote_addr_v6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					      0, 0, 0, 0, 0, 0, 0, 0x12 } } };
+
+static struct net_pkt *offload_tcp_pkt(sa_family_t af, uint32_t seq, uint8_t flags,
+				       const uint8_t *data, size_t len)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
+	struct net_pkt *pkt;
+	struct tcphdr *th;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(eth_iface, sizeof(struct tcphdr) + len, af,
+					IPPROTO_TCP, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	if (af == AF_INET) {
+		ret = net_ipv4_create(pkt, &local_addr, &remote_addr);
+	} else {
+		ret = net_ipv6_create(pkt, &local_addr_v6, &remote_addr_v6);
+	}
+
+	zassert_ok(ret, "Cannot create IP header");
+
+	th = (struct tcphdr *)net_pkt_get_data(pkt, &tcp_access);
+	zassert_not_null(th, "Cannot get TCP header");
+
+	memset(th, 0, sizeof(*th));
+	th->th_sport = htons(OFFLOAD_PORT);
+	th->th_dport = htons(OFFLOAD_PORT);
+	th->th_off = 5U;
+	th->th_flags = flags;
+	th->th_win = htons(NET_IPV6_MTU);
+	th->th_seq = htonl(seq);
+	th->th_ack = htonl(1000U);
+
+	zassert_ok(net_pkt_set_data(pkt, &tcp_access));
+	zassert_ok(net_pkt_write(pkt, data, len));
+
+	return pkt;
+}
+
+static void offload_finalize(struct net_pkt *pkt)
+{
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_family(pkt) == AF_INET) {
+		zassert_ok(net_ipv4_finalize(pkt, IPPROTO_TCP));
+	} else {
+		zassert_ok(net_ipv6_finalize(pkt, IPPROTO_TCP));
+	}
+}
+
+static void check_segment(struct net_pkt *seg, uint32_t seq, uint8_t flags,
+			  const uint8_t *data, size_t len)
+{
+	size_t ip_len = net_pkt_ip_hdr_len(seg);
+	uint8_t ip[NET_IPV6H_LEN];
+	uint8_t got[sizeof(payload)];
+	struct tcphdr th;
+
+	zassert_equal(net_pkt_get_len(seg), ip_len + sizeof(th) + len,
+		      "Segment of %zu bytes, expected %zu", net_pkt_get_len(seg),
+		      ip_len + sizeof(th) + len);
+
+	net_pkt_cursor_init(seg);
+	zassert_ok(net_pkt_read(seg, ip, ip_len));
+	zassert_ok(net_pkt_read(seg, &th, sizeof(th)));
+	zassert_ok(net_pkt_read(seg, got, len));
+
+	if (net_pkt_family(seg) == AF_INET) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)ip;
+
+		zassert_equal(ntohs(UNALIGNED_GET(&hdr->len)), ip_len + sizeof(th) + len);
+		zassert_equal(calc_chksum(0, ip, NET_IPV4H_LEN), 0xffff,
+			      "Invalid IPv4 header checksum");
+	} else {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)ip;
+
+		zassert_equal(ntohs(UNALIGNED_GET(&hdr->len)), sizeof(th) + len);
+	}
+
+	zassert_equal(th_seq(&th), seq, "Sequence %u, expected %u", th_seq(&th), seq);
+	zassert_equal(th_flags(&th), flags, "Flags 0x%02x, expected 0x%02x", th_flags(&th),
+		      flags);
+	zassert_mem_equal(got, data, len, "Payload differs at sequence %u", seq);
+
+	net_pkt_cursor_init(seg);
+	zassert_equal(net_calc_chksum_tcp(seg), 0, "Invalid TCP checksum at sequence %u", seq);
+}
+
+static void test_gso_family(sa_family_t af)
+{
+	const uint16_t mss = 200U;
+	const uint32_t seq = 0xfffffe00U;
+	struct net_pkt *pkt;
+	struct net_pkt *seg;
+	sys_slist_t segments;
+	size_t offset = 0;
+	int count = 0;
+
+	/* Three full segments and a short one, the sequence number wraps */
+	pkt = offload_tcp_pkt(af, seq, ACK | PSH | FIN, payload, 3 * mss + 50);
+	net_pkt_set_gso_size(pkt, mss);
+	offload_finalize(pkt);
+
+	zassert_ok(net_tcp_gso_segment(pkt, &segments));
+
+	while (!sys_slist_is_empty(&segments)) {
+		size_t len;
+
+		seg = CONTAINER_OF(sys_slist_get_not_empty(&segments), struct net_pkt, next);
+		len = MIN(mss, 3 * mss + 50 - offset);
+
+		/* PSH and FIN stay on the last segment only */
+		check_segment(seg, seq + offset, offset + len == 3 * mss + 50 ?
+			      ACK | PSH | FIN : ACK, &payload[offset], len);
+
+		offset += len;
+		count++;
+		net_pkt_unref(seg);
+	}
+
+	zassert_equal(count, 4, "%d segments, expected 4", count);
+
+	/* The payload was moved, the headers are left for the caller */
+	zassert_equal(net_pkt_get_len(pkt), net_pkt_ip_hdr_len(pkt) + sizeof(struct tcphdr));
+	net_pkt_unref(pkt);
+}
+
+ZTEST(net_tcp_offload, test_gso_ipv4)
+{
+	test_gso_family(AF_INET);
+}
+
+ZTEST(net_tcp_offload, test_gso_ipv6)
+{
+	test_gso_family(AF_INET6);
+}
+
+ZTEST(net_tcp_offload, test_gso_exact_multiple)
+{
+	const uint16_t mss = 100U;
+	struct net_pkt *pkt;
+	sys_slist_t segments;
+	int count = 0;
+
+	pkt = offload_tcp_pkt(AF_INET, 1U, ACK, payload, 3 * mss);
+	net_pkt_set_gso_size(pkt, mss);
+	offload_finalize(pkt);
+
+	zassert_ok(net_tcp_gso_segment(pkt, &segments));
+
+	while (!sys_slist_is_empty(&segments)) {
+		struct net_pkt *seg = CONTAINER_OF(sys_slist_get_not_empty(&segments),
+						   struct net_pkt, next);
+
+		check_segment(seg, 1U + count * mss, ACK, &payload[count * mss], mss);
+		count++;
+		net_pkt_unref(seg);
+	}
+
+	zassert_equal(count, 3, "%d segments, expected 3", count);
+	net_pkt_unref(pkt);
+}
+
+ZTEST(net_tcp_offload, test_gso_no_copy)
+{
+	const uint16_t mss = 100U;
+	struct net_buf *bufs[3];
+	struct net_pkt *pkt;
+	sys_slist_t segments;
+	int count = 0;
+
+	/* Each segment in its own buffer, as TCP builds super-segments */
+	pkt = offload_tcp_pkt(AF_INET, 1U, ACK, payload, 0);
+
+	for (int i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = net_pkt_get_frag(pkt, mss, K_NO_WAIT);
+		zassert_not_null(bufs[i], "Cannot allocate buffer");
+		net_buf_add_mem(bufs[i], &payload[i * mss], mss);
+		net_pkt_append_buffer(pkt, bufs[i]);
+	}
+
+	net_pkt_set_gso_size(pkt, mss);
+	offload_finalize(pkt);
+
+	zassert_ok(net_tcp_gso_segment(pkt, &segments));
+
+	while (!sys_slist_is_empty(&segments)) {
+		struct net_pkt *seg = CONTAINER_OF(sys_slist_get_not_empty(&segments),
+						   struct net_pkt, next);
+
+		check_segment(seg, 1U + count * mss, ACK, &payload[count * mss], mss);
+		zassert_equal_ptr(seg->buffer->frags, bufs[count], "Payload of segment %d copied",
+				  count);
+		count++;
+		net_pkt_unref(seg);
+	}
+
+	zassert_equal(count, 3, "%d segments, expected 3", count);
+	net_pkt_unref(pkt);
+}
+
+ZTEST(net_tcp_offload, test_gso_no_size)
+{
+	struct net_pkt *pkt;
+	sys_slist_t segments;
+
+	pkt = offload_tcp_pkt(AF_INET, 1U, ACK, payload, 100);
+	offload_finalize(pkt);
+
+	zassert_equal(net_tcp_gso_segment(pkt, &segments), -EINVAL);
+	zassert_true(sys_slist_is_empty(&segments));
+	net_pkt_unref(pkt);
+}
+
+#endif /* CONFIG_NET_TCP_GSO */
+
+#if defined(CONFIG_NET_TCP_GRO)
+#define GRO_HDR_LEN (sizeof(struct net_eth_hdr) + NET_IPV4H_LEN + sizeof(struct tcphdr))
+
+/* A received Ethernet frame, as queued to the RX traffic class threads */
+static struct net_pkt *gro_frame(uint32_t seq, uint8_t flags, const uint8_t *data, size_t len)
+{
+	uint8_t frame[GRO_HDR_LEN];
+	struct net_eth_hdr *eth = (struct net_eth_hdr *)frame;
+	struct net_ipv4_hdr *ip = (struct net_ipv4_hdr *)(eth + 1);
+	struct tcphdr *th = (struct tcphdr *)(ip + 1);
+	uint16_t tcp_len = sizeof(*th) + len;
+	struct net_pkt *pkt;
+	uint16_t sum;
+
+	memset(frame, 0, sizeof(frame));
+
+	memcpy(&eth->dst, net_if_get_link_addr(eth_iface)->addr, sizeof(eth->dst));
+	eth->src.addr[0] = 0x00;
+	eth->src.addr[1] = 0x00;
+	eth->src.addr[2] = 0x5E;
+	eth->src.addr[3] = 0x00;
+	eth->src.addr[4] = 0x53;
+	eth->src.addr[5] = 0x12;
+	eth->type = htons(NET_ETH_PTYPE_IP);
+
+	ip->vhl = 0x45;
+	ip->len[0] = (NET_IPV4H_LEN + tcp_len) >> 8;
+	ip->len[1] = (NET_IPV4H_LEN + tcp_len) & 0xff;
+	ip->ttl = 64U;
+	ip->proto = IPPROTO_TCP;
+	memcpy(ip->src, &remote_addr, sizeof(remote_addr));
+	memcpy(ip->dst, &local_addr, sizeof(local_addr));
+	ip->chksum = htons(~calc_chksum(0, (uint8_t *)ip, NET_IPV4H_LEN));
+
+	th->th_sport = htons(OFFLOAD_PORT);
+	th->th_dport = htons(OFFLOAD_PORT);
+	th->th_seq = htonl(seq);
+	th->th_ack = htonl(1000U);
+	th->th_off = 5U;
+	th->th_flags = flags;
+	th->th_win = htons(NET_IPV6_MTU);
+
+	sum = calc_chksum(tcp_len + IPPROTO_TCP, ip->src, 2 * sizeof(struct in_addr));
+	sum = calc_chksum(sum, (uint8_t *)th, sizeof(*th));
+	sum = calc_chksum(sum, data, len);
+	th->th_sum = htons(~sum);
+
+	pkt = net_pkt_rx_alloc_with_buffer(eth_iface, sizeof(frame) + len, AF_UNSPEC, 0,
+					   K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate frame");
+
+	zassert_ok(net_pkt_write(pkt, frame, sizeof(frame)));
+	zassert_ok(net_pkt_write(pkt, data, len));
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static void check_merged(struct net_pkt *pkt, uint32_t seq, uint8_t flags, size_t len)
+{
+	uint8_t frame[GRO_HDR_LEN];
+	struct net_ipv4_hdr *ip = (struct net_ipv4_hdr *)(frame + sizeof(struct net_eth_hdr));
+	struct tcphdr *th = (struct tcphdr *)(ip + 1);
+	uint8_t got[sizeof(payload)];
+
+	zassert_equal(net_pkt_get_len(pkt), GRO_HDR_LEN + len, "Frame of %zu bytes, expected %zu",
+		      net_pkt_get_len(pkt), GRO_HDR_LEN + len);
+
+	net_pkt_cursor_init(pkt);
+	zassert_ok(net_pkt_read(pkt, frame, sizeof(frame)));
+	zassert_ok(net_pkt_read(pkt, got, len));
+	net_pkt_cursor_init(pkt);
+
+	zassert_equal((ip->len[0] << 8) + ip->len[1], NET_IPV4H_LEN + sizeof(*th) + len);
+	zassert_equal(calc_chksum(0, (uint8_t *)ip, NET_IPV4H_LEN), 0xffff,
+		      "Invalid IPv4 header checksum");
+	zassert_equal(th_seq(th), seq);
+	zassert_equal(th_flags(th), flags, "Flags 0x%02x, expected 0x%02x", th_flags(th), flags);
+	zassert_mem_equal(got, payload, len, "Merged payload differs");
+}
+
+ZTEST(net_tcp_offload, test_gro_in_order)
+{
+	struct net_tcp_gro gro;
+	struct net_pkt *head;
+
+	head = gro_frame(5000U, ACK, &payload[0], 100);
+	zassert_true(net_tcp_gro_init(&gro, head));
+
+	zassert_true(net_tcp_gro_merge(&gro, gro_frame(5100U, ACK, &payload[100], 100)));
+	zassert_true(net_tcp_gro_merge(&gro, gro_frame(5200U, ACK, &payload[200], 55)));
+	net_tcp_gro_finish(&gro);
+
+	check_merged(head, 5000U, ACK, 255);
+	zassert_true(net_pkt_is_chksum_done(head), "Merged frame not marked as verified");
+
+	net_pkt_unref(head);
+}
+
+ZTEST(net_tcp_offload, test_gro_out_of_order)
+{
+	struct net_tcp_gro gro;
+	struct net_pkt *head;
+	struct net_pkt *pkt;
+
+	head = gro_frame(5000U, ACK, &payload[0], 100);
+	zassert_true(net_tcp_gro_init(&gro, head));
+
+	/* A gap, then a retransmission of the head */
+	pkt = gro_frame(5200U, ACK, &payload[200], 100);
+	zassert_false(net_tcp_gro_merge(&gro, pkt));
+	zassert_equal(net_pkt_get_len(pkt), GRO_HDR_LEN + 100, "Refused frame modified");
+	net_pkt_unref(pkt);
+
+	pkt = gro_frame(5000U, ACK, &payload[0], 100);
+	zassert_false(net_tcp_gro_merge(&gro, pkt));
+	net_pkt_unref(pkt);
+
+	net_tcp_gro_finish(&gro);
+
+	check_merged(head, 5000U, ACK, 100);
+	zassert_false(net_pkt_is_chksum_done(head), "Unmerged frame marked as verified");
+
+	net_pkt_unref(head);
+}
+
+ZTEST(net_tcp_offload, test_gro_psh_fin_boundary)
+{
+	struct net_tcp_gro gro;
+	struct net_tcp_gro fin;
+	struct net_pkt *head;
+	struct net_pkt *pkt;
+
+	/* PSH is merged into the head and ends the coalescing */
+	head = gro_frame(5000U, ACK, &payload[0], 100);
+	zassert_true(net_tcp_gro_init(&gro, head));
+	zassert_true(net_tcp_gro_merge(&gro, gro_frame(5100U, ACK | PSH, &payload[100], 100)));
+
+	pkt = gro_frame(5200U, ACK, &payload[200], 100);
+	zassert_false(net_tcp_gro_merge(&gro, pkt), "Merged after PSH");
+	net_pkt_unref(pkt);
+
+	net_tcp_gro_finish(&gro);
+	check_merged(head, 5000U, ACK | PSH, 200);
+	net_pkt_unref(head);
+
+	/* FIN is not a pure data segment, it is neither merged nor merged into */
+	head = gro_frame(5000U, ACK, &payload[0], 100);
+	zassert_true(net_tcp_gro_init(&gro, head));
+
+	pkt = gro_frame(5100U, ACK | FIN, &payload[100], 100);
+	zassert_false(net_tcp_gro_merge(&gro, pkt), "FIN segment merged");
+	zassert_false(net_tcp_gro_init(&fin, pkt), "Coalescing into a FIN segment");
+	net_pkt_unref(pkt);
+
+	net_tcp_gro_finish(&gro);
+	net_pkt_unref(head);
+}
+
+ZTEST(net_tcp_offload, test_gro_size_limit)
+{
+	struct net_tcp_gro gro;
+	struct net_pkt *head;
+	struct net_pkt *pkt;
+
+	head = gro_frame(5000U, ACK, &payload[0], 100);
+	zassert_true(net_tcp_gro_init(&gro, head));
+	zassert_true(net_tcp_gro_merge(&gro, gro_frame(5100U, ACK, &payload[100], 100)));
+
+	/* Pretend that almost 64 KiB have been merged already, the next
+	 * segment would not fit into the 16-bit IP length. The head is not
+	 * finished, its lengths no longer match the pretended payload.
+	 */
+	gro.payload_len = UINT16_MAX - gro.hdr_len - 50;
+
+	pkt = gro_frame(5000U + gro.payload_len, ACK, &payload[200], 100);
+	zassert_false(net_tcp_gro_merge(&gro, pkt), "Merged beyond the IP length");
+	zassert_equal(net_pkt_get_len(pkt), GRO_HDR_LEN + 100, "Refused frame modified");
+	net_pkt_unref(pkt);
+
+	/* A segment that still fits is merged */
+	pkt = gro_frame(5000U + gro.payload_len, ACK, &payload[200], 50);
+	zassert_true(net_tcp_gro_merge(&gro, pkt), "Segment up to the limit not merged");
+	zassert_equal(gro.hdr_len + gro.payload_len, UINT16_MAX);
+
+	net_pkt_unref(head);
+}
+
+ZTEST(net_tcp_offload, test_gro_bad_checksum)
+{
+	struct net_tcp_gro gro;
+	struct net_pkt *head;
+	struct net_pkt *pkt;
+
+	head = gro_frame(5000U, ACK, &payload[0], 100);
+	zassert_true(net_tcp_gro_init(&gro, head));
+
+	pkt = gro_frame(5100U, ACK, &payload[100], 100);
+	pkt->buffer->data[GRO_HDR_LEN] ^= 0x01;
+	zassert_false(net_tcp_gro_merge(&gro, pkt), "Corrupted segment merged");
+	net_pkt_unref(pkt);
+
+	net_tcp_gro_finish(&gro);
+	net_pkt_unref(head);
+}
+#endif /* CONFIG_NET_TCP_GRO */
+
+static void *offload_setup(void)
+{
+	eth_iface = net_if_get_first_by_type(&NET_L2_GET_NAME(ETHERNET));
+	zassert_not_null(eth_iface, "No Ethernet interface");
+
+	/* Received segments are only coalesced for local destinations */
+	zassert_not_null(net_if_ipv4_addr_add(eth_iface, &local_addr, NET_ADDR_MANUAL, 0),
+			 "Cannot add IPv4 address");
+
+	for (int i = 0; i < sizeof(payload); i++) {
+		payload[i] = (uint8_t)(i * 13 + 7);
+	}
+
+	return NULL;
+}
+
+ZTEST_SUITE(net_tcp_offload, NULL, offload_setup, NULL, NULL, NULL);
+
+#endif /* CONFIG_NET_TCP_GSO || CONFIG_NET_TCP_GRO */
@@ -0,0 +1,203 @@
+/*
+ * Copyright The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Packets waiting in the Tx queue are taken by the Tx thread together and
+ * handed to the Ethernet driver with one send_burst() call. Check the batch
+ * size, the fallback to send() for the packets the driver does not take and
+ * that the packets are sent in order.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+
+#include "ipv6.h"
+
+/* The length makes the test packets stand out from any other traffic */
+#define TEST_DATA_LEN 77
+#define TEST_PKT_LEN (sizeof(struct net_ipv6_hdr) + TEST_DATA_LEN)
+#define WAIT_TIME K_SECONDS(1)
+
+static K_SEM_DEFINE(sent_sem, 0, CONFIG_NET_TC_TX_BURST);
+
+static uint8_t mac_addr[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+static uint8_t sent_order[CONFIG_NET_TC_TX_BURST];
+static size_t sent_count;
+static size_t burst_calls;
+static size_t burst_pkts;
+static size_t single_pkts;
+static size_t burst_limit;
+static struct net_if *test_iface;
+
+static bool is_test_pkt(struct net_pkt *pkt)
+{
+	return net_pkt_get_len(pkt) == sizeof(struct net_eth_hdr) + TEST_PKT_LEN;
+}
+
+static void record_sent(struct net_pkt *pkt)
+{
+	struct net_buf *buf = pkt->buffer;
+	size_t offset = sizeof(struct net_eth_hdr) + sizeof(struct net_ipv6_hdr);
+
+	while (offset >= buf->len) {
+		offset -= buf->len;
+		buf = buf->frags;
+	}
+
+	zassert_true(sent_count < ARRAY_SIZE(sent_order), "Too many packets sent");
+	sent_order[sent_count++] = buf->data[offset];
+
+	k_sem_give(&sent_sem);
+}
+
+static int eth_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+
+	if (is_test_pkt(pkt)) {
+		single_pkts++;
+		record_sent(pkt);
+	}
+
+	return 0;
+}
+
+static int eth_send_burst(const struct device *dev, struct net_pkt **pkts, size_t count)
+{
+	size_t taken = MIN(count, burst_limit);
+
+	ARG_UNUSED(dev);
+
+	burst_calls++;
+
+	for (size_t i = 0; i < taken; i++) {
+		if (is_test_pkt(pkts[i])) {
+			burst_pkts++;
+			record_sent(pkts[i]);
+		}
+	}
+
+	return taken;
+}
+
+static void eth_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr), NET_LINK_ETHERNET);
+
+	ethernet_init(iface);
+}
+
+static enum ethernet_hw_caps eth_get_capabilities(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static const struct ethernet_api eth_api = {
+	.iface_api.init = eth_iface_init,
+	.get_capabilities = eth_get_capabilities,
+	.send = eth_send,
+	.send_burst = eth_send_burst,
+};
+
+ETH_NET_DEVICE_INIT(eth_tx_burst_test, "eth_tx_burst_test", NULL, NULL, NULL, NULL,
+		    CONFIG_ETH_INIT_PRIORITY, &eth_api, NET_ETH_MTU);
+
+static struct net_pkt *test_pkt(uint8_t seq)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(test_iface, TEST_PKT_LEN, AF_INET6, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	/* An all zero destination is not multicast, so the link destination
+	 * set below is used.
+	 */
+	zassert_ok(net_pkt_memset(pkt, 0, sizeof(struct net_ipv6_hdr)));
+	zassert_ok(net_pkt_memset(pkt, seq, TEST_DATA_LEN));
+
+	net_pkt_lladdr_src(pkt)->addr = net_if_get_link_addr(test_iface)->addr;
+	net_pkt_lladdr_src(pkt)->len = sizeof(struct net_eth_addr);
+	net_pkt_lladdr_dst(pkt)->addr = mac_addr;
+	net_pkt_lladdr_dst(pkt)->len = sizeof(struct net_eth_addr);
+
+	return pkt;
+}
+
+static void send_pkts(size_t count)
+{
+	/* Queue all the packets before the Tx thread can run */
+	k_sched_lock();
+
+	for (size_t i = 0; i < count; i++) {
+		net_if_queue_tx(test_iface, test_pkt(i));
+	}
+
+	k_sched_unlock();
+
+	for (size_t i = 0; i < count; i++) {
+		zassert_ok(k_sem_take(&sent_sem, WAIT_TIME), "Packet %zu not sent", i);
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		zassert_equal(sent_order[i], i, "Packet %zu sent out of order", i);
+	}
+}
+
+ZTEST(net_tx_burst, test_single)
+{
+	send_pkts(1);
+
+	zassert_equal(burst_calls, 0, "Single packet sent as a burst");
+	zassert_equal(single_pkts, 1, "Packet not sent with send()");
+}
+
+ZTEST(net_tx_burst, test_burst)
+{
+	send_pkts(4);
+
+	zassert_equal(burst_calls, 1, "Packets not sent in one burst (%zu)", burst_calls);
+	zassert_equal(burst_pkts, 4, "Packets missing from the burst (%zu)", burst_pkts);
+	zassert_equal(single_pkts, 0, "Packets sent with send() (%zu)", single_pkts);
+}
+
+ZTEST(net_tx_burst, test_burst_partial)
+{
+	burst_limit = 2;
+
+	send_pkts(4);
+
+	zassert_equal(burst_calls, 1, "Packets not sent in one burst (%zu)", burst_calls);
+	zassert_equal(burst_pkts, 2, "Driver took %zu packets", burst_pkts);
+	zassert_equal(single_pkts, 2, "Packets not taken not sent with send() (%zu)",
+		      single_pkts);
+}
+
+static void *setup(void)
+{
+	test_iface = net_if_lookup_by_dev(DEVICE_GET(eth_tx_burst_test));
+	zassert_not_null(test_iface, "Interface not found");
+
+	return NULL;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	k_sem_reset(&sent_sem);
+	sent_count = 0;
+	burst_calls = 0;
+	burst_pkts = 0;
+	single_pkts = 0;
+	burst_limit = CONFIG_NET_TC_TX_BURST;
+}
+
+ZTEST_SUITE(net_tx_burst, NULL, setup, before, NULL, NULL);